@@ -33,22 +33,16 @@ LOG_MODULE_REGISTER(MODULE, CONFIG_BRIDGE_BLE_LOG_LEVEL);
 #define BLE_AD_IDX_FLAGS 0
 #define BLE_AD_IDX_NAME 1
 
-#define ATT_MIN_PAYLOAD 20 /* Minimum L2CAP MTU minus ATT header */
-
-static void bt_send_work_handler(struct k_work *work);
-
 K_MEM_SLAB_DEFINE(ble_rx_slab, BLE_RX_BLOCK_SIZE, BLE_RX_BUF_COUNT, BLE_SLAB_ALIGNMENT);
 RING_BUF_DECLARE(ble_tx_ring_buf, BLE_TX_BUF_SIZE);
 
 static K_SEM_DEFINE(ble_tx_sem, 0, 1);
 
-static K_WORK_DEFINE(bt_send_work, bt_send_work_handler);
-
 static struct bt_conn *current_conn;
 static struct bt_gatt_exchange_params exchange_params;
-static uint32_t nus_max_send_len;
 static atomic_t ready;
 static atomic_t active;
+static atomic_t send_enabled;
 
 static char bt_device_name[CONFIG_BT_DEVICE_NAME_MAX + 1] = CONFIG_BT_DEVICE_NAME;
 
@@ -64,8 +58,8 @@ static const struct bt_data sd[] = {
 static void exchange_func(struct bt_conn *conn, uint8_t err,
 			  struct bt_gatt_exchange_params *params)
 {
-	if (!err) {
-		nus_max_send_len = bt_nus_get_mtu(conn);
+	if (err) {
+		LOG_WRN("MTU exchange failed (err %u)", err);
 	}
 }
 
@@ -126,37 +120,6 @@ static struct bt_conn_cb conn_callbacks = {
 	.disconnected = disconnected,
 };
 
-static void bt_send_work_handler(struct k_work *work)
-{
-	uint16_t len;
-	uint8_t *buf;
-	int err;
-	bool notif_disabled = false;
-
-	do {
-		len = ring_buf_get_claim(&ble_tx_ring_buf, &buf, nus_max_send_len);
-
-		err = bt_nus_send(current_conn, buf, len);
-		if (err == -EINVAL) {
-			notif_disabled = true;
-			len = 0;
-		} else if (err) {
-			len = 0;
-		}
-
-		err = ring_buf_get_finish(&ble_tx_ring_buf, len);
-		if (err) {
-			LOG_ERR("ring_buf_get_finish: %d", err);
-			break;
-		}
-	} while (len != 0 && !ring_buf_is_empty(&ble_tx_ring_buf));
-
-	if (notif_disabled) {
-		/* Peer has not enabled notifications: don't accumulate data */
-		ring_buf_reset(&ble_tx_ring_buf);
-	}
-}
-
 static void bt_receive_cb(struct bt_conn *conn, const uint8_t *const data,
 			  uint16_t len)
 {
@@ -188,18 +151,14 @@ static void bt_receive_cb(struct bt_conn *conn, const uint8_t *const data,
 	} while (remainder);
 }
 
-static void bt_sent_cb(struct bt_conn *conn)
+static void bt_send_enabled_cb(enum bt_nus_send_status status)
 {
-	if (ring_buf_is_empty(&ble_tx_ring_buf)) {
-		return;
-	}
-
-	k_work_submit(&bt_send_work);
+	atomic_set(&send_enabled, status == BT_NUS_SEND_STATUS_ENABLED);
 }
 
 static struct bt_nus_cb nus_cb = {
 	.received = bt_receive_cb,
-	.sent = bt_sent_cb,
+	.send_enabled = bt_send_enabled_cb,
 };
 
 static void adv_start(void)
@@ -293,7 +252,8 @@ static bool app_event_handler(const struct app_event_header *aeh)
 			return false;
 		}
 
-		if (current_conn == NULL) {
+		/* Peer has not enabled notifications: don't accumulate data */
+		if (current_conn == NULL || !atomic_get(&send_enabled)) {
 			return false;
 		}
 
@@ -305,14 +265,13 @@ static bool app_event_handler(const struct app_event_header *aeh)
 			LOG_WRN("UART_%d -> BLE overflow", event->dev_idx);
 		}
 
-		uint32_t buf_utilization =
-			(ring_buf_capacity_get(&ble_tx_ring_buf) -
-			ring_buf_space_get(&ble_tx_ring_buf));
+		/* The NUS stream sends the data straight from the ring buffer,
+		 * and frees it as the notifications complete.
+		 */
+		int err = bt_nus_stream_ring_send(current_conn, &ble_tx_ring_buf);
 
-		/* Simple check to start transmission. */
-		/* If bt_send_work is already running, this has no effect */
-		if (buf_utilization == written) {
-			k_work_submit(&bt_send_work);
+		if (err && err != -EINVAL) {
+			LOG_WRN("bt_nus_stream_ring_send: %d", err);
 		}
 
 		return false;
@@ -364,8 +323,6 @@ static bool app_event_handler(const struct app_event_header *aeh)
 
 			atomic_set(&active, false);
 
-			nus_max_send_len = ATT_MIN_PAYLOAD;
-
 			err = bt_enable(bt_ready);
 			if (err) {
 				LOG_ERR("bt_enable: %d", err);
@@ -17,8 +17,12 @@ find_package(Python3 REQUIRED)
 #                 to image formats used.
 #   OUTPUT        location of the created package
 #
+# Optional arguments:
+#   DIGEST        include the digest of the package content in the header, which is
+#                 needed to resume an interrupted package write
+#
 function(dfu_multi_image_package TARGET_NAME)
-    cmake_parse_arguments(ARG "" "OUTPUT" "IMAGE_IDS;IMAGE_PATHS" ${ARGN})
+    cmake_parse_arguments(ARG "DIGEST" "OUTPUT" "IMAGE_IDS;IMAGE_PATHS" ${ARGN})
 
     if (NOT DEFINED ARG_IMAGE_IDS OR NOT ARG_IMAGE_PATHS OR NOT ARG_OUTPUT)
         message(FATAL_ERROR "All IMAGE_IDS, IMAGE_PATHS and OUTPUT arguments must be specified")
@@ -31,6 +35,10 @@ function(dfu_multi_image_package TARGET_NAME)
         list(APPEND SCRIPT_ARGS "--image" "${image_0}" "${image_1}")
     endforeach()
 
+    if (ARG_DIGEST)
+        list(APPEND SCRIPT_ARGS "--digest")
+    endif()
+
     list(APPEND SCRIPT_ARGS ${ARG_OUTPUT})
 
     # Pass the argument list via file to avoid hitting Windows command-line length limit
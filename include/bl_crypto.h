@@ -169,6 +169,18 @@ int bl_sha256_verify(const uint8_t *data, uint32_t data_len, const uint8_t *expe
 typedef int (*bl_sha256_verify_t)(const uint8_t *data, uint32_t data_len,
 				const uint8_t *expected);
 
+/**
+ * @brief Implementation of sha256_verify for use by the bootloader itself.
+ *
+ * Unlike @ref bl_sha256_verify, this function is not safe to call through
+ * EXT_API. In exchange, the hash backend may use its static buffers, which
+ * lets it process flash-resident data in larger chunks.
+ *
+ * See @ref bl_sha256_verify for docs.
+ */
+int bl_sha256_verify_internal(const uint8_t *data, uint32_t data_len,
+			      const uint8_t *expected);
+
 
 /**
  * @brief Validate a secp256r1 signature.
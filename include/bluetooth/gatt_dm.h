@@ -264,9 +264,11 @@ const struct bt_gatt_dm_attr *bt_gatt_dm_desc_next(
  * This function is asynchronous. Discovery results are passed through
  * the supplied callback.
  *
- * @note Only one discovery procedure can be started simultaneously. To start
- * another one, wait for the result of the previous procedure to finish
- * and call @ref bt_gatt_dm_data_release if it was successful.
+ * @note Only one discovery procedure can be started simultaneously on
+ * a connection. To start another one, wait for the result of the previous
+ * procedure to finish and call @ref bt_gatt_dm_data_release if it was
+ * successful. Discovery procedures on different connections can run in
+ * parallel, up to @kconfig{CONFIG_BT_GATT_DM_MAX_INSTANCES}.
  *
  * @param[in]     conn Connection object.
  * @param[in]     svc_uuid UUID of target service
@@ -284,7 +286,9 @@ const struct bt_gatt_dm_attr *bt_gatt_dm_desc_next(
  * Call @ref bt_gatt_dm_continue to discover the next service instance.
  *
  * @retval 0 If the operation was successful.
- *           Otherwise, a (negative) error code is returned.
+ * @retval -EALREADY If a discovery is already in progress on @p conn.
+ * @retval -ENOMEM If all Discovery Manager instances are in use.
+ * @return Otherwise, a (negative) error code is returned.
  */
 int bt_gatt_dm_start(struct bt_conn *conn,
 		     const struct bt_uuid *svc_uuid,
@@ -331,6 +335,40 @@ static inline void bt_gatt_dm_data_print(const struct bt_gatt_dm *dm)
 }
 #endif
 
+/** @brief Invalidate the cached discovery results of a connected peer.
+ *
+ * The Database Hash of the peer is read again before the next discovery
+ * on the connection, and cached results that do not match it are not used.
+ * Call this function when a Service Changed indication is received.
+ *
+ * @param[in] conn Connection object.
+ */
+#ifdef CONFIG_BT_GATT_DM_CACHE
+void bt_gatt_dm_cache_invalidate(struct bt_conn *conn);
+#else
+static inline void bt_gatt_dm_cache_invalidate(struct bt_conn *conn)
+{
+}
+#endif
+
+/** @brief Remove the cached discovery results of a peer.
+ *
+ * This is done automatically when the bond with the peer is deleted.
+ *
+ * @param[in] addr Identity address of the peer.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+#ifdef CONFIG_BT_GATT_DM_CACHE
+int bt_gatt_dm_cache_clear(const bt_addr_le_t *addr);
+#else
+static inline int bt_gatt_dm_cache_clear(const bt_addr_le_t *addr)
+{
+	return 0;
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
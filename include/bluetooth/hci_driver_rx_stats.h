@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ * @defgroup bt_hci_driver_rx_stats SoftDevice Controller HCI receive statistics
+ * @{
+ * @brief Statistics of the retrieval of HCI packets from the SoftDevice
+ *        Controller.
+ *
+ * @details The HCI driver retrieves several packets from the controller each
+ *          time it is woken up, see @kconfig{CONFIG_BT_CTLR_SDC_RX_BATCH_SIZE}.
+ *          These statistics help tune the batch limits. They are available
+ *          when @kconfig{CONFIG_BT_CTLR_SDC_RX_STATS} is enabled.
+ */
+
+#ifndef BT_HCI_DRIVER_RX_STATS_H_
+#define BT_HCI_DRIVER_RX_STATS_H_
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief HCI receive statistics. */
+struct hci_driver_rx_stats {
+	/** Number of times the receive processing was run. */
+	uint32_t wakeups;
+
+	/** Number of packets retrieved from the controller. */
+	uint32_t packets;
+
+	/** Largest number of packets retrieved in a single run. */
+	uint32_t packets_max;
+
+	/** Number of ACL packets copied by the controller directly into host
+	 *  buffers. Always 0 with @kconfig{CONFIG_BT_HCI_ACL_FLOW_CONTROL}.
+	 */
+	uint32_t acl_direct;
+
+	/** Number of runs that stopped on the batch limits while the
+	 *  controller still had packets.
+	 */
+	uint32_t budget_exhausted;
+};
+
+/**@brief Get the HCI receive statistics.
+ *
+ * @param[out] stats Receive statistics.
+ */
+void hci_driver_rx_stats_get(struct hci_driver_rx_stats *stats);
+
+/**@brief Reset the HCI receive statistics. */
+void hci_driver_rx_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* BT_HCI_DRIVER_RX_STATS_H_ */
@@ -51,6 +51,10 @@ struct bt_mesh_light_ctrl_reg {
 	float measured;
 	/** Regulator output update callback. */
 	void (*updated)(struct bt_mesh_light_ctrl_reg *reg, float output);
+	/** Regulator output update callback for regulators working without
+	 *  floating point arithmetic, see @ref bt_mesh_light_ctrl_reg_fixed.
+	 */
+	void (*updated_lvl)(struct bt_mesh_light_ctrl_reg *reg, uint16_t output);
 	/** User data, available in update callback. */
 	void *user_data;
 /** @cond INTERNAL_HIDDEN */
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @defgroup bt_mesh_light_ctrl_reg_fixed Fixed-point illuminance regulator
+ *  @ingroup bt_mesh_light_ctrl
+ *  @{
+ *  @brief Fixed-point implementation of the specification-defined illuminance regulator
+ */
+
+#ifndef BT_MESH_LIGHT_CTRL_REG_FIXED_H__
+#define BT_MESH_LIGHT_CTRL_REG_FIXED_H__
+
+#include <bluetooth/mesh/light_ctrl_reg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**  @def BT_MESH_LIGHT_CTRL_REG_FIXED_INIT
+ *
+ *   @brief Initialization macro for @ref bt_mesh_light_ctrl_reg_fixed.
+ */
+#define BT_MESH_LIGHT_CTRL_REG_FIXED_INIT                                      \
+	{                                                                      \
+		.reg = {                                                       \
+			.init = bt_mesh_light_ctrl_reg_fixed_init,             \
+			.start = bt_mesh_light_ctrl_reg_fixed_start,           \
+			.stop = bt_mesh_light_ctrl_reg_fixed_stop              \
+		}                                                              \
+	}
+
+/** Fixed-point illuminance regulator context. */
+struct bt_mesh_light_ctrl_reg_fixed {
+	/** Common regulator context. */
+	struct bt_mesh_light_ctrl_reg reg;
+	/** Regulator step timer. */
+	struct k_work_delayable timer;
+	/** Internal integral sum, in Q16.16 format. */
+	int64_t i;
+	/** Regulator enabled flag. */
+	bool enabled;
+};
+
+/** @cond INTERNAL_HIDDEN */
+void bt_mesh_light_ctrl_reg_fixed_init(struct bt_mesh_light_ctrl_reg *reg);
+void bt_mesh_light_ctrl_reg_fixed_start(struct bt_mesh_light_ctrl_reg *reg);
+void bt_mesh_light_ctrl_reg_fixed_stop(struct bt_mesh_light_ctrl_reg *reg);
+/** @endcond */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BT_MESH_LIGHT_CTRL_REG_FIXED_H__ */
+
+/** @} */
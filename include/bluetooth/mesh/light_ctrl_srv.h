@@ -22,6 +22,7 @@
 #include <bluetooth/mesh/model_types.h>
 #include <bluetooth/mesh/light_ctrl_reg.h>
 #include <bluetooth/mesh/light_ctrl_reg_spec.h>
+#include <bluetooth/mesh/light_ctrl_reg_fixed.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -56,7 +57,10 @@ struct bt_mesh_light_ctrl_srv;
  *
  *  This will enable the specification-defined regulator if
  *  @kconfig{CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG} and
- *  @kconfig{CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC} are selected.
+ *  @kconfig{CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC} are selected, or its
+ *  fixed-point implementation if @kconfig{CONFIG_BT_MESH_LIGHT_CTRL_REG_FIXED}
+ *  is selected instead. Use @ref BT_MESH_LIGHT_CTRL_SRV_INIT_WITH_REG to
+ *  select the regulator for each server.
  *
  *  @param[in] _lightness_srv Pointer to the @ref bt_mesh_lightness_srv this
  *                            server controls.
@@ -67,6 +71,12 @@ struct bt_mesh_light_ctrl_srv;
 		_lightness_srv,                                                \
 		&(&((struct bt_mesh_light_ctrl_reg_spec)                       \
 		    BT_MESH_LIGHT_CTRL_REG_SPEC_INIT))->reg)
+#elif CONFIG_BT_MESH_LIGHT_CTRL_REG_FIXED && CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG
+#define BT_MESH_LIGHT_CTRL_SRV_INIT(_lightness_srv)                            \
+	BT_MESH_LIGHT_CTRL_SRV_INIT_WITH_REG(                                  \
+		_lightness_srv,                                                \
+		&(&((struct bt_mesh_light_ctrl_reg_fixed)                      \
+		    BT_MESH_LIGHT_CTRL_REG_FIXED_INIT))->reg)
 #else
 #define BT_MESH_LIGHT_CTRL_SRV_INIT(_lightness_srv)                            \
 	{                                                                      \
@@ -27,6 +27,10 @@ extern "C" {
 #define CONFIG_BT_MESH_SCENES_MAX 0
 #endif
 
+#ifndef CONFIG_BT_MESH_SCENE_SRV_PAGES_MAX
+#define CONFIG_BT_MESH_SCENE_SRV_PAGES_MAX 0
+#endif
+
 /** @def BT_MESH_SCENE_ENTRY_SIG
  *
  *  @brief Scene entry type definition for SIG models
@@ -67,6 +71,24 @@ struct bt_mesh_scene_srv;
 						 _srv),                        \
 			 &_bt_mesh_scene_setup_srv_cb)
 
+/** @cond INTERNAL_HIDDEN */
+
+/** Stored scene data page. */
+struct bt_mesh_scene_page {
+	/** CRC32 of the page data. Only valid if the data is stored with
+	 *  this scene.
+	 */
+	uint32_t hash;
+	/** Scene the page data is stored with, or @ref BT_MESH_SCENE_NONE
+	 *  if it is stored with this scene.
+	 */
+	uint16_t link;
+	/** Whether the page is stored. */
+	bool stored;
+};
+
+/** @endcond */
+
 /** Scene Server model instance */
 struct bt_mesh_scene_srv {
 	/** All known scenes. */
@@ -86,6 +108,12 @@ struct bt_mesh_scene_srv {
 	/** Largest number of pages used to store SIG model scene data. */
 	uint8_t sigpages;
 
+	/** Index of the first scene data pages of every scene, for SIG and
+	 *  vendor models. Ordered like @c all.
+	 */
+	struct bt_mesh_scene_page pages[CONFIG_BT_MESH_SCENES_MAX][2]
+				       [CONFIG_BT_MESH_SCENE_SRV_PAGES_MAX];
+
 	/** Linked list node for Scene Server list */
 	sys_snode_t n;
 
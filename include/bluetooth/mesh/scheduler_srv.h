@@ -76,6 +76,14 @@ struct bt_mesh_scheduler_srv {
 		 * in the Schedule Register.
 		 */
 		uint16_t active_bitmap;
+		/* Min-heap of the active entries, ordered by
+		 * their TAI-time.
+		 */
+		uint8_t heap[BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT];
+		/* Position of each active entry in the heap. */
+		uint8_t heap_pos[BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT];
+		/* Number of entries in the heap. */
+		uint8_t heap_len;
 		/* The Schedule Register state is a 16-entry,
 		 * zero-based, indexed array
 		 */
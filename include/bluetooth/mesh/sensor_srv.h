@@ -63,6 +63,8 @@ struct bt_mesh_sensor_srv {
 	struct bt_mesh_sensor *const *sensor_array;
 	/** Ordered linked list of sensors. */
 	sys_slist_t sensors;
+	/** Sensors ordered by sensor type ID, for lookup. */
+	struct bt_mesh_sensor *sorted[CONFIG_BT_MESH_SENSOR_SRV_SENSORS_MAX];
 	/** Publish sequence counter */
 	uint16_t seq;
 	/** Number of sensors. */
@@ -543,6 +543,49 @@ int bt_scan_blocklist_device_add(const bt_addr_le_t *addr);
  */
 void bt_scan_blocklist_clear(void);
 
+/**@brief Advertising report deduplication statistics.
+ */
+struct bt_scan_dedup_stats {
+	/** Number of advertising reports received. */
+	uint32_t received;
+
+	/** Number of reports passed on to the filters and the application. */
+	uint32_t reported;
+
+	/** Number of reports suppressed as duplicates. */
+	uint32_t suppressed;
+
+	/** Number of devices evicted from the cache to make room for others. */
+	uint32_t evicted;
+};
+
+/**@brief Clear the advertising report deduplication cache.
+ *
+ * @details Use this function to have the next report from every device
+ *          passed on to the application, regardless of
+ *          the reports received before. The cache is also cleared when
+ *          scanning is started and when the filters are changed.
+ *          Available when @kconfig{CONFIG_BT_SCAN_DEDUP} is enabled.
+ */
+void bt_scan_dedup_clear(void);
+
+/**@brief Get the advertising report deduplication statistics.
+ *
+ * @details Available when @kconfig{CONFIG_BT_SCAN_DEDUP} is enabled.
+ *
+ * @param[out] stats Deduplication statistics.
+ *
+ * @return 0 If the operation was successful. Otherwise, a (negative) error
+ *	     code is returned.
+ */
+int bt_scan_dedup_stats_get(struct bt_scan_dedup_stats *stats);
+
+/**@brief Reset the advertising report deduplication statistics.
+ *
+ * @details Available when @kconfig{CONFIG_BT_SCAN_DEDUP} is enabled.
+ */
+void bt_scan_dedup_stats_reset(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -227,6 +227,23 @@ struct bt_hids_inp_rep {
 
 	/** Callback with the notification event. */
 	bt_hids_notify_handler_t handler;
+
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+	/** Connections subscribed to notifications, by context ID. */
+	ATOMIC_DEFINE(subscribed, CONFIG_BT_MAX_CONN);
+
+	/** Connections with a notification in flight, by context ID. */
+	ATOMIC_DEFINE(in_flight, CONFIG_BT_MAX_CONN);
+
+	/** Connections waiting for the latest report, by context ID. */
+	ATOMIC_DEFINE(pending, CONFIG_BT_MAX_CONN);
+
+	/** Latest report sent to all connections. */
+	uint8_t latest[CONFIG_BT_HIDS_INP_REP_FAST_PATH_MAX_LEN];
+
+	/** Notification sent callback for the latest report. */
+	bt_gatt_complete_func_t cb;
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
 };
 
 
@@ -460,6 +477,14 @@ struct bt_hids {
 
 	/** Bluetooth connection contexts. */
 	struct bt_conn_ctx_lib *conn_ctx;
+
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+	/** Lock for the Input Report data used by the fast path. */
+	struct k_spinlock lock;
+
+	/** Node in the list of initialized HIDS instances. */
+	sys_snode_t node;
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
 };
 
 /** @brief HID Connection context data structure.
@@ -537,6 +562,28 @@ int bt_hids_disconnected(struct bt_hids *hids_obj, struct bt_conn *conn);
  *  @note The function is not thread safe.
  *	     It can not be called from multiple threads at the same time.
  *
+ *  If @kconfig{CONFIG_BT_HIDS_INP_REP_FAST_PATH} is enabled, @p conn is
+ *  NULL and @p len does not exceed
+ *  @kconfig{CONFIG_BT_HIDS_INP_REP_FAST_PATH_MAX_LEN}, the report is sent
+ *  through the fast path:
+ *  - The report is sent to the peers that enabled notifications through
+ *    the CCC descriptor, including peers whose CCC was restored on a bonded
+ *    reconnection. The subscriptions are tracked by the HIDS module and
+ *    updated on CCC writes, on connection and on security changes.
+ *  - Each peer has at most one notification of the report in flight.
+ *    A report sent in the meantime waits, and is sent once the
+ *    notification in flight has completed.
+ *  - Only one report can wait. While a report is waiting for any peer,
+ *    the function fails with -EBUSY and the new report is not sent to
+ *    any peer. Merge it with the next report, for example by adding up
+ *    the mouse movement, and send it again after @p cb has been called.
+ *  - @p cb is called with @c user_data set to NULL once for every
+ *    completed notification, including the notifications of waiting
+ *    reports. The callback passed with the latest report is used.
+ *  - A waiting report is dropped if the peer disables notifications, and
+ *    @p cb is not called for notifications completed after the peer has
+ *    disconnected.
+ *
  *  @param hids_obj Pointer to HIDS instance.
  *  @param conn Pointer to Connection Object.
  *  @param rep_index Index of report descriptor.
@@ -544,8 +591,10 @@ int bt_hids_disconnected(struct bt_hids *hids_obj, struct bt_conn *conn);
  *  @param len Length of report data.
  *  @param cb Notification complete callback (can be NULL).
  *
- *  @return 0 If the operation was successful. Otherwise, a (negative) error
- *	      code is returned.
+ *  @retval 0 If the operation was successful.
+ *  @retval -EBUSY If a report is already waiting to be sent through the
+ *	    fast path to @p conn, or to any peer if @p conn is NULL.
+ *  @return Otherwise, a (negative) error code is returned.
  */
 int bt_hids_inp_rep_send(struct bt_hids *hids_obj, struct bt_conn *conn,
 			 uint8_t rep_index, uint8_t const *rep, uint8_t len,
@@ -71,6 +71,24 @@ struct bt_mds_cb {
 	bool (*access_enable)(struct bt_conn *conn);
 };
 
+/** @brief Memfault Diagnostic Service export statistics. */
+struct bt_mds_stats {
+	/** Number of diagnostic data bytes exported. */
+	uint32_t bytes;
+
+	/** Number of diagnostic data chunks exported. */
+	uint32_t chunks;
+
+	/** Number of times the export stalled for lack of Bluetooth buffers. */
+	uint32_t stalls;
+
+	/** Time with chunks in flight in milliseconds.
+	 *
+	 * The export throughput is @ref bytes divided by this time.
+	 */
+	uint32_t duration_ms;
+};
+
 /** @brief Register the Memfault Diagnostic service callback.
  *
  * This function should be called before enabling Bluetooth stack to ensure proper access grating
@@ -84,6 +102,17 @@ struct bt_mds_cb {
  */
 int bt_mds_cb_register(const struct bt_mds_cb *cb);
 
+/** @brief Get the diagnostic data export statistics.
+ *
+ * The statistics are reset when a client enables the data export on a new connection.
+ *
+ * @param[out] stats Export statistics.
+ *
+ *  @retval 0 If the operation was successful.
+ *          Otherwise, a negative error code is returned
+ */
+int bt_mds_stats_get(struct bt_mds_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
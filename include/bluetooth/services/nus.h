@@ -18,6 +18,8 @@
 #include <zephyr/bluetooth/conn.h>
 #include <zephyr/bluetooth/uuid.h>
 #include <zephyr/bluetooth/gatt.h>
+#include <zephyr/net/buf.h>
+#include <zephyr/sys/ring_buffer.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -126,6 +128,93 @@ static inline uint32_t bt_nus_get_mtu(struct bt_conn *conn)
 	return bt_gatt_get_mtu(conn) - 3;
 }
 
+/** @brief NUS stream statistics. */
+struct bt_nus_stream_stats {
+	/** Number of bytes sent. */
+	uint32_t tx_bytes;
+
+	/** Number of notifications sent. */
+	uint32_t tx_notifications;
+
+	/** Number of times the stream stalled for lack of transmit buffers. */
+	uint32_t tx_stalls;
+
+	/** Number of bytes dropped unsent because notifications were disabled,
+	 *  or a notification failed.
+	 */
+	uint32_t dropped_bytes;
+
+	/** Time since the statistics were reset, in milliseconds. */
+	uint32_t duration_ms;
+};
+
+/**@brief Stream a net_buf chain.
+ *
+ * @details This function queues the data of a net_buf chain for sending
+ *          to a connected peer. The data is sent as notifications of up
+ *          to @ref bt_nus_get_mtu bytes, and each notification carries
+ *          data of a single fragment. Use fragments of at least the
+ *          maximum notification length to send full notifications.
+ *
+ *          Up to @kconfig{CONFIG_BT_NUS_STREAM_TX_COUNT} notifications are
+ *          in flight at a time. The stream sends more data as the
+ *          notifications complete.
+ *
+ *          The stream takes over the reference to @p buf, and releases it
+ *          once all of its data has been sent, or dropped.
+ *
+ * @param[in] conn Pointer to connection object.
+ * @param[in] buf  First fragment of the chain.
+ *
+ * @retval 0 If the data is queued.
+ *           Otherwise, a negative value is returned, and the reference to
+ *           @p buf is kept by the caller.
+ * @retval -EINVAL If the chain holds no data, or the peer has not enabled
+ *                 notifications.
+ */
+int bt_nus_stream_send(struct bt_conn *conn, struct net_buf *buf);
+
+/**@brief Stream the data of a ring buffer.
+ *
+ * @details This function sends the data held in a ring buffer to
+ *          a connected peer, the same way as @ref bt_nus_stream_send.
+ *          Call it after putting data in the ring buffer.
+ *
+ *          The stream owns the reading side of the ring buffer until the
+ *          peer disconnects, and frees the data once it has been sent.
+ *          Data queued with @ref bt_nus_stream_send is sent first.
+ *
+ * @param[in] conn Pointer to connection object.
+ * @param[in] rb   Ring buffer.
+ *
+ * @retval 0 If the data is queued.
+ *           Otherwise, a negative value is returned.
+ * @retval -EINVAL If the peer has not enabled notifications.
+ * @retval -EBUSY If the stream still sends data of another ring buffer.
+ */
+int bt_nus_stream_ring_send(struct bt_conn *conn, struct ring_buf *rb);
+
+/**@brief Get the statistics of a stream.
+ *
+ * @details The statistics are reset when a stream is started on a new
+ *          connection.
+ *
+ * @param[in] conn   Pointer to connection object.
+ * @param[out] stats Stream statistics.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a negative value is returned.
+ * @retval -ENOENT If no stream has been started on the connection.
+ */
+int bt_nus_stream_stats_get(struct bt_conn *conn,
+			    struct bt_nus_stream_stats *stats);
+
+/**@brief Reset the statistics of a stream.
+ *
+ * @param[in] conn Pointer to connection object.
+ */
+void bt_nus_stream_stats_reset(struct bt_conn *conn);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @file
+ * @defgroup bt_throughput_bench Bluetooth LE GATT Throughput benchmark API
+ * @{
+ * @brief API for benchmarking the link throughput with the GATT Throughput
+ *        Service.
+ */
+
+#ifndef BT_THROUGHPUT_BENCH_H_
+#define BT_THROUGHPUT_BENCH_H_
+
+#include <zephyr/bluetooth/conn.h>
+#include <bluetooth/services/throughput.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Header of the comma-separated benchmark results.
+ *
+ *  Matches the lines written by @ref bt_throughput_bench_csv.
+ */
+#define BT_THROUGHPUT_BENCH_CSV_HEADER                                         \
+	"phy,interval,data_len,att_mtu,bytes,writes,duration_us,goodput_bps,"  \
+	"latency_p50_us,latency_p90_us,latency_p99_us,latency_max_us,cpu_load"
+
+/** @brief Parameters of a single benchmark run. */
+struct bt_throughput_bench_params {
+	/** Preferred PHY. */
+	struct bt_conn_le_phy_param phy;
+
+	/** Connection interval in 1.25 ms units. */
+	uint16_t interval;
+
+	/** Maximum LL payload length in octets. */
+	uint16_t data_len;
+
+	/** ATT MTU used for the writes, or 0 to use the exchanged ATT MTU.
+	 *
+	 *  The value is capped at the exchanged ATT MTU.
+	 */
+	uint16_t att_mtu;
+
+	/** Number of bytes to transfer. */
+	uint32_t size;
+};
+
+/** @brief Results of a single benchmark run. */
+struct bt_throughput_bench_result {
+	/** Number of bytes transferred. */
+	uint32_t bytes;
+
+	/** Number of GATT writes. */
+	uint32_t writes;
+
+	/** ATT MTU used for the writes. */
+	uint16_t att_mtu;
+
+	/** Time from the first write to the completion of the last write. */
+	uint32_t duration_us;
+
+	/** Goodput in bits per second. */
+	uint32_t goodput;
+
+	/** Median write latency in microseconds. */
+	uint32_t latency_p50;
+
+	/** 90th percentile of the write latency in microseconds. */
+	uint32_t latency_p90;
+
+	/** 99th percentile of the write latency in microseconds. */
+	uint32_t latency_p99;
+
+	/** Maximum write latency in microseconds. */
+	uint32_t latency_max;
+
+	/** CPU load during the transfer in 0.001% units.
+	 *
+	 *  Set to 0 if @kconfig{CONFIG_CPU_LOAD} is disabled.
+	 */
+	uint32_t cpu_load;
+};
+
+/** @brief Benchmark sweep.
+ *
+ *  A sweep runs the benchmark for every combination of the given values.
+ */
+struct bt_throughput_bench_sweep {
+	/** Preferred PHYs. */
+	const struct bt_conn_le_phy_param *phy;
+
+	/** Number of preferred PHYs. */
+	size_t phy_cnt;
+
+	/** Connection intervals in 1.25 ms units. */
+	const uint16_t *interval;
+
+	/** Number of connection intervals. */
+	size_t interval_cnt;
+
+	/** Maximum LL payload lengths in octets. */
+	const uint16_t *data_len;
+
+	/** Number of LL payload lengths. */
+	size_t data_len_cnt;
+
+	/** ATT MTUs, see @ref bt_throughput_bench_params.att_mtu. */
+	const uint16_t *att_mtu;
+
+	/** Number of ATT MTUs. */
+	size_t att_mtu_cnt;
+
+	/** Number of bytes to transfer in each run. */
+	uint32_t size;
+};
+
+/** @brief Benchmark result callback.
+ *
+ *  @param[in] params Parameters of the run.
+ *  @param[in] result Results of the run.
+ *  @param[in] user_data User data passed to @ref bt_throughput_bench_sweep.
+ */
+typedef void (*bt_throughput_bench_result_cb_t)(
+	const struct bt_throughput_bench_params *params,
+	const struct bt_throughput_bench_result *result,
+	void *user_data);
+
+/** @brief Initialize the throughput benchmark.
+ *
+ *  The benchmark writes to the peer of the given Throughput Service instance,
+ *  which must have its handles assigned with
+ *  @ref bt_throughput_handles_assign.
+ *
+ *  @param[in] throughput Throughput Service instance.
+ *
+ *  @retval 0 If the operation was successful.
+ *            Otherwise, a negative error code is returned.
+ */
+int bt_throughput_bench_init(struct bt_throughput *throughput);
+
+/** @brief Run a single benchmark.
+ *
+ *  Updates the link to the given parameters and transfers the given number
+ *  of bytes to the peer. The function blocks until the transfer has
+ *  completed.
+ *
+ *  @param[in] params Benchmark parameters.
+ *  @param[out] result Benchmark results.
+ *
+ *  @retval 0 If the operation was successful.
+ *            Otherwise, a negative error code is returned.
+ *  @retval -ENOTCONN If the peer is not connected.
+ *  @retval -EAGAIN If a link update or the transfer timed out.
+ */
+int bt_throughput_bench_run(const struct bt_throughput_bench_params *params,
+			    struct bt_throughput_bench_result *result);
+
+/** @brief Run a benchmark sweep.
+ *
+ *  Runs @ref bt_throughput_bench_run for every combination of the sweep
+ *  values, and calls the callback with the results of each run.
+ *
+ *  @param[in] sweep Benchmark sweep.
+ *  @param[in] cb Result callback.
+ *  @param[in] user_data User data passed to the callback.
+ *
+ *  @retval 0 If the operation was successful.
+ *            Otherwise, the error code of the first failed run is returned.
+ */
+int bt_throughput_bench_sweep(const struct bt_throughput_bench_sweep *sweep,
+			      bt_throughput_bench_result_cb_t cb,
+			      void *user_data);
+
+/** @brief Format benchmark results as a comma-separated line.
+ *
+ *  The columns are listed in @ref BT_THROUGHPUT_BENCH_CSV_HEADER.
+ *
+ *  @param[out] buf Buffer for the line.
+ *  @param[in] size Size of the buffer.
+ *  @param[in] params Parameters of the run.
+ *  @param[in] result Results of the run.
+ *
+ *  @return Length of the line, as returned by snprintk().
+ */
+int bt_throughput_bench_csv(char *buf, size_t size,
+			    const struct bt_throughput_bench_params *params,
+			    const struct bt_throughput_bench_result *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* BT_THROUGHPUT_BENCH_H_ */
@@ -34,6 +34,17 @@
  * 4. Call @c dfu_multi_image_done function to release open resources and verify that all
  *    data declared in the header have been written properly.
  *
+ * When @c CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS is enabled, the library persists the index
+ * of the first image that has not been fully written yet. The progress is bound to the
+ * package header, which must then include the digest of the package content, see the
+ * '--digest' option of the script. Packages without a digest are always written from
+ * the beginning. If the update is interrupted,
+ * the package shall be written again from offset 0 after repeating steps 1 and 2. Once
+ * the header is parsed, images completed before the interruption are skipped and
+ * @c dfu_multi_image_offset returns the offset at which the download can resume. The
+ * interrupted image is resumed from the offset reported by its writer, see
+ * @c dfu_image_writer::offset.
+ *
  * @{
  */
 
@@ -51,6 +62,7 @@ extern "C" {
 typedef int (*dfu_image_open_t)(int image_id, size_t image_size);
 typedef int (*dfu_image_write_t)(const uint8_t *chunk, size_t chunk_size);
 typedef int (*dfu_image_close_t)(bool success);
+typedef int (*dfu_image_offset_t)(size_t *offset);
 
 /**
  * @brief User-provided functions for writing a single image from DFU Multi Image package.
@@ -93,6 +105,19 @@ struct dfu_image_writer {
 	 * @return 0        On success.
 	 */
 	dfu_image_close_t close;
+
+	/**
+	 * @brief Optional function called to get the number of bytes of the applicable
+	 *        image that have already been stored.
+	 *
+	 * The function is only called when resuming an interrupted package, right after
+	 * @c open, and only if @c CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS is enabled. If not
+	 * provided, an interrupted image is written again from the beginning.
+	 *
+	 * @return negative On failure.
+	 * @return 0        On success.
+	 */
+	dfu_image_offset_t offset;
 };
 
 /**
@@ -178,6 +203,18 @@ size_t dfu_multi_image_offset(void);
  */
 int dfu_multi_image_done(bool success);
 
+/**
+ * @brief Discard the stored DFU Multi Image package write progress.
+ *
+ * Makes the next package be written from the beginning, even if it is the package whose
+ * write has been interrupted. The function has no effect unless
+ * @c CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS is enabled.
+ *
+ * @return negative On failure.
+ * @return 0        On success.
+ */
+int dfu_multi_image_reset_progress(void);
+
 #ifdef __cplusplus
 }
 #endif
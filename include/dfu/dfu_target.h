@@ -24,7 +24,8 @@ enum dfu_target_image_type {
 	DFU_TARGET_IMAGE_TYPE_ANY = 0,
 	DFU_TARGET_IMAGE_TYPE_MCUBOOT = 1,
 	DFU_TARGET_IMAGE_TYPE_MODEM_DELTA,
-	DFU_TARGET_IMAGE_TYPE_FULL_MODEM
+	DFU_TARGET_IMAGE_TYPE_FULL_MODEM,
+	DFU_TARGET_IMAGE_TYPE_APP_DELTA
 };
 
 enum dfu_target_evt_id {
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file dfu_target_app_delta.h
+ *
+ * @defgroup dfu_target_app_delta Application delta DFU Target
+ * @{
+ * @brief DFU Target for application delta upgrades performed by MCUBoot
+ *
+ * The target applies a patch, created with
+ * 'scripts/bootloader/app_delta_tool.py', to the image in the MCUBoot primary
+ * slot and streams the resulting image into the MCUBoot secondary slot.
+ */
+
+#ifndef DFU_TARGET_APP_DELTA_H__
+#define DFU_TARGET_APP_DELTA_H__
+
+#include <stddef.h>
+#include <dfu/dfu_target.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief See if data in buf indicates application delta upgrade.
+ *
+ * @retval true if data matches, false otherwise.
+ */
+bool dfu_target_app_delta_identify(const void *const buf);
+
+/**
+ * @brief Initialize dfu target, perform steps necessary to receive firmware.
+ *
+ * The buffer set with @ref dfu_target_mcuboot_set_buf is used to write the
+ * resulting image.
+ *
+ * @param[in] file_size Size of the patch being downloaded.
+ * @param[in] img_num Image pair index. Only 0 is supported.
+ * @param[in] cb Callback for signaling events(unused).
+ *
+ * @retval 0 If successful, negative errno otherwise.
+ */
+int dfu_target_app_delta_init(size_t file_size, int img_num, dfu_target_callback_t cb);
+
+/**
+ * @brief Get offset of firmware
+ *
+ * The progress of patch application is kept in RAM only, so the offset is
+ * reset after the device reboots or the target is deinitialized.
+ *
+ * @param[out] offset Returns the number of patch bytes processed.
+ *
+ * @return 0 if success, otherwise negative value if unable to get the offset
+ */
+int dfu_target_app_delta_offset_get(size_t *offset);
+
+/**
+ * @brief Write patch data.
+ *
+ * @param[in] buf Pointer to data that should be written.
+ * @param[in] len Length of data to write.
+ *
+ * @retval -ENOENT If the patch does not apply to the image in the primary slot.
+ * @retval -EBADMSG If the patch is malformed.
+ * @return 0 on success, negative errno otherwise.
+ */
+int dfu_target_app_delta_write(const void *const buf, size_t len);
+
+/**
+ * @brief Deinitialize resources and finalize firmware upgrade if successful.
+ *
+ * @param[in] successful Indicate whether the patch was successfully received.
+ *
+ * @retval -EBADMSG If the patch is incomplete or the resulting image is
+ *		    corrupted.
+ * @return 0 on success, negative errno otherwise.
+ */
+int dfu_target_app_delta_done(bool successful);
+
+/**
+ * @brief Schedule update of the image.
+ *
+ * This call requests image update. The update will be performed after
+ * the device reset.
+ *
+ * @param[in] img_num This parameter is unused by this target type.
+ *
+ * @return 0 for a successful request or a negative error
+ *	   code identicating reason of failure.
+ **/
+int dfu_target_app_delta_schedule_update(int img_num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DFU_TARGET_APP_DELTA_H__ */
+
+/**@} */
@@ -166,6 +166,9 @@ int emds_prepare(void);
  * registered in the entries. This value is dependent on the chip used, and
  * should be checked against the chip datasheet.
  *
+ * The estimate is the worst case for the number of flash writes the entries
+ * are gathered into, see @kconfig{CONFIG_EMDS_STORE_BUF_SIZE}.
+ *
  * @return Time needed to store all data (in microseconds).
  */
 uint32_t emds_store_time_get(void);
@@ -95,7 +95,8 @@ struct nrf_cloud_rest_context {
 	/** Fragment size for downloads, set to zero to use
 	 * CONFIG_NRF_CLOUD_REST_FRAGMENT_SIZE.
 	 * The rx_buf must be able to hold the HTTPS headers
-	 * plus this fragment size.
+	 * plus this fragment size, except for A-GPS downloads into
+	 * a result buffer, which are streamed into that buffer.
 	 */
 	size_t fragment_size;
 
@@ -193,7 +194,9 @@ int nrf_cloud_rest_cell_pos_get(struct nrf_cloud_rest_context *const rest_ctx,
  * @param[in,out] result Optional; Additional buffer for A-GPS data. This is
  *                       necessary when the A-GPS data from the cloud is larger
  *                       than the fragment size specified by
- *                       rest_ctx->fragment_size.
+ *                       rest_ctx->fragment_size. If provided, the data is
+ *                       streamed into it as it is received, so that
+ *                       rest_ctx->rx_buf only needs to hold the HTTPS headers.
  *
  * @retval 0 If successful.
  *           If result is NULL and the A-GPS data is larger than the fragment
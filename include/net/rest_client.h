@@ -39,6 +39,42 @@ enum rest_client_http_status {
 	REST_CLIENT_HTTP_STATUS_NOT_FOUND = 404,
 };
 
+/** @brief Fragment of a response body, see @ref rest_client_body_cb_t. */
+struct rest_client_body_frag {
+	/** Body data. Only valid for the duration of the callback. */
+	const char *data;
+
+	/** Length of data. */
+	size_t len;
+
+	/** Offset of data from the start of the body. */
+	size_t offset;
+
+	/** Numeric HTTP status code of the response. */
+	uint16_t http_status_code;
+
+	/** Complete length of the resource from the Content-Range header of the
+	 *  response. 0 if the response has no Content-Range header, or if the
+	 *  complete length is unknown.
+	 */
+	size_t range_total;
+};
+
+/**
+ * @brief Callback for receiving the response body in fragments.
+ *
+ * @details Called from the context of @ref rest_client_request with the body data
+ *          of each filled receive buffer. A receive buffer holding parts of
+ *          several chunks of a chunked body gives a fragment per chunk.
+ *
+ * @param[in] frag Body fragment.
+ * @param[in] user_data User data given in the request context.
+ *
+ * @return 0 to continue. A negative error code to discard the rest of the body,
+ *         which is then returned by @ref rest_client_request.
+ */
+typedef int (*rest_client_body_cb_t)(const struct rest_client_body_frag *frag, void *user_data);
+
 /**
  * @brief REST client request context.
  *
@@ -96,6 +132,16 @@ struct rest_client_req_context {
 
 	/** User-defined size of resp_buff. */
 	size_t resp_buff_len;
+
+	/** Optional callback for streaming the response body. When set, the body is passed
+	 *  to the callback as it is received instead of being stored in resp_buff, so that
+	 *  resp_buff only needs to hold the response headers. Bodies sent with chunked
+	 *  transfer encoding are passed on without the chunk framing. Default: NULL.
+	 */
+	rest_client_body_cb_t body_cb;
+
+	/** User data passed to body_cb. */
+	void *body_cb_user_data;
 };
 
 /**
@@ -111,7 +157,9 @@ struct rest_client_resp_context {
 	/** Length of response body/content data. */
 	size_t response_len;
 
-	/** Start of response data (the body/content) in resp_buff.*/
+	/** Start of response data (the body/content) in resp_buff.
+	 *  NULL if the body was passed to the body callback of the request.
+	 */
 	char *response;
 
 	/** Numeric HTTP status code. */
@@ -132,6 +180,30 @@ struct rest_client_resp_context {
 	int used_socket_is_alive;
 };
 
+/** @brief Connection pool statistics. */
+struct rest_client_pool_stats {
+	/** Number of connections opened. */
+	uint32_t connections;
+
+	/** Number of TLS handshakes done when opening connections. */
+	uint32_t handshakes;
+
+	/** Number of requests that reused a pooled connection. */
+	uint32_t reused;
+
+	/** Number of TLS handshakes saved by reusing pooled connections. */
+	uint32_t handshakes_saved;
+
+	/** Number of pooled connections found closed by the server when reused. */
+	uint32_t stale;
+
+	/** Number of idle connections closed to make room in the pool. */
+	uint32_t evicted;
+
+	/** Number of idle connections closed after CONFIG_REST_CLIENT_CONN_POOL_IDLE_TIMEOUT. */
+	uint32_t expired;
+};
+
 /**
  * @brief REST client request.
  *
@@ -157,6 +229,23 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
  */
 void rest_client_request_defaults_set(struct rest_client_req_context *req_ctx);
 
+/**
+ * @brief Close all idle pooled connections.
+ *
+ * @details Intended to be used before the network goes down, for example before
+ *          the modem is put offline. Available if CONFIG_REST_CLIENT_CONN_POOL is enabled.
+ */
+void rest_client_pool_flush(void);
+
+/**
+ * @brief Get connection pool statistics.
+ *
+ * @details Available if CONFIG_REST_CLIENT_CONN_POOL is enabled.
+ *
+ * @param[out] stats Statistics collected since boot.
+ */
+void rest_client_pool_stats_get(struct rest_client_pool_stats *stats);
+
 /** @} */
 
 #endif /* REST_CLIENT_H__ */
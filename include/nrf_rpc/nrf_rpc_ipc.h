@@ -11,6 +11,7 @@
 #include <zephyr/ipc/ipc_service.h>
 
 #include <nrf_rpc.h>
+#include <nrf_rpc_os.h>
 #include <nrf_rpc_tr.h>
 
 #include <stdbool.h>
@@ -56,6 +57,17 @@ struct nrf_rpc_ipc {
 	/** User context. */
 	void *context;
 
+	/** Buffer of the packet being received, while the receive callback runs. */
+	const void *rx_data;
+
+	/** Length of the packet being received. */
+	size_t rx_len;
+
+	/** Priority class of the commands received on the endpoint,
+	 *  see @ref nrf_rpc_os_prio.
+	 */
+	uint8_t prio;
+
 	/** Indicates if transport is already initialized. */
 	bool used;
 };
@@ -111,9 +123,44 @@ struct nrf_rpc_ipc {
  *                      corresponding remote CPU.
  */
 #define NRF_RPC_IPC_TRANSPORT(_name, _ipc, _ept_name)                        \
+	NRF_RPC_IPC_TRANSPORT_PRIO(_name, _ipc, _ept_name, NRF_RPC_OS_PRIO_DEFAULT)
+
+/** @brief Defines the nRF IPC Transport instance with a command priority class.
+ *
+ * Same as @ref NRF_RPC_IPC_TRANSPORT, but the commands received on the endpoint
+ * are served by the threads of the given priority class, with a queue of their
+ * own.
+ *
+ * All the endpoints of an IPC instance are received in the same context. When
+ * the queue of a class is full, this context waits for room in the queue, and
+ * the other endpoints of the instance are not received in the meantime. To
+ * isolate the latency of the nRF RPC groups using this transport from bursts of
+ * commands to the groups using other transports, use an IPC instance that is
+ * not shared with them.
+ *
+ * Example:
+ *
+ *  * Latency sensitive group with an IPC instance of its own, served by the
+ *    @kconfig{CONFIG_NRF_RPC_THREAD_POOL_HIGH_PRIO_SIZE} high priority threads:
+ *
+ *      NRF_RPC_IPC_TRANSPORT(nrf_rpc_bulk, DEVICE_DT_GET(DT_NODELABEL(ipc0)), "bulk_ept");
+ *      NRF_RPC_IPC_TRANSPORT_PRIO(nrf_rpc_ctrl, DEVICE_DT_GET(DT_NODELABEL(ipc1)),
+ *                                 "ctrl_ept", NRF_RPC_OS_PRIO_HIGH);
+ *
+ *      NRF_RPC_GROUP_DEFINE(bulk_group, "Bulk", &nrf_rpc_bulk, NULL, NULL, NULL);
+ *      NRF_RPC_GROUP_DEFINE(ctrl_group, "Control", &nrf_rpc_ctrl, NULL, NULL, NULL);
+ *
+ * @param[in] _name nRF RPC IPC Service transport instance name.
+ * @param[in] _ipc The instance used for the IPC Service to transfer data between CPUs.
+ * @param[in] _ept_name IPC Service endpoint name. The endpoint must have the same name on the
+ *                      corresponding remote CPU.
+ * @param[in] _prio Priority class of the received commands, see @ref nrf_rpc_os_prio.
+ */
+#define NRF_RPC_IPC_TRANSPORT_PRIO(_name, _ipc, _ept_name, _prio)            \
 	static struct nrf_rpc_ipc _name##_instance = {                       \
 	       .ipc = _ipc,                                                  \
 	       .endpoint.ept_cfg.name = _ept_name,                           \
+	       .prio = _prio,                                                \
 	};                                                                   \
 									     \
 	const struct nrf_rpc_tr _name = {                                    \
@@ -121,6 +168,45 @@ struct nrf_rpc_ipc {
 		.ctx = &_name##_instance                                     \
 	}
 
+/** @brief Hold the buffer of the packet being decoded.
+ *
+ * By default, the IPC Service buffer of a received packet is released when
+ * its decoding is done, so any data that must outlive the decoding has to be
+ * copied. A decoder can instead hold the buffer, keep using the data in place
+ * in the shared memory, and release the buffer with @ref nrf_rpc_ipc_rx_release
+ * when done.
+ *
+ * Must be called by the decoder of a command or an event received on the
+ * transport, before it reports that the decoding is done. The number of
+ * buffers held at the same time is limited by the IPC Service backend, and
+ * holding them for long may block the remote from sending.
+ *
+ * @param[in] transport nRF RPC IPC Service transport of the group of the decoder.
+ * @param[in] packet Data of the packet given to the decoder, for example the
+ *                   pointer of a decoded byte string.
+ * @param[out] buf Start of the held buffer, to be passed to @ref nrf_rpc_ipc_rx_release.
+ *
+ * @retval 0 The buffer is held.
+ * @retval -ENOENT No packet is being received on the transport.
+ * @retval -EINVAL @p packet is not within the packet being received on the
+ *                 transport.
+ * @retval -ENOTSUP The IPC Service backend cannot hold buffers, the data
+ *                  must be copied instead.
+ * @retval -ERRNO Other IPC Service error.
+ */
+int nrf_rpc_ipc_rx_hold(const struct nrf_rpc_tr *transport, const void *packet,
+			const void **buf);
+
+/** @brief Release a buffer held with @ref nrf_rpc_ipc_rx_hold.
+ *
+ * @param[in] transport nRF RPC IPC Service transport the buffer was held on.
+ * @param[in] data Held buffer.
+ *
+ * @retval 0 The buffer is released.
+ * @retval -ERRNO IPC Service error.
+ */
+int nrf_rpc_ipc_rx_release(const struct nrf_rpc_tr *transport, const void *data);
+
 /**
  * @}
  */
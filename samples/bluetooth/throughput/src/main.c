@@ -18,6 +18,7 @@
 #include <zephyr/bluetooth/hci.h>
 #include <zephyr/bluetooth/uuid.h>
 #include <bluetooth/services/throughput.h>
+#include <bluetooth/services/throughput_bench.h>
 #include <bluetooth/scan.h>
 #include <bluetooth/gatt_dm.h>
 
@@ -141,6 +142,14 @@ static void discovery_complete(struct bt_gatt_dm *dm,
 	bt_throughput_handles_assign(dm, throughput);
 	bt_gatt_dm_data_release(dm);
 
+#if CONFIG_BT_THROUGHPUT_BENCH
+	err = bt_throughput_bench_init(throughput);
+	if (err) {
+		printk("Throughput benchmark initialization failed (err %d)\n",
+		       err);
+	}
+#endif /* CONFIG_BT_THROUGHPUT_BENCH */
+
 	exchange_params.func = exchange_func;
 
 	err = bt_gatt_exchange_mtu(default_conn, &exchange_params);
@@ -0,0 +1,364 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2022 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+"""
+Utility for creating and applying application delta patches.
+
+An application delta patch describes how to produce a new application image
+(the target) from the image currently stored in the MCUboot primary slot
+(the source). The patch is applied on the device by the application delta
+DFU target, which streams the resulting image into the MCUboot secondary slot.
+
+The patch uses a bsdiff-style encoding. It consists of a fixed header
+followed by a sequence of records, each made of three parts:
+
+    diff:  bytes that are added to the bytes of the source (modulo 256),
+    extra: bytes that are copied to the target as is,
+    seek:  a signed value by which the source position is moved.
+
+The header has the following little-endian layout:
+
+    uint32 magic, uint16 version, uint16 flags,
+    uint32 source size, uint32 source CRC-32,
+    uint32 target size, uint32 target CRC-32
+
+Each record starts with the diff length, extra length and seek value, encoded
+as LEB128 variable-length integers (the seek value is zigzag-encoded). As diff
+bytes are mostly zero when code has only moved, they are run-length encoded:
+a token byte below 0x80 is followed by (token + 1) literal bytes, while a token
+byte of 0x80 or more stands for (token - 0x80 + 1) zero bytes.
+
+Usage examples:
+
+Creating a patch:
+./app_delta_tool.py create old_app_update.bin app_update.bin app_delta.bin
+
+Applying a patch on the host:
+./app_delta_tool.py apply old_app_update.bin app_delta.bin app_update.bin
+
+Reporting patch size and creation time:
+./app_delta_tool.py stats old_app_update.bin app_update.bin
+"""
+
+import argparse
+import struct
+import sys
+import time
+import zlib
+
+
+MAGIC = 0x0d3a11fa
+VERSION = 1
+HEADER_FORMAT = '<IHHIIII'
+
+# Length of the blocks used to find matches between the source and target
+BLOCK_SIZE = 8
+# Maximum number of source positions remembered per block value
+MAX_CANDIDATES = 16
+# Matches shorter than this are cheaper to store as extra data
+MIN_MATCH = 12
+# Number of bytes without improvement after which match extension stops
+EXTEND_LOOKAHEAD = 64
+
+RLE_MAX_RUN = 128
+
+
+def encode_varint(value: int) -> bytes:
+    out = bytearray()
+
+    while True:
+        byte = value & 0x7f
+        value >>= 7
+
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def decode_varint(data: bytes, pos: int) -> tuple:
+    value = 0
+    shift = 0
+
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+
+        if not byte & 0x80:
+            return value, pos
+
+
+def zigzag_encode(value: int) -> int:
+    return (value << 1) if value >= 0 else ((-value << 1) - 1)
+
+
+def zigzag_decode(value: int) -> int:
+    return (value >> 1) if not value & 1 else -((value + 1) >> 1)
+
+
+def rle_encode(diff: bytes) -> bytes:
+    out = bytearray()
+    i = 0
+
+    while i < len(diff):
+        if diff[i] == 0:
+            run = 1
+            while run < RLE_MAX_RUN and i + run < len(diff) and diff[i + run] == 0:
+                run += 1
+            out.append(0x80 | (run - 1))
+            i += run
+            continue
+
+        start = i
+        while i < len(diff) and i - start < RLE_MAX_RUN:
+            # Break the literal run only where a zero run pays off
+            if diff[i] == 0 and i + 1 < len(diff) and diff[i + 1] == 0:
+                break
+            i += 1
+        out.append(i - start - 1)
+        out += diff[start:i]
+
+    return bytes(out)
+
+
+def build_index(source: bytes) -> dict:
+    index = {}
+
+    for pos in range(len(source) - BLOCK_SIZE + 1):
+        positions = index.setdefault(source[pos:pos + BLOCK_SIZE], [])
+
+        if len(positions) < MAX_CANDIDATES:
+            positions.append(pos)
+
+    return index
+
+
+def exact_match_length(source: bytes, spos: int, target: bytes, tpos: int) -> int:
+    length = 0
+    limit = min(len(source) - spos, len(target) - tpos)
+
+    # Compare in blocks first, then narrow down on the mismatching block
+    while length + 64 <= limit and \
+            source[spos + length:spos + length + 64] == target[tpos + length:tpos + length + 64]:
+        length += 64
+
+    while length < limit and source[spos + length] == target[tpos + length]:
+        length += 1
+
+    return length
+
+
+def extend_match(source: bytes, spos: int, target: bytes, tpos: int) -> int:
+    """
+    Extend a match forward as long as at least half of the bytes match, the same way
+    bsdiff does, so that code that has only moved or had its addresses changed ends up
+    in one diff segment.
+    """
+    limit = min(len(source) - spos, len(target) - tpos)
+    score = 0
+    best_score = 0
+    best_length = 0
+    i = 0
+
+    while i < limit and i - best_length <= EXTEND_LOOKAHEAD:
+        if source[spos + i] == target[tpos + i]:
+            score += 1
+        i += 1
+
+        if score * 2 - i > best_score * 2 - best_length:
+            best_score = score
+            best_length = i
+
+    return best_length
+
+
+def find_matches(source: bytes, target: bytes) -> list:
+    """
+    Find approximate matches between the source and target. Returns a list of
+    (source position, target position, length) tuples, ordered by target position.
+    """
+    index = build_index(source)
+    matches = []
+    tpos = 0
+    expected_spos = 0
+
+    while tpos + BLOCK_SIZE <= len(target):
+        candidates = [expected_spos] if expected_spos < len(source) else []
+        candidates += index.get(target[tpos:tpos + BLOCK_SIZE], [])
+
+        best_spos = None
+        best_length = 0
+
+        for spos in candidates:
+            length = exact_match_length(source, spos, target, tpos)
+
+            if length > best_length:
+                best_spos = spos
+                best_length = length
+
+        if best_length < MIN_MATCH:
+            tpos += 1
+            expected_spos += 1
+            continue
+
+        length = extend_match(source, best_spos, target, tpos)
+        matches.append((best_spos, tpos, length))
+        tpos += length
+        expected_spos = best_spos + length
+
+    return matches
+
+
+def create_patch(source: bytes, target: bytes) -> bytes:
+    patch = bytearray(struct.pack(HEADER_FORMAT, MAGIC, VERSION, 0,
+                                  len(source), zlib.crc32(source),
+                                  len(target), zlib.crc32(target)))
+    matches = find_matches(source, target)
+
+    # Bytes preceding the first match are emitted by a record with no diff part
+    if not matches or matches[0][1] != 0:
+        first_spos = matches[0][0] if matches else 0
+        extra_end = matches[0][1] if matches else len(target)
+        patch += encode_varint(0) + encode_varint(extra_end)
+        patch += encode_varint(zigzag_encode(first_spos))
+        patch += target[:extra_end]
+
+    for i, (spos, tpos, length) in enumerate(matches):
+        if i + 1 < len(matches):
+            next_spos, extra_end, _ = matches[i + 1]
+        else:
+            next_spos, extra_end = spos + length, len(target)
+
+        diff = bytes((target[tpos + j] - source[spos + j]) & 0xff for j in range(length))
+
+        patch += encode_varint(length) + encode_varint(extra_end - tpos - length)
+        patch += encode_varint(zigzag_encode(next_spos - spos - length))
+        patch += rle_encode(diff)
+        patch += target[tpos + length:extra_end]
+
+    return bytes(patch)
+
+
+def apply_patch(source: bytes, patch: bytes) -> bytes:
+    header_size = struct.calcsize(HEADER_FORMAT)
+    magic, version, _, source_size, source_crc, target_size, target_crc = \
+        struct.unpack(HEADER_FORMAT, patch[:header_size])
+
+    if magic != MAGIC or version != VERSION:
+        raise ValueError('Not an application delta patch')
+
+    if source_size > len(source) or zlib.crc32(source[:source_size]) != source_crc:
+        raise ValueError('Patch does not apply to the given source')
+
+    target = bytearray()
+    pos = header_size
+    spos = 0
+
+    while len(target) < target_size:
+        diff_len, pos = decode_varint(patch, pos)
+        extra_len, pos = decode_varint(patch, pos)
+        seek, pos = decode_varint(patch, pos)
+
+        end = len(target) + diff_len
+        while len(target) < end:
+            token = patch[pos]
+            pos += 1
+            run = (token & 0x7f) + 1
+
+            if token & 0x80:
+                target += source[spos:spos + run]
+            else:
+                target += bytes((source[spos + j] + patch[pos + j]) & 0xff for j in range(run))
+                pos += run
+            spos += run
+
+        target += patch[pos:pos + extra_len]
+        pos += extra_len
+        spos += zigzag_decode(seek)
+
+    if len(target) != target_size or zlib.crc32(target) != target_crc:
+        raise ValueError('Patched image is corrupted')
+
+    return bytes(target)
+
+
+def create_command(args: object) -> None:
+    source = args.source.read()
+    target = args.target.read()
+    patch = create_patch(source, target)
+
+    if apply_patch(source, patch) != target:
+        raise RuntimeError('Created patch does not reproduce the target')
+
+    args.patch.write(patch)
+
+
+def apply_command(args: object) -> None:
+    args.target.write(apply_patch(args.source.read(), args.patch.read()))
+
+
+def stats_command(args: object) -> None:
+    source = args.source.read()
+    target = args.target.read()
+
+    start = time.perf_counter()
+    patch = create_patch(source, target)
+    create_time = time.perf_counter() - start
+
+    start = time.perf_counter()
+    apply_patch(source, patch)
+    apply_time = time.perf_counter() - start
+
+    print(f'Target size:      {len(target)} bytes')
+    print(f'Patch size:       {len(patch)} bytes '
+          f'({100 * len(patch) / max(len(target), 1):.1f}% of target)')
+    print(f'Compressed size:  {len(zlib.compress(target, 9))} bytes '
+          f'(full image, zlib level 9, for reference)')
+    print(f'Create time:      {create_time:.2f} s')
+    print(f'Host apply time:  {apply_time:.2f} s')
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Application delta patch tool',
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        allow_abbrev=False)
+
+    subcommands = parser.add_subparsers(dest='subcommand', required=True)
+
+    create_parser = subcommands.add_parser('create', help='Create patch')
+    create_parser.add_argument('source', type=argparse.FileType('rb'),
+                               help='Image currently in the primary slot')
+    create_parser.add_argument('target', type=argparse.FileType('rb'), help='New image')
+    create_parser.add_argument('patch', type=argparse.FileType('wb'), help='Output patch')
+    create_parser.set_defaults(func=create_command)
+
+    apply_parser = subcommands.add_parser('apply', help='Apply patch')
+    apply_parser.add_argument('source', type=argparse.FileType('rb'),
+                              help='Image currently in the primary slot')
+    apply_parser.add_argument('patch', type=argparse.FileType('rb'), help='Patch')
+    apply_parser.add_argument('target', type=argparse.FileType('wb'), help='Output image')
+    apply_parser.set_defaults(func=apply_command)
+
+    stats_parser = subcommands.add_parser('stats', help='Report patch size and timing')
+    stats_parser.add_argument('source', type=argparse.FileType('rb'),
+                              help='Image currently in the primary slot')
+    stats_parser.add_argument('target', type=argparse.FileType('rb'), help='New image')
+    stats_parser.set_defaults(func=stats_command)
+
+    args = parser.parse_args()
+
+    try:
+        args.func(args)
+    except (ValueError, RuntimeError) as err:
+        sys.exit(f'Error: {err}')
+
+
+if __name__ == '__main__':
+    main()
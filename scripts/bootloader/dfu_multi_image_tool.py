@@ -17,20 +17,28 @@ The CBOR header currently complies with the following format:
         {"id": 0, "size": 102400},
         {"id": 1, "size": 204800}
         ...
-    ]
+    ],
+    "digest": h'...'
 }
 
+The optional "digest" entry is the SHA-256 digest of the package content, that is,
+of all images. It binds the write progress stored by a device to the package content.
+
 Usage examples:
 
 Creating DFU Multi Image package:
 ./dfu_multi_image_tool.py create --image 0 app_update.bin --image 1 net_core_app_update.bin dfu_multi_image.bin
 
+Creating DFU Multi Image package with the digest of its content:
+./dfu_multi_image_tool.py create --digest --image 0 app_update.bin dfu_multi_image.bin
+
 Showing DFU Multi Image package header:
 ./dfu_multi_image_tool.py show dfu_multi_image.bin
 """
 
 import argparse
 import cbor2
+import hashlib
 import struct
 import os
 
@@ -39,13 +47,35 @@ import os
 READ_BUFFER_SIZE = 16 * 1024
 
 
-def generate_header(image: list) -> bytes:
+def generate_digest(image: list) -> bytes:
+    """
+    Generate SHA-256 digest of DFU Multi Image package content
+    """
+
+    digest = hashlib.sha256()
+
+    for _, path in image:
+        with open(path, 'rb') as file:
+            while True:
+                chunk = file.read(READ_BUFFER_SIZE)
+                if not chunk:
+                    break
+                digest.update(chunk)
+
+    return digest.digest()
+
+
+def generate_header(image: list, digest: bool) -> bytes:
     """
     Generate DFU Multi Image package header
     """
 
     image_data = [{'id': int(id), 'size': os.path.getsize(path)} for id, path in image]
     header_data = {'img': image_data}
+
+    if digest:
+        header_data['digest'] = generate_digest(image)
+
     header_cbor = cbor2.dumps(header_data)
 
     return struct.pack('<H', len(header_cbor)) + header_cbor
@@ -63,13 +93,13 @@ def parse_header(file: object) -> object:
     return cbor2.loads(header_cbor)
 
 
-def generate_image(images: list, output_file: str) -> None:
+def generate_image(images: list, digest: bool, output_file: str) -> None:
     """
     Generate DFU Multi Image package
     """
 
     with open(output_file, 'wb') as out_file:
-        out_file.write(generate_header(images))
+        out_file.write(generate_header(images, digest))
 
         for _, path in images:
             with open(path, 'rb') as file:
@@ -93,6 +123,9 @@ def show_header(input_file: str) -> None:
             print(f'- Id: {image["id"]}')
             print(f'  Size: {image["size"]}')
 
+        if 'digest' in header:
+            print(f'Digest: {header["digest"].hex()}')
+
 
 def main():
     parser = argparse.ArgumentParser(description='DFU Multi Image tool', fromfile_prefix_chars='@')
@@ -104,6 +137,9 @@ def main():
         '-i', '--image',
         required=True, action='append', nargs=2, metavar=('id', 'path'),
         help='Image to be included in package')
+    create_parser.add_argument(
+        '--digest', action='store_true',
+        help='Include SHA-256 digest of package content in header')
     create_parser.add_argument(
         'output_file', help='Path to output package file')
 
@@ -115,7 +151,7 @@ def main():
     args = parser.parse_args()
 
     if args.subcommand == 'create':
-        generate_image(args.image, args.output_file)
+        generate_image(args.image, args.digest, args.output_file)
     elif args.subcommand == 'show':
         show_header(args.input_file)
     else:
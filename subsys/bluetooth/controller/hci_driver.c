@@ -17,6 +17,7 @@
 #include <zephyr/sys/byteorder.h>
 #include <zephyr/sys/util.h>
 #include <stdbool.h>
+#include <string.h>
 #include <zephyr/sys/__assert.h>
 
 #include <sdc.h>
@@ -25,6 +26,8 @@
 #include <sdc_hci_vs.h>
 #include <mpsl/mpsl_work.h>
 
+#include <bluetooth/hci_driver_rx_stats.h>
+
 #include "multithreading_lock.h"
 #include "hci_internal.h"
 #include "ecdh.h"
@@ -155,6 +158,16 @@ void sdc_assertion_handler(const char *const file, const uint32_t line)
 }
 #endif /* IS_ENABLED(CONFIG_BT_CTLR_ASSERT_HANDLER) */
 
+#define RX_BATCH_TIME_CYC k_us_to_cyc_ceil32(CONFIG_BT_CTLR_SDC_RX_BATCH_TIME_US)
+
+#if defined(CONFIG_BT_CTLR_SDC_RX_STATS)
+static struct k_spinlock rx_stats_lock;
+static struct hci_driver_rx_stats rx_stats;
+
+/* ACL packets copied directly into host buffers in the current invocation. */
+static uint32_t rx_acl_direct;
+#endif
+
 static struct k_work receive_work;
 static inline void receive_signal_raise(void)
 {
@@ -236,18 +249,15 @@ static int hci_driver_send(struct net_buf *buf)
 	return err;
 }
 
-static void data_packet_process(uint8_t *hci_buf)
+/* Pass an ACL packet to the host. The packet is already in the tailroom of
+ * the buffer.
+ */
+static void data_packet_recv(struct net_buf *data_buf)
 {
-	struct net_buf *data_buf = bt_buf_get_rx(BT_BUF_ACL_IN, K_FOREVER);
-	struct bt_hci_acl_hdr *hdr = (void *)hci_buf;
+	struct bt_hci_acl_hdr *hdr = (void *)data_buf->data;
 	uint16_t hf, handle, len;
 	uint8_t flags, pb, bc;
 
-	if (!data_buf) {
-		BT_ERR("No data buffer available");
-		return;
-	}
-
 	len = sys_le16_to_cpu(hdr->len);
 	hf = sys_le16_to_cpu(hdr->handle);
 	handle = bt_acl_handle(hf);
@@ -258,10 +268,28 @@ static void data_packet_process(uint8_t *hci_buf)
 	BT_DBG("Data: handle (0x%02x), PB(%01d), BC(%01d), len(%u)", handle,
 	       pb, bc, len);
 
-	net_buf_add_mem(data_buf, &hci_buf[0], len + sizeof(*hdr));
+	net_buf_add(data_buf, len + sizeof(*hdr));
 	bt_recv(data_buf);
 }
 
+static void data_packet_process(uint8_t *hci_buf)
+{
+	struct net_buf *data_buf = bt_buf_get_rx(BT_BUF_ACL_IN, K_FOREVER);
+	struct bt_hci_acl_hdr *hdr = (void *)hci_buf;
+	uint16_t len;
+
+	if (!data_buf) {
+		BT_ERR("No data buffer available");
+		return;
+	}
+
+	len = sys_le16_to_cpu(hdr->len) + sizeof(*hdr);
+	__ASSERT_NO_MSG(net_buf_tailroom(data_buf) >= len);
+
+	memcpy(data_buf->data, hci_buf, len);
+	data_packet_recv(data_buf);
+}
+
 static bool event_packet_is_discardable(const uint8_t *hci_buf)
 {
 	struct bt_hci_evt_hdr *hdr = (void *)hci_buf;
@@ -357,13 +385,51 @@ static bool fetch_and_process_hci_evt(uint8_t *p_hci_buffer)
 	return true;
 }
 
-static bool fetch_and_process_acl_data(uint8_t *p_hci_buffer)
+/* Get a buffer for the controller to copy the next ACL packet directly into.
+ * The buffer is kept until a packet is received in it, and released at the
+ * end of the receive processing otherwise.
+ *
+ * With Controller to Host flow control, releasing a buffer reports a
+ * completed packet to the controller, so a buffer is only taken once a
+ * packet is there to be copied.
+ */
+static struct net_buf *acl_buf_get(struct net_buf **p_data_buf)
+{
+	struct net_buf *data_buf = *p_data_buf;
+
+	if (IS_ENABLED(CONFIG_BT_HCI_ACL_FLOW_CONTROL)) {
+		return NULL;
+	}
+
+	if (data_buf) {
+		return data_buf;
+	}
+
+	data_buf = bt_buf_get_rx(BT_BUF_ACL_IN, K_NO_WAIT);
+	if (data_buf && net_buf_tailroom(data_buf) < BT_BUF_ACL_RX_SIZE) {
+		net_buf_unref(data_buf);
+		data_buf = NULL;
+	}
+
+	*p_data_buf = data_buf;
+
+	return data_buf;
+}
+
+static bool fetch_and_process_acl_data(uint8_t *p_hci_buffer, struct net_buf **p_data_buf)
 {
 	int errcode;
+	struct net_buf *data_buf;
+
+	/* Let the controller copy the packet directly into the buffer passed
+	 * to the host. If no buffer is available without waiting, the packet
+	 * is copied later, as the events are.
+	 */
+	data_buf = acl_buf_get(p_data_buf);
 
 	errcode = MULTITHREADING_LOCK_ACQUIRE();
 	if (!errcode) {
-		errcode = sdc_hci_data_get(p_hci_buffer);
+		errcode = sdc_hci_data_get(data_buf ? data_buf->data : p_hci_buffer);
 		MULTITHREADING_LOCK_RELEASE();
 	}
 
@@ -371,11 +437,19 @@ static bool fetch_and_process_acl_data(uint8_t *p_hci_buffer)
 		return false;
 	}
 
-	data_packet_process(p_hci_buffer);
+	if (data_buf) {
+#if defined(CONFIG_BT_CTLR_SDC_RX_STATS)
+		rx_acl_direct++;
+#endif
+		*p_data_buf = NULL;
+		data_packet_recv(data_buf);
+	} else {
+		data_packet_process(p_hci_buffer);
+	}
+
 	return true;
 }
 
-
 static bool fetch_and_process_hci_msg(uint8_t *p_hci_buffer)
 {
 	int errcode;
@@ -403,6 +477,39 @@ static bool fetch_and_process_hci_msg(uint8_t *p_hci_buffer)
 	return true;
 }
 
+#if defined(CONFIG_BT_CTLR_SDC_RX_STATS)
+static void rx_stats_update(uint32_t packets, uint32_t acl_direct, bool budget_exhausted)
+{
+	k_spinlock_key_t key = k_spin_lock(&rx_stats_lock);
+
+	rx_stats.wakeups++;
+	rx_stats.packets += packets;
+	rx_stats.packets_max = MAX(rx_stats.packets_max, packets);
+	rx_stats.acl_direct += acl_direct;
+	rx_stats.budget_exhausted += budget_exhausted;
+
+	k_spin_unlock(&rx_stats_lock, key);
+}
+
+void hci_driver_rx_stats_get(struct hci_driver_rx_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&rx_stats_lock);
+
+	*stats = rx_stats;
+
+	k_spin_unlock(&rx_stats_lock, key);
+}
+
+void hci_driver_rx_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&rx_stats_lock);
+
+	memset(&rx_stats, 0, sizeof(rx_stats));
+
+	k_spin_unlock(&rx_stats_lock, key);
+}
+#endif /* CONFIG_BT_CTLR_SDC_RX_STATS */
+
 void hci_driver_receive_process(void)
 {
 #if defined(CONFIG_BT_BUF_EVT_DISCARDABLE_COUNT)
@@ -412,19 +519,46 @@ void hci_driver_receive_process(void)
 	static uint8_t hci_buf[BT_BUF_RX_SIZE];
 #endif
 
-	bool received_evt = false;
-	bool received_data = false;
-	bool received_msg = false;
+	struct net_buf *acl_buf = NULL;
+	uint32_t start = k_cycle_get_32();
+	uint32_t packets = 0;
+	bool received;
+
+	/* Retrieve packets until the controller has none left, or the budget
+	 * of this invocation is used.
+	 */
+	do {
+		received = false;
+
+		if (fetch_and_process_hci_evt(&hci_buf[0])) {
+			received = true;
+			packets++;
+		}
+
+		if (IS_ENABLED(CONFIG_BT_CONN) &&
+		    fetch_and_process_acl_data(&hci_buf[0], &acl_buf)) {
+			received = true;
+			packets++;
+		}
 
-	received_evt = fetch_and_process_hci_evt(&hci_buf[0]);
+		if (fetch_and_process_hci_msg(&hci_buf[0])) {
+			received = true;
+			packets++;
+		}
+	} while (received && packets < CONFIG_BT_CTLR_SDC_RX_BATCH_SIZE &&
+		 (!CONFIG_BT_CTLR_SDC_RX_BATCH_TIME_US ||
+		  k_cycle_get_32() - start < RX_BATCH_TIME_CYC));
 
-	if (IS_ENABLED(CONFIG_BT_CONN)) {
-		received_data = fetch_and_process_acl_data(&hci_buf[0]);
+	if (acl_buf) {
+		net_buf_unref(acl_buf);
 	}
 
-	received_msg = fetch_and_process_hci_msg(&hci_buf[0]);
+#if defined(CONFIG_BT_CTLR_SDC_RX_STATS)
+	rx_stats_update(packets, rx_acl_direct, received);
+	rx_acl_direct = 0;
+#endif
 
-	if (received_evt || received_data || received_msg) {
+	if (received) {
 		/* Let other threads of same priority run in between. */
 		receive_signal_raise();
 	}
@@ -10,6 +10,15 @@
 
 #include <bluetooth/gatt_dm.h>
 
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+#include <stdio.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/net/buf.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/crc.h>
+#endif
+
 LOG_MODULE_REGISTER(bt_gatt_dm, CONFIG_BT_GATT_DM_LOG_LEVEL);
 
 /* Available sizes: 128, 512, 2048... */
@@ -22,6 +31,16 @@ LOG_MODULE_REGISTER(bt_gatt_dm, CONFIG_BT_GATT_DM_LOG_LEVEL);
 BUILD_ASSERT(sizeof(struct bt_gatt_service_val) % DATA_ALIGN == 0);
 BUILD_ASSERT(sizeof(struct bt_gatt_chrc) % DATA_ALIGN == 0);
 
+/* Length of the Database Hash characteristic value */
+#define DB_HASH_LEN 16
+
+/* State of the Database Hash of the peer */
+enum {
+	DB_HASH_UNKNOWN,
+	DB_HASH_KNOWN,
+	DB_HASH_UNSUPPORTED,
+};
+
 /* Flags for parsed attribute array state */
 enum {
 	STATE_ATTRS_LOCKED,
@@ -71,10 +90,100 @@ struct bt_gatt_dm {
 
 	/* Indicates that services should be searched by the UUID. */
 	bool search_svc_by_uuid;
+
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	/* Database Hash of the peer, if db_hash_state is DB_HASH_KNOWN */
+	uint8_t db_hash[DB_HASH_LEN];
+	/* One of the DB_HASH_* values */
+	uint8_t db_hash_state;
+	/* Store the result in the cache when the discovery completes */
+	bool cache_store;
+	/* Start handle of the discovery in progress, part of the cache key */
+	uint16_t cache_start_handle;
+	/* Looks up the cache, and discovers over the air on a miss */
+	struct k_work cache_work;
+	/* Parameters for reading the Database Hash */
+	struct bt_gatt_read_params read_params;
+#endif
 };
 
-/* Currently only one instance is supported */
-static struct bt_gatt_dm bt_gatt_dm_inst;
+/* One instance per connection with discovery in progress */
+static struct bt_gatt_dm bt_gatt_dm_inst[CONFIG_BT_GATT_DM_MAX_INSTANCES];
+/* Protects instance allocation */
+static struct k_spinlock bt_gatt_dm_lock;
+
+/* Allocates an instance for the connection. An idle instance stays bound to its
+ * connection until the connection is dropped, so that bt_gatt_dm_continue can be
+ * called after bt_gatt_dm_data_release. Such instances are only taken over by
+ * another connection if there is no other free instance.
+ */
+static struct bt_gatt_dm *dm_alloc(struct bt_conn *conn, int *err)
+{
+	struct bt_gatt_dm *unbound = NULL;
+	struct bt_gatt_dm *idle = NULL;
+	struct bt_gatt_dm *dm = NULL;
+	k_spinlock_key_t key = k_spin_lock(&bt_gatt_dm_lock);
+
+	for (size_t i = 0; i < ARRAY_SIZE(bt_gatt_dm_inst); i++) {
+		struct bt_gatt_dm *cur = &bt_gatt_dm_inst[i];
+
+		if (atomic_test_bit(cur->state_flags, STATE_ATTRS_LOCKED)) {
+			if (cur->conn == conn) {
+				/* Only one discovery at a time per connection */
+				k_spin_unlock(&bt_gatt_dm_lock, key);
+				*err = -EALREADY;
+				return NULL;
+			}
+		} else if (cur->conn == conn) {
+			dm = cur;
+		} else if (!cur->conn) {
+			unbound = unbound ? unbound : cur;
+		} else {
+			idle = idle ? idle : cur;
+		}
+	}
+
+	if (!dm) {
+		dm = unbound ? unbound : idle;
+	}
+
+	if (dm) {
+		atomic_set_bit(dm->state_flags, STATE_ATTRS_LOCKED);
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+		if (dm->conn != conn) {
+			dm->db_hash_state = DB_HASH_UNKNOWN;
+		}
+#endif
+		dm->conn = conn;
+		*err = 0;
+	} else {
+		*err = -ENOMEM;
+	}
+
+	k_spin_unlock(&bt_gatt_dm_lock, key);
+
+	return dm;
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason)
+{
+	k_spinlock_key_t key = k_spin_lock(&bt_gatt_dm_lock);
+
+	for (size_t i = 0; i < ARRAY_SIZE(bt_gatt_dm_inst); i++) {
+		struct bt_gatt_dm *cur = &bt_gatt_dm_inst[i];
+
+		if (cur->conn == conn &&
+		    !atomic_test_bit(cur->state_flags, STATE_ATTRS_LOCKED)) {
+			cur->conn = NULL;
+		}
+	}
+
+	k_spin_unlock(&bt_gatt_dm_lock, key);
+}
+
+BT_CONN_CB_DEFINE(gatt_dm_conn_callbacks) = {
+	.disconnected = disconnected,
+};
 
 /* Returns pointer to newly allocated space in a dm->data_chunk */
 static void *user_data_alloc(struct bt_gatt_dm *dm,
@@ -247,9 +356,645 @@ static struct bt_gatt_dm_attr *attr_find_by_handle(
 	return NULL;
 }
 
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+
+#define CACHE_VERSION 1
+#define CACHE_KEY_PREFIX "bt_dm"
+/* Prefix, peer address and type, and the discovery parameters */
+#define CACHE_KEY_LEN (sizeof(CACHE_KEY_PREFIX) + 15 + 12)
+/* Type and value of a UUID */
+#define CACHE_UUID_MAX_LEN (1 + 16)
+/* Handle, permissions and UUID of an attribute, followed by the end handle and
+ * UUID of a service, or by the value handle, properties and UUID of a characteristic.
+ */
+#define CACHE_ATTR_MAX_LEN (3 + CACHE_UUID_MAX_LEN + 3 + CACHE_UUID_MAX_LEN)
+/* Database Hash, version and number of attributes */
+#define CACHE_HDR_LEN (DB_HASH_LEN + 2)
+#define CACHE_BUF_LEN (CACHE_HDR_LEN + CONFIG_BT_GATT_DM_MAX_ATTRS * CACHE_ATTR_MAX_LEN)
+
+BUILD_ASSERT(CONFIG_BT_GATT_DM_MAX_ATTRS <= UINT8_MAX);
+
+union cache_uuid {
+	struct bt_uuid uuid;
+	struct bt_uuid_16 u16;
+	struct bt_uuid_32 u32;
+	struct bt_uuid_128 u128;
+};
+
+/* Serialized result waiting to be written to settings */
+struct cache_entry {
+	sys_snode_t node;
+	char key[CACHE_KEY_LEN];
+	size_t len;
+	uint8_t data[];
+};
+
+/* Serialization buffer, shared by all instances */
+NET_BUF_SIMPLE_DEFINE_STATIC(cache_buf, CACHE_BUF_LEN);
+static K_MUTEX_DEFINE(cache_buf_mutex);
+
+/* Results are written to settings from the system workqueue, as discoveries
+ * complete in the Bluetooth receive context.
+ */
+static sys_slist_t cache_store_list = SYS_SLIST_STATIC_INIT(&cache_store_list);
+static struct k_spinlock cache_store_lock;
+/* Orders the writes of queued results with the removal of entries */
+static K_MUTEX_DEFINE(cache_settings_mutex);
+
+static void cache_store_work_handler(struct k_work *work);
+static K_WORK_DEFINE(cache_store_work, cache_store_work_handler);
+
+static void discovery_complete(struct bt_gatt_dm *dm);
+static void discovery_complete_not_found(struct bt_gatt_dm *dm);
+static void discovery_complete_error(struct bt_gatt_dm *dm, int err);
+
+static void cache_addr_key(char *key, size_t key_len, const bt_addr_le_t *addr)
+{
+	const uint8_t *a = addr->a.val;
+
+	snprintf(key, key_len, CACHE_KEY_PREFIX "/%02x%02x%02x%02x%02x%02x%u",
+		 a[5], a[4], a[3], a[2], a[1], a[0], addr->type);
+}
+
+static void cache_uuid_add(struct net_buf_simple *buf, const struct bt_uuid *uuid)
+{
+	net_buf_simple_add_u8(buf, uuid->type);
+
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		net_buf_simple_add_le16(buf, BT_UUID_16(uuid)->val);
+		break;
+	case BT_UUID_TYPE_32:
+		net_buf_simple_add_le32(buf, BT_UUID_32(uuid)->val);
+		break;
+	default:
+		net_buf_simple_add_mem(buf, BT_UUID_128(uuid)->val, 16);
+		break;
+	}
+}
+
+/* Builds the key of the discovery in progress. Fails if the peer is not bonded. */
+static int cache_key(const struct bt_gatt_dm *dm, char *key, size_t key_len)
+{
+	struct bt_conn_info info;
+	uint32_t uuid_crc = 0;
+	size_t len;
+	int err;
+
+	err = bt_conn_get_info(dm->conn, &info);
+	if (err) {
+		return err;
+	}
+
+	if (info.type != BT_CONN_TYPE_LE || !bt_addr_le_is_bonded(info.id, info.le.dst)) {
+		return -ENOENT;
+	}
+
+	if (dm->search_svc_by_uuid) {
+		NET_BUF_SIMPLE_DEFINE(uuid_buf, CACHE_UUID_MAX_LEN);
+
+		cache_uuid_add(&uuid_buf, &dm->svc_uuid.uuid);
+		uuid_crc = crc32_ieee(uuid_buf.data, uuid_buf.len);
+	}
+
+	cache_addr_key(key, key_len, info.le.dst);
+	len = strlen(key);
+	snprintf(&key[len], key_len - len, "/%08" PRIx32 "%04x", uuid_crc, dm->cache_start_handle);
+
+	return 0;
+}
+
+static int cache_uuid_pull(struct net_buf_simple *buf, union cache_uuid *uuid)
+{
+	if (buf->len < 1) {
+		return -EBADMSG;
+	}
+
+	uuid->uuid.type = net_buf_simple_pull_u8(buf);
+
+	switch (uuid->uuid.type) {
+	case BT_UUID_TYPE_16:
+		if (buf->len < sizeof(uint16_t)) {
+			return -EBADMSG;
+		}
+		uuid->u16.val = net_buf_simple_pull_le16(buf);
+		return 0;
+	case BT_UUID_TYPE_32:
+		if (buf->len < sizeof(uint32_t)) {
+			return -EBADMSG;
+		}
+		uuid->u32.val = net_buf_simple_pull_le32(buf);
+		return 0;
+	case BT_UUID_TYPE_128:
+		if (buf->len < 16) {
+			return -EBADMSG;
+		}
+		memcpy(uuid->u128.val, net_buf_simple_pull_mem(buf, 16), 16);
+		return 0;
+	default:
+		return -EBADMSG;
+	}
+}
+
+static void cache_store_work_handler(struct k_work *work)
+{
+	struct cache_entry *entry;
+	sys_snode_t *node;
+	k_spinlock_key_t key;
+	int err;
+
+	k_mutex_lock(&cache_settings_mutex, K_FOREVER);
+
+	do {
+		key = k_spin_lock(&cache_store_lock);
+		node = sys_slist_get(&cache_store_list);
+		k_spin_unlock(&cache_store_lock, key);
+
+		if (!node) {
+			break;
+		}
+
+		entry = CONTAINER_OF(node, struct cache_entry, node);
+
+		err = settings_save_one(entry->key, entry->data, entry->len);
+		if (err) {
+			LOG_WRN("Failed to store discovery result (err %d)", err);
+		} else {
+			LOG_DBG("Stored %zu bytes under %s", entry->len, entry->key);
+		}
+
+		k_free(entry);
+	} while (true);
+
+	k_mutex_unlock(&cache_settings_mutex);
+}
+
+/* Drops the queued results of a peer. Call with cache_settings_mutex held. */
+static void cache_store_drop(const char *prefix)
+{
+	struct cache_entry *entry;
+	struct cache_entry *next;
+	sys_slist_t dropped;
+	k_spinlock_key_t key;
+
+	sys_slist_init(&dropped);
+
+	key = k_spin_lock(&cache_store_lock);
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&cache_store_list, entry, next, node) {
+		if (!strncmp(entry->key, prefix, strlen(prefix))) {
+			sys_slist_find_and_remove(&cache_store_list, &entry->node);
+			sys_slist_append(&dropped, &entry->node);
+		}
+	}
+
+	k_spin_unlock(&cache_store_lock, key);
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&dropped, entry, next, node) {
+		k_free(entry);
+	}
+}
+
+static void cache_store(struct bt_gatt_dm *dm, bool found)
+{
+	char key[CACHE_KEY_LEN];
+	struct cache_entry *entry;
+	k_spinlock_key_t lock_key;
+	int err;
+
+	if (!dm->cache_store) {
+		return;
+	}
+
+	dm->cache_store = false;
+
+	err = cache_key(dm, key, sizeof(key));
+	if (err) {
+		return;
+	}
+
+	k_mutex_lock(&cache_buf_mutex, K_FOREVER);
+
+	net_buf_simple_reset(&cache_buf);
+	net_buf_simple_add_mem(&cache_buf, dm->db_hash, DB_HASH_LEN);
+	net_buf_simple_add_u8(&cache_buf, CACHE_VERSION);
+	net_buf_simple_add_u8(&cache_buf, found ? dm->cur_attr_id : 0);
+
+	for (size_t i = 0; found && i < dm->cur_attr_id; i++) {
+		const struct bt_gatt_dm_attr *attr = &dm->attrs[i];
+		const struct bt_gatt_service_val *service_val;
+		const struct bt_gatt_chrc *chrc;
+
+		net_buf_simple_add_le16(&cache_buf, attr->handle);
+		net_buf_simple_add_u8(&cache_buf, attr->perm);
+		cache_uuid_add(&cache_buf, attr->uuid);
+
+		service_val = bt_gatt_dm_attr_service_val(attr);
+		if (service_val) {
+			net_buf_simple_add_le16(&cache_buf, service_val->end_handle);
+			cache_uuid_add(&cache_buf, service_val->uuid);
+			continue;
+		}
+
+		chrc = bt_gatt_dm_attr_chrc_val(attr);
+		if (chrc) {
+			net_buf_simple_add_le16(&cache_buf, chrc->value_handle);
+			net_buf_simple_add_u8(&cache_buf, chrc->properties);
+			cache_uuid_add(&cache_buf, chrc->uuid);
+		}
+	}
+
+	entry = k_malloc(sizeof(*entry) + cache_buf.len);
+	if (entry) {
+		strcpy(entry->key, key);
+		entry->len = cache_buf.len;
+		memcpy(entry->data, cache_buf.data, cache_buf.len);
+	}
+
+	k_mutex_unlock(&cache_buf_mutex);
+
+	if (!entry) {
+		LOG_WRN("No memory to store discovery result");
+		return;
+	}
+
+	lock_key = k_spin_lock(&cache_store_lock);
+	sys_slist_append(&cache_store_list, &entry->node);
+	k_spin_unlock(&cache_store_lock, lock_key);
+
+	k_work_submit(&cache_store_work);
+}
+
+/* Recreates the attributes in the same way as the discovery does. */
+static int cache_attr_restore(struct bt_gatt_dm *dm, struct net_buf_simple *buf)
+{
+	union cache_uuid uuid;
+	union cache_uuid val_uuid;
+	struct bt_gatt_attr attr = { .uuid = &uuid.uuid };
+	struct bt_gatt_dm_attr *cur_attr;
+	bool service;
+	bool chrc;
+	int err;
+
+	if (buf->len < 3) {
+		return -EBADMSG;
+	}
+
+	attr.handle = net_buf_simple_pull_le16(buf);
+	attr.perm = net_buf_simple_pull_u8(buf);
+
+	err = cache_uuid_pull(buf, &uuid);
+	if (err) {
+		return err;
+	}
+
+	service = !bt_uuid_cmp(&uuid.uuid, BT_UUID_GATT_PRIMARY) ||
+		  !bt_uuid_cmp(&uuid.uuid, BT_UUID_GATT_SECONDARY);
+	chrc = !bt_uuid_cmp(&uuid.uuid, BT_UUID_GATT_CHRC);
+
+	if (service) {
+		struct bt_gatt_service_val *service_val;
+
+		cur_attr = attr_store(dm, &attr, sizeof(*service_val));
+		if (!cur_attr) {
+			return -ENOMEM;
+		}
+
+		if (buf->len < 2) {
+			return -EBADMSG;
+		}
+
+		service_val = bt_gatt_dm_attr_service_val(cur_attr);
+		service_val->end_handle = net_buf_simple_pull_le16(buf);
+
+		err = cache_uuid_pull(buf, &val_uuid);
+		if (err) {
+			return err;
+		}
+
+		service_val->uuid = uuid_store(dm, &val_uuid.uuid);
+		return service_val->uuid ? 0 : -ENOMEM;
+	} else if (chrc) {
+		struct bt_gatt_chrc *chrc_val;
+
+		cur_attr = attr_store(dm, &attr, sizeof(*chrc_val));
+		if (!cur_attr) {
+			return -ENOMEM;
+		}
+
+		if (buf->len < 3) {
+			return -EBADMSG;
+		}
+
+		chrc_val = bt_gatt_dm_attr_chrc_val(cur_attr);
+		chrc_val->value_handle = net_buf_simple_pull_le16(buf);
+		chrc_val->properties = net_buf_simple_pull_u8(buf);
+
+		err = cache_uuid_pull(buf, &val_uuid);
+		if (err) {
+			return err;
+		}
+
+		chrc_val->uuid = uuid_store(dm, &val_uuid.uuid);
+		return chrc_val->uuid ? 0 : -ENOMEM;
+	}
+
+	return attr_store(dm, &attr, 0) ? 0 : -ENOMEM;
+}
+
+static int cache_read_cb(const char *key, size_t len, settings_read_cb read_cb,
+			 void *cb_arg, void *param)
+{
+	ssize_t *read_len = param;
+
+	/* Only the entry itself, not the entries below it */
+	if (key) {
+		return 0;
+	}
+
+	if (len > cache_buf.size) {
+		*read_len = -ENOMEM;
+		return 1;
+	}
+
+	*read_len = read_cb(cb_arg, cache_buf.data, len);
+
+	return 1;
+}
+
+/* Leaves the discovery parameters as the discovery over the air does, so that
+ * bt_gatt_dm_continue works the same, see discovery_process_service() and
+ * discovery_process_attribute().
+ */
+static void cache_discover_params_set(struct bt_gatt_dm *dm)
+{
+	const struct bt_gatt_dm_attr *service = &dm->attrs[0];
+
+	dm->discover_params.end_handle = bt_gatt_dm_attr_service_val(service)->end_handle;
+
+	if (service->handle == dm->discover_params.end_handle) {
+		/* Empty service, completed by the service discovery */
+		return;
+	}
+
+	dm->discover_params.uuid = NULL;
+	dm->discover_params.start_handle = service->handle + 1;
+	dm->discover_params.type = (dm->cur_attr_id > 1) ? BT_GATT_DISCOVER_CHARACTERISTIC :
+							   BT_GATT_DISCOVER_ATTRIBUTE;
+}
+
+/* Returns 0 if the discovery was completed from the cache. */
+static int cache_load(struct bt_gatt_dm *dm)
+{
+	char key[CACHE_KEY_LEN];
+	ssize_t read_len = -ENOENT;
+	uint8_t attr_cnt = 0;
+	int err;
+
+	err = cache_key(dm, key, sizeof(key));
+	if (err) {
+		return err;
+	}
+
+	k_mutex_lock(&cache_buf_mutex, K_FOREVER);
+
+	net_buf_simple_reset(&cache_buf);
+
+	err = settings_load_subtree_direct(key, cache_read_cb, &read_len);
+	if (err || read_len < CACHE_HDR_LEN) {
+		err = err ? err : -ENOENT;
+		goto out;
+	}
+
+	cache_buf.len = read_len;
+
+	if (memcmp(net_buf_simple_pull_mem(&cache_buf, DB_HASH_LEN), dm->db_hash,
+		   DB_HASH_LEN) ||
+	    net_buf_simple_pull_u8(&cache_buf) != CACHE_VERSION) {
+		LOG_DBG("Cached result for %s is out of date", key);
+		err = -ESTALE;
+		goto out;
+	}
+
+	attr_cnt = net_buf_simple_pull_u8(&cache_buf);
+
+	for (uint8_t i = 0; i < attr_cnt && !err; i++) {
+		err = cache_attr_restore(dm, &cache_buf);
+	}
+
+	if (!err && (cache_buf.len != 0 || (attr_cnt > 0 && !bt_gatt_dm_attr_service_val(
+						&dm->attrs[0])))) {
+		err = -EBADMSG;
+	}
+
+	if (err) {
+		LOG_WRN("Invalid cached result for %s (err %d)", key, err);
+		svc_attr_memory_release(dm);
+	}
+
+out:
+	k_mutex_unlock(&cache_buf_mutex);
+
+	if (err) {
+		return err;
+	}
+
+	LOG_DBG("Discovery result restored from %s", key);
+
+	if (attr_cnt == 0) {
+		discovery_complete_not_found(dm);
+	} else {
+		cache_discover_params_set(dm);
+		discovery_complete(dm);
+	}
+
+	return 0;
+}
+
+static uint8_t db_hash_read_cb(struct bt_conn *conn, uint8_t err,
+			       struct bt_gatt_read_params *params,
+			       const void *data, uint16_t length)
+{
+	struct bt_gatt_dm *dm = CONTAINER_OF(params, struct bt_gatt_dm, read_params);
+
+	if (!err && data && length == DB_HASH_LEN) {
+		memcpy(dm->db_hash, data, DB_HASH_LEN);
+		dm->db_hash_state = DB_HASH_KNOWN;
+	} else {
+		LOG_DBG("Database Hash not available (err %u)", err);
+		dm->db_hash_state = DB_HASH_UNSUPPORTED;
+	}
+
+	k_work_submit(&dm->cache_work);
+
+	return BT_GATT_ITER_STOP;
+}
+
+static void cache_work_handler(struct k_work *work)
+{
+	struct bt_gatt_dm *dm = CONTAINER_OF(work, struct bt_gatt_dm, cache_work);
+	int err;
+
+	if (dm->db_hash_state == DB_HASH_UNKNOWN) {
+		dm->read_params.func = db_hash_read_cb;
+		dm->read_params.handle_count = 0;
+		dm->read_params.by_uuid.start_handle = 0x0001;
+		dm->read_params.by_uuid.end_handle = 0xffff;
+		dm->read_params.by_uuid.uuid = BT_UUID_GATT_DB_HASH;
+
+		err = bt_gatt_read(dm->conn, &dm->read_params);
+		if (!err) {
+			/* Continued in db_hash_read_cb */
+			return;
+		}
+
+		dm->db_hash_state = DB_HASH_UNSUPPORTED;
+	}
+
+	if (dm->db_hash_state == DB_HASH_KNOWN) {
+		if (!cache_load(dm)) {
+			return;
+		}
+
+		dm->cache_store = true;
+	}
+
+	err = bt_gatt_discover(dm->conn, &dm->discover_params);
+	if (err) {
+		LOG_ERR("Discover failed, error: %d.", err);
+		dm->cache_store = false;
+		discovery_complete_error(dm, err);
+	}
+}
+
+static bool cache_in_use(struct bt_gatt_dm *dm)
+{
+	struct bt_conn_info info;
+
+	if (dm->db_hash_state == DB_HASH_UNSUPPORTED ||
+	    bt_conn_get_info(dm->conn, &info) || info.type != BT_CONN_TYPE_LE) {
+		return false;
+	}
+
+	return bt_addr_le_is_bonded(info.id, info.le.dst);
+}
+
+static int cache_entry_find_cb(const char *key, size_t len, settings_read_cb read_cb,
+			       void *cb_arg, void *param)
+{
+	char *name = param;
+
+	/* Skip the deleted entries that some backends report */
+	if (!key || len == 0) {
+		return 0;
+	}
+
+	strncat(name, key, CACHE_KEY_LEN - strlen(name) - 1);
+
+	return 1;
+}
+
+int bt_gatt_dm_cache_clear(const bt_addr_le_t *addr)
+{
+	char prefix[CACHE_KEY_LEN];
+	char name[CACHE_KEY_LEN];
+	int err;
+
+	cache_addr_key(prefix, sizeof(prefix), addr);
+
+	k_mutex_lock(&cache_settings_mutex, K_FOREVER);
+
+	/* Results queued before the removal must not be written after it. */
+	cache_store_drop(prefix);
+
+	/* Deleting entries while they are being loaded is not supported by all
+	 * settings backends, so look them up and delete them one by one.
+	 */
+	do {
+		snprintf(name, sizeof(name), "%s/", prefix);
+
+		err = settings_load_subtree_direct(prefix, cache_entry_find_cb, name);
+		if (err || strlen(name) == strlen(prefix) + 1) {
+			break;
+		}
+
+		err = settings_delete(name);
+	} while (!err);
+
+	k_mutex_unlock(&cache_settings_mutex);
+
+	return err;
+}
+
+void bt_gatt_dm_cache_invalidate(struct bt_conn *conn)
+{
+	k_spinlock_key_t key = k_spin_lock(&bt_gatt_dm_lock);
+
+	for (size_t i = 0; i < ARRAY_SIZE(bt_gatt_dm_inst); i++) {
+		if (bt_gatt_dm_inst[i].conn == conn) {
+			bt_gatt_dm_inst[i].db_hash_state = DB_HASH_UNKNOWN;
+		}
+	}
+
+	k_spin_unlock(&bt_gatt_dm_lock, key);
+}
+
+#if defined(CONFIG_BT_SMP)
+static void bond_deleted(uint8_t id, const bt_addr_le_t *peer)
+{
+	int err = bt_gatt_dm_cache_clear(peer);
+
+	if (err) {
+		LOG_WRN("Failed to clear the discovery cache (err %d)", err);
+	}
+}
+
+static struct bt_conn_auth_info_cb auth_info_cb = {
+	.bond_deleted = bond_deleted,
+};
+#endif
+
+static int gatt_dm_cache_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	for (size_t i = 0; i < ARRAY_SIZE(bt_gatt_dm_inst); i++) {
+		k_work_init(&bt_gatt_dm_inst[i].cache_work, cache_work_handler);
+	}
+
+#if defined(CONFIG_BT_SMP)
+	return bt_conn_auth_info_cb_register(&auth_info_cb);
+#else
+	return 0;
+#endif
+}
+
+SYS_INIT(gatt_dm_cache_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif /* CONFIG_BT_GATT_DM_CACHE */
+
+/* Starts the discovery of a service, using the cache if possible. */
+static int discovery_start(struct bt_gatt_dm *dm)
+{
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	dm->cache_store = false;
+	dm->cache_start_handle = dm->discover_params.start_handle;
+
+	if (cache_in_use(dm)) {
+		k_work_submit(&dm->cache_work);
+		return 0;
+	}
+#endif
+
+	return bt_gatt_discover(dm->conn, &dm->discover_params);
+}
+
 static void discovery_complete(struct bt_gatt_dm *dm)
 {
 	LOG_DBG("Discovery complete.");
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	cache_store(dm, true);
+#endif
 	atomic_set_bit(dm->state_flags, STATE_ATTRS_RELEASE_PENDING);
 	if (dm->callback->completed) {
 		dm->callback->completed(dm, dm->context);
@@ -259,6 +1004,9 @@ static void discovery_complete(struct bt_gatt_dm *dm)
 static void discovery_complete_not_found(struct bt_gatt_dm *dm)
 {
 	LOG_DBG("Discover complete. No service found.");
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	cache_store(dm, false);
+#endif
 
 	svc_attr_memory_release(dm);
 	atomic_clear_bit(dm->state_flags, STATE_ATTRS_LOCKED);
@@ -270,6 +1018,9 @@ static void discovery_complete_not_found(struct bt_gatt_dm *dm)
 
 static void discovery_complete_error(struct bt_gatt_dm *dm, int err)
 {
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	dm->cache_store = false;
+#endif
 	svc_attr_memory_release(dm);
 	atomic_clear_bit(dm->state_flags, STATE_ATTRS_LOCKED);
 	if (dm->callback->error_found) {
@@ -437,34 +1188,33 @@ static uint8_t discovery_callback(struct bt_conn *conn,
 			       const struct bt_gatt_attr *attr,
 			       struct bt_gatt_discover_params *params)
 {
+	struct bt_gatt_dm *dm = CONTAINER_OF(params, struct bt_gatt_dm,
+					     discover_params);
+
 	if (!attr) {
 		LOG_DBG("NULL attribute");
 	} else {
 		LOG_DBG("Attr: handle %u", attr->handle);
 	}
 
-	if (conn != bt_gatt_dm_inst.conn) {
+	if (conn != dm->conn) {
 		LOG_ERR("Unexpected conn object. Aborting.");
-		discovery_complete_error(&bt_gatt_dm_inst, -EFAULT);
+		discovery_complete_error(dm, -EFAULT);
 		return BT_GATT_ITER_STOP;
 	}
 
 	switch (params->type) {
 	case BT_GATT_DISCOVER_PRIMARY:
 	case BT_GATT_DISCOVER_SECONDARY:
-		return discovery_process_service(&bt_gatt_dm_inst,
-						 attr, params);
+		return discovery_process_service(dm, attr, params);
 	case BT_GATT_DISCOVER_ATTRIBUTE:
-		return discovery_process_attribute(&bt_gatt_dm_inst,
-						   attr, params);
+		return discovery_process_attribute(dm, attr, params);
 	case BT_GATT_DISCOVER_CHARACTERISTIC:
-		return discovery_process_characteristic(&bt_gatt_dm_inst,
-							attr,
-							params);
+		return discovery_process_characteristic(dm, attr, params);
 	default:
 		/* This should not be possible */
 		__ASSERT(false, "Unknown param type.");
-		discovery_complete_error(&bt_gatt_dm_inst, -EINVAL);
+		discovery_complete_error(dm, -EINVAL);
 
 		break;
 	}
@@ -619,13 +1369,11 @@ int bt_gatt_dm_start(struct bt_conn *conn,
 		return -EINVAL;
 	}
 
-	dm = &bt_gatt_dm_inst;
-
-	if (atomic_test_and_set_bit(dm->state_flags, STATE_ATTRS_LOCKED)) {
-		return -EALREADY;
+	dm = dm_alloc(conn, &err);
+	if (!dm) {
+		return err;
 	}
 
-	dm->conn = conn;
 	dm->context = context;
 	dm->callback = cb;
 	dm->cur_attr_id = 0;
@@ -646,7 +1394,7 @@ int bt_gatt_dm_start(struct bt_conn *conn,
 	dm->discover_params.end_handle = 0xffff;
 	dm->discover_params.type = BT_GATT_DISCOVER_PRIMARY;
 
-	err = bt_gatt_discover(conn, &dm->discover_params);
+	err = discovery_start(dm);
 	if (err) {
 		LOG_ERR("Discover failed, error: %d.", err);
 		atomic_clear_bit(dm->state_flags, STATE_ATTRS_LOCKED);
@@ -689,7 +1437,7 @@ int bt_gatt_dm_continue(struct bt_gatt_dm *dm, void *context)
 	dm->discover_params.type = BT_GATT_DISCOVER_PRIMARY;
 	dm->discover_params.uuid = dm->search_svc_by_uuid ? &dm->svc_uuid.uuid : NULL;
 
-	err = bt_gatt_discover(dm->conn, &dm->discover_params);
+	err = discovery_start(dm);
 	if (err) {
 		LOG_ERR("Discover failed, error: %d.", err);
 		atomic_clear_bit(dm->state_flags, STATE_ATTRS_LOCKED);
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <bluetooth/mesh/light_ctrl_reg_fixed.h>
+
+#define REG_INT CONFIG_BT_MESH_LIGHT_CTRL_REG_FIXED_INTERVAL
+
+/* All values are in Q16.16 format. The limits keep every product below in
+ * 63 bits: Illuminance values are far above the 167772 lux representable by
+ * the Light LC Server, and the coefficients and accuracy are limited to the
+ * ranges defined by the specification.
+ */
+#define Q16_ONE (1LL << 16)
+#define Q16(_val) ((int64_t)(_val) * Q16_ONE)
+#define LUX_MAX (1 << 19)
+#define COEFF_MAX 1000
+#define ACCURACY_MAX 100
+
+/* Decode the IEEE 754 single precision value in Q16.16 format, using integer
+ * operations only. The value is truncated towards zero and clamped to
+ * [-max, max].
+ */
+static int64_t q16_get(const float *val, int32_t max)
+{
+	uint32_t bits;
+	int32_t exp;
+	int64_t q;
+
+	memcpy(&bits, val, sizeof(bits));
+
+	exp = (bits >> 23) & 0xff;
+	if (exp == 0) {
+		/* Zero or subnormal */
+		return 0;
+	}
+
+	/* Remove the exponent bias and move the binary point from bit 23 to
+	 * bit 16.
+	 */
+	exp -= 127 + 23 - 16;
+	q = (bits & BIT_MASK(23)) | BIT(23);
+
+	if (exp >= 24) {
+		q = Q16(max);
+	} else if (exp >= 0) {
+		q = MIN(q << exp, Q16(max));
+	} else if (exp > -24) {
+		q = MIN(q >> -exp, Q16(max));
+	} else {
+		q = 0;
+	}
+
+	return (bits & BIT(31)) ? -q : q;
+}
+
+static int64_t q16_mul(int64_t a, int64_t b)
+{
+	return (a * b) / Q16_ONE;
+}
+
+/* Integer counterpart of bt_mesh_light_ctrl_reg_target_get(). */
+static int64_t target_get(struct bt_mesh_light_ctrl_reg *reg)
+{
+	int64_t target = q16_get(&reg->target, LUX_MAX);
+
+	if (reg->transition_time == 0) {
+		return target;
+	}
+
+	int32_t elapsed = k_uptime_get() - reg->transition_start;
+
+	if (elapsed >= reg->transition_time) {
+		reg->transition_time = 0;
+		return target;
+	}
+
+	int64_t prev = q16_get(&reg->prev_target, LUX_MAX);
+
+	return prev + (elapsed * (target - prev)) / reg->transition_time;
+}
+
+static void reg_step(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct bt_mesh_light_ctrl_reg_fixed *fixed_reg = CONTAINER_OF(
+		dwork, struct bt_mesh_light_ctrl_reg_fixed, timer);
+	struct bt_mesh_light_ctrl_reg_cfg *cfg = &fixed_reg->reg.cfg;
+
+	if (!fixed_reg->enabled) {
+		/* The regulator might be disabled asynchronously. */
+		return;
+	}
+
+	k_work_reschedule(&fixed_reg->timer, K_MSEC(REG_INT));
+
+	int64_t target = target_get(&fixed_reg->reg);
+	int64_t error = target - q16_get(&fixed_reg->reg.measured, LUX_MAX);
+	/* Accuracy should be in percent and both up and down: */
+	int64_t accuracy =
+		q16_mul(q16_get(&cfg->accuracy, ACCURACY_MAX), target) / (2 * 100);
+	int64_t input;
+
+	if (error > accuracy) {
+		input = error - accuracy;
+	} else if (error < -accuracy) {
+		input = error + accuracy;
+	} else {
+		input = 0;
+	}
+
+	int64_t kp, ki;
+
+	if (input >= 0) {
+		kp = q16_get(&cfg->kp.up, COEFF_MAX);
+		ki = q16_get(&cfg->ki.up, COEFF_MAX);
+	} else {
+		kp = q16_get(&cfg->kp.down, COEFF_MAX);
+		ki = q16_get(&cfg->ki.down, COEFF_MAX);
+	}
+
+	fixed_reg->i += (q16_mul(input, ki) * REG_INT) / MSEC_PER_SEC;
+	fixed_reg->i = CLAMP(fixed_reg->i, 0, Q16(UINT16_MAX));
+
+	int64_t p = q16_mul(input, kp);
+	int64_t output = CLAMP(fixed_reg->i + p, 0, Q16(UINT16_MAX));
+
+	fixed_reg->reg.updated_lvl(&fixed_reg->reg, output / Q16_ONE);
+}
+
+void bt_mesh_light_ctrl_reg_fixed_start(struct bt_mesh_light_ctrl_reg *reg)
+{
+	struct bt_mesh_light_ctrl_reg_fixed *fixed_reg = CONTAINER_OF(
+		reg, struct bt_mesh_light_ctrl_reg_fixed, reg);
+	fixed_reg->enabled = true;
+	k_work_schedule(&fixed_reg->timer, K_MSEC(REG_INT));
+}
+
+void bt_mesh_light_ctrl_reg_fixed_stop(struct bt_mesh_light_ctrl_reg *reg)
+{
+	struct bt_mesh_light_ctrl_reg_fixed *fixed_reg = CONTAINER_OF(
+		reg, struct bt_mesh_light_ctrl_reg_fixed, reg);
+	fixed_reg->i = 0;
+	fixed_reg->enabled = false;
+	k_work_cancel_delayable(&fixed_reg->timer);
+}
+
+void bt_mesh_light_ctrl_reg_fixed_init(struct bt_mesh_light_ctrl_reg *reg)
+{
+	struct bt_mesh_light_ctrl_reg_fixed *fixed_reg = CONTAINER_OF(
+		reg, struct bt_mesh_light_ctrl_reg_fixed, reg);
+	k_work_init_delayable(&fixed_reg->timer, reg_step);
+}
@@ -360,10 +360,9 @@ static float lux_getf(struct bt_mesh_light_ctrl_srv *srv)
 	return to_centi_lux(&srv->cfg.lux[srv->state]) / 100.0f;
 }
 
-static void reg_updated(struct bt_mesh_light_ctrl_reg *reg, float value)
+static void reg_updated_lvl(struct bt_mesh_light_ctrl_reg *reg, uint16_t output)
 {
 	struct bt_mesh_light_ctrl_srv *srv = (struct bt_mesh_light_ctrl_srv *)(reg->user_data);
-	uint16_t output = CLAMP(value, 0, UINT16_MAX);
 	/* The regulator output is always in linear format. We'll convert to
 	 * the configured representation again before calling the Lightness
 	 * server.
@@ -391,6 +390,11 @@ static void reg_updated(struct bt_mesh_light_ctrl_reg *reg, float value)
 				  &(struct bt_mesh_lightness_status){});
 }
 
+static void reg_updated(struct bt_mesh_light_ctrl_reg *reg, float value)
+{
+	reg_updated_lvl(reg, CLAMP(value, 0, UINT16_MAX));
+}
+
 #else
 
 static void lux_get(struct bt_mesh_light_ctrl_srv *srv,
@@ -1519,6 +1523,7 @@ static int light_ctrl_srv_init(struct bt_mesh_model *model)
 		struct bt_mesh_light_ctrl_reg_cfg reg_cfg = BT_MESH_LIGHT_CTRL_SRV_REG_CFG_INIT;
 
 		srv->reg->updated = reg_updated;
+		srv->reg->updated_lvl = reg_updated_lvl;
 		srv->reg->user_data = srv;
 		srv->reg->cfg = reg_cfg;
 		if (srv->reg->init) {
@@ -18,18 +18,117 @@
 #include <mesh/rpl.h>
 #include <emds/emds.h>
 
+/* Open addressing with linear probing, at most two thirds full. */
+#define RPL_INDEX_SIZE (CONFIG_BT_MESH_CRPL + CONFIG_BT_MESH_CRPL / 2 + 1)
+
 static struct bt_mesh_rpl replay_list[CONFIG_BT_MESH_CRPL];
 
 EMDS_STATIC_ENTRY_DEFINE(rpl_store, CONFIG_BT_MESH_RPL_INDEX, replay_list, sizeof(replay_list));
 
+/* Hash index of the used replay_list slots by source address. The slots are
+ * stored incremented by one, zero marks an empty bucket. The used slots are
+ * kept at the start of replay_list, so that the next free one is always
+ * replay_list[rpl_count].
+ */
+static uint16_t rpl_index[RPL_INDEX_SIZE];
+static uint16_t rpl_count;
+static bool rpl_index_valid;
+
+BUILD_ASSERT(CONFIG_BT_MESH_CRPL < UINT16_MAX, "RPL too large for the index");
+
 static inline int rpl_idx(const struct bt_mesh_rpl *rpl)
 {
 	return rpl - &replay_list[0];
 }
 
+static inline uint32_t rpl_hash(uint16_t src)
+{
+	/* Fibonacci hashing spreads the sequential unicast addresses over the
+	 * high bits of the product, which are scaled down to the index size.
+	 */
+	uint32_t hash = src * 2654435761U;
+
+	return ((uint64_t)hash * RPL_INDEX_SIZE) >> 32;
+}
+
+static void rpl_index_add(const struct bt_mesh_rpl *rpl)
+{
+	uint32_t i = rpl_hash(rpl->src);
+
+	while (rpl_index[i]) {
+		i = (i + 1) % RPL_INDEX_SIZE;
+	}
+
+	rpl_index[i] = rpl_idx(rpl) + 1;
+}
+
+/* The entries are loaded from the emergency data storage without notice, so
+ * the index is built on first use, and rebuilt whenever the list is compacted.
+ */
+static void rpl_index_build(void)
+{
+	(void)memset(rpl_index, 0, sizeof(rpl_index));
+	rpl_count = 0;
+
+	for (int i = 0; i < ARRAY_SIZE(replay_list); i++) {
+		if (!replay_list[i].src) {
+			continue;
+		}
+
+		if (i != rpl_count) {
+			replay_list[rpl_count] = replay_list[i];
+			(void)memset(&replay_list[i], 0, sizeof(replay_list[i]));
+		}
+
+		rpl_index_add(&replay_list[rpl_count]);
+		rpl_count++;
+	}
+
+	rpl_index_valid = true;
+}
+
+static struct bt_mesh_rpl *rpl_find(uint16_t src)
+{
+	uint32_t i = rpl_hash(src);
+
+	if (!rpl_index_valid) {
+		rpl_index_build();
+	}
+
+	/* The index is never full, the probing ends at an empty bucket. */
+	while (rpl_index[i]) {
+		struct bt_mesh_rpl *rpl = &replay_list[rpl_index[i] - 1];
+
+		if (rpl->src == src) {
+			return rpl;
+		}
+
+		i = (i + 1) % RPL_INDEX_SIZE;
+	}
+
+	return NULL;
+}
+
 void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		struct bt_mesh_net_rx *rx)
 {
+	/* The free slot handed out by bt_mesh_rpl_check() for a new source may
+	 * have been taken by another source before the update.
+	 */
+	if (rpl->src != rx->ctx.addr) {
+		rpl = rpl_find(rx->ctx.addr);
+		if (!rpl) {
+			if (rpl_count == ARRAY_SIZE(replay_list)) {
+				BT_ERR("RPL is full!");
+				return;
+			}
+
+			rpl = &replay_list[rpl_count++];
+			rpl->src = rx->ctx.addr;
+			rpl_index_add(rpl);
+		}
+	}
+
 	/* If this is the first message on the new IV index, we should reset it
 	 * to zero to avoid invalid combinations of IV index and seg.
 	 */
@@ -50,7 +149,7 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		struct bt_mesh_rpl **match)
 {
-	int i;
+	struct bt_mesh_rpl *rpl;
 
 	/* Don't bother checking messages from ourselves */
 	if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
@@ -62,48 +161,49 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		return false;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		struct bt_mesh_rpl *rpl = &replay_list[i];
+	rpl = rpl_find(rx->ctx.addr);
+	if (!rpl) {
+		if (rpl_count == ARRAY_SIZE(replay_list)) {
+			BT_ERR("RPL is full!");
+			return true;
+		}
 
 		/* Empty slot */
-		if (!rpl->src) {
-			if (match) {
-				*match = rpl;
-			} else {
-				bt_mesh_rpl_update(rpl, rx);
-			}
-
-			return false;
+		rpl = &replay_list[rpl_count];
+		if (match) {
+			*match = rpl;
+		} else {
+			bt_mesh_rpl_update(rpl, rx);
 		}
 
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
+		return false;
+	}
 
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				if (match) {
-					*match = rpl;
-				} else {
-					bt_mesh_rpl_update(rpl, rx);
-				}
+	/* Existing slot for given address */
+	if (rx->old_iv && !rpl->old_iv) {
+		return true;
+	}
 
-				return false;
-			} else {
-				return true;
-			}
+	if ((!rx->old_iv && rpl->old_iv) ||
+	    rpl->seq < rx->seq) {
+		if (match) {
+			*match = rpl;
+		} else {
+			bt_mesh_rpl_update(rpl, rx);
 		}
+
+		return false;
 	}
 
-	BT_ERR("RPL is full!");
 	return true;
 }
 
 void bt_mesh_rpl_clear(void)
 {
 	(void)memset(replay_list, 0, sizeof(replay_list));
+	(void)memset(rpl_index, 0, sizeof(rpl_index));
+	rpl_count = 0;
+	rpl_index_valid = true;
 }
 
 void bt_mesh_rpl_reset(void)
@@ -135,6 +235,8 @@ void bt_mesh_rpl_reset(void)
 	}
 
 	(void) memset(&replay_list[last - shift + 1], 0, sizeof(struct bt_mesh_rpl) * shift);
+
+	rpl_index_build();
 }
 
 void bt_mesh_rpl_pending_store(uint16_t addr)
@@ -6,9 +6,11 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <zephyr/bluetooth/mesh/access.h>
 #include <bluetooth/mesh/models.h>
 #include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
 #include "model_utils.h"
 #include "mesh/net.h"
 #include "mesh/access.h"
@@ -20,6 +22,11 @@
 #define SCENE_PAGE_SIZE SETTINGS_MAX_VAL_LEN
 /* Account for company ID in data: */
 #define VND_MODEL_SCENE_DATA_OVERHEAD sizeof(uint16_t)
+#define PAGES_MAX CONFIG_BT_MESH_SCENE_SRV_PAGES_MAX
+/* Longest page path, "ffff/lvff": */
+#define PATH_LEN 10
+/* A link holds the number of the scene the page data is stored with: */
+#define LINK_LEN sizeof(uint16_t)
 
 struct __packed scene_data {
 	uint8_t len;
@@ -36,6 +43,12 @@ static char *scene_path(char *buf, uint16_t scene, bool vnd, uint8_t page)
 	return buf;
 }
 
+static char *link_path(char *buf, uint16_t scene, bool vnd, uint8_t page)
+{
+	sprintf(buf, "%x/l%c%x", scene, vnd ? 'v' : 's', page);
+	return buf;
+}
+
 static inline void update_page_count(struct bt_mesh_scene_srv *srv, bool vnd,
 			       uint8_t page)
 {
@@ -295,6 +308,181 @@ static uint16_t *scene_find(struct bt_mesh_scene_srv *srv, uint16_t scene)
 	return NULL;
 }
 
+static struct bt_mesh_scene_page *page_get(struct bt_mesh_scene_srv *srv,
+					   uint16_t scene, bool vnd, uint8_t page)
+{
+	uint16_t *entry = scene_find(srv, scene);
+
+	if (!entry || page >= PAGES_MAX) {
+		return NULL;
+	}
+
+	return &srv->pages[entry - srv->all][vnd][page];
+}
+
+/** Get the scene the page data is stored with. */
+static uint16_t page_owner(uint16_t scene, const struct bt_mesh_scene_page *entry)
+{
+	return (entry->link == BT_MESH_SCENE_NONE) ? scene : entry->link;
+}
+
+static void data_store(struct bt_mesh_scene_srv *srv, const char *path,
+		       const void *data, size_t len)
+{
+	int err;
+
+	err = bt_mesh_model_data_store(srv->model, false, path, data, len);
+	if (err) {
+		BT_ERR("Failed storing %s: %d", path, err);
+	}
+}
+
+struct page_read_ctx {
+	uint8_t *buf;
+	ssize_t len;
+};
+
+static int page_read_cb(const char *key, size_t len, settings_read_cb read_cb,
+			void *cb_arg, void *param)
+{
+	struct page_read_ctx *ctx = param;
+
+	/* Only the page itself is of interest: */
+	if (key) {
+		return 0;
+	}
+
+	ctx->len = read_cb(cb_arg, ctx->buf, SCENE_PAGE_SIZE);
+	return 0;
+}
+
+/** Read the page data stored with the given scene. */
+static ssize_t page_read(struct bt_mesh_scene_srv *srv, uint16_t scene,
+			 bool vnd, uint8_t page, uint8_t buf[])
+{
+	struct page_read_ctx ctx = {
+		.buf = buf,
+		.len = -ENOENT,
+	};
+	char path[32];
+
+	sprintf(path, "bt/mesh/s/%x/data/%x/%c%x",
+		(srv->model->elem_idx << 8) | srv->model->mod_idx, scene,
+		vnd ? 'v' : 's', page);
+
+	(void)settings_load_subtree_direct(path, page_read_cb, &ctx);
+
+	return ctx.len;
+}
+
+/* The hashes only rule out pages that differ. The stored data is compared as
+ * well, so that a hash collision can't make a scene recall another scene's
+ * state.
+ */
+static bool page_equals(struct bt_mesh_scene_srv *srv, uint16_t scene,
+			bool vnd, uint8_t page, const uint8_t buf[], size_t len)
+{
+	uint8_t stored[SCENE_PAGE_SIZE];
+	ssize_t size;
+
+	size = page_read(srv, scene, vnd, page, stored);
+
+	return size == (ssize_t)len && !memcmp(stored, buf, len);
+}
+
+/** Find a scene that stores the same page data, to link to it. */
+static uint16_t page_owner_find(struct bt_mesh_scene_srv *srv, uint16_t scene,
+				bool vnd, uint8_t page, uint32_t hash,
+				const uint8_t buf[], size_t len)
+{
+	for (int i = 0; i < srv->count; i++) {
+		const struct bt_mesh_scene_page *entry = &srv->pages[i][vnd][page];
+
+		if (srv->all[i] == scene || !entry->stored ||
+		    entry->link != BT_MESH_SCENE_NONE || entry->hash != hash) {
+			continue;
+		}
+
+		if (page_equals(srv, srv->all[i], vnd, page, buf, len)) {
+			return srv->all[i];
+		}
+	}
+
+	return BT_MESH_SCENE_NONE;
+}
+
+/** @brief Hand the page data of a scene over to the scenes linking to it.
+ *
+ *  The page data is moved to the first scene linking to it, and the other
+ *  scenes are linked to that scene instead. Must be called before the page
+ *  data of the scene is changed or deleted.
+ */
+static void page_promote(struct bt_mesh_scene_srv *srv, uint16_t scene,
+			 bool vnd, uint8_t page)
+{
+	const struct bt_mesh_scene_page *owner = page_get(srv, scene, vnd, page);
+	uint16_t heir = BT_MESH_SCENE_NONE;
+	uint8_t buf[SCENE_PAGE_SIZE];
+	uint8_t link[LINK_LEN];
+	char path[PATH_LEN];
+	ssize_t len;
+
+	for (int i = 0; i < srv->count; i++) {
+		struct bt_mesh_scene_page *entry = &srv->pages[i][vnd][page];
+
+		if (!entry->stored || entry->link != scene) {
+			continue;
+		}
+
+		if (heir != BT_MESH_SCENE_NONE) {
+			data_store(srv, link_path(path, srv->all[i], vnd, page),
+				   link, sizeof(link));
+			entry->link = heir;
+			continue;
+		}
+
+		len = page_read(srv, scene, vnd, page, buf);
+		if (len < 0) {
+			BT_ERR("Failed reading 0x%x page %u: %d", scene, page, len);
+			return;
+		}
+
+		heir = srv->all[i];
+		sys_put_le16(heir, link);
+
+		/* Store the data before removing the link, so that the page
+		 * is never lost:
+		 */
+		data_store(srv, scene_path(path, heir, vnd, page), buf, len);
+		data_store(srv, link_path(path, heir, vnd, page), NULL, 0);
+		entry->link = BT_MESH_SCENE_NONE;
+		entry->hash = owner->hash;
+	}
+}
+
+static void page_remove(struct bt_mesh_scene_srv *srv, uint16_t scene,
+			bool vnd, uint8_t page, bool promote)
+{
+	struct bt_mesh_scene_page *entry = page_get(srv, scene, vnd, page);
+	char path[PATH_LEN];
+
+	if (!entry || !entry->stored) {
+		return;
+	}
+
+	if (entry->link != BT_MESH_SCENE_NONE) {
+		data_store(srv, link_path(path, scene, vnd, page), NULL, 0);
+	} else {
+		if (promote) {
+			page_promote(srv, scene, vnd, page);
+		}
+
+		data_store(srv, scene_path(path, scene, vnd, page), NULL, 0);
+	}
+
+	entry->stored = false;
+}
+
 static void entry_recover(struct bt_mesh_scene_srv *srv, bool vnd,
 			  const struct scene_data *data)
 {
@@ -387,20 +575,66 @@ static ssize_t entry_store(struct bt_mesh_model *mod,
  *
  *  To accommodate large scene data, each scene is stored in pages of up to 256
  *  bytes.
+ *
+ *  The first CONFIG_BT_MESH_SCENE_SRV_PAGES_MAX pages are indexed by the
+ *  hash of their data. An indexed page isn't written if it's unchanged, and
+ *  is stored as a link to another scene if that scene stores the same data.
  */
 static void page_store(struct bt_mesh_scene_srv *srv, uint16_t scene,
 		       uint8_t page, bool vnd, uint8_t buf[], size_t len)
 {
-	char path[9];
-	int err;
+	struct bt_mesh_scene_page *entry = page_get(srv, scene, vnd, page);
+	const struct bt_mesh_scene_page *stored;
+	char path[PATH_LEN];
+	uint16_t owner;
+	uint32_t hash;
 
-	scene_path(path, scene, vnd, page);
 	update_page_count(srv, vnd, page);
 
-	err = bt_mesh_model_data_store(srv->model, false, path, buf, len);
-	if (err) {
-		BT_ERR("Failed storing %s: %d", path, err);
+	if (!entry) {
+		data_store(srv, scene_path(path, scene, vnd, page), buf, len);
+		return;
 	}
+
+	hash = crc32_ieee(buf, len);
+
+	if (entry->stored) {
+		owner = page_owner(scene, entry);
+		stored = page_get(srv, owner, vnd, page);
+		if (stored && stored->hash == hash &&
+		    page_equals(srv, owner, vnd, page, buf, len)) {
+			BT_DBG("0x%x: %c%u unchanged", scene, vnd ? 'v' : 's', page);
+			return;
+		}
+
+		if (entry->link == BT_MESH_SCENE_NONE) {
+			page_promote(srv, scene, vnd, page);
+		}
+	}
+
+	owner = page_owner_find(srv, scene, vnd, page, hash, buf, len);
+	if (owner != BT_MESH_SCENE_NONE) {
+		uint8_t link[LINK_LEN];
+
+		BT_DBG("0x%x: %c%u linked to 0x%x", scene, vnd ? 'v' : 's', page,
+		       owner);
+
+		sys_put_le16(owner, link);
+		data_store(srv, link_path(path, scene, vnd, page), link,
+			   sizeof(link));
+		if (entry->stored && entry->link == BT_MESH_SCENE_NONE) {
+			data_store(srv, scene_path(path, scene, vnd, page), NULL, 0);
+		}
+	} else {
+		data_store(srv, scene_path(path, scene, vnd, page), buf, len);
+		if (entry->stored && entry->link != BT_MESH_SCENE_NONE) {
+			data_store(srv, link_path(path, scene, vnd, page), NULL, 0);
+		}
+	}
+
+	entry->stored = true;
+	entry->hash = hash;
+	entry->link = owner;
 }
 
 /** @brief Get the end of the Scene server's controlled elements.
@@ -525,7 +759,12 @@ static void scene_store_mod(struct bt_mesh_scene_srv *srv, uint16_t scene,
 	}
 
 	if (len) {
-		page_store(srv, scene, page, vnd, buf, len);
+		page_store(srv, scene, page++, vnd, buf, len);
+	}
+
+	/* Remove the pages left from a larger version of the scene: */
+	for (; page < PAGES_MAX; page++) {
+		page_remove(srv, scene, vnd, page, true);
 	}
 }
 
@@ -554,18 +793,33 @@ static enum bt_mesh_scene_status scene_store(struct bt_mesh_scene_srv *srv,
 	return BT_MESH_SCENE_SUCCESS;
 }
 
-static void scene_delete(struct bt_mesh_scene_srv *srv, uint16_t *scene)
+/** @brief Delete a scene.
+ *
+ *  @param[in] srv     Scene Server the scene belongs to.
+ *  @param[in] scene   Scene to delete, in the list of all scenes.
+ *  @param[in] promote Whether to hand the page data of the scene over to the
+ *                     scenes linking to it. Only unnecessary if all scenes are
+ *                     deleted.
+ */
+static void scene_delete(struct bt_mesh_scene_srv *srv, uint16_t *scene,
+			 bool promote)
 {
-	uint8_t path[9];
+	size_t idx = scene - srv->all;
+	char path[PATH_LEN];
 
 	BT_DBG("0x%x", *scene);
 
-	for (int i = 0; i < srv->sigpages; i++) {
+	for (int i = 0; i < PAGES_MAX; i++) {
+		page_remove(srv, *scene, false, i, promote);
+		page_remove(srv, *scene, true, i, promote);
+	}
+
+	for (int i = PAGES_MAX; i < srv->sigpages; i++) {
 		scene_path(path, *scene, false, i);
 		(void)bt_mesh_model_data_store(srv->model, false, path, NULL, 0);
 	}
 
-	for (int i = 0; i < srv->vndpages; i++) {
+	for (int i = PAGES_MAX; i < srv->vndpages; i++) {
 		scene_path(path, *scene, true, i);
 		(void)bt_mesh_model_data_store(srv->model, false, path, NULL, 0);
 	}
@@ -585,6 +839,8 @@ static void scene_delete(struct bt_mesh_scene_srv *srv, uint16_t *scene)
 	}
 
 	*scene = srv->all[--srv->count];
+	memcpy(srv->pages[idx], srv->pages[srv->count], sizeof(srv->pages[idx]));
+	memset(srv->pages[srv->count], 0, sizeof(srv->pages[srv->count]));
 }
 
 static int handle_store(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
@@ -628,7 +884,7 @@ static int delete_scene(struct bt_mesh_scene_srv *srv, struct bt_mesh_msg_ctx *c
 
 	scene = scene_find(srv, net_buf_simple_pull_le16(buf));
 	if (scene != BT_MESH_SCENE_NONE) {
-		scene_delete(srv, scene);
+		scene_delete(srv, scene, true);
 	}
 
 	return 0;
@@ -732,10 +988,12 @@ static int scene_srv_set(struct bt_mesh_model *model, const char *path,
 			 size_t len_rd, settings_read_cb read_cb, void *cb_arg)
 {
 	struct bt_mesh_scene_srv *srv = model->user_data;
+	struct bt_mesh_scene_page *entry;
 	uint8_t buf[SCENE_PAGE_SIZE];
 	uint16_t scene;
 	ssize_t size;
 	uint8_t page;
+	bool link;
 	bool vnd;
 
 	BT_DBG("path: %s", path);
@@ -746,6 +1004,8 @@ static int scene_srv_set(struct bt_mesh_model *model, const char *path,
 	 *
 	 * - Path "XXXX/vYY": Scene XXXX vendor model page YY
 	 * - Path "XXXX/sYY": Scene XXXX sig model page YY
+	 * - Path "XXXX/lvYY": Link to the vendor model page YY of another scene
+	 * - Path "XXXX/lsYY": Link to the sig model page YY of another scene
 	 */
 	scene = strtol(path, NULL, 16);
 	if (scene == BT_MESH_SCENE_NONE) {
@@ -758,6 +1018,11 @@ static int scene_srv_set(struct bt_mesh_model *model, const char *path,
 		return 0;
 	}
 
+	link = path[0] == 'l';
+	if (link) {
+		path++;
+	}
+
 	vnd = path[0] == 'v';
 	page = strtol(&path[1], NULL, 16);
 	update_page_count(srv, vnd, page);
@@ -767,26 +1032,55 @@ static int scene_srv_set(struct bt_mesh_model *model, const char *path,
 	 * this callback again, but bt_mesh_is_provisioned() will be true.
 	 */
 	if (!bt_mesh_is_provisioned()) {
-		if (scene_find(srv, scene)) {
-			return 0;
+		if (!scene_find(srv, scene)) {
+			if (srv->count == ARRAY_SIZE(srv->all)) {
+				BT_WARN("No room for scene 0x%x", scene);
+				return 0;
+			}
+
+			BT_DBG("Recovered scene 0x%x", scene);
+			srv->all[srv->count++] = scene;
 		}
 
-		if (srv->count == ARRAY_SIZE(srv->all)) {
-			BT_WARN("No room for scene 0x%x", scene);
+		/* Rebuild the page index: */
+		entry = page_get(srv, scene, vnd, page);
+		if (!entry) {
 			return 0;
 		}
 
-		BT_DBG("Recovered scene 0x%x", scene);
-		srv->all[srv->count++] = scene;
+		size = read_cb(cb_arg, &buf, sizeof(buf));
+		if (size < 0 || (link && size != LINK_LEN)) {
+			BT_ERR("Failed loading scene 0x%x", scene);
+			return -EINVAL;
+		}
+
+		entry->stored = true;
+		if (link) {
+			entry->link = sys_get_le16(buf);
+		} else {
+			entry->link = BT_MESH_SCENE_NONE;
+			entry->hash = crc32_ieee(buf, size);
+		}
+
 		return 0;
 	}
 
 	size = read_cb(cb_arg, &buf, sizeof(buf));
-	if (size < 0) {
+	if (size < 0 || (link && size != LINK_LEN)) {
 		BT_ERR("Failed loading scene 0x%x", scene);
 		return -EINVAL;
 	}
 
+	if (link) {
+		uint16_t owner = sys_get_le16(buf);
+
+		size = page_read(srv, owner, vnd, page, buf);
+		if (size < 0) {
+			BT_ERR("Failed loading scene 0x%x from 0x%x", scene, owner);
+			return -EINVAL;
+		}
+	}
+
 	BT_DBG("0x%x: %s", scene, bt_hex(buf, size));
 	page_recover(srv, vnd, buf, size);
 	return 0;
@@ -799,7 +1093,7 @@ static void scene_srv_reset(struct bt_mesh_model *model)
 	srv->next = BT_MESH_SCENE_NONE;
 
 	while (srv->count) {
-		scene_delete(srv, &srv->all[0]);
+		scene_delete(srv, &srv->all[0], false);
 	}
 
 	srv->prev = BT_MESH_SCENE_NONE;
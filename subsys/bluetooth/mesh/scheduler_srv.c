@@ -378,19 +378,88 @@ static bool convert_scheduler_time_to_tm(struct tm *sched_time,
 	return stage == FINAL_STAGE;
 }
 
-static uint8_t get_least_time_index(struct bt_mesh_scheduler_srv *srv)
+/* The active entries are kept in a min-heap ordered by their TAI-time, so
+ * that only the entry that changed has to be looked at when an entry is set,
+ * fired or rescheduled.
+ */
+static bool heap_less(struct bt_mesh_scheduler_srv *srv, uint8_t a, uint8_t b)
+{
+	return srv->sched_tai[srv->heap[a]].sec < srv->sched_tai[srv->heap[b]].sec;
+}
+
+static void heap_swap(struct bt_mesh_scheduler_srv *srv, uint8_t a, uint8_t b)
 {
-	uint8_t cnt = u32_count_trailing_zeros(srv->active_bitmap);
-	uint8_t idx = cnt;
+	uint8_t idx = srv->heap[a];
+
+	srv->heap[a] = srv->heap[b];
+	srv->heap[b] = idx;
+	srv->heap_pos[srv->heap[a]] = a;
+	srv->heap_pos[srv->heap[b]] = b;
+}
+
+static void heap_fix(struct bt_mesh_scheduler_srv *srv, uint8_t pos)
+{
+	while (pos > 0 && heap_less(srv, pos, (pos - 1) / 2)) {
+		heap_swap(srv, pos, (pos - 1) / 2);
+		pos = (pos - 1) / 2;
+	}
+
+	while (true) {
+		uint8_t least = pos;
+		uint8_t child = 2 * pos + 1;
 
-	while (++cnt < BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT) {
-		if (srv->active_bitmap & BIT(cnt)) {
-			idx = srv->sched_tai[idx].sec >
-				srv->sched_tai[cnt].sec ? cnt : idx;
+		if (child < srv->heap_len && heap_less(srv, child, least)) {
+			least = child;
 		}
+
+		if (child + 1 < srv->heap_len && heap_less(srv, child + 1, least)) {
+			least = child + 1;
+		}
+
+		if (least == pos) {
+			return;
+		}
+
+		heap_swap(srv, pos, least);
+		pos = least;
+	}
+}
+
+/* Add an entry to the heap, or move it if its TAI-time changed. */
+static void entry_activate(struct bt_mesh_scheduler_srv *srv, uint8_t idx)
+{
+	if (!(srv->active_bitmap & BIT(idx))) {
+		WRITE_BIT(srv->active_bitmap, idx, 1);
+		srv->heap[srv->heap_len] = idx;
+		srv->heap_pos[idx] = srv->heap_len++;
+	}
+
+	heap_fix(srv, srv->heap_pos[idx]);
+}
+
+static void entry_deactivate(struct bt_mesh_scheduler_srv *srv, uint8_t idx)
+{
+	uint8_t pos = srv->heap_pos[idx];
+
+	if (!(srv->active_bitmap & BIT(idx))) {
+		return;
+	}
+
+	WRITE_BIT(srv->active_bitmap, idx, 0);
+
+	if (pos != --srv->heap_len) {
+		heap_swap(srv, pos, srv->heap_len);
+		heap_fix(srv, pos);
+	}
+}
+
+static uint8_t get_least_time_index(struct bt_mesh_scheduler_srv *srv)
+{
+	if (!srv->heap_len) {
+		return BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
 	}
 
-	return MIN(BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT, idx);
+	return srv->heap[0];
 }
 
 static void run_scheduler(struct bt_mesh_scheduler_srv *srv)
@@ -400,6 +469,11 @@ static void run_scheduler(struct bt_mesh_scheduler_srv *srv)
 	uint8_t planned_idx = get_least_time_index(srv);
 
 	if (planned_idx == BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT) {
+		/* If this cancellation fails, we'll exit early from the timer
+		 * handler, as srv->idx is out of bounds.
+		 */
+		srv->idx = BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
+		k_work_cancel_delayable(&srv->delayed_work);
 		return;
 	}
 
@@ -431,6 +505,7 @@ static void schedule_action(struct bt_mesh_scheduler_srv *srv,
 
 	if (current_local == NULL) {
 		BT_WARN("Local time not available");
+		entry_deactivate(srv, idx);
 		return;
 	}
 
@@ -446,11 +521,13 @@ static void schedule_action(struct bt_mesh_scheduler_srv *srv,
 
 	if (!convert_scheduler_time_to_tm(&sched_time, current_local, entry)) {
 		BT_WARN("Cannot convert scheduled action time to struct tm");
+		entry_deactivate(srv, idx);
 		return;
 	}
 
 	if (ts_to_tai(&srv->sched_tai[idx], &sched_time)) {
 		BT_WARN("tm cannot be converted into TAI");
+		entry_deactivate(srv, idx);
 		return;
 	}
 
@@ -462,7 +539,14 @@ static void schedule_action(struct bt_mesh_scheduler_srv *srv,
 	BT_DBG("        minute: %d", sched_time.tm_min);
 	BT_DBG("        second: %d", sched_time.tm_sec);
 
-	WRITE_BIT(srv->active_bitmap, idx, 1);
+	entry_activate(srv, idx);
+}
+
+static bool has_action(const struct bt_mesh_schedule_entry *entry)
+{
+	return entry->action < BT_MESH_SCHEDULER_SCENE_RECALL ||
+	       (entry->action == BT_MESH_SCHEDULER_SCENE_RECALL &&
+		entry->scene_number != 0);
 }
 
 static void scheduled_action_handle(struct k_work *work)
@@ -477,7 +561,7 @@ static void scheduled_action_handle(struct k_work *work)
 		return;
 	}
 
-	WRITE_BIT(srv->active_bitmap, srv->idx, 0);
+	entry_deactivate(srv, srv->idx);
 
 	struct bt_mesh_model *next_sched_mod = NULL;
 	uint16_t model_id = srv->sch_reg[srv->idx].action ==
@@ -642,13 +726,14 @@ static int action_set(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
 	srv->sch_reg[idx] = tmp;
 	BT_DBG("Rx: scheduler server action index %d set, ack %d", idx, ack);
 
-	if (srv->sch_reg[idx].action < BT_MESH_SCHEDULER_SCENE_RECALL ||
-	   (srv->sch_reg[idx].action == BT_MESH_SCHEDULER_SCENE_RECALL &&
-	    srv->sch_reg[idx].scene_number != 0)) {
+	if (has_action(&srv->sch_reg[idx])) {
 		schedule_action(srv, idx);
-		run_scheduler(srv);
+	} else {
+		entry_deactivate(srv, idx);
 	}
 
+	run_scheduler(srv);
+
 	if (srv->action_set_cb) {
 		srv->action_set_cb(srv, ctx, idx, &srv->sch_reg[idx]);
 	}
@@ -758,6 +843,7 @@ static int scheduler_srv_init(struct bt_mesh_model *model)
 	net_buf_simple_init_with_data(&srv->pub_buf, srv->pub_data,
 			sizeof(srv->pub_data));
 	srv->active_bitmap = 0;
+	srv->heap_len = 0;
 
 	srv->idx = BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
 	k_work_init_delayable(&srv->delayed_work, scheduled_action_handle);
@@ -775,6 +861,7 @@ static void scheduler_srv_reset(struct bt_mesh_model *model)
 
 	srv->idx = BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
 	srv->active_bitmap = 0;
+	srv->heap_len = 0;
 	/* If this cancellation fails, we'll exit early from the timer handler,
 	 * as srv->idx is out of bounds.
 	 */
@@ -840,7 +927,11 @@ int bt_mesh_scheduler_srv_time_update(struct bt_mesh_scheduler_srv *srv)
 	}
 
 	for (int idx = 0; idx < BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT; ++idx) {
-		schedule_action(srv, idx);
+		if (has_action(&srv->sch_reg[idx])) {
+			schedule_action(srv, idx);
+		} else {
+			entry_deactivate(srv, idx);
+		}
 	}
 
 	run_scheduler(srv);
@@ -24,13 +24,22 @@
 static struct bt_mesh_sensor *sensor_get(struct bt_mesh_sensor_srv *srv,
 					 uint16_t id)
 {
-	struct bt_mesh_sensor *sensor;
+	size_t lo = 0;
+	size_t hi = srv->sensor_count;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		struct bt_mesh_sensor *sensor = srv->sorted[mid];
 
-	SENSOR_FOR_EACH(&srv->sensors, sensor)
-	{
 		if (sensor->type->id == id) {
 			return sensor;
 		}
+
+		if (sensor->type->id < id) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
 	}
 
 	return NULL;
@@ -319,13 +328,29 @@ respond:
 	return 0;
 }
 
+/* Number of series columns that fit in a single Sensor Series Status message.
+ * The response is sent as a segmented message, so the columns can fill the
+ * whole transport SDU, except for the opcode, property ID and MIC.
+ */
 static uint16_t max_column_count(const struct bt_mesh_sensor_type *sensor)
 {
+	const struct bt_mesh_sensor_format *col_format;
 	uint16_t column_size = 0;
 
 	for (int i = 0; i < sensor->channel_count; i++) {
 		column_size += sensor->channels[i].format->size;
 	}
+
+	/* Columns of sensors with more than two channels are prefixed by their
+	 * start and width, see sensor_column_encode().
+	 */
+	if (sensor->channel_count >= 3) {
+		col_format = bt_mesh_sensor_column_format_get(sensor);
+		if (col_format) {
+			column_size += 2 * col_format->size;
+		}
+	}
+
 	return (BT_MESH_TX_SDU_MAX - BT_MESH_MIC_SHORT - 3) / column_size;
 }
 
@@ -417,6 +442,8 @@ static int handle_series_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx
 		return -EMSGSIZE;
 	}
 
+	uint16_t max_columns = max_column_count(sensor->type);
+
 	for (uint32_t i = 0; i < sensor->series.column_count; ++i) {
 		const struct bt_mesh_sensor_column *col =
 			&sensor->series.columns[i];
@@ -426,6 +453,11 @@ static int handle_series_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx
 			continue;
 		}
 
+		if (!max_columns--) {
+			BT_WARN("Not enough room for all columns");
+			break;
+		}
+
 		BT_DBG("Column #%u", i);
 
 		int err = sensor_column_encode(&rsp, srv, sensor, ctx, col);
@@ -866,20 +898,77 @@ static uint16_t min_int_get(const struct bt_mesh_sensor *sensor,
 	return ceiling_fraction(min_int, pub_int);
 }
 
+/** @brief Get the sensor periodic publication interval (in number of publish
+ *         messages).
+ *
+ *  Sensors without a configured cadence state are published with the
+ *  server's base period.
+ *
+ *  @param sensor      Sensor instance
+ *  @param period_div  Server's period divisor
+ *
+ *  @return The periodic publication interval of the sensor measured in number
+ *          of published messages by the server.
+ */
+static uint16_t periodic_int_get(const struct bt_mesh_sensor *sensor,
+				 uint8_t period_div)
+{
+	if (!sensor->state.configured) {
+		return (1U << period_div);
+	}
+
+	return pub_int_get(sensor, period_div);
+}
+
+/** @brief Get the number of publish messages a sensor's periodic publication
+ *         can be brought forward in this publication.
+ *
+ *  Periodic publications are only brought forward if the publication will
+ *  carry the periodic publication of another sensor anyway.
+ *
+ *  @param srv         Server sending the publication.
+ *  @param period_div  Server's original period divisor.
+ *  @param base_period Server's original base period.
+ *
+ *  @return The publication window, in number of published messages.
+ */
+static uint16_t pub_window_get(struct bt_mesh_sensor_srv *srv,
+			       uint8_t period_div, uint32_t base_period)
+{
+	struct bt_mesh_sensor *s;
+
+	if (!CONFIG_BT_MESH_SENSOR_SRV_PUB_WINDOW) {
+		return 0;
+	}
+
+	SENSOR_FOR_EACH(&srv->sensors, s)
+	{
+		uint16_t delta = srv->seq - s->state.seq;
+
+		if (delta >= min_int_get(s, period_div, base_period) &&
+		    delta >= periodic_int_get(s, period_div)) {
+			return CONFIG_BT_MESH_SENSOR_SRV_PUB_WINDOW;
+		}
+	}
+
+	return 0;
+}
+
 /** @brief Conditionally add a sensor value to a publication.
  *
  *  A sensor message will be added to the publication if its minimum interval
  *  has expired and the value is outside its delta threshold or the
- *  publication interval has expired.
+ *  publication interval expires within the publication window.
  *
  *  @param srv         Server sending the publication.
  *  @param s           Sensor to add data of.
  *  @param period_div  Server's original period divisor.
  *  @param base_period Server's original base period.
+ *  @param window      Publication window, see @ref pub_window_get.
  */
 static void pub_msg_add(struct bt_mesh_sensor_srv *srv,
 			struct bt_mesh_sensor *s, uint8_t period_div,
-			uint32_t base_period)
+			uint32_t base_period, uint16_t window)
 {
 	uint16_t min_int = min_int_get(s, period_div, base_period);
 	uint16_t delta = srv->seq - s->state.seq;
@@ -890,7 +979,7 @@ static void pub_msg_add(struct bt_mesh_sensor_srv *srv,
 	}
 
 	if (!s->state.configured &&
-	    (delta < (1 << period_div))) {
+	    (delta + window < periodic_int_get(s, period_div))) {
 		/** Don't publish a sensor value with not configured sensor cadence state more
 		 * frequently than base periodic publication.
 		 */
@@ -906,9 +995,9 @@ static void pub_msg_add(struct bt_mesh_sensor_srv *srv,
 
 	if (s->state.configured) {
 		bool delta_triggered = bt_mesh_sensor_delta_threshold(s, value);
-		uint16_t interval = pub_int_get(s, period_div);
+		uint16_t interval = periodic_int_get(s, period_div);
 
-		if (!delta_triggered && delta < interval) {
+		if (!delta_triggered && delta + window < interval) {
 			return;
 		}
 	}
@@ -946,9 +1035,11 @@ static int update_handler(struct bt_mesh_model *model)
 
 	srv->pub.fast_period = true;
 
+	uint16_t window = pub_window_get(srv, period_div, base_period);
+
 	SENSOR_FOR_EACH(&srv->sensors, s)
 	{
-		pub_msg_add(srv, s, period_div, base_period);
+		pub_msg_add(srv, s, period_div, base_period, window);
 
 		/** Update the publication divisor to a new value. This is needed to take new
 		 * changes in a sensor cadence state, .e.g. when the cadence decreased.
@@ -1000,6 +1091,7 @@ static int sensor_srv_init(struct bt_mesh_model *model)
 		}
 
 		sys_slist_append(&srv->sensors, &best->state.node);
+		srv->sorted[count] = best;
 		BT_DBG("Sensor 0x%04x", best->type->id);
 		min_id = best->type->id + 1;
 	}
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Client side of the asynchronous bluetooth API calls over nRF RPC.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "bluetooth/bluetooth.h"
+#include "bluetooth/gatt.h"
+
+#include "bt_rpc.h"
+#include "bt_rpc_async_client.h"
+#include "bt_rpc_common.h"
+#include "bt_rpc_fast.h"
+#include "serialize.h"
+#include "nrf_rpc_cbor.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(BT_RPC, CONFIG_BT_RPC_LOG_LEVEL);
+
+/* Command ID preceding the arguments of each call. */
+#define CALL_HEADER_SIZE 2
+
+/* Scratchpad size preceding the arguments of the calls which the host decodes
+ * into a scratchpad.
+ */
+#define SCRATCHPAD_HEADER_SIZE 5
+
+/* Null ending the batch. */
+#define BATCH_END_SIZE 1
+
+/* Encoders shared with bt_rpc_gap_client.c and bt_rpc_gatt_client.c. */
+size_t bt_data_buf_size(const struct bt_data *data);
+size_t bt_data_sp_size(const struct bt_data *data);
+void bt_data_enc(struct nrf_rpc_cbor_ctx *encoder, const struct bt_data *data);
+size_t bt_gatt_notify_params_buf_size(const struct bt_gatt_notify_params *data);
+size_t bt_gatt_notify_params_sp_size(const struct bt_gatt_notify_params *data);
+void bt_gatt_notify_params_enc(struct nrf_rpc_cbor_ctx *encoder,
+			       const struct bt_gatt_notify_params *data);
+int bt_rpc_gatt_notify_fast_get(const struct bt_gatt_notify_params *data,
+				struct bt_rpc_fast_notify *notify);
+
+/* Held from bt_rpc_batch_begin() to bt_rpc_batch_end(), and for the duration
+ * of each asynchronous call.
+ */
+static K_MUTEX_DEFINE(batch_mutex);
+
+static struct {
+	struct nrf_rpc_cbor_ctx ctx;
+	size_t used;
+	uint32_t calls;
+	uint32_t depth;
+	/* Thread which opened the batch. */
+	k_tid_t owner;
+} batch;
+
+#if defined(CONFIG_BT_RPC_STATS)
+static struct k_spinlock stats_lock;
+static struct bt_rpc_stats stats;
+
+static uint32_t latency_get(uint32_t start)
+{
+	return k_cyc_to_us_floor32(k_cycle_get_32() - start);
+}
+
+void bt_rpc_stats_sync_call(uint32_t start)
+{
+	uint32_t latency = latency_get(start);
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats.ipc_msgs += 2;
+	stats.sync_calls++;
+	stats.sync_latency_us += latency;
+	stats.sync_latency_max_us = MAX(stats.sync_latency_max_us, latency);
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+static void stats_async_call(uint32_t start)
+{
+	uint32_t latency = latency_get(start);
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats.async_calls++;
+	stats.async_latency_us += latency;
+	stats.async_latency_max_us = MAX(stats.async_latency_max_us, latency);
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+static void stats_batch_sent(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats.ipc_msgs++;
+	stats.batches++;
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+void bt_rpc_stats_get(struct bt_rpc_stats *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	*out = stats;
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+void bt_rpc_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	memset(&stats, 0, sizeof(stats));
+
+	k_spin_unlock(&stats_lock, key);
+}
+#endif /* defined(CONFIG_BT_RPC_STATS) */
+
+static void batch_send(void)
+{
+	if (!batch.calls) {
+		return;
+	}
+
+	ser_encode_null(&batch.ctx);
+
+	nrf_rpc_cbor_evt_no_err(&bt_rpc_grp, BT_RPC_ASYNC_BATCH_RPC_EVT, &batch.ctx);
+
+	batch.calls = 0;
+
+#if defined(CONFIG_BT_RPC_STATS)
+	stats_batch_sent();
+#endif
+}
+
+/* Lock the batch and start encoding a call in it. A call made outside of a
+ * batch gets a batch of its own, sized for it.
+ */
+static struct nrf_rpc_cbor_ctx *async_call_begin(uint8_t cmd_id, size_t buffer_size_max)
+{
+	size_t size = CALL_HEADER_SIZE + buffer_size_max;
+
+	k_mutex_lock(&batch_mutex, K_FOREVER);
+
+	if (batch.calls &&
+	    (batch.used + size + BATCH_END_SIZE > CONFIG_BT_RPC_ASYNC_BATCH_SIZE)) {
+		batch_send();
+	}
+
+	if (!batch.calls) {
+		size_t alloc_size = size + BATCH_END_SIZE;
+
+		if (batch.depth) {
+			alloc_size = MAX(alloc_size, CONFIG_BT_RPC_ASYNC_BATCH_SIZE);
+		}
+
+		NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, batch.ctx, alloc_size);
+		batch.used = 0;
+	}
+
+	batch.used += size;
+	batch.calls++;
+
+	ser_encode_uint(&batch.ctx, cmd_id);
+
+	return &batch.ctx;
+}
+
+static void async_call_end(uint32_t start)
+{
+	if (!batch.depth) {
+		batch_send();
+	}
+
+	k_mutex_unlock(&batch_mutex);
+
+#if defined(CONFIG_BT_RPC_STATS)
+	stats_async_call(start);
+#endif
+}
+
+void bt_rpc_batch_begin(void)
+{
+	k_mutex_lock(&batch_mutex, K_FOREVER);
+
+	if (!batch.depth) {
+		batch.owner = k_current_get();
+	}
+
+	batch.depth++;
+}
+
+void bt_rpc_batch_flush(void)
+{
+	/* Only the owner can see itself here, as the batch is opened and closed
+	 * by the owner with the lock held.
+	 */
+	if (batch.owner != k_current_get()) {
+		return;
+	}
+
+	k_mutex_lock(&batch_mutex, K_FOREVER);
+	batch_send();
+	k_mutex_unlock(&batch_mutex);
+}
+
+int bt_rpc_batch_end(void)
+{
+	k_mutex_lock(&batch_mutex, K_FOREVER);
+
+	if (!batch.depth) {
+		k_mutex_unlock(&batch_mutex);
+		return -EALREADY;
+	}
+
+	batch.depth--;
+
+	if (!batch.depth) {
+		batch_send();
+		batch.owner = NULL;
+	}
+
+	/* Release the lock taken above and the one taken by bt_rpc_batch_begin(). */
+	k_mutex_unlock(&batch_mutex);
+	k_mutex_unlock(&batch_mutex);
+
+	return 0;
+}
+
+#if defined(CONFIG_BT_CONN)
+int bt_rpc_gatt_notify_cb_async(struct bt_conn *conn, struct bt_gatt_notify_params *params)
+{
+	struct nrf_rpc_cbor_ctx *ctx;
+	uint32_t start = k_cycle_get_32();
+	size_t scratchpad_size = 0;
+	size_t buffer_size_max = SCRATCHPAD_HEADER_SIZE + 3;
+
+	if (!params || !params->attr) {
+		return -EINVAL;
+	}
+
+	if (IS_ENABLED(CONFIG_BT_RPC_FAST_ENCODING) && !params->uuid) {
+		struct bt_rpc_fast_notify notify;
+		int err;
+
+		err = bt_rpc_gatt_notify_fast_get(params, &notify);
+		if (err) {
+			return err;
+		}
+
+		ctx = async_call_begin(BT_GATT_NOTIFY_CB_FAST_RPC_CMD,
+				       BT_RPC_FAST_NOTIFY_BUF_SIZE(params->len));
+
+		bt_rpc_encode_bt_conn(ctx, conn);
+		bt_rpc_fast_notify_enc(ctx, &notify);
+
+		async_call_end(start);
+
+		return 0;
+	}
+
+	buffer_size_max += bt_gatt_notify_params_buf_size(params);
+
+	scratchpad_size += bt_gatt_notify_params_sp_size(params);
+
+	ctx = async_call_begin(BT_GATT_NOTIFY_CB_RPC_CMD, buffer_size_max);
+
+	ser_encode_uint(ctx, scratchpad_size);
+	bt_rpc_encode_bt_conn(ctx, conn);
+	bt_gatt_notify_params_enc(ctx, params);
+
+	async_call_end(start);
+
+	return 0;
+}
+#endif /* defined(CONFIG_BT_CONN) */
+
+int bt_rpc_le_adv_update_data_async(const struct bt_data *ad, size_t ad_len,
+				    const struct bt_data *sd, size_t sd_len)
+{
+	struct nrf_rpc_cbor_ctx *ctx;
+	uint32_t start = k_cycle_get_32();
+	size_t scratchpad_size = 0;
+	size_t buffer_size_max = SCRATCHPAD_HEADER_SIZE + 10;
+
+	if ((ad_len && !ad) || (sd_len && !sd)) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < ad_len; i++) {
+		buffer_size_max += bt_data_buf_size(&ad[i]);
+		scratchpad_size += SCRATCHPAD_ALIGN(sizeof(struct bt_data));
+		scratchpad_size += bt_data_sp_size(&ad[i]);
+	}
+	for (size_t i = 0; i < sd_len; i++) {
+		buffer_size_max += bt_data_buf_size(&sd[i]);
+		scratchpad_size += SCRATCHPAD_ALIGN(sizeof(struct bt_data));
+		scratchpad_size += bt_data_sp_size(&sd[i]);
+	}
+
+	ctx = async_call_begin(BT_LE_ADV_UPDATE_DATA_RPC_CMD, buffer_size_max);
+
+	ser_encode_uint(ctx, scratchpad_size);
+	ser_encode_uint(ctx, ad_len);
+
+	for (size_t i = 0; i < ad_len; i++) {
+		bt_data_enc(ctx, &ad[i]);
+	}
+
+	ser_encode_uint(ctx, sd_len);
+
+	for (size_t i = 0; i < sd_len; i++) {
+		bt_data_enc(ctx, &sd[i]);
+	}
+
+	async_call_end(start);
+
+	return 0;
+}
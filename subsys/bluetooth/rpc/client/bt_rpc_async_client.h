@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BT_RPC_ASYNC_CLIENT_H_
+#define BT_RPC_ASYNC_CLIENT_H_
+
+/**
+ * @file
+ * @defgroup bt_rpc_async_client RPC asynchronous calls client API
+ * @{
+ * @brief Internal API for the RPC asynchronous calls batching and statistics.
+ */
+
+#include <zephyr/types.h>
+#include <nrf_rpc_cbor.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Account a completed synchronous call in the call statistics.
+ *
+ * The call must have an asynchronous variant.
+ *
+ * @param[in] start Value of k_cycle_get_32() when the call was made.
+ */
+void bt_rpc_stats_sync_call(uint32_t start);
+
+#if defined(CONFIG_BT_RPC_ASYNC)
+/** @brief Send the batch of asynchronous calls opened by the current thread.
+ *
+ * Does nothing if the current thread has no batch open. The batch stays open,
+ * and the next asynchronous calls start a new one.
+ */
+void bt_rpc_batch_flush(void);
+#else
+static inline void bt_rpc_batch_flush(void)
+{
+}
+#endif /* defined(CONFIG_BT_RPC_ASYNC) */
+
+/** @brief Send a synchronous command to the host.
+ *
+ * Same as nrf_rpc_cbor_cmd_no_err(), but the asynchronous calls batched by
+ * the current thread are sent first, so that the host executes the calls in
+ * the order in which they were made.
+ */
+static inline void bt_rpc_cbor_cmd_no_err(const struct nrf_rpc_group *group, uint8_t cmd,
+					  struct nrf_rpc_cbor_ctx *ctx,
+					  nrf_rpc_cbor_handler_t handler, void *handler_data)
+{
+	bt_rpc_batch_flush();
+	nrf_rpc_cbor_cmd_no_err(group, cmd, ctx, handler, handler_data);
+}
+
+/** @brief Send a synchronous command to the host.
+ *
+ * Same as nrf_rpc_cbor_cmd(), see @ref bt_rpc_cbor_cmd_no_err.
+ */
+static inline int bt_rpc_cbor_cmd(const struct nrf_rpc_group *group, uint8_t cmd,
+				  struct nrf_rpc_cbor_ctx *ctx,
+				  nrf_rpc_cbor_handler_t handler, void *handler_data)
+{
+	bt_rpc_batch_flush();
+	return nrf_rpc_cbor_cmd(group, cmd, ctx, handler, handler_data);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* BT_RPC_ASYNC_CLIENT_H_ */
@@ -8,6 +8,7 @@
 #include "bluetooth/bluetooth.h"
 #include "bluetooth/conn.h"
 
+#include "bt_rpc_async_client.h"
 #include "bt_rpc_common.h"
 #include "serialize.h"
 #include "cbkproxy.h"
@@ -88,8 +89,8 @@ static void bt_conn_remote_update_ref(struct bt_conn *conn, int8_t value)
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	ser_encode_int(&ctx, value);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_REMOTE_UPDATE_REF_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_REMOTE_UPDATE_REF_RPC_CMD,
+			       &ctx, ser_rsp_decode_void, NULL);
 }
 
 static void bt_conn_ref_local(struct bt_conn *conn)
@@ -160,8 +161,8 @@ void bt_conn_foreach(int type, void (*func)(struct bt_conn *conn, void *data),
 	ser_encode_callback(&ctx, func);
 	ser_encode_uint(&ctx, (uintptr_t)data);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_FOREACH_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_FOREACH_RPC_CMD,
+			       &ctx, ser_rsp_decode_void, NULL);
 }
 
 struct bt_conn_lookup_addr_le_rpc_res {
@@ -193,8 +194,8 @@ struct bt_conn *bt_conn_lookup_addr_le(uint8_t id, const bt_addr_le_t *peer)
 	ser_encode_uint(&ctx, id);
 	ser_encode_buffer(&ctx, peer, sizeof(bt_addr_le_t));
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LOOKUP_ADDR_LE_RPC_CMD,
-				&ctx, bt_conn_lookup_addr_le_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LOOKUP_ADDR_LE_RPC_CMD,
+			       &ctx, bt_conn_lookup_addr_le_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -228,8 +229,8 @@ static bool bt_conn_get_dst_out(const struct bt_conn *conn, bt_addr_le_t *dst)
 
 	result.dst = dst;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_GET_DST_OUT_RPC_CMD,
-				&ctx, bt_conn_get_dst_out_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_GET_DST_OUT_RPC_CMD,
+			       &ctx, bt_conn_get_dst_out_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -349,8 +350,8 @@ int bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info)
 	result.conn = (struct bt_conn *)conn;
 	result.info = info;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_GET_INFO_RPC_CMD,
-				&ctx, bt_conn_get_info_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_GET_INFO_RPC_CMD,
+			       &ctx, bt_conn_get_info_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -406,8 +407,8 @@ int bt_conn_get_remote_info(struct bt_conn *conn,
 	result.conn = conn;
 	result.remote_info = remote_info;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_GET_REMOTE_INFO_RPC_CMD,
-				&ctx, bt_conn_get_remote_info_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_GET_REMOTE_INFO_RPC_CMD,
+			       &ctx, bt_conn_get_remote_info_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -440,8 +441,8 @@ int bt_conn_le_param_update(struct bt_conn *conn,
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	bt_le_conn_param_enc(&ctx, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_PARAM_UPDATE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_PARAM_UPDATE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -466,8 +467,8 @@ int bt_conn_le_data_len_update(struct bt_conn *conn,
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	bt_conn_le_data_len_param_enc(&ctx, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_DATA_LEN_UPDATE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_DATA_LEN_UPDATE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -494,8 +495,8 @@ int bt_conn_le_phy_update(struct bt_conn *conn,
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	bt_conn_le_phy_param_enc(&ctx, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_PHY_UPDATE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_PHY_UPDATE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -513,8 +514,8 @@ int bt_conn_disconnect(struct bt_conn *conn, uint8_t reason)
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	ser_encode_uint(&ctx, reason);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_DISCONNECT_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_DISCONNECT_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -569,8 +570,8 @@ int bt_conn_le_create(const bt_addr_le_t *peer,
 
 	result.conn = conn;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_CREATE_RPC_CMD,
-				&ctx, bt_conn_le_create_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_CREATE_RPC_CMD,
+			       &ctx, bt_conn_le_create_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -588,8 +589,8 @@ int bt_conn_le_create_auto(const struct bt_conn_le_create_param *create_param,
 	bt_conn_le_create_param_enc(&ctx, create_param);
 	bt_le_conn_param_enc(&ctx, conn_param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_CREATE_AUTO_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_CREATE_AUTO_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -602,8 +603,8 @@ int bt_conn_create_auto_stop(void)
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CREATE_AUTO_STOP_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CREATE_AUTO_STOP_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -629,8 +630,8 @@ int bt_le_set_auto_conn(const bt_addr_le_t *addr,
 		bt_le_conn_param_enc(&ctx, param);
 	}
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SET_AUTO_CONN_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SET_AUTO_CONN_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -649,8 +650,8 @@ int bt_conn_set_security(struct bt_conn *conn, bt_security_t sec)
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	ser_encode_uint(&ctx, (uint32_t)sec);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_SET_SECURITY_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_SET_SECURITY_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -680,8 +681,8 @@ bt_security_t bt_conn_get_security(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_GET_SECURITY_RPC_CMD,
-				&ctx, bt_conn_get_security_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_GET_SECURITY_RPC_CMD,
+			       &ctx, bt_conn_get_security_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -696,8 +697,8 @@ uint8_t bt_conn_enc_key_size(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_ENC_KEY_SIZE_RPC_CMD,
-				&ctx, ser_rsp_decode_u8, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_ENC_KEY_SIZE_RPC_CMD,
+			       &ctx, ser_rsp_decode_u8, &result);
 
 	return result;
 }
@@ -1146,8 +1147,8 @@ static void bt_conn_cb_register_on_remote(void)
 
 		NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-		nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CB_REGISTER_ON_REMOTE_RPC_CMD,
-					&ctx, ser_rsp_decode_void, NULL);
+		bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CB_REGISTER_ON_REMOTE_RPC_CMD,
+				       &ctx, ser_rsp_decode_void, NULL);
 	}
 }
 
@@ -1171,8 +1172,8 @@ void bt_set_bondable(bool enable)
 
 	ser_encode_bool(&ctx, enable);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_SET_BONDABLE_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_SET_BONDABLE_RPC_CMD,
+			       &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_set_oob_data_flag(bool enable)
@@ -1184,8 +1185,8 @@ void bt_set_oob_data_flag(bool enable)
 
 	ser_encode_bool(&ctx, enable);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_SET_OOB_DATA_FLAG_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_SET_OOB_DATA_FLAG_RPC_CMD,
+			       &ctx, ser_rsp_decode_void, NULL);
 }
 
 #if !defined(CONFIG_BT_SMP_SC_PAIR_ONLY)
@@ -1208,8 +1209,8 @@ int bt_le_oob_set_legacy_tk(struct bt_conn *conn, const uint8_t *tk)
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	ser_encode_buffer(&ctx, tk, tk_size);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_OOB_SET_LEGACY_TK_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_OOB_SET_LEGACY_TK_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1264,8 +1265,8 @@ int bt_le_oob_set_sc_data(struct bt_conn *conn,
 		bt_le_oob_sc_data_enc(&ctx, oobd_remote);
 	}
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_OOB_SET_SC_DATA_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_OOB_SET_SC_DATA_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1316,8 +1317,8 @@ int bt_le_oob_get_sc_data(struct bt_conn *conn,
 	result.oobd_local = oobd_local;
 	result.oobd_remote = oobd_remote;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_OOB_GET_SC_DATA_RPC_CMD,
-				&ctx, bt_le_oob_get_sc_data_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_OOB_GET_SC_DATA_RPC_CMD,
+			       &ctx, bt_le_oob_get_sc_data_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -1334,8 +1335,8 @@ int bt_passkey_set(unsigned int passkey)
 
 	ser_encode_uint(&ctx, passkey);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_PASSKEY_SET_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_PASSKEY_SET_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1573,8 +1574,8 @@ int bt_conn_auth_cb_register_on_remote(uint16_t flags)
 
 	ser_encode_uint(&ctx, flags);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_CB_REGISTER_ON_REMOTE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_CB_REGISTER_ON_REMOTE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1714,8 +1715,8 @@ int bt_conn_auth_info_cb_register_on_remote(uint16_t flags)
 
 	ser_encode_uint(&ctx, flags);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_INFO_CB_REGISTER_ON_REMOTE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_INFO_CB_REGISTER_ON_REMOTE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1761,8 +1762,8 @@ int bt_conn_auth_info_cb_unregister_on_remote(void)
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_INFO_CB_UNREGISTER_ON_REMOTE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_INFO_CB_UNREGISTER_ON_REMOTE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1798,8 +1799,8 @@ int bt_conn_auth_passkey_entry(struct bt_conn *conn, unsigned int passkey)
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	ser_encode_uint(&ctx, passkey);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_PASSKEY_ENTRY_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_PASSKEY_ENTRY_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1814,8 +1815,8 @@ int bt_conn_auth_cancel(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_CANCEL_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_CANCEL_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1830,8 +1831,8 @@ int bt_conn_auth_passkey_confirm(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_PASSKEY_CONFIRM_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_PASSKEY_CONFIRM_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1846,8 +1847,8 @@ int bt_conn_auth_pairing_confirm(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_PAIRING_CONFIRM_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_PAIRING_CONFIRM_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -10,6 +10,7 @@
 
 #include "bluetooth/crypto.h"
 
+#include "bt_rpc_async_client.h"
 #include "bt_rpc_common.h"
 #include "serialize.h"
 #include "nrf_rpc_cbor.h"
@@ -46,7 +47,7 @@ int bt_rand(void *buf, size_t len)
 	result.len = len;
 	result.buf = buf;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RAND_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RAND_RPC_CMD,
 		&ctx, bt_rand_rpc_rsp, &result);
 
 	return result.result;
@@ -81,7 +82,7 @@ int bt_encrypt_le(const uint8_t key[16], const uint8_t plaintext[16],
 	ser_encode_buffer(&ctx, plaintext, plaintext_size);
 	ser_encode_buffer(&ctx, enc_data, enc_data_size);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ENCRYPT_LE_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ENCRYPT_LE_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -116,7 +117,7 @@ int bt_encrypt_be(const uint8_t key[16], const uint8_t plaintext[16],
 	ser_encode_buffer(&ctx, plaintext, plaintext_size);
 	ser_encode_buffer(&ctx, enc_data, enc_data_size);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ENCRYPT_BE_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ENCRYPT_BE_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -186,7 +187,7 @@ int bt_ccm_decrypt(const uint8_t key[16], uint8_t nonce[13], const uint8_t *enc_
 	result.len = len;
 	result.plaintext = plaintext;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CCM_DECRYPT_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CCM_DECRYPT_RPC_CMD,
 		&ctx, bt_ccm_decrypt_rpc_rsp, &result);
 
 	return result.result;
@@ -254,7 +255,7 @@ int bt_ccm_encrypt(const uint8_t key[16], uint8_t nonce[13], const uint8_t *enc_
 	result.len = len;
 	result.plaintext = plaintext;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CCM_ENCRYPT_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CCM_ENCRYPT_RPC_CMD,
 		&ctx, bt_ccm_encrypt_rpc_rsp, &result);
 
 	return result.result;
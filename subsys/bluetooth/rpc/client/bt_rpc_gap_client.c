@@ -12,6 +12,7 @@
 #include <zephyr/settings/settings.h>
 
 
+#include "bt_rpc_async_client.h"
 #include "bt_rpc_gatt_client.h"
 #include "bt_rpc_conn_client.h"
 #include "bt_rpc_common.h"
@@ -61,8 +62,8 @@ static void bt_rpc_get_check_list(uint8_t *data, size_t size)
 	result.size = size;
 	result.data = data;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GET_CHECK_LIST_RPC_CMD,
-				&ctx, bt_rpc_get_check_list_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GET_CHECK_LIST_RPC_CMD,
+			       &ctx, bt_rpc_get_check_list_rpc_rsp, &result);
 }
 
 static void validate_config(void)
@@ -118,8 +119,8 @@ int bt_enable(bt_ready_cb_t cb)
 
 	ser_encode_callback(&ctx, cb);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ENABLE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ENABLE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	/* In case if the Bluetooth was disabled, we don't need to init again
 	 * dependencies.
@@ -160,7 +161,7 @@ int bt_disable(void)
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_DISABLE_RPC_CMD, &ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_DISABLE_RPC_CMD, &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -173,8 +174,8 @@ bool bt_is_ready(void)
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_IS_READY_RPC_CMD, &ctx, ser_rsp_decode_bool,
-				&result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_IS_READY_RPC_CMD, &ctx, ser_rsp_decode_bool,
+			       &result);
 
 	return result;
 }
@@ -198,8 +199,8 @@ int bt_set_name(const char *name)
 
 	ser_encode_str(&ctx, name, name_strlen);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_SET_NAME_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_SET_NAME_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 #else
@@ -242,8 +243,8 @@ static bool bt_get_name_out(char *name, size_t size)
 	result.size = size;
 	result.name = name;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GET_NAME_OUT_RPC_CMD,
-				&ctx, bt_get_name_out_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GET_NAME_OUT_RPC_CMD,
+			       &ctx, bt_get_name_out_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -276,8 +277,8 @@ int bt_set_appearance(uint16_t new_appearance)
 
 	ser_encode_uint(&ctx, new_appearance);
 
-	nrf_rpc_cbor_cmd(&bt_rpc_grp, BT_SET_APPEARANCE_RPC_CMD, &ctx, ser_rsp_decode_u16,
-			 &result);
+	bt_rpc_cbor_cmd(&bt_rpc_grp, BT_SET_APPEARANCE_RPC_CMD, &ctx, ser_rsp_decode_u16,
+			&result);
 
 	return result;
 }
@@ -290,8 +291,8 @@ static uint16_t bt_get_appearance_from_remote(void)
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd(&bt_rpc_grp, BT_GET_APPEARANCE_RPC_CMD, &ctx, ser_rsp_decode_u16,
-			 &appearance);
+	bt_rpc_cbor_cmd(&bt_rpc_grp, BT_GET_APPEARANCE_RPC_CMD, &ctx, ser_rsp_decode_u16,
+			&appearance);
 
 	return appearance;
 }
@@ -338,8 +339,8 @@ void bt_id_get(bt_addr_le_t *addrs, size_t *count)
 	result.count = count;
 	result.addrs = addrs;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ID_GET_RPC_CMD,
-				&ctx, bt_id_get_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ID_GET_RPC_CMD,
+			       &ctx, bt_id_get_rpc_rsp, &result);
 }
 
 struct bt_id_create_rpc_res {
@@ -382,8 +383,8 @@ int bt_id_create(bt_addr_le_t *addr, uint8_t *irk)
 	result.addr = addr;
 	result.irk = irk;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ID_CREATE_RPC_CMD,
-				&ctx, bt_id_create_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ID_CREATE_RPC_CMD,
+			       &ctx, bt_id_create_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -429,8 +430,8 @@ int bt_id_reset(uint8_t id, bt_addr_le_t *addr, uint8_t *irk)
 	result.addr = addr;
 	result.irk = irk;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ID_RESET_RPC_CMD,
-				&ctx, bt_id_reset_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ID_RESET_RPC_CMD,
+			       &ctx, bt_id_reset_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -445,8 +446,8 @@ int bt_id_delete(uint8_t id)
 
 	ser_encode_uint(&ctx, id);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ID_DELETE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ID_DELETE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -604,8 +605,8 @@ int bt_le_adv_start(const struct bt_le_adv_param *param,
 		bt_data_enc(&ctx, &sd[i]);
 	}
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_ADV_START_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_ADV_START_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -618,6 +619,9 @@ int bt_le_adv_update_data(const struct bt_data *ad, size_t ad_len,
 	int result;
 	size_t scratchpad_size = 0;
 	size_t buffer_size_max = 15;
+#if defined(CONFIG_BT_RPC_STATS)
+	uint32_t start = k_cycle_get_32();
+#endif
 
 	for (size_t i = 0; i < ad_len; i++) {
 		buffer_size_max += bt_data_buf_size(&ad[i]);
@@ -644,8 +648,12 @@ int bt_le_adv_update_data(const struct bt_data *ad, size_t ad_len,
 		bt_data_enc(&ctx, &sd[i]);
 	}
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_ADV_UPDATE_DATA_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_ADV_UPDATE_DATA_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
+
+#if defined(CONFIG_BT_RPC_STATS)
+	bt_rpc_stats_sync_call(start);
+#endif
 
 	return result;
 }
@@ -658,8 +666,8 @@ int bt_le_adv_stop(void)
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_ADV_STOP_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_ADV_STOP_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -835,8 +843,8 @@ int bt_le_ext_adv_create(const struct bt_le_adv_param *param,
 
 	result.adv = adv;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_CREATE_RPC_CMD,
-				&ctx, bt_le_ext_adv_create_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_CREATE_RPC_CMD,
+			       &ctx, bt_le_ext_adv_create_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -860,8 +868,8 @@ int bt_le_ext_adv_start(struct bt_le_ext_adv *adv,
 	ser_encode_uint(&ctx, (uintptr_t)adv);
 	bt_le_ext_adv_start_param_enc(&ctx, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_START_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_START_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -877,8 +885,8 @@ int bt_le_ext_adv_stop(struct bt_le_ext_adv *adv)
 
 	ser_encode_uint(&ctx, (uintptr_t)adv);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_STOP_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_STOP_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -920,8 +928,8 @@ int bt_le_ext_adv_set_data(struct bt_le_ext_adv *adv,
 		bt_data_enc(&ctx, &sd[i]);
 	}
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_SET_DATA_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_SET_DATA_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -944,8 +952,8 @@ int bt_le_ext_adv_update_param(struct bt_le_ext_adv *adv,
 	ser_encode_uint(&ctx, (uintptr_t)adv);
 	bt_le_adv_param_enc(&ctx, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_UPDATE_PARAM_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_UPDATE_PARAM_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -960,8 +968,8 @@ int bt_le_ext_adv_delete(struct bt_le_ext_adv *adv)
 
 	ser_encode_uint(&ctx, (uintptr_t)adv);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_DELETE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_DELETE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -976,8 +984,8 @@ uint8_t bt_le_ext_adv_get_index(struct bt_le_ext_adv *adv)
 
 	ser_encode_uint(&ctx, (uintptr_t)adv);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_GET_INDEX_RPC_CMD,
-				&ctx, ser_rsp_decode_u8, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_GET_INDEX_RPC_CMD,
+			       &ctx, ser_rsp_decode_u8, &result);
 
 	return result;
 }
@@ -1001,8 +1009,8 @@ int bt_le_ext_adv_get_info(const struct bt_le_ext_adv *adv,
 	ser_encode_uint(&ctx, (uintptr_t)adv);
 	bt_le_ext_adv_info_enc(&ctx, info);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_GET_INFO_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_GET_INFO_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1035,8 +1043,8 @@ int bt_le_ext_adv_oob_get_local(struct bt_le_ext_adv *adv,
 
 	result.oob = oob;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_OOB_GET_LOCAL_RPC_CMD,
-				&ctx, bt_le_ext_adv_oob_get_local_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_OOB_GET_LOCAL_RPC_CMD,
+			       &ctx, bt_le_ext_adv_oob_get_local_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -1064,8 +1072,8 @@ int bt_le_per_adv_set_param(struct bt_le_ext_adv *adv,
 	ser_encode_uint(&ctx, (uintptr_t)adv);
 	bt_le_per_adv_param_enc(&ctx, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SET_PARAM_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SET_PARAM_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1093,8 +1101,8 @@ int bt_le_per_adv_set_data(const struct bt_le_ext_adv *adv,
 		bt_data_enc(&ctx, &ad[i]);
 	}
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SET_DATA_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SET_DATA_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1109,8 +1117,8 @@ int bt_le_per_adv_start(struct bt_le_ext_adv *adv)
 
 	ser_encode_uint(&ctx, (uintptr_t)adv);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_START_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_START_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1125,8 +1133,8 @@ int bt_le_per_adv_stop(struct bt_le_ext_adv *adv)
 
 	ser_encode_uint(&ctx, (uintptr_t)adv);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_STOP_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_STOP_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1146,8 +1154,8 @@ int bt_le_per_adv_set_info_transfer(const struct bt_le_ext_adv *adv,
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	ser_encode_uint(&ctx, service_data);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SET_INFO_TRANSFER_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SET_INFO_TRANSFER_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1165,8 +1173,8 @@ uint8_t bt_le_per_adv_sync_get_index(struct bt_le_per_adv_sync *per_adv_sync)
 
 	ser_encode_uint(&ctx, (uintptr_t)per_adv_sync);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_GET_INDEX_RPC_CMD,
-				&ctx, ser_rsp_decode_u8, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_GET_INDEX_RPC_CMD,
+			       &ctx, ser_rsp_decode_u8, &result);
 
 	return result;
 }
@@ -1220,8 +1228,8 @@ int bt_le_per_adv_sync_create(const struct bt_le_per_adv_sync_param *param,
 
 	result.out_sync = out_sync;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_CREATE_RPC_CMD,
-				&ctx, bt_le_per_adv_sync_create_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_CREATE_RPC_CMD,
+			       &ctx, bt_le_per_adv_sync_create_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -1236,8 +1244,8 @@ int bt_le_per_adv_sync_delete(struct bt_le_per_adv_sync *per_adv_sync)
 
 	ser_encode_uint(&ctx, (uintptr_t)per_adv_sync);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_DELETE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_DELETE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1251,8 +1259,8 @@ void bt_le_per_adv_sync_cb_register_on_remote(void)
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_CB_REGISTER_ON_REMOTE_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_CB_REGISTER_ON_REMOTE_RPC_CMD,
+			       &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_le_per_adv_sync_cb_register(struct bt_le_per_adv_sync_cb *cb)
@@ -1278,8 +1286,8 @@ int bt_le_per_adv_sync_recv_enable(struct bt_le_per_adv_sync *per_adv_sync)
 
 	ser_encode_uint(&ctx, (uintptr_t)per_adv_sync);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_RECV_ENABLE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_RECV_ENABLE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1294,8 +1302,8 @@ int bt_le_per_adv_sync_recv_disable(struct bt_le_per_adv_sync *per_adv_sync)
 
 	ser_encode_uint(&ctx, (uintptr_t)per_adv_sync);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_RECV_DISABLE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_RECV_DISABLE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1315,8 +1323,8 @@ int bt_le_per_adv_sync_transfer(const struct bt_le_per_adv_sync *per_adv_sync,
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	ser_encode_uint(&ctx, service_data);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_TRANSFER_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_TRANSFER_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1342,8 +1350,8 @@ int bt_le_per_adv_sync_transfer_subscribe(
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	bt_le_per_adv_sync_transfer_param_enc(&ctx, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_TRANSFER_SUBSCRIBE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_TRANSFER_SUBSCRIBE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1358,8 +1366,8 @@ int bt_le_per_adv_sync_transfer_unsubscribe(const struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_TRANSFER_UNSUBSCRIBE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_TRANSFER_UNSUBSCRIBE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1378,8 +1386,8 @@ int bt_le_per_adv_list_add(const bt_addr_le_t *addr, uint8_t sid)
 	ser_encode_buffer(&ctx, addr, sizeof(bt_addr_le_t));
 	ser_encode_uint(&ctx, sid);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_LIST_ADD_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_LIST_ADD_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1397,8 +1405,8 @@ int bt_le_per_adv_list_remove(const bt_addr_le_t *addr, uint8_t sid)
 	ser_encode_buffer(&ctx, addr, sizeof(bt_addr_le_t));
 	ser_encode_uint(&ctx, sid);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_LIST_REMOVE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_LIST_REMOVE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1411,8 +1419,8 @@ int bt_le_per_adv_list_clear(void)
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_LIST_CLEAR_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_LIST_CLEAR_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1642,8 +1650,8 @@ int bt_le_scan_start(const struct bt_le_scan_param *param, bt_le_scan_cb_t cb)
 	bt_le_scan_param_enc(&ctx, param);
 	ser_encode_callback(&ctx, cb);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SCAN_START_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SCAN_START_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1656,8 +1664,8 @@ int bt_le_scan_stop(void)
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SCAN_STOP_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SCAN_STOP_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1751,8 +1759,8 @@ static void bt_le_scan_cb_register_on_remote(void)
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SCAN_CB_REGISTER_ON_REMOTE_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SCAN_CB_REGISTER_ON_REMOTE_RPC_CMD,
+			       &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_le_scan_cb_register(struct bt_le_scan_cb *cb)
@@ -1782,8 +1790,8 @@ int bt_le_filter_accept_list_add(const bt_addr_le_t *addr)
 
 	ser_encode_buffer(&ctx, addr, sizeof(bt_addr_le_t));
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_FILTER_ACCEPT_LIST_ADD_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_FILTER_ACCEPT_LIST_ADD_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1801,8 +1809,8 @@ int bt_le_filter_accept_list_remove(const bt_addr_le_t *addr)
 
 	ser_encode_buffer(&ctx, addr, sizeof(bt_addr_le_t));
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_FILTER_ACCEPT_LIST_REMOVE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_FILTER_ACCEPT_LIST_REMOVE_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1816,8 +1824,8 @@ int bt_le_filter_accept_list_clear(void)
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_ACCEPT_LIST_CLEAR_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_ACCEPT_LIST_CLEAR_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1841,8 +1849,8 @@ int bt_le_set_chan_map(uint8_t chan_map[5])
 
 	ser_encode_buffer(&ctx, chan_map, chan_map_size);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SET_CHAN_MAP_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SET_CHAN_MAP_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1905,8 +1913,8 @@ int bt_le_oob_get_local(uint8_t id, struct bt_le_oob *oob)
 
 	result.oob = oob;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_OOB_GET_LOCAL_RPC_CMD,
-				&ctx, bt_le_oob_get_local_rpc_rsp, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_OOB_GET_LOCAL_RPC_CMD,
+			       &ctx, bt_le_oob_get_local_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -1978,8 +1986,8 @@ int bt_unpair(uint8_t id, const bt_addr_le_t *addr)
 	ser_encode_uint(&ctx, id);
 	ser_encode_buffer(&ctx, addr, sizeof(bt_addr_le_t));
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_UNPAIR_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_UNPAIR_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -2033,8 +2041,8 @@ void bt_foreach_bond(uint8_t id, void (*func)(const struct bt_bond_info *info,
 	ser_encode_callback(&ctx, func);
 	ser_encode_uint(&ctx, (uintptr_t)user_data);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_FOREACH_BOND_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_FOREACH_BOND_RPC_CMD,
+			       &ctx, ser_rsp_decode_void, NULL);
 }
 #endif /* (defined(CONFIG_BT_CONN) && defined(CONFIG_BT_SMP)) */
 
@@ -2056,8 +2064,8 @@ static int rpc_settings_set(const char *key, size_t len_rd, settings_read_cb rea
 	if (!strncmp(key, "network", len)) {
 		NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-		nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_SETTINGS_LOAD_RPC_CMD,
-					&ctx, ser_rsp_decode_void, NULL);
+		bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_SETTINGS_LOAD_RPC_CMD,
+				       &ctx, ser_rsp_decode_void, NULL);
 
 	}
 
@@ -14,6 +14,8 @@
 #include "bluetooth/gatt.h"
 
 #include "bt_rpc_common.h"
+#include "bt_rpc_async_client.h"
+#include "bt_rpc_fast.h"
 #include "bt_rpc_gatt_common.h"
 #include "serialize.h"
 #include "cbkproxy.h"
@@ -368,7 +370,7 @@ static int bt_rpc_gatt_start_service(uint8_t service_index, size_t attr_count)
 	ser_encode_uint(&ctx, service_index);
 	ser_encode_uint(&ctx, attr_count);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GATT_START_SERVICE_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GATT_START_SERVICE_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -444,7 +446,7 @@ static int bt_rpc_gatt_send_simple_attr(uint8_t special_attr, const struct bt_uu
 	ser_encode_uint(&ctx, special_attr);
 	ser_encode_uint(&ctx, data);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GATT_SEND_SIMPLE_ATTR_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GATT_SEND_SIMPLE_ATTR_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -503,7 +505,7 @@ static int bt_rpc_gatt_send_desc_attr(uint8_t special_attr, uint16_t param, uint
 	ser_encode_uint(&ctx, size);
 	ser_encode_buffer(&ctx, buffer, buffer_size);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GATT_SEND_DESC_ATTR_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GATT_SEND_DESC_ATTR_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -560,7 +562,7 @@ static int bt_rpc_gatt_end_service(void)
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GATT_END_SERVICE_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GATT_END_SERVICE_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -705,8 +707,8 @@ int bt_gatt_service_unregister(struct bt_gatt_service *svc)
 
 	ser_encode_uint(&ctx, svc_index);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GATT_SERVICE_UNREGISTER_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GATT_SERVICE_UNREGISTER_RPC_CMD,
+			       &ctx, ser_rsp_decode_i32, &result);
 
 	if (result) {
 		return result;
@@ -754,6 +756,60 @@ void bt_gatt_notify_params_enc(struct nrf_rpc_cbor_ctx *encoder,
 	}
 }
 
+int bt_rpc_gatt_notify_fast_get(const struct bt_gatt_notify_params *data,
+				struct bt_rpc_fast_notify *notify)
+{
+	uint32_t attr_index;
+	int slot;
+	int err;
+
+	err = bt_rpc_gatt_attr_to_index(data->attr, &attr_index);
+	if (err || (attr_index > UINT16_MAX) || (data->len > UINT16_MAX)) {
+		return -EINVAL;
+	}
+
+	notify->attr_index = attr_index;
+	notify->func_slot = BT_RPC_FAST_NO_CALLBACK;
+	notify->user_data = (uintptr_t)data->user_data;
+	notify->data = data->data;
+	notify->len = data->len;
+
+	if (data->func) {
+		slot = cbkproxy_in_set(data->func);
+		if (slot < 0) {
+			return -ENOMEM;
+		}
+
+		notify->func_slot = slot;
+	}
+
+	return 0;
+}
+
+static int bt_gatt_notify_cb_fast(struct bt_conn *conn,
+				  struct bt_gatt_notify_params *params)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	struct bt_rpc_fast_notify notify;
+	int result;
+	size_t buffer_size_max = BT_RPC_FAST_NOTIFY_BUF_SIZE(params->len);
+
+	result = bt_rpc_gatt_notify_fast_get(params, &notify);
+	if (result) {
+		return result;
+	}
+
+	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
+
+	bt_rpc_encode_bt_conn(&ctx, conn);
+	bt_rpc_fast_notify_enc(&ctx, &notify);
+
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_NOTIFY_CB_FAST_RPC_CMD,
+		&ctx, ser_rsp_decode_i32, &result);
+
+	return result;
+}
+
 int bt_gatt_notify_cb(struct bt_conn *conn,
 		      struct bt_gatt_notify_params *params)
 {
@@ -761,6 +817,14 @@ int bt_gatt_notify_cb(struct bt_conn *conn,
 	int result;
 	size_t scratchpad_size = 0;
 	size_t buffer_size_max = 8;
+#if defined(CONFIG_BT_RPC_STATS)
+	uint32_t start = k_cycle_get_32();
+#endif
+
+	if (IS_ENABLED(CONFIG_BT_RPC_FAST_ENCODING) && !params->uuid) {
+		result = bt_gatt_notify_cb_fast(conn, params);
+		goto done;
+	}
 
 	buffer_size_max += bt_gatt_notify_params_buf_size(params);
 
@@ -772,9 +836,14 @@ int bt_gatt_notify_cb(struct bt_conn *conn,
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	bt_gatt_notify_params_enc(&ctx, params);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_NOTIFY_CB_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_NOTIFY_CB_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
+done:
+#if defined(CONFIG_BT_RPC_STATS)
+	bt_rpc_stats_sync_call(start);
+#endif
+
 	return result;
 }
 
@@ -853,7 +922,7 @@ int bt_gatt_indicate(struct bt_conn *conn, struct bt_gatt_indicate_params *param
 	bt_gatt_indicate_params_enc(&ctx, params);
 	ser_encode_uint(&ctx, params_addr);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_INDICATE_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_INDICATE_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -930,7 +999,7 @@ bool bt_gatt_is_subscribed(struct bt_conn *conn,
 	bt_rpc_encode_gatt_attr(&ctx, attr);
 	ser_encode_uint(&ctx, ccc_value);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_IS_SUBSCRIBED_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_IS_SUBSCRIBED_RPC_CMD,
 		&ctx, ser_rsp_decode_bool, &result);
 
 	return result;
@@ -946,7 +1015,7 @@ uint16_t bt_gatt_get_mtu(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_GET_MTU_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_GET_MTU_RPC_CMD,
 		&ctx, ser_rsp_decode_u16, &result);
 
 	return result;
@@ -994,7 +1063,7 @@ int bt_gatt_exchange_mtu(struct bt_conn *conn,
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	ser_encode_uint(&ctx, (uintptr_t)params);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_EXCHANGE_MTU_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_EXCHANGE_MTU_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -1046,7 +1115,7 @@ uint16_t bt_gatt_attr_get_handle(const struct bt_gatt_attr *attr)
 
 	bt_rpc_encode_gatt_attr(&ctx, attr);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_ATTR_GET_HANDLE_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_ATTR_GET_HANDLE_RPC_CMD,
 		&ctx, ser_rsp_decode_u16, &result);
 
 	return result;
@@ -1093,8 +1162,8 @@ static void bt_le_gatt_cb_register_on_remote(void)
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_GATT_CB_REGISTER_ON_REMOTE_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_GATT_CB_REGISTER_ON_REMOTE_RPC_CMD,
+			       &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_gatt_cb_register(struct bt_gatt_cb *cb)
@@ -1169,7 +1238,7 @@ int bt_gatt_discover(struct bt_conn *conn, struct bt_gatt_discover_params *param
 	bt_gatt_discover_params_enc(&ctx, params);
 	ser_encode_uint(&ctx, (uintptr_t)params);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_DISCOVER_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_DISCOVER_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -1292,7 +1361,7 @@ int bt_gatt_read(struct bt_conn *conn, struct bt_gatt_read_params *params)
 	bt_gatt_read_params_enc(&ctx, params);
 	ser_encode_uint(&ctx, (uintptr_t)params);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_READ_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_READ_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -1360,7 +1429,7 @@ int bt_gatt_write(struct bt_conn *conn, struct bt_gatt_write_params *params)
 	bt_gatt_write_params_enc(&ctx, params);
 	ser_encode_uint(&ctx, (uintptr_t)params);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_WRITE_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_WRITE_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -1421,7 +1490,7 @@ int bt_gatt_write_without_response_cb(struct bt_conn *conn, uint16_t handle,
 	ser_encode_callback(&ctx, func);
 	ser_encode_uint(&ctx, (uintptr_t)user_data);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_WRITE_WITHOUT_RESPONSE_CB_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_WRITE_WITHOUT_RESPONSE_CB_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -1469,7 +1538,7 @@ int bt_gatt_subscribe(struct bt_conn *conn,
 	ser_encode_uint(&ctx, (uintptr_t)params);
 	bt_gatt_subscribe_params_enc(&ctx, params);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_SUBSCRIBE_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_SUBSCRIBE_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -1494,7 +1563,7 @@ int bt_gatt_resubscribe(uint8_t id, const bt_addr_le_t *peer,
 	ser_encode_uint(&ctx, (uintptr_t)params);
 	bt_gatt_subscribe_params_enc(&ctx, params);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_RESUBSCRIBE_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_RESUBSCRIBE_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -1512,7 +1581,7 @@ int bt_gatt_unsubscribe(struct bt_conn *conn,
 	bt_rpc_encode_bt_conn(&ctx, conn);
 	ser_encode_uint(&ctx, (uintptr_t)params);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_UNSUBSCRIBE_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GATT_UNSUBSCRIBE_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -1531,7 +1600,7 @@ static int bt_rpc_gatt_subscribe_flag_update(struct bt_gatt_subscribe_params *pa
 	ser_encode_uint(&ctx, flags_bit);
 	ser_encode_int(&ctx, val);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GATT_SUBSCRIBE_FLAG_UPDATE_RPC_CMD,
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GATT_SUBSCRIBE_FLAG_UPDATE_RPC_CMD,
 		&ctx, ser_rsp_decode_i32, &result);
 
 	return result;
@@ -7,6 +7,7 @@
 
 #include <nrf_rpc_cbor.h>
 
+#include "bt_rpc_async_client.h"
 #include "bt_rpc_common.h"
 #include "serialize.h"
 #include "cbkproxy.h"
@@ -27,8 +28,8 @@ bool bt_addr_le_is_bonded(uint8_t id, const bt_addr_le_t *addr)
 
 	ser_encode_uint(&ctx, id);
 	ser_encode_buffer(&ctx, addr, sizeof(bt_addr_le_t));
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ADDR_LE_IS_BONDED_CMD,
-				&ctx, ser_rsp_decode_bool, &result);
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ADDR_LE_IS_BONDED_CMD,
+			       &ctx, ser_rsp_decode_bool, &result);
 
 	return result;
 }
@@ -228,8 +228,8 @@ static const CHECK_LIST_ENTRY_TYPE check_table[] = {
 		CONFIG_BT_GATT_CLIENT,
 		CONFIG_BT_RPC_INTERNAL_FUNCTIONS,
 		CONFIG_BT_DEVICE_APPEARANCE_DYNAMIC,
-		0,
-		0,
+		CONFIG_BT_RPC_ASYNC,
+		CONFIG_BT_RPC_FAST_ENCODING,
 		0,
 		0),
 	CHECK_UINT8(CONFIG_BT_MAX_CONN),
@@ -18,6 +18,7 @@
 #include <zephyr/bluetooth/conn.h>
 #include <zephyr/bluetooth/gatt.h>
 
+#include <nrf_rpc/nrf_rpc_ipc.h>
 #include <nrf_rpc_cbor.h>
 #include <cbkproxy.h>
 
@@ -142,6 +143,8 @@ enum bt_rpc_cmd_from_cli_to_host {
 	BT_CCM_ENCRYPT_RPC_CMD,
 	/* internal.h API */
 	BT_ADDR_LE_IS_BONDED_CMD,
+	/* Fixed-layout encoding, see bt_rpc_fast.h */
+	BT_GATT_NOTIFY_CB_FAST_RPC_CMD,
 };
 
 /** @brief Host commands IDs used in bluetooth API serialization.
@@ -208,6 +211,17 @@ enum bt_rpc_evt_from_host_to_cli {
 	BT_READY_CB_T_CALLBACK_RPC_EVT,
 };
 
+/** @brief Client events IDs used in bluetooth API serialization.
+ *         Those events are sent from the client to the host.
+ */
+enum bt_rpc_evt_from_cli_to_host {
+	/* Batch of asynchronous calls. Each call is encoded as the command ID
+	 * of its synchronous variant followed by the command arguments. The
+	 * batch ends with a null.
+	 */
+	BT_RPC_ASYNC_BATCH_RPC_EVT,
+};
+
 /** @brief Pairing flags IDs. Those flags are used to setup valid callback sets on
  *         the host side.
  */
@@ -241,6 +255,7 @@ typedef void (*bt_le_ext_adv_cb_connected)(struct bt_le_ext_adv *adv,
 typedef void (*bt_le_ext_adv_cb_scanned)(struct bt_le_ext_adv *adv,
 			struct bt_le_ext_adv_scanned_info *info);
 
+NRF_RPC_IPC_TRANSPORT_DECLARE(bt_rpc_tr);
 NRF_RPC_GROUP_DECLARE(bt_rpc_grp);
 
 #if defined(CONFIG_BT_RPC_HOST)
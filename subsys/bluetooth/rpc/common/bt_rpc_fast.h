@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BT_RPC_FAST_H_
+#define BT_RPC_FAST_H_
+
+/**
+ * @file
+ * @defgroup bt_rpc_fast Bluetooth RPC fixed-layout encoding
+ * @{
+ * @brief Fixed-layout encoding of the high-rate Bluetooth RPC commands.
+ *
+ * With @kconfig{CONFIG_BT_RPC_FAST_ENCODING}, the arguments of the commands
+ * listed below are packed into a byte string of a fixed layout, instead of
+ * being encoded field by field. This replaces several CBOR items, each one
+ * encoded and validated separately, by a single one. The commands are:
+ *
+ * - BT_GATT_NOTIFY_CB_FAST_RPC_CMD: @ref bt_gatt_notify_cb without a UUID.
+ *   The connection is encoded as usual, followed by the
+ *   @ref BT_RPC_FAST_NOTIFY_HDR_SIZE bytes long header and the notification
+ *   data in a second byte string.
+ */
+
+#include <zephyr/sys/byteorder.h>
+
+#include <nrf_rpc_cbor.h>
+
+#include "serialize.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Size of the fixed-layout notification header. */
+#define BT_RPC_FAST_NOTIFY_HDR_SIZE 8
+
+/** Callback slot of a notification without a callback. */
+#define BT_RPC_FAST_NO_CALLBACK 0xFFFF
+
+/** Maximum encoded size of a notification, including the connection. */
+#define BT_RPC_FAST_NOTIFY_BUF_SIZE(_len) (15 + (_len))
+
+/** @brief Notification in the fixed-layout encoding. */
+struct bt_rpc_fast_notify {
+	/** Attribute index, see bt_rpc_gatt_attr_to_index(). */
+	uint16_t attr_index;
+
+	/** Callback proxy slot, or @ref BT_RPC_FAST_NO_CALLBACK. */
+	uint16_t func_slot;
+
+	/** User data of the callback. */
+	uint32_t user_data;
+
+	/** Notification data. When decoded, it points into the received
+	 *  packet, and is only valid until the decoding is done.
+	 */
+	const uint8_t *data;
+
+	/** Length of the notification data. */
+	uint16_t len;
+};
+
+/** @brief Encode a notification in the fixed layout.
+ *
+ * @param[in, out] ctx CBOR encoding context.
+ * @param[in] notify Notification to encode.
+ */
+static inline void bt_rpc_fast_notify_enc(struct nrf_rpc_cbor_ctx *ctx,
+					  const struct bt_rpc_fast_notify *notify)
+{
+	uint8_t hdr[BT_RPC_FAST_NOTIFY_HDR_SIZE];
+
+	sys_put_le16(notify->attr_index, &hdr[0]);
+	sys_put_le16(notify->func_slot, &hdr[2]);
+	sys_put_le32(notify->user_data, &hdr[4]);
+
+	ser_encode_buffer(ctx, hdr, sizeof(hdr));
+	ser_encode_buffer(ctx, notify->data, notify->len);
+}
+
+/** @brief Decode a notification in the fixed layout.
+ *
+ * The decoder is put in the invalid state on malformed input.
+ *
+ * @param[in, out] ctx CBOR decoding context.
+ * @param[out] notify Decoded notification.
+ *
+ * @retval true If the notification was decoded.
+ *         Otherwise, false.
+ */
+static inline bool bt_rpc_fast_notify_dec(struct nrf_rpc_cbor_ctx *ctx,
+					  struct bt_rpc_fast_notify *notify)
+{
+	const uint8_t *hdr;
+	size_t size = 0;
+
+	hdr = ser_decode_buffer_ptr_and_size(ctx, &size);
+	if (!hdr || (size != BT_RPC_FAST_NOTIFY_HDR_SIZE)) {
+		ser_decoder_invalid(ctx, ZCBOR_ERR_WRONG_TYPE);
+		return false;
+	}
+
+	notify->attr_index = sys_get_le16(&hdr[0]);
+	notify->func_slot = sys_get_le16(&hdr[2]);
+	notify->user_data = sys_get_le32(&hdr[4]);
+
+	size = 0;
+	notify->data = ser_decode_buffer_ptr_and_size(ctx, &size);
+	if (size > UINT16_MAX) {
+		ser_decoder_invalid(ctx, ZCBOR_ERR_WRONG_TYPE);
+		return false;
+	}
+
+	notify->len = size;
+
+	return ser_decode_valid(ctx);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* BT_RPC_FAST_H_ */
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host side of the asynchronous bluetooth API calls over nRF RPC.
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/gatt.h>
+
+#include <nrf_rpc_cbor.h>
+
+#include "bt_rpc_common.h"
+#include "serialize.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(BT_RPC, CONFIG_BT_RPC_LOG_LEVEL);
+
+/* Decoders shared with bt_rpc_gap_host.c and bt_rpc_gatt_host.c. */
+void bt_data_dec(struct ser_scratchpad *scratchpad, struct bt_data *data);
+void bt_gatt_notify_params_dec(struct ser_scratchpad *scratchpad,
+			       struct bt_gatt_notify_params *data);
+void bt_gatt_notify_fast_dec(struct nrf_rpc_cbor_ctx *ctx, struct bt_gatt_notify_params *data);
+
+static void report_decoding_error(uint8_t cmd_evt_id, void *data)
+{
+	nrf_rpc_err(-EBADMSG, NRF_RPC_ERR_SRC_RECV, &bt_rpc_grp, cmd_evt_id,
+		    NRF_RPC_PACKET_TYPE_EVT);
+}
+
+#if defined(CONFIG_BT_CONN)
+static int bt_gatt_notify_cb_async_call(struct nrf_rpc_cbor_ctx *ctx)
+{
+	struct bt_conn *conn;
+	struct bt_gatt_notify_params params;
+	struct ser_scratchpad scratchpad;
+
+	SER_SCRATCHPAD_DECLARE(&scratchpad, ctx);
+
+	conn = bt_rpc_decode_bt_conn(ctx);
+	bt_gatt_notify_params_dec(&scratchpad, &params);
+
+	if (!ser_decode_valid(ctx)) {
+		return -EBADMSG;
+	}
+
+	return bt_gatt_notify_cb(conn, &params);
+}
+
+/* The call is executed before the decoding is done, so the data can be used
+ * in place. The fixed-layout arguments are not preceded by a scratchpad size.
+ */
+static int bt_gatt_notify_cb_fast_async_call(struct nrf_rpc_cbor_ctx *ctx)
+{
+	struct bt_conn *conn;
+	struct bt_gatt_notify_params params;
+
+	conn = bt_rpc_decode_bt_conn(ctx);
+	bt_gatt_notify_fast_dec(ctx, &params);
+
+	if (!ser_decode_valid(ctx)) {
+		return -EBADMSG;
+	}
+
+	return bt_gatt_notify_cb(conn, &params);
+}
+#endif /* defined(CONFIG_BT_CONN) */
+
+static int bt_le_adv_update_data_async_call(struct nrf_rpc_cbor_ctx *ctx)
+{
+	size_t ad_len;
+	struct bt_data *ad;
+	size_t sd_len;
+	struct bt_data *sd;
+	struct ser_scratchpad scratchpad;
+
+	SER_SCRATCHPAD_DECLARE(&scratchpad, ctx);
+
+	ad_len = ser_decode_uint(ctx);
+	ad = ser_scratchpad_add(&scratchpad, ad_len * sizeof(struct bt_data));
+	if (ad == NULL) {
+		ser_decoder_invalid(ctx, ZCBOR_ERR_NO_PAYLOAD);
+		return -EBADMSG;
+	}
+
+	for (size_t i = 0; i < ad_len; i++) {
+		bt_data_dec(&scratchpad, &ad[i]);
+	}
+
+	sd_len = ser_decode_uint(ctx);
+	sd = ser_scratchpad_add(&scratchpad, sd_len * sizeof(struct bt_data));
+	if (sd == NULL) {
+		ser_decoder_invalid(ctx, ZCBOR_ERR_NO_PAYLOAD);
+		return -EBADMSG;
+	}
+
+	for (size_t i = 0; i < sd_len; i++) {
+		bt_data_dec(&scratchpad, &sd[i]);
+	}
+
+	if (!ser_decode_valid(ctx)) {
+		return -EBADMSG;
+	}
+
+	return bt_le_adv_update_data(ad, ad_len, sd, sd_len);
+}
+
+/* Decode and execute a single call of the batch. The call is executed before
+ * the rest of the batch is decoded, so its data only needs to live in a
+ * scratchpad of its own, declared by the call.
+ */
+static int async_call(uint32_t cmd_id, struct nrf_rpc_cbor_ctx *ctx)
+{
+	switch (cmd_id) {
+#if defined(CONFIG_BT_CONN)
+	case BT_GATT_NOTIFY_CB_RPC_CMD:
+		return bt_gatt_notify_cb_async_call(ctx);
+	case BT_GATT_NOTIFY_CB_FAST_RPC_CMD:
+		return bt_gatt_notify_cb_fast_async_call(ctx);
+#endif /* defined(CONFIG_BT_CONN) */
+	case BT_LE_ADV_UPDATE_DATA_RPC_CMD:
+		return bt_le_adv_update_data_async_call(ctx);
+	default:
+		/* The arguments of an unknown call cannot be skipped. */
+		ser_decoder_invalid(ctx, ZCBOR_ERR_UNKNOWN);
+		return -EBADMSG;
+	}
+}
+
+static void bt_rpc_async_batch_rpc_handler(const struct nrf_rpc_group *group,
+					   struct nrf_rpc_cbor_ctx *ctx, void *handler_data)
+{
+	uint32_t cmd_id;
+	int err;
+
+	while (ser_decode_valid(ctx) && !ser_decode_is_null(ctx)) {
+		cmd_id = ser_decode_uint(ctx);
+
+		err = async_call(cmd_id, ctx);
+		if (err && ser_decode_valid(ctx)) {
+			LOG_WRN("Asynchronous call %u failed (err %d)", cmd_id, err);
+		}
+	}
+
+	if (!ser_decoding_done_and_check(group, ctx)) {
+		report_decoding_error(BT_RPC_ASYNC_BATCH_RPC_EVT, handler_data);
+	}
+}
+
+NRF_RPC_CBOR_EVT_DECODER(bt_rpc_grp, bt_rpc_async_batch, BT_RPC_ASYNC_BATCH_RPC_EVT,
+			 bt_rpc_async_batch_rpc_handler, NULL);
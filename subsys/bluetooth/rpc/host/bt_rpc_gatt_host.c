@@ -11,10 +11,12 @@
 #include <zephyr/bluetooth/gatt.h>
 #include <zephyr/bluetooth/conn.h>
 
+#include <nrf_rpc/nrf_rpc_ipc.h>
 #include <nrf_rpc_cbor.h>
 
 #include "bt_rpc_gatt_common.h"
 #include "bt_rpc_common.h"
+#include "bt_rpc_fast.h"
 #include "serialize.h"
 #include "cbkproxy.h"
 
@@ -826,6 +828,92 @@ decoding_error:
 NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_gatt_notify_cb, BT_GATT_NOTIFY_CB_RPC_CMD,
 	bt_gatt_notify_cb_rpc_handler, NULL);
 
+void bt_gatt_notify_fast_dec(struct nrf_rpc_cbor_ctx *ctx, struct bt_gatt_notify_params *data)
+{
+	struct bt_rpc_fast_notify notify;
+
+	memset(data, 0, sizeof(*data));
+
+	if (!bt_rpc_fast_notify_dec(ctx, &notify)) {
+		return;
+	}
+
+	data->attr = bt_rpc_gatt_index_to_attr(notify.attr_index);
+	data->data = notify.data;
+	data->len = notify.len;
+	data->user_data = (void *)(uintptr_t)notify.user_data;
+
+	if (notify.func_slot != BT_RPC_FAST_NO_CALLBACK) {
+		data->func = (bt_gatt_complete_func_t)cbkproxy_out_get(notify.func_slot,
+							bt_gatt_complete_func_t_encoder);
+		if (!data->func) {
+			ser_decoder_invalid(ctx, ZCBOR_ERR_UNKNOWN);
+		}
+	}
+}
+
+/* The data points into the received packet, which is released when the
+ * decoding is done. Hold the IPC Service buffer of the packet instead, or copy
+ * the data into buf if the backend cannot hold it. Returns the held buffer.
+ */
+const void *bt_gatt_notify_fast_data_keep(struct bt_gatt_notify_params *params, uint8_t *buf)
+{
+	const void *held;
+
+	if (!params->data) {
+		return NULL;
+	}
+
+	if (!nrf_rpc_ipc_rx_hold(&bt_rpc_tr, params->data, &held)) {
+		return held;
+	}
+
+	memcpy(buf, params->data, params->len);
+	params->data = buf;
+
+	return NULL;
+}
+
+static void bt_gatt_notify_cb_fast_rpc_handler(const struct nrf_rpc_group *group,
+					       struct nrf_rpc_cbor_ctx *ctx, void *handler_data)
+{
+	struct bt_conn *conn;
+	struct bt_gatt_notify_params params;
+	const void *held;
+	int result;
+
+	conn = bt_rpc_decode_bt_conn(ctx);
+	bt_gatt_notify_fast_dec(ctx, &params);
+
+	uint8_t data[MAX(params.len, 1)];
+
+	held = bt_gatt_notify_fast_data_keep(&params, data);
+
+	if (!ser_decoding_done_and_check(group, ctx)) {
+		goto decoding_error;
+	}
+
+	/* The data is copied into the ATT PDU. */
+	result = bt_gatt_notify_cb(conn, &params);
+
+	if (held) {
+		nrf_rpc_ipc_rx_release(&bt_rpc_tr, held);
+	}
+
+	ser_rsp_send_int(group, result);
+
+	return;
+decoding_error:
+	if (held) {
+		nrf_rpc_ipc_rx_release(&bt_rpc_tr, held);
+	}
+
+	report_decoding_error(BT_GATT_NOTIFY_CB_FAST_RPC_CMD, handler_data);
+}
+
+NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_gatt_notify_cb_fast, BT_GATT_NOTIFY_CB_FAST_RPC_CMD,
+	bt_gatt_notify_cb_fast_rpc_handler, NULL);
+
 void bt_gatt_indicate_params_dec(struct ser_scratchpad *scratchpad,
 				 struct bt_gatt_indicate_params *data)
 {
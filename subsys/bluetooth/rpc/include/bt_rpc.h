@@ -58,6 +58,119 @@ int bt_rpc_gatt_subscribe_flag_clear(struct bt_gatt_subscribe_params *params, ui
  */
 int bt_rpc_gatt_subscribe_flag_get(struct bt_gatt_subscribe_params *params, uint32_t flags_bit);
 
+#if defined(CONFIG_BT_RPC_ASYNC) || defined(__DOXYGEN__)
+/** @brief Send a notification without waiting for the host.
+ *
+ * Asynchronous variant of @ref bt_gatt_notify_cb. The call is sent to the host
+ * in an nRF RPC event, and the function returns without waiting for the result.
+ * A failure on the host is only logged, use the @a func field of the parameters
+ * to learn when the notification has been sent.
+ *
+ * Available if @kconfig{CONFIG_BT_RPC_ASYNC} is enabled.
+ *
+ * @param conn   Connection object, or NULL to notify all connected peers.
+ * @param params Notification parameters.
+ *
+ * @return 0 in case of success or negative value in case of error.
+ */
+int bt_rpc_gatt_notify_cb_async(struct bt_conn *conn, struct bt_gatt_notify_params *params);
+
+/** @brief Update the advertising data without waiting for the host.
+ *
+ * Asynchronous variant of @ref bt_le_adv_update_data. A failure on the host
+ * is only logged.
+ *
+ * Available if @kconfig{CONFIG_BT_RPC_ASYNC} is enabled.
+ *
+ * @param ad     Data to be used in advertisement packets.
+ * @param ad_len Number of elements in ad.
+ * @param sd     Data to be used in scan response packets.
+ * @param sd_len Number of elements in sd.
+ *
+ * @return 0 in case of success or negative value in case of error.
+ */
+int bt_rpc_le_adv_update_data_async(const struct bt_data *ad, size_t ad_len,
+				    const struct bt_data *sd, size_t sd_len);
+
+/** @brief Start a batch of asynchronous calls.
+ *
+ * The asynchronous calls made by the thread until @ref bt_rpc_batch_end are
+ * collected and sent to the host in a single nRF RPC event, which the host
+ * executes in order. The batch is sent early if the next call does not fit in
+ * @kconfig{CONFIG_BT_RPC_ASYNC_BATCH_SIZE} bytes. Asynchronous calls from other
+ * threads wait until the batch has ended. Batches can be nested, the outermost
+ * @ref bt_rpc_batch_end sends the batch.
+ *
+ * A synchronous call made by the thread while the batch is open first sends
+ * the calls collected so far, so the host executes all calls of the thread in
+ * the order in which they were made. The batch stays open.
+ *
+ * Available if @kconfig{CONFIG_BT_RPC_ASYNC} is enabled.
+ */
+void bt_rpc_batch_begin(void);
+
+/** @brief End a batch of asynchronous calls and send it to the host.
+ *
+ * Available if @kconfig{CONFIG_BT_RPC_ASYNC} is enabled.
+ *
+ * @return 0 in case of success or negative value in case of error.
+ * @retval -EALREADY No batch has been started.
+ */
+int bt_rpc_batch_end(void);
+#endif /* defined(CONFIG_BT_RPC_ASYNC) || defined(__DOXYGEN__) */
+
+#if defined(CONFIG_BT_RPC_STATS) || defined(__DOXYGEN__)
+/** @brief Call statistics of the Bluetooth RPC client.
+ *
+ * The latencies cover the calls with an asynchronous variant, that is
+ * @ref bt_gatt_notify_cb and @ref bt_le_adv_update_data, and their
+ * asynchronous variants. The latency of an asynchronous call is the time the
+ * caller is blocked, which includes waiting for a batch of another thread.
+ */
+struct bt_rpc_stats {
+	/** Number of nRF RPC messages exchanged for the measured calls.
+	 *  A command and its response count as two messages, an event
+	 *  counts as one.
+	 */
+	uint32_t ipc_msgs;
+
+	/** Number of asynchronous call batches sent. */
+	uint32_t batches;
+
+	/** Number of synchronous calls. */
+	uint32_t sync_calls;
+
+	/** Total latency of the synchronous calls in microseconds. */
+	uint64_t sync_latency_us;
+
+	/** Maximum latency of a synchronous call in microseconds. */
+	uint32_t sync_latency_max_us;
+
+	/** Number of asynchronous calls. */
+	uint32_t async_calls;
+
+	/** Total latency of the asynchronous calls in microseconds. */
+	uint64_t async_latency_us;
+
+	/** Maximum latency of an asynchronous call in microseconds. */
+	uint32_t async_latency_max_us;
+};
+
+/** @brief Get the call statistics.
+ *
+ * Available if @kconfig{CONFIG_BT_RPC_STATS} is enabled.
+ *
+ * @param[out] stats Call statistics.
+ */
+void bt_rpc_stats_get(struct bt_rpc_stats *stats);
+
+/** @brief Reset the call statistics.
+ *
+ * Available if @kconfig{CONFIG_BT_RPC_STATS} is enabled.
+ */
+void bt_rpc_stats_reset(void);
+#endif /* defined(CONFIG_BT_RPC_STATS) || defined(__DOXYGEN__) */
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,7 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/sys/byteorder.h>
+#include <stdlib.h>
 #include <string.h>
 #include <bluetooth/scan.h>
 
@@ -47,6 +48,52 @@ struct bt_scan_control {
 	struct bt_scan_filter_match filter_status;
 };
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+/* Address and UUID filters are indexed by open addressing hash tables with
+ * room for at least twice as many entries as there are filters, so that
+ * a lookup always ends on an empty slot. An occupied slot holds the filter
+ * index incremented by one.
+ */
+#define INDEX_SLOT_EMPTY 0
+#define ADDR_INDEX_SIZE (2 * CONFIG_BT_SCAN_ADDRESS_CNT + 1)
+#define UUID_INDEX_SIZE (2 * CONFIG_BT_SCAN_UUID_CNT + 1)
+
+/* Name and short name filters are indexed by prefix tries. Each name adds
+ * at most one node per character, on top of the root node.
+ */
+#define NAME_TRIE_SIZE \
+	(CONFIG_BT_SCAN_NAME_CNT * CONFIG_BT_SCAN_NAME_MAX_LEN + 1)
+#define SHORT_NAME_TRIE_SIZE \
+	(CONFIG_BT_SCAN_SHORT_NAME_CNT * CONFIG_BT_SCAN_SHORT_NAME_MAX_LEN + 1)
+#define TRIE_NONE UINT16_MAX
+
+BUILD_ASSERT((NAME_TRIE_SIZE < TRIE_NONE) && (SHORT_NAME_TRIE_SIZE < TRIE_NONE),
+	     "Too many name filter characters to index");
+
+/* Name prefix trie node. */
+struct name_trie_node {
+	/* First child node. */
+	uint16_t child;
+
+	/* Next node with the same parent. */
+	uint16_t sibling;
+
+	/* Lowest index of the filters whose names pass through this node. */
+	uint16_t first;
+
+	/* Index of the filter whose name ends at this node. */
+	uint16_t term;
+
+	/* Lowest short name minimum length of the filters whose names
+	 * pass through this node.
+	 */
+	uint8_t min_len;
+
+	/* Character leading to this node. */
+	uint8_t c;
+};
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 /* Name filter structure.
  */
 struct bt_scan_name_filter {
@@ -55,6 +102,14 @@ struct bt_scan_name_filter {
 	 */
 	char target_name[CONFIG_BT_SCAN_NAME_CNT][CONFIG_BT_SCAN_NAME_MAX_LEN];
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	/* Prefix trie of the target names. */
+	struct name_trie_node trie[NAME_TRIE_SIZE];
+
+	/* Number of used trie nodes. */
+	uint16_t trie_cnt;
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	/* Name filter counter. */
 	uint8_t cnt;
 
@@ -76,6 +131,14 @@ struct bt_scan_short_name_filter {
 		uint8_t min_len;
 	} name[CONFIG_BT_SCAN_SHORT_NAME_CNT];
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	/* Prefix trie of the target short names. */
+	struct name_trie_node trie[SHORT_NAME_TRIE_SIZE];
+
+	/* Number of used trie nodes. */
+	uint16_t trie_cnt;
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	/* Short name filter counter. */
 	uint8_t cnt;
 
@@ -89,6 +152,11 @@ struct bt_scan_addr_filter {
 	/* Addresses advertised by the peripherals. */
 	bt_addr_le_t target_addr[CONFIG_BT_SCAN_ADDRESS_CNT];
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	/* Hash table of the target addresses. */
+	uint16_t slot[ADDR_INDEX_SIZE];
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	/* Address filter counter. */
 	uint8_t cnt;
 
@@ -120,6 +188,14 @@ struct bt_scan_uuid_filter {
 	 */
 	struct bt_scan_uuid uuid[CONFIG_BT_SCAN_UUID_CNT];
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	/* UUIDs converted to the 128-bit little-endian form. */
+	uint8_t key[CONFIG_BT_SCAN_UUID_CNT][BT_SCAN_UUID_128_SIZE];
+
+	/* Hash table of the UUID keys. */
+	uint16_t slot[UUID_INDEX_SIZE];
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	/* UUID filter counter. */
 	uint8_t cnt;
 
@@ -230,6 +306,53 @@ struct conn_blocklist {
 };
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+#if CONFIG_BT_SCAN_DEDUP
+#define DEDUP_NONE UINT16_MAX
+
+BUILD_ASSERT(CONFIG_BT_SCAN_DEDUP_CACHE_SIZE < DEDUP_NONE);
+
+/* Recently seen advertising report. */
+struct dedup_entry {
+	/* Node in the least recently used list. */
+	sys_dnode_t node;
+
+	/* Advertiser address. */
+	bt_addr_le_t addr;
+
+	/* Hash of the address and advertising data. */
+	uint32_t hash;
+
+	/* Uptime at which the report was last passed on, in milliseconds. */
+	uint32_t reported_at;
+
+	/* Next entry in the same hash bucket. */
+	uint16_t next;
+
+	/* RSSI of the report last passed on. */
+	int8_t rssi;
+
+	/* Set if the entry holds a report. */
+	bool used;
+};
+
+/* Advertising report deduplication cache. */
+struct dedup_cache {
+	/* Cache entries. */
+	struct dedup_entry entry[CONFIG_BT_SCAN_DEDUP_CACHE_SIZE];
+
+	/* First entry of each hash bucket. */
+	uint16_t bucket[CONFIG_BT_SCAN_DEDUP_CACHE_SIZE];
+
+	/* Entries ordered from the most to the least recently seen,
+	 * unused entries last.
+	 */
+	sys_dlist_t lru;
+
+	/* Deduplication statistics. */
+	struct bt_scan_dedup_stats stats;
+};
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 /* Scanning module instance. Options for the different scanning modes.
  * This structure stores all module settings. It is used to enable
  * or disable scanning modes and to configure filters.
@@ -264,6 +387,11 @@ static struct bt_scan {
 	struct conn_blocklist blocklist;
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+#if CONFIG_BT_SCAN_DEDUP
+	/* Advertising report deduplication cache. */
+	struct dedup_cache dedup;
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 } bt_scan;
 
 static sys_slist_t callback_list;
@@ -500,11 +628,392 @@ static void scan_connect_with_target(struct bt_scan_control *control,
 	}
 }
 
+#if CONFIG_BT_SCAN_FILTER_INDEX || CONFIG_BT_SCAN_DEDUP
+#define SCAN_HASH_INIT 2166136261U
+#define SCAN_HASH_PRIME 16777619U
+
+/* FNV-1a hash. */
+static uint32_t scan_hash(const uint8_t *data, size_t len, uint32_t hash)
+{
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ data[i]) * SCAN_HASH_PRIME;
+	}
+
+	return hash;
+}
+
+static uint32_t addr_hash(const bt_addr_le_t *addr, uint32_t hash)
+{
+	hash = scan_hash(&addr->type, sizeof(addr->type), hash);
+
+	return scan_hash(addr->a.val, sizeof(addr->a.val), hash);
+}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX || CONFIG_BT_SCAN_DEDUP */
+
+#if CONFIG_BT_SCAN_DEDUP
+void bt_scan_dedup_clear(void)
+{
+	struct dedup_cache *cache = &bt_scan.dedup;
+
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+
+	sys_dlist_init(&cache->lru);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache->entry); i++) {
+		cache->entry[i].used = false;
+		cache->bucket[i] = DEDUP_NONE;
+		sys_dlist_append(&cache->lru, &cache->entry[i].node);
+	}
+
+	k_mutex_unlock(&scan_mutex);
+}
+
+static void dedup_unlink(struct dedup_cache *cache, uint16_t idx)
+{
+	uint16_t *link = &cache->bucket[cache->entry[idx].hash %
+					ARRAY_SIZE(cache->bucket)];
+
+	while (*link != idx) {
+		link = &cache->entry[*link].next;
+	}
+
+	*link = cache->entry[idx].next;
+}
+
+static bool dedup_rssi_changed(const struct dedup_entry *entry, int8_t rssi)
+{
+	int diff = (int)rssi - entry->rssi;
+
+	return (CONFIG_BT_SCAN_DEDUP_RSSI_THRESHOLD > 0) &&
+	       (abs(diff) >= CONFIG_BT_SCAN_DEDUP_RSSI_THRESHOLD);
+}
+
+static bool dedup_interval_elapsed(const struct dedup_entry *entry,
+				   uint32_t now)
+{
+	return (CONFIG_BT_SCAN_DEDUP_INTERVAL > 0) &&
+	       ((now - entry->reported_at) >= CONFIG_BT_SCAN_DEDUP_INTERVAL);
+}
+
+/* Check if the report repeats one passed on recently, and record it if
+ * it does not.
+ */
+static bool dedup_suppress(const struct bt_le_scan_recv_info *info,
+			   const struct net_buf_simple *ad)
+{
+	struct dedup_cache *cache = &bt_scan.dedup;
+	uint32_t now = k_uptime_get_32();
+	struct dedup_entry *entry = NULL;
+	bool suppress = false;
+	uint32_t hash;
+	uint16_t idx;
+
+	/* Scan responses are kept apart from the advertising data
+	 * they follow.
+	 */
+	hash = addr_hash(info->addr, SCAN_HASH_INIT ^
+			 (info->adv_props & BT_GAP_ADV_PROP_SCAN_RESPONSE));
+	hash = scan_hash(ad->data, ad->len, hash);
+
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+
+	cache->stats.received++;
+
+	for (idx = cache->bucket[hash % ARRAY_SIZE(cache->bucket)];
+	     idx != DEDUP_NONE; idx = cache->entry[idx].next) {
+		entry = &cache->entry[idx];
+
+		if ((entry->hash == hash) &&
+		    (bt_addr_le_cmp(&entry->addr, info->addr) == 0)) {
+			break;
+		}
+	}
+
+	if (idx != DEDUP_NONE) {
+		suppress = !dedup_interval_elapsed(entry, now) &&
+			   !dedup_rssi_changed(entry, info->rssi);
+	} else {
+		/* Reuse the least recently seen entry. */
+		entry = CONTAINER_OF(sys_dlist_peek_tail(&cache->lru),
+				     struct dedup_entry, node);
+		idx = entry - cache->entry;
+
+		if (entry->used) {
+			dedup_unlink(cache, idx);
+			cache->stats.evicted++;
+		}
+
+		bt_addr_le_copy(&entry->addr, info->addr);
+		entry->hash = hash;
+		entry->used = true;
+		entry->next = cache->bucket[hash % ARRAY_SIZE(cache->bucket)];
+		cache->bucket[hash % ARRAY_SIZE(cache->bucket)] = idx;
+	}
+
+	sys_dlist_remove(&entry->node);
+	sys_dlist_prepend(&cache->lru, &entry->node);
+
+	if (suppress) {
+		cache->stats.suppressed++;
+	} else {
+		entry->reported_at = now;
+		entry->rssi = info->rssi;
+		cache->stats.reported++;
+	}
+
+	k_mutex_unlock(&scan_mutex);
+
+	return suppress;
+}
+
+int bt_scan_dedup_stats_get(struct bt_scan_dedup_stats *stats)
+{
+	if (!stats) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+	*stats = bt_scan.dedup.stats;
+	k_mutex_unlock(&scan_mutex);
+
+	return 0;
+}
+
+void bt_scan_dedup_stats_reset(void)
+{
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+	memset(&bt_scan.dedup.stats, 0, sizeof(bt_scan.dedup.stats));
+	k_mutex_unlock(&scan_mutex);
+}
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
+#if CONFIG_BT_SCAN_FILTER_INDEX
+/* Offset of 16-bit and 32-bit UUIDs within the Bluetooth Base UUID. */
+#define UUID_BASE_VAL_OFFSET 12
+
+static const uint8_t uuid_base[BT_SCAN_UUID_128_SIZE] = {
+	BT_UUID_128_ENCODE(0x00000000, 0x0000, 0x1000, 0x8000, 0x00805F9B34FB)
+};
+
+static int addr_index_find(const bt_addr_le_t *addr)
+{
+	const struct bt_scan_addr_filter *filter = &bt_scan.scan_filters.addr;
+
+	for (size_t i = addr_hash(addr, SCAN_HASH_INIT) % ADDR_INDEX_SIZE;
+	     filter->slot[i] != INDEX_SLOT_EMPTY;
+	     i = (i + 1) % ADDR_INDEX_SIZE) {
+		uint16_t idx = filter->slot[i] - 1;
+
+		if (bt_addr_le_cmp(addr, &filter->target_addr[idx]) == 0) {
+			return idx;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static void addr_index_add(uint16_t idx)
+{
+	struct bt_scan_addr_filter *filter = &bt_scan.scan_filters.addr;
+	size_t i = addr_hash(&filter->target_addr[idx], SCAN_HASH_INIT) %
+		   ADDR_INDEX_SIZE;
+
+	while (filter->slot[i] != INDEX_SLOT_EMPTY) {
+		i = (i + 1) % ADDR_INDEX_SIZE;
+	}
+
+	filter->slot[i] = idx + 1;
+}
+
+/* Convert a little-endian UUID of any size to the 128-bit form, so that
+ * UUIDs match regardless of the size they are advertised with,
+ * the same way as bt_uuid_cmp() does.
+ */
+static void uuid_key_make(uint8_t *key, const uint8_t *val, uint8_t len)
+{
+	if (len == BT_SCAN_UUID_128_SIZE) {
+		memcpy(key, val, len);
+		return;
+	}
+
+	memcpy(key, uuid_base, sizeof(uuid_base));
+	memcpy(&key[UUID_BASE_VAL_OFFSET], val, len);
+}
+
+static void uuid_filter_key_make(uint8_t *key, const struct bt_uuid *uuid)
+{
+	uint8_t val[sizeof(uint32_t)];
+
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		sys_put_le16(BT_UUID_16(uuid)->val, val);
+		uuid_key_make(key, val, sizeof(uint16_t));
+		break;
+
+	case BT_UUID_TYPE_32:
+		sys_put_le32(BT_UUID_32(uuid)->val, val);
+		uuid_key_make(key, val, sizeof(uint32_t));
+		break;
+
+	default:
+		uuid_key_make(key, BT_UUID_128(uuid)->val,
+			      BT_SCAN_UUID_128_SIZE);
+		break;
+	}
+}
+
+static int uuid_index_find(const uint8_t *key)
+{
+	const struct bt_scan_uuid_filter *filter = &bt_scan.scan_filters.uuid;
+	uint32_t hash = scan_hash(key, BT_SCAN_UUID_128_SIZE, SCAN_HASH_INIT);
+
+	for (size_t i = hash % UUID_INDEX_SIZE;
+	     filter->slot[i] != INDEX_SLOT_EMPTY;
+	     i = (i + 1) % UUID_INDEX_SIZE) {
+		uint16_t idx = filter->slot[i] - 1;
+
+		if (memcmp(key, filter->key[idx], BT_SCAN_UUID_128_SIZE) == 0) {
+			return idx;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static void uuid_index_add(uint16_t idx)
+{
+	struct bt_scan_uuid_filter *filter = &bt_scan.scan_filters.uuid;
+	uint32_t hash = scan_hash(filter->key[idx], BT_SCAN_UUID_128_SIZE,
+				  SCAN_HASH_INIT);
+	size_t i = hash % UUID_INDEX_SIZE;
+
+	while (filter->slot[i] != INDEX_SLOT_EMPTY) {
+		i = (i + 1) % UUID_INDEX_SIZE;
+	}
+
+	filter->slot[i] = idx + 1;
+}
+
+static void name_trie_node_init(struct name_trie_node *node, uint8_t c)
+{
+	node->child = TRIE_NONE;
+	node->sibling = TRIE_NONE;
+	node->first = TRIE_NONE;
+	node->term = TRIE_NONE;
+	node->min_len = UINT8_MAX;
+	node->c = c;
+}
+
+static void name_trie_node_update(struct name_trie_node *node, uint16_t idx,
+				  uint8_t min_len)
+{
+	/* Filters are added with increasing indexes. */
+	if (node->first == TRIE_NONE) {
+		node->first = idx;
+	}
+
+	node->min_len = MIN(node->min_len, min_len);
+}
+
+static uint16_t name_trie_child(const struct name_trie_node *trie,
+				uint16_t node, uint8_t c)
+{
+	uint16_t child = trie[node].child;
+
+	while ((child != TRIE_NONE) && (trie[child].c != c)) {
+		child = trie[child].sibling;
+	}
+
+	return child;
+}
+
+static void name_trie_add(struct name_trie_node *trie, uint16_t *trie_cnt,
+			  const char *name, size_t name_len, uint16_t idx,
+			  uint8_t min_len)
+{
+	uint16_t node = 0;
+
+	if (*trie_cnt == 0) {
+		name_trie_node_init(&trie[0], '\0');
+		*trie_cnt = 1;
+	}
+
+	name_trie_node_update(&trie[node], idx, min_len);
+
+	for (size_t i = 0; i < name_len; i++) {
+		uint16_t child = name_trie_child(trie, node, name[i]);
+
+		if (child == TRIE_NONE) {
+			child = (*trie_cnt)++;
+
+			name_trie_node_init(&trie[child], name[i]);
+			trie[child].sibling = trie[node].child;
+			trie[node].child = child;
+		}
+
+		node = child;
+		name_trie_node_update(&trie[node], idx, min_len);
+	}
+
+	trie[node].term = idx;
+}
+
+/* Follow the advertised name through the trie. The filter names that
+ * strncmp() would match against it are the ones passing through the returned
+ * node or, if the advertised name is cut short by a NUL character
+ * (@p terminated), the one ending at the returned node.
+ */
+static uint16_t name_trie_find(const struct name_trie_node *trie,
+			       uint16_t trie_cnt, const uint8_t *data,
+			       uint8_t data_len, bool *terminated)
+{
+	uint16_t node = 0;
+
+	*terminated = false;
+
+	if (trie_cnt == 0) {
+		return TRIE_NONE;
+	}
+
+	for (size_t i = 0; (i < data_len) && (node != TRIE_NONE); i++) {
+		if (data[i] == '\0') {
+			*terminated = true;
+			break;
+		}
+
+		node = name_trie_child(trie, node, data[i]);
+	}
+
+	return node;
+}
+
+static bool name_trie_contains(const struct name_trie_node *trie,
+			       uint16_t trie_cnt, const char *name,
+			       size_t name_len)
+{
+	bool terminated;
+	uint16_t node = name_trie_find(trie, trie_cnt, (const uint8_t *)name,
+				       name_len, &terminated);
+
+	return (node != TRIE_NONE) && (trie[node].term != TRIE_NONE);
+}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 static bool adv_addr_compare(const bt_addr_le_t *target_addr,
 			     struct bt_scan_control *control)
 {
 	const bt_addr_le_t *addr =
 			bt_scan.scan_filters.addr.target_addr;
+
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	int idx = addr_index_find(target_addr);
+
+	if (idx >= 0) {
+		control->filter_status.addr.addr = &addr[idx];
+
+		return true;
+	}
+#else
 	uint8_t counter = bt_scan.scan_filters.addr.cnt;
 
 	for (size_t i = 0; i < counter; i++) {
@@ -514,6 +1023,7 @@ static bool adv_addr_compare(const bt_addr_le_t *target_addr,
 			return true;
 		}
 	}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
 
 	return false;
 }
@@ -550,15 +1060,25 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 	}
 
 	/* Check for duplicated filter. */
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	if (addr_index_find(target_addr) >= 0) {
+		return 0;
+	}
+#else
 	for (size_t i = 0; i < counter; i++) {
 		if (bt_addr_le_cmp(target_addr, &addr_filter[i]) == 0) {
 			return 0;
 		}
 	}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
 
 	/* Add target address to filter. */
 	bt_addr_le_copy(&addr_filter[counter], target_addr);
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	addr_index_add(counter);
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	LOG_DBG("Filter set on address type %i",
 		addr_filter[counter].type);
 
@@ -572,21 +1092,45 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 	return 0;
 }
 
+#if !CONFIG_BT_SCAN_FILTER_INDEX
 static bool adv_name_cmp(const uint8_t *data,
 			 uint8_t data_len,
 			 const char *target_name)
 {
 	return strncmp(target_name, data, data_len) == 0;
 }
+#endif /* !CONFIG_BT_SCAN_FILTER_INDEX */
 
 static bool adv_name_compare(const struct bt_data *data,
 			     struct bt_scan_control *control)
 {
 	struct bt_scan_name_filter const *name_filter =
 			&bt_scan.scan_filters.name;
-	uint8_t counter = bt_scan.scan_filters.name.cnt;
 	uint8_t data_len = data->data_len;
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	bool terminated;
+	uint16_t node = name_trie_find(name_filter->trie, name_filter->trie_cnt,
+				       data->data, data_len, &terminated);
+	uint16_t idx;
+
+	if (node == TRIE_NONE) {
+		return false;
+	}
+
+	idx = terminated ? name_filter->trie[node].term :
+			   name_filter->trie[node].first;
+	if (idx == TRIE_NONE) {
+		return false;
+	}
+
+	control->filter_status.name.name = name_filter->target_name[idx];
+	control->filter_status.name.len = data_len;
+
+	return true;
+#else
+	uint8_t counter = bt_scan.scan_filters.name.cnt;
+
 	/* Compare the name found with the name filter. */
 	for (size_t i = 0; i < counter; i++) {
 		if (adv_name_cmp(data->data,
@@ -602,6 +1146,7 @@ static bool adv_name_compare(const struct bt_data *data,
 	}
 
 	return false;
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
 }
 
 static inline bool is_name_filter_enabled(void)
@@ -641,16 +1186,30 @@ static int scan_name_filter_add(const char *name)
 	}
 
 	/* Check for duplicated filter. */
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	if (name_trie_contains(bt_scan.scan_filters.name.trie,
+			       bt_scan.scan_filters.name.trie_cnt,
+			       name, name_len)) {
+		return 0;
+	}
+#else
 	for (size_t i = 0; i < counter; i++) {
 		if (!strcmp(bt_scan.scan_filters.name.target_name[i], name)) {
 			return 0;
 		}
 	}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
 
 	/* Add name to filter. */
 	memcpy(bt_scan.scan_filters.name.target_name[counter],
 	       name, name_len);
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	name_trie_add(bt_scan.scan_filters.name.trie,
+		      &bt_scan.scan_filters.name.trie_cnt,
+		      name, name_len, counter, 0);
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	bt_scan.scan_filters.name.cnt++;
 
 	LOG_DBG("Adding filter on %s name", name);
@@ -678,9 +1237,42 @@ static bool adv_short_name_compare(const struct bt_data *data,
 			&bt_scan.scan_filters.short_name;
 	uint8_t counter = bt_scan.scan_filters.short_name.cnt;
 	uint8_t data_len = data->data_len;
+	size_t i = 0;
+
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	bool terminated;
+	uint16_t node = name_trie_find(name_filter->trie, name_filter->trie_cnt,
+				       data->data, data_len, &terminated);
+	uint16_t idx;
+
+	if ((node == TRIE_NONE) ||
+	    (data_len < name_filter->trie[node].min_len)) {
+		return false;
+	}
+
+	idx = terminated ? name_filter->trie[node].term :
+			   name_filter->trie[node].first;
+	if (idx == TRIE_NONE) {
+		return false;
+	}
+
+	if (data_len >= name_filter->name[idx].min_len) {
+		control->filter_status.short_name.name =
+			name_filter->name[idx].target_name;
+		control->filter_status.short_name.len = data_len;
+
+		return true;
+	}
+
+	/* A later filter with a lower minimum length may still match.
+	 * This is rare, so look for it the slow way, which keeps the reported
+	 * filter the same as without the index.
+	 */
+	i = idx + 1;
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
 
 	/* Compare the name found with the name filters. */
-	for (size_t i = 0; i < counter; i++) {
+	for (; i < counter; i++) {
 		if (adv_short_name_cmp(data->data,
 				       data_len,
 				       name_filter->name[i].target_name,
@@ -738,12 +1330,20 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	}
 
 	/* Check for duplicated filter. */
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	if (name_trie_contains(short_name_filter->trie,
+			       short_name_filter->trie_cnt,
+			       short_name->name, name_len)) {
+		return 0;
+	}
+#else
 	for (size_t i = 0; i < counter; i++) {
 		if (!strcmp(short_name_filter->name[i].target_name,
 			    short_name->name)) {
 			return 0;
 		}
 	}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
 
 	/* Add name to the filter. */
 	short_name_filter->name[counter].min_len = short_name->min_len;
@@ -751,6 +1351,12 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	       short_name->name,
 	       name_len);
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	name_trie_add(short_name_filter->trie, &short_name_filter->trie_cnt,
+		      short_name->name, name_len, counter,
+		      short_name->min_len);
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	bt_scan.scan_filters.short_name.cnt++;
 
 	LOG_DBG("Adding filter on %s name", short_name->name);
@@ -758,6 +1364,7 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	return 0;
 }
 
+#if !CONFIG_BT_SCAN_FILTER_INDEX
 static bool find_uuid(const uint8_t *data,
 		      uint8_t data_len,
 		      uint8_t uuid_type,
@@ -796,7 +1403,86 @@ static bool find_uuid(const uint8_t *data,
 
 	return false;
 }
+#endif /* !CONFIG_BT_SCAN_FILTER_INDEX */
+
+#if CONFIG_BT_SCAN_FILTER_INDEX
+static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
+			     struct bt_scan_control *control)
+{
+	const struct bt_scan_uuid_filter *uuid_filter =
+			&bt_scan.scan_filters.uuid;
+	const bool all_filters_mode = bt_scan.scan_filters.all_mode;
+	const uint8_t counter = bt_scan.scan_filters.uuid.cnt;
+	uint32_t found[CONFIG_BT_SCAN_UUID_CNT / 32 + 1] = {0};
+	uint8_t key[BT_SCAN_UUID_128_SIZE];
+	uint8_t uuid_match_cnt = 0;
+	uint8_t uuid_len;
+	int first = counter;
+
+	switch (uuid_type) {
+	case BT_UUID_TYPE_16:
+		uuid_len = sizeof(uint16_t);
+		break;
+
+	case BT_UUID_TYPE_32:
+		uuid_len = sizeof(uint32_t);
+		break;
+
+	case BT_UUID_TYPE_128:
+		uuid_len = BT_SCAN_UUID_128_SIZE;
+		break;
+
+	default:
+		return false;
+	}
+
+	/* Look up each advertised UUID once, instead of searching the
+	 * advertised UUIDs for every filter.
+	 */
+	for (size_t i = 0; (i + uuid_len) <= data->data_len; i += uuid_len) {
+		int idx;
+
+		uuid_key_make(key, &data->data[i], uuid_len);
+
+		idx = uuid_index_find(key);
+		if (idx < 0) {
+			continue;
+		}
+
+		found[idx / 32] |= BIT(idx % 32);
+		first = MIN(first, idx);
+	}
+
+	/* In the normal filter mode, only one UUID is needed to match. */
+	if (!all_filters_mode) {
+		if (first == counter) {
+			control->filter_status.uuid.count = 0;
+
+			return false;
+		}
+
+		control->filter_status.uuid.uuid[0] = uuid_filter->uuid[first].uuid;
+		control->filter_status.uuid.count = 1;
 
+		return true;
+	}
+
+	/* In the multifilter mode, all UUIDs must be found in
+	 * the advertisement packets.
+	 */
+	while ((uuid_match_cnt < counter) &&
+	       (found[uuid_match_cnt / 32] & BIT(uuid_match_cnt % 32))) {
+		control->filter_status.uuid.uuid[uuid_match_cnt] =
+			uuid_filter->uuid[uuid_match_cnt].uuid;
+
+		uuid_match_cnt++;
+	}
+
+	control->filter_status.uuid.count = uuid_match_cnt;
+
+	return uuid_match_cnt == counter;
+}
+#else
 static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
 			     struct bt_scan_control *control)
 {
@@ -840,6 +1526,7 @@ static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
 
 	return false;
 }
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
 
 static bool is_uuid_filter_enabled(void)
 {
@@ -875,11 +1562,21 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 	}
 
 	/* Check for duplicated filter. */
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	uint8_t *key = bt_scan.scan_filters.uuid.key[counter];
+
+	uuid_filter_key_make(key, uuid);
+
+	if (uuid_index_find(key) >= 0) {
+		return 0;
+	}
+#else
 	for (size_t i = 0; i < counter; i++) {
 		if (bt_uuid_cmp(uuid_filter[i].uuid, uuid) == 0) {
 			return 0;
 		}
 	}
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
 
 	/* Add UUID to the filter. */
 	switch (uuid->type) {
@@ -911,6 +1608,10 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		return -EINVAL;
 	}
 
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	uuid_index_add(counter);
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	bt_scan.scan_filters.uuid.cnt++;
 	LOG_DBG("Added filter on UUID type %x", uuid->type);
 
@@ -1203,6 +1904,13 @@ int bt_scan_filter_add(enum bt_scan_filter_type type,
 		break;
 	}
 
+#if CONFIG_BT_SCAN_DEDUP
+	/* Suppressed reports may match the new filter. */
+	if (!err) {
+		bt_scan_dedup_clear();
+	}
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 	k_mutex_unlock(&scan_mutex);
 
 	return err;
@@ -1236,6 +1944,17 @@ void bt_scan_filter_remove_all(void)
 		&bt_scan.scan_filters.manufacturer_data;
 	manufacturer_data_filter->cnt = 0;
 
+#if CONFIG_BT_SCAN_DEDUP
+	bt_scan_dedup_clear();
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
+#if CONFIG_BT_SCAN_FILTER_INDEX
+	name_filter->trie_cnt = 0;
+	short_name_filter->trie_cnt = 0;
+	memset(addr_filter->slot, 0, sizeof(addr_filter->slot));
+	memset(uuid_filter->slot, 0, sizeof(uuid_filter->slot));
+#endif /* CONFIG_BT_SCAN_FILTER_INDEX */
+
 	k_mutex_unlock(&scan_mutex);
 }
 
@@ -1248,6 +1967,10 @@ void bt_scan_filter_disable(void)
 	bt_scan.scan_filters.uuid.enabled = false;
 	bt_scan.scan_filters.appearance.enabled = false;
 	bt_scan.scan_filters.manufacturer_data.enabled = false;
+
+#if CONFIG_BT_SCAN_DEDUP
+	bt_scan_dedup_clear();
+#endif /* CONFIG_BT_SCAN_DEDUP */
 }
 
 int bt_scan_filter_enable(uint8_t mode, bool match_all)
@@ -1361,6 +2084,10 @@ void bt_scan_init(const struct bt_scan_init_param *init)
 #if CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER
 	bt_conn_cb_register(&conn_callbacks);
 #endif /* CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER */
+
+#if CONFIG_BT_SCAN_DEDUP
+	bt_scan_dedup_clear();
+#endif /* CONFIG_BT_SCAN_DEDUP */
 }
 
 void bt_scan_update_init_conn_params(struct bt_le_conn_param *new_conn_param)
@@ -1447,6 +2174,36 @@ static bool adv_data_found(struct bt_data *data, void *user_data)
 	return true;
 }
 
+/* Walk the AD structures in place and evaluate every filter type in
+ * the same pass. Unlike bt_data_parse(), this leaves the buffer untouched,
+ * so it can be passed on to the application as is.
+ */
+static void adv_data_parse(const struct net_buf_simple *ad,
+			   struct bt_scan_control *control)
+{
+	const uint8_t *field = ad->data;
+	size_t len = ad->len;
+
+	while (len > 1) {
+		struct bt_data data;
+		uint8_t field_len = field[0];
+
+		/* Check for early termination or malformed data. */
+		if ((field_len == 0) || (field_len > (len - 1))) {
+			return;
+		}
+
+		data.type = field[1];
+		data.data_len = field_len - 1;
+		data.data = &field[2];
+
+		adv_data_found(&data, control);
+
+		field += field_len + 1;
+		len -= field_len + 1;
+	}
+}
+
 static void filter_state_check(struct bt_scan_control *control,
 			       const bt_addr_le_t *addr)
 {
@@ -1480,7 +2237,12 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 		      struct net_buf_simple *ad)
 {
 	struct bt_scan_control scan_control;
-	struct net_buf_simple_state state;
+
+#if CONFIG_BT_SCAN_DEDUP
+	if (dedup_suppress(info, ad)) {
+		return;
+	}
+#endif /* CONFIG_BT_SCAN_DEDUP */
 
 	memset(&scan_control, 0, sizeof(scan_control));
 
@@ -1495,12 +2257,12 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 	/* Check the address filter. */
 	check_addr(&scan_control, info->addr);
 
-	/* Save advertising buffer state to transfer it
-	 * data to application if futher processing is needed.
+	/* Only the address filter can match without looking
+	 * at the advertising data.
 	 */
-	net_buf_simple_save(ad, &state);
-	bt_data_parse(ad, adv_data_found, (void *)&scan_control);
-	net_buf_simple_restore(ad, &state);
+	if (scan_control.filter_cnt > (is_addr_filter_enabled() ? 1 : 0)) {
+		adv_data_parse(ad, &scan_control);
+	}
 
 	scan_control.device_info.recv_info = info;
 	scan_control.device_info.conn_param = &bt_scan.conn_param;
@@ -1532,6 +2294,13 @@ int bt_scan_start(enum bt_scan_type scan_type)
 		return -EINVAL;
 	}
 
+#if CONFIG_BT_SCAN_DEDUP
+	/* Report every device again in the new scan, like
+	 * the controller duplicate filter does.
+	 */
+	bt_scan_dedup_clear();
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 	/* Start the scanning. */
 	int err = bt_le_scan_start(&bt_scan.scan_param, NULL);
 
@@ -52,6 +52,102 @@
 
 LOG_MODULE_REGISTER(bt_hids, CONFIG_BT_HIDS_LOG_LEVEL);
 
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+static sys_slist_t hids_list;
+
+static int conn_ctx_id_get(struct bt_hids *hids_obj, struct bt_conn *conn)
+{
+	struct bt_conn_ctx_lib *ctx_lib = hids_obj->conn_ctx;
+
+	for (size_t i = 0; i < ARRAY_SIZE(ctx_lib->ctx); i++) {
+		if (ctx_lib->ctx[i].conn == conn) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static void inp_rep_subscription_update(struct bt_hids *hids_obj,
+					struct bt_hids_inp_rep *hids_inp_rep,
+					size_t id)
+{
+	const struct bt_conn_ctx *ctx = &hids_obj->conn_ctx->ctx[id];
+	struct bt_gatt_attr *rep_attr =
+		&hids_obj->gp.svc.attrs[hids_inp_rep->att_ind];
+
+	if (ctx->conn && ctx->data &&
+	    bt_gatt_is_subscribed(ctx->conn, rep_attr, BT_GATT_CCC_NOTIFY)) {
+		atomic_set_bit(hids_inp_rep->subscribed, id);
+	} else {
+		atomic_clear_bit(hids_inp_rep->subscribed, id);
+	}
+}
+
+static void inp_rep_subscriptions_update(struct bt_hids *hids_obj,
+					 struct bt_conn *conn)
+{
+	int id = conn_ctx_id_get(hids_obj, conn);
+	size_t cnt = MIN(hids_obj->inp_rep_group.cnt,
+			 ARRAY_SIZE(hids_obj->inp_rep_group.reports));
+
+	if (id < 0) {
+		return;
+	}
+
+	for (size_t i = 0; i < cnt; i++) {
+		inp_rep_subscription_update(hids_obj,
+					    &hids_obj->inp_rep_group.reports[i],
+					    id);
+	}
+}
+
+static void inp_rep_fast_path_conn_clear(struct bt_hids *hids_obj,
+					 struct bt_conn *conn)
+{
+	int id = conn_ctx_id_get(hids_obj, conn);
+	size_t cnt = MIN(hids_obj->inp_rep_group.cnt,
+			 ARRAY_SIZE(hids_obj->inp_rep_group.reports));
+
+	if (id < 0) {
+		return;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&hids_obj->lock);
+
+	for (size_t i = 0; i < cnt; i++) {
+		struct bt_hids_inp_rep *hids_inp_rep =
+			&hids_obj->inp_rep_group.reports[i];
+
+		atomic_clear_bit(hids_inp_rep->subscribed, id);
+		atomic_clear_bit(hids_inp_rep->in_flight, id);
+		atomic_clear_bit(hids_inp_rep->pending, id);
+	}
+
+	k_spin_unlock(&hids_obj->lock, key);
+}
+
+#if CONFIG_BT_SMP
+static void security_changed(struct bt_conn *conn, bt_security_t level,
+			     enum bt_security_err err)
+{
+	struct bt_hids *hids_obj;
+
+	/* Subscriptions of bonded peers that require security are only
+	 * restored once the link is encrypted, and the CCC changed callback
+	 * is not called if other peers are already subscribed.
+	 */
+	SYS_SLIST_FOR_EACH_CONTAINER(&hids_list, hids_obj, node) {
+		inp_rep_subscriptions_update(hids_obj, conn);
+	}
+}
+
+BT_CONN_CB_DEFINE(conn_callbacks) = {
+	.security_changed = security_changed,
+};
+#endif /* CONFIG_BT_SMP */
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
+
 int bt_hids_connected(struct bt_hids *hids_obj, struct bt_conn *conn)
 {
 	__ASSERT_NO_MSG(conn != NULL);
@@ -95,6 +191,11 @@ int bt_hids_connected(struct bt_hids *hids_obj, struct bt_conn *conn)
 
 	bt_conn_ctx_release(hids_obj->conn_ctx, (void *)conn_data);
 
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+	/* Subscriptions of bonded peers may have been restored already. */
+	inp_rep_subscriptions_update(hids_obj, conn);
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
+
 	return 0;
 }
 
@@ -103,6 +204,10 @@ int bt_hids_disconnected(struct bt_hids *hids_obj, struct bt_conn *conn)
 	__ASSERT_NO_MSG(conn != NULL);
 	__ASSERT_NO_MSG(hids_obj != NULL);
 
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+	inp_rep_fast_path_conn_clear(hids_obj, conn);
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
+
 	int err = bt_conn_ctx_free(hids_obj->conn_ctx, conn);
 
 	if (err) {
@@ -228,9 +333,18 @@ static ssize_t hids_inp_rep_read(struct bt_conn *conn,
 
 	rep_data = conn_data->inp_rep_ctx + rep->offset;
 
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+	/* The fast path updates the report without the context mutex. */
+	k_spinlock_key_t key = k_spin_lock(&hids->lock);
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
+
 	ret_len = bt_gatt_attr_read(conn, attr, buf, len, offset, rep_data,
 				    rep->size);
 
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+	k_spin_unlock(&hids->lock, key);
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
+
 	bt_conn_ctx_release(hids->conn_ctx, (void *)conn_data);
 
 	return ret_len;
@@ -460,6 +574,16 @@ static void hids_input_report_ccc_changed(struct bt_gatt_attr const *attr,
 	    CONTAINER_OF((struct _bt_gatt_ccc *)attr->user_data,
 			 struct bt_hids_inp_rep, ccc);
 
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+	struct bt_hids *hids = CONTAINER_OF((inp_rep - inp_rep->idx),
+					    struct bt_hids,
+					    inp_rep_group.reports);
+
+	for (size_t i = 0; i < ARRAY_SIZE(hids->conn_ctx->ctx); i++) {
+		inp_rep_subscription_update(hids, inp_rep, i);
+	}
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
+
 	if (value == BT_GATT_CCC_NOTIFY) {
 		LOG_DBG("Notification has been turned on");
 		if (inp_rep->handler != NULL) {
@@ -473,6 +597,34 @@ static void hids_input_report_ccc_changed(struct bt_gatt_attr const *attr,
 	}
 }
 
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+static ssize_t hids_input_report_ccc_write(struct bt_conn *conn,
+					   struct bt_gatt_attr const *attr,
+					   uint16_t value)
+{
+	struct bt_hids_inp_rep *inp_rep =
+	    CONTAINER_OF((struct _bt_gatt_ccc *)attr->user_data,
+			 struct bt_hids_inp_rep, ccc);
+	struct bt_hids *hids = CONTAINER_OF((inp_rep - inp_rep->idx),
+					    struct bt_hids,
+					    inp_rep_group.reports);
+	int id = conn_ctx_id_get(hids, conn);
+
+	/* The CCC changed callback is only called when the value aggregated
+	 * over all peers changes, so track the subscription of each peer here.
+	 */
+	if ((id >= 0) && hids->conn_ctx->ctx[id].data) {
+		if (value & BT_GATT_CCC_NOTIFY) {
+			atomic_set_bit(inp_rep->subscribed, id);
+		} else {
+			atomic_clear_bit(inp_rep->subscribed, id);
+		}
+	}
+
+	return sizeof(value);
+}
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
+
 static ssize_t hids_boot_mouse_inp_report_read(struct bt_conn *conn,
 					       struct bt_gatt_attr const *attr,
 					       void *buf, uint16_t len,
@@ -769,6 +921,15 @@ hids_input_reports_register(struct bt_hids *hids_obj,
 
 		BT_GATT_POOL_CCC(&hids_obj->gp, hids_inp_rep->ccc,
 				 hids_input_report_ccc_changed,  wperm | rperm);
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+		hids_inp_rep->ccc.cfg_write = hids_input_report_ccc_write;
+		memset(hids_inp_rep->subscribed, 0,
+		       sizeof(hids_inp_rep->subscribed));
+		memset(hids_inp_rep->in_flight, 0,
+		       sizeof(hids_inp_rep->in_flight));
+		memset(hids_inp_rep->pending, 0,
+		       sizeof(hids_inp_rep->pending));
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
 		BT_GATT_POOL_DESC(&hids_obj->gp, BT_UUID_HIDS_REPORT_REF,
 				  rperm, hids_inp_rep_ref_read,
 				  NULL, &hids_inp_rep->id);
@@ -984,7 +1145,15 @@ int bt_hids_init(struct bt_hids *hids_obj,
 			  NULL, hids_ctrl_point_write, &hids_obj->cp);
 
 	/* Register HIDS attributes in GATT database. */
-	return bt_gatt_service_register(&hids_obj->gp.svc);
+	int err = bt_gatt_service_register(&hids_obj->gp.svc);
+
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+	if (!err) {
+		sys_slist_append(&hids_list, &hids_obj->node);
+	}
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
+
+	return err;
 }
 
 int bt_hids_uninit(struct bt_hids *hids_obj)
@@ -1000,6 +1169,10 @@ int bt_hids_uninit(struct bt_hids *hids_obj)
 	struct bt_gatt_attr *attr_start = hids_obj->gp.svc.attrs;
 	struct bt_conn_ctx_lib *conn_ctx = hids_obj->conn_ctx;
 
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+	sys_slist_find_and_remove(&hids_list, &hids_obj->node);
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
+
 	/* Free the whole GATT pool */
 	bt_gatt_pool_free(&hids_obj->gp);
 
@@ -1081,6 +1254,147 @@ static int inp_rep_notify_all(struct bt_hids *hids_obj,
 	}
 }
 
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+static void inp_rep_fast_path_sent(struct bt_conn *conn, void *user_data);
+
+static int inp_rep_fast_path_notify(struct bt_hids *hids_obj,
+				    struct bt_hids_inp_rep *hids_inp_rep,
+				    struct bt_conn *conn, uint8_t const *rep)
+{
+	struct bt_gatt_notify_params params = {0};
+
+	params.attr = &hids_obj->gp.svc.attrs[hids_inp_rep->att_ind];
+	params.data = rep;
+	params.len = hids_inp_rep->size;
+	params.func = inp_rep_fast_path_sent;
+	params.user_data = hids_inp_rep;
+
+	return bt_gatt_notify_cb(conn, &params);
+}
+
+static void inp_rep_fast_path_sent(struct bt_conn *conn, void *user_data)
+{
+	struct bt_hids_inp_rep *hids_inp_rep = user_data;
+	struct bt_hids *hids_obj = CONTAINER_OF((hids_inp_rep - hids_inp_rep->idx),
+						struct bt_hids,
+						inp_rep_group.reports);
+	uint8_t rep[CONFIG_BT_HIDS_INP_REP_FAST_PATH_MAX_LEN];
+	bt_gatt_complete_func_t cb;
+	bool pending;
+	int err;
+
+	k_spinlock_key_t key = k_spin_lock(&hids_obj->lock);
+	int id = conn_ctx_id_get(hids_obj, conn);
+
+	if (id < 0) {
+		/* The peer has disconnected in the meantime. */
+		k_spin_unlock(&hids_obj->lock, key);
+		return;
+	}
+
+	cb = hids_inp_rep->cb;
+	pending = atomic_test_and_clear_bit(hids_inp_rep->pending, id);
+
+	/* The peer may have unsubscribed in the meantime. */
+	if (pending && !atomic_test_bit(hids_inp_rep->subscribed, id)) {
+		pending = false;
+	}
+
+	if (pending) {
+		memcpy(rep, hids_inp_rep->latest, hids_inp_rep->size);
+	} else {
+		atomic_clear_bit(hids_inp_rep->in_flight, id);
+	}
+
+	k_spin_unlock(&hids_obj->lock, key);
+
+	if (cb) {
+		cb(conn, NULL);
+	}
+
+	if (!pending) {
+		return;
+	}
+
+	err = inp_rep_fast_path_notify(hids_obj, hids_inp_rep, conn, rep);
+	if (err) {
+		LOG_WRN("Cannot send the waiting Input Report (err %d)",
+			err);
+		atomic_clear_bit(hids_inp_rep->in_flight, id);
+	}
+}
+
+static int inp_rep_fast_path_notify_all(struct bt_hids *hids_obj,
+					struct bt_hids_inp_rep *hids_inp_rep,
+					uint8_t const *rep, uint8_t len,
+					bt_gatt_complete_func_t cb)
+{
+	struct bt_conn_ctx_lib *ctx_lib = hids_obj->conn_ctx;
+	int ret = -ENODATA;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&hids_obj->lock);
+
+	/* A waiting report would be replaced and never sent. */
+	for (size_t i = 0; i < ARRAY_SIZE(ctx_lib->ctx); i++) {
+		if (atomic_test_bit(hids_inp_rep->pending, i)) {
+			k_spin_unlock(&hids_obj->lock, key);
+			return -EBUSY;
+		}
+	}
+
+	memcpy(hids_inp_rep->latest, rep, len);
+	hids_inp_rep->cb = cb;
+	k_spin_unlock(&hids_obj->lock, key);
+
+	for (size_t i = 0; i < ARRAY_SIZE(ctx_lib->ctx); i++) {
+		struct bt_hids_conn_data *conn_data;
+		struct bt_conn *conn;
+		int err;
+
+		if (!atomic_test_bit(hids_inp_rep->subscribed, i)) {
+			continue;
+		}
+
+		key = k_spin_lock(&hids_obj->lock);
+
+		/* The peer may have disconnected since the check above. */
+		if (!atomic_test_bit(hids_inp_rep->subscribed, i)) {
+			k_spin_unlock(&hids_obj->lock, key);
+			continue;
+		}
+
+		conn_data = ctx_lib->ctx[i].data;
+		store_input_report(hids_inp_rep,
+				   conn_data->inp_rep_ctx + hids_inp_rep->offset,
+				   rep, len);
+
+		if (atomic_test_and_set_bit(hids_inp_rep->in_flight, i)) {
+			/* Sent once the notification in flight completes. */
+			atomic_set_bit(hids_inp_rep->pending, i);
+			k_spin_unlock(&hids_obj->lock, key);
+			ret = 0;
+			continue;
+		}
+
+		conn = bt_conn_ref(ctx_lib->ctx[i].conn);
+		k_spin_unlock(&hids_obj->lock, key);
+
+		err = inp_rep_fast_path_notify(hids_obj, hids_inp_rep, conn,
+					       rep);
+		if (err) {
+			atomic_clear_bit(hids_inp_rep->in_flight, i);
+		}
+
+		bt_conn_unref(conn);
+
+		ret = (ret == 0) ? 0 : err;
+	}
+
+	return ret;
+}
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
+
 int bt_hids_inp_rep_send(struct bt_hids *hids_obj,
 			 struct bt_conn *conn, uint8_t rep_index,
 			 uint8_t const *rep, uint8_t len,
@@ -1097,6 +1411,13 @@ int bt_hids_inp_rep_send(struct bt_hids *hids_obj,
 	}
 
 	if (!conn) {
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+		if (len <= sizeof(hids_inp_rep->latest)) {
+			return inp_rep_fast_path_notify_all(hids_obj,
+							    hids_inp_rep, rep,
+							    len, cb);
+		}
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
 		return inp_rep_notify_all(hids_obj, hids_inp_rep, rep, len, cb);
 	}
 
@@ -1112,6 +1433,16 @@ int bt_hids_inp_rep_send(struct bt_hids *hids_obj,
 		return -EINVAL;
 	}
 
+#if CONFIG_BT_HIDS_INP_REP_FAST_PATH
+	int id = conn_ctx_id_get(hids_obj, conn);
+
+	/* The waiting report would be sent after this one. */
+	if ((id >= 0) && atomic_test_bit(hids_inp_rep->pending, id)) {
+		bt_conn_ctx_release(hids_obj->conn_ctx, (void *)conn_data);
+		return -EBUSY;
+	}
+#endif /* CONFIG_BT_HIDS_INP_REP_FAST_PATH */
+
 	rep_data = conn_data->inp_rep_ctx + hids_inp_rep->offset;
 
 	store_input_report(hids_inp_rep, rep_data, rep, len);
@@ -15,7 +15,6 @@
 
 #include <bluetooth/services/mds.h>
 
-#include <zephyr/net/buf.h>
 #include <zephyr/sys/atomic.h>
 #include <zephyr/sys/__assert.h>
 
@@ -63,6 +62,15 @@ LOG_MODULE_REGISTER(mds, CONFIG_BT_MDS_LOG_LEVEL);
 
 #define STREAM_ENABLED BIT(0)
 
+/* According to BLE Core v5.3 Vol 3, Part F 3.4.7.1 maximum supported length of the
+ * notification is (ATT_MTU - 3).
+ */
+#define ATT_HEADER_LENGTH 0x03
+#define CHUNK_BUF_SIZE (CONFIG_BT_L2CAP_TX_MTU - ATT_HEADER_LENGTH)
+
+/* Retry delay when the Bluetooth stack has no buffers and no chunk is in flight. */
+#define SEND_RETRY_DELAY K_MSEC(10)
+
 /* Application error code defined by the MDS.
  * According to BLE Core v5.3 Vol 3, Part F 3.4.1.
  */
@@ -88,6 +96,16 @@ struct mds {
 	atomic_t send_cnt;
 	atomic_t stream_state;
 	uint8_t chunk_number;
+
+	/* Chunk fetched from Memfault ahead of its notification, so that it is ready when
+	 * a notification in flight completes.
+	 */
+	uint8_t prefetch_buf[CHUNK_BUF_SIZE];
+	size_t prefetch_len;
+
+	struct k_spinlock stats_lock;
+	struct bt_mds_stats stats;
+	int64_t busy_start;
 };
 
 struct mds_data_export_nfy {
@@ -231,7 +249,12 @@ static void stream_enable(struct bt_conn *conn)
 	}
 
 	if (!mds_instance.conn) {
+		k_spinlock_key_t key = k_spin_lock(&mds_instance.stats_lock);
+
 		mds_instance.conn = conn;
+		memset(&mds_instance.stats, 0, sizeof(mds_instance.stats));
+
+		k_spin_unlock(&mds_instance.stats_lock, key);
 	}
 
 	k_work_schedule(&mds_work, K_NO_WAIT);
@@ -383,9 +406,18 @@ static void disconnected(struct bt_conn *conn, uint8_t reason)
 	if (conn == mds_instance.conn) {
 		stream_disable(conn);
 
+		/* The chunks in flight are lost, so restart the Memfault message in progress
+		 * on the next connection.
+		 */
+		if (mds_instance.prefetch_len ||
+		    (atomic_get(&mds_instance.send_cnt) != MAX_PIPELINE)) {
+			memfault_packetizer_abort();
+		}
+
 		/* Clean up connection */
 		mds_instance.conn = NULL;
 		mds_instance.chunk_number = 0;
+		mds_instance.prefetch_len = 0;
 
 		atomic_set(&mds_instance.send_cnt, MAX_PIPELINE);
 
@@ -402,42 +434,91 @@ BT_CONN_CB_DEFINE(conn_callbacks) = {
 
 static void mds_sent_cb(struct bt_conn *conn, void *user_data)
 {
-	atomic_inc(&mds_instance.send_cnt);
+	k_spinlock_key_t key;
+
+	/* The pipeline has been reset on disconnection, ignore the late completions of
+	 * the chunks that were in flight.
+	 */
+	if (conn != mds_instance.conn) {
+		return;
+	}
+
+	key = k_spin_lock(&mds_instance.stats_lock);
+
+	/* The pipeline has drained, stop counting the export time. */
+	if (atomic_inc(&mds_instance.send_cnt) == (MAX_PIPELINE - 1)) {
+		mds_instance.stats.duration_ms += k_uptime_get() - mds_instance.busy_start;
+	}
+
+	k_spin_unlock(&mds_instance.stats_lock, key);
+
 	k_work_reschedule(&mds_work, K_NO_WAIT);
 }
 
 static size_t chunk_data_length_get(struct bt_conn *conn)
 {
-	static const size_t att_header_length = 0x03;
-
+	uint16_t mtu;
 	size_t length;
 
 	if (!conn) {
 		return 0;
 	}
 
-	length = bt_gatt_get_mtu(conn);
-	if (length < (att_header_length + sizeof(struct mds_data_export_nfy))) {
-		LOG_ERR("MTU value too low: %d or link is disconnected", length);
+	/* The ATT MTU is 0 if the link is disconnected. */
+	mtu = bt_gatt_get_mtu(conn);
+	if (mtu < (ATT_HEADER_LENGTH + sizeof(struct mds_data_export_nfy) + 1)) {
+		LOG_ERR("MTU value too low: %u or link is disconnected", mtu);
 		return 0;
 	}
 
-	/* According to BLE Core v5.3 Vol 3, Part F 3.4.7.1 maximum supported length of the
-	 * notification is (ATT_MTU - 3).
+	length = MIN(mtu - ATT_HEADER_LENGTH, CHUNK_BUF_SIZE);
+
+	return length - sizeof(struct mds_data_export_nfy);
+}
+
+static uint8_t chunk_number_update(uint8_t chunk_number)
+{
+	return ++chunk_number & MDS_CHUNK_NUMBER_MAX_VALUE;
+}
+
+static bool chunk_prefetch(struct bt_conn *conn)
+{
+	struct mds_data_export_nfy *data_export_nfy =
+		(struct mds_data_export_nfy *)mds_instance.prefetch_buf;
+	size_t chunk_size;
+
+	if (mds_instance.prefetch_len) {
+		return true;
+	}
+
+	/* The ATT MTU does not decrease during the connection, so the chunk still fits in
+	 * a notification when it is sent.
 	 */
-	length -= att_header_length;
-	length -= sizeof(struct mds_data_export_nfy);
+	chunk_size = chunk_data_length_get(conn);
+	if (!chunk_size) {
+		return false;
+	}
 
-	return length;
+	if (!memfault_packetizer_get_chunk(data_export_nfy->data, &chunk_size)) {
+		return false;
+	}
+
+	mds_instance.prefetch_len = sizeof(struct mds_data_export_nfy) + chunk_size;
+
+	return true;
 }
 
-static int chunk_send(struct bt_conn *conn, struct net_buf_simple *buf)
+static int chunk_send(struct bt_conn *conn)
 {
+	struct mds_data_export_nfy *data_export_nfy =
+		(struct mds_data_export_nfy *)mds_instance.prefetch_buf;
 	struct bt_gatt_notify_params params = {0};
 	static struct bt_gatt_attr *attr;
+	k_spinlock_key_t key;
+	int err;
 
 	__ASSERT(conn, "Invalid parameters");
-	__ASSERT(buf, "Invalid parameters");
+	__ASSERT(mds_instance.prefetch_len, "No chunk to send");
 
 	if (!attr) {
 		attr = bt_gatt_find_by_uuid(mds_svc.attrs, mds_svc.attr_count,
@@ -446,90 +527,113 @@ static int chunk_send(struct bt_conn *conn, struct net_buf_simple *buf)
 
 	__ASSERT_NO_MSG(attr);
 
+	/* The chunk number is set on sending to keep it continuous if sending fails. */
+	data_export_nfy->chunk_number = mds_instance.chunk_number;
+	data_export_nfy->rfu = 0;
+
 	params.attr = attr;
-	params.data = buf->data;
-	params.len = buf->len;
+	params.data = mds_instance.prefetch_buf;
+	params.len = mds_instance.prefetch_len;
 	params.func = mds_sent_cb;
 
-	return bt_gatt_notify_cb(conn, &params);
-}
+	err = bt_gatt_notify_cb(conn, &params);
+	if (err) {
+		return err;
+	}
 
-static uint8_t chunk_number_update(uint8_t chunk_number)
-{
-	return ++chunk_number & MDS_CHUNK_NUMBER_MAX_VALUE;
+	LOG_DBG("Memfault diagnostic data chunk %d successfully sent",
+		mds_instance.chunk_number);
+	mds_instance.chunk_number = chunk_number_update(mds_instance.chunk_number);
+
+	key = k_spin_lock(&mds_instance.stats_lock);
+
+	/* The pipeline was idle, start counting the export time. */
+	if (atomic_dec(&mds_instance.send_cnt) == MAX_PIPELINE) {
+		mds_instance.busy_start = k_uptime_get();
+	}
+
+	mds_instance.stats.bytes += mds_instance.prefetch_len - sizeof(*data_export_nfy);
+	mds_instance.stats.chunks++;
+
+	k_spin_unlock(&mds_instance.stats_lock, key);
+
+	/* The notification data has been copied, the buffer is free for the next chunk. */
+	mds_instance.prefetch_len = 0;
+
+	return 0;
 }
 
-static int mds_data_send(struct bt_conn *conn)
+static void mds_work_handler(struct k_work *work)
 {
+	struct bt_conn *conn = mds_instance.conn;
 	int err;
-	bool data_available;
-	struct mds_data_export_nfy *data_export_nfy;
-	size_t chunk_max_size = chunk_data_length_get(mds_instance.conn);
-	size_t chunk_size = chunk_max_size;
-
-	NET_BUF_SIMPLE_DEFINE(buf, (sizeof(struct mds_data_export_nfy) + chunk_max_size));
 
-	data_export_nfy = net_buf_simple_add(&buf,
-					sizeof(struct mds_data_export_nfy) + chunk_max_size);
-	if (!data_export_nfy) {
-		LOG_ERR("Cannot allocate place for memfault chunk data");
-		return -ENOMEM;
+	if (!atomic_test_bit(&mds_instance.stream_state, STREAM_ENABLED)) {
+		return;
 	}
 
-	data_available = memfault_packetizer_get_chunk(data_export_nfy->data, &chunk_size);
+	/* Fill the pipeline. */
+	while (atomic_get(&mds_instance.send_cnt) > 0) {
+		if (!chunk_prefetch(conn)) {
+			break;
+		}
 
-	if (data_available) {
-		data_export_nfy->chunk_number = mds_instance.chunk_number;
-		data_export_nfy->rfu = 0;
+		err = chunk_send(conn);
+		if ((err == -ENOMEM) || (err == -ENOBUFS)) {
+			k_spinlock_key_t key = k_spin_lock(&mds_instance.stats_lock);
 
-		/* If chunk size is smaller than maximum chunk size then shrink the buffer to actual
-		 * packet size.
-		 */
-		(void)net_buf_simple_remove_mem(&buf, (chunk_max_size - chunk_size));
+			mds_instance.stats.stalls++;
+
+			k_spin_unlock(&mds_instance.stats_lock, key);
 
-		err = chunk_send(conn, &buf);
-		if (err) {
+			/* Keep the chunk, the completion of a chunk in flight triggers the
+			 * retry.
+			 */
+			if (atomic_get(&mds_instance.send_cnt) == MAX_PIPELINE) {
+				k_work_reschedule(&mds_work, SEND_RETRY_DELAY);
+			}
+
+			return;
+		} else if (err) {
 			memfault_packetizer_abort();
+			mds_instance.prefetch_len = 0;
 			LOG_WRN("Failed to send Memfault diagnostic chunk, err %d", err);
 
-			return err;
+			k_work_reschedule(&mds_work, SEND_RETRY_DELAY);
+			return;
 		}
+	}
 
-		LOG_DBG("Memfault diagnostic data chunk %d successfully sent",
-			mds_instance.chunk_number);
-		mds_instance.chunk_number = chunk_number_update(mds_instance.chunk_number);
-
-		return chunk_size;
+	/* Fetch the next chunk while the pipeline drains. The completion of a chunk in
+	 * flight sends it.
+	 */
+	if (chunk_prefetch(conn)) {
+		return;
 	}
 
-	return 0;
+	/* Reschedule the workqueue here to check if there is any new Memfault data. */
+	k_work_reschedule(&mds_work, K_MSEC(DATA_POLL_INTERVAL));
 }
 
-static void mds_work_handler(struct k_work *work)
+int bt_mds_stats_get(struct bt_mds_stats *stats)
 {
-	int err;
-	bool data_available;
+	k_spinlock_key_t key;
 
-	if (!atomic_test_bit(&mds_instance.stream_state, STREAM_ENABLED)) {
-		return;
+	if (!stats) {
+		return -EINVAL;
 	}
 
-	err = mds_data_send(mds_instance.conn);
-	if (err > 0) {
-		atomic_dec(&mds_instance.send_cnt);
-	}
+	key = k_spin_lock(&mds_instance.stats_lock);
 
-	data_available = memfault_packetizer_data_available();
-	if (data_available) {
-		if (atomic_get(&mds_instance.send_cnt)) {
-			k_work_reschedule(&mds_work, K_NO_WAIT);
-		}
+	*stats = mds_instance.stats;
 
-		return;
+	if (atomic_get(&mds_instance.send_cnt) != MAX_PIPELINE) {
+		stats->duration_ms += k_uptime_get() - mds_instance.busy_start;
 	}
 
-	/* Reschedule the workqueue here to check if there is any new Memfault data. */
-	k_work_reschedule(&mds_work, K_MSEC(DATA_POLL_INTERVAL));
+	k_spin_unlock(&mds_instance.stats_lock, key);
+
+	return 0;
 }
 
 int bt_mds_cb_register(const struct bt_mds_cb *cb)
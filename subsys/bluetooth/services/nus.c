@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
 #include <zephyr/bluetooth/conn.h>
 #include <zephyr/bluetooth/uuid.h>
 #include <zephyr/bluetooth/gatt.h>
@@ -15,6 +16,48 @@ LOG_MODULE_REGISTER(bt_nus, CONFIG_BT_NUS_LOG_LEVEL);
 
 static struct bt_nus_cb nus_cb;
 
+#if CONFIG_BT_NUS_STREAM
+#define STREAM_TX_COUNT CONFIG_BT_NUS_STREAM_TX_COUNT
+
+/* Retry delay when the host is out of transmit buffers and no notification
+ * of the stream is in flight to trigger the retry.
+ */
+#define STREAM_RETRY_DELAY K_MSEC(1)
+
+struct stream_tx {
+	/* Chain to release once the notification has been sent. */
+	struct net_buf *release;
+	uint16_t len;
+	bool ring;
+};
+
+struct nus_stream {
+	struct bt_conn *conn;
+	struct k_work_delayable work;
+	struct k_spinlock lock;
+
+	/* Queued chains, and the position in the chain being sent. */
+	sys_slist_t queue;
+	struct net_buf *buf;
+	struct net_buf *frag;
+	uint16_t offset;
+
+	/* Ring buffer, and the number of its bytes in flight. */
+	struct ring_buf *rb;
+	uint32_t rb_sent;
+
+	/* Notifications in flight, oldest first. */
+	struct stream_tx tx[STREAM_TX_COUNT];
+	uint8_t tx_head;
+	uint8_t tx_cnt;
+
+	struct bt_nus_stream_stats stats;
+	int64_t stats_start;
+};
+
+static struct nus_stream streams[CONFIG_BT_MAX_CONN];
+#endif /* CONFIG_BT_NUS_STREAM */
+
 static void nus_ccc_cfg_changed(const struct bt_gatt_attr *attr,
 				  uint16_t value)
 {
@@ -81,6 +124,431 @@ BT_GATT_PRIMARY_SERVICE(BT_UUID_NUS_SERVICE),
 			       NULL, on_receive, NULL),
 );
 
+#if CONFIG_BT_NUS_STREAM
+static void stream_ring_discard(struct ring_buf *rb, uint32_t len)
+{
+	uint8_t *data;
+	uint32_t claimed;
+
+	while (len) {
+		claimed = ring_buf_get_claim(rb, &data, len);
+		if (!claimed) {
+			break;
+		}
+
+		(void)ring_buf_get_finish(rb, claimed);
+		len -= claimed;
+	}
+}
+
+/* Drop all data of the stream. Chains to release are moved to @p drop. */
+static void stream_flush(struct nus_stream *stream, sys_slist_t *drop)
+{
+	struct net_buf *buf;
+
+	while ((buf = net_buf_slist_get(&stream->queue))) {
+		stream->stats.dropped_bytes += net_buf_frags_len(buf);
+		net_buf_slist_put(drop, buf);
+	}
+
+	if (stream->buf) {
+		stream->stats.dropped_bytes += net_buf_frags_len(stream->frag) -
+					       stream->offset;
+		net_buf_slist_put(drop, stream->buf);
+		stream->buf = NULL;
+		stream->frag = NULL;
+	}
+
+	for (; stream->tx_cnt; stream->tx_cnt--) {
+		struct stream_tx *tx = &stream->tx[stream->tx_head];
+
+		if (tx->release) {
+			net_buf_slist_put(drop, tx->release);
+		}
+
+		stream->tx_head = (stream->tx_head + 1) % STREAM_TX_COUNT;
+	}
+
+	if (stream->rb) {
+		stream->stats.dropped_bytes += ring_buf_size_get(stream->rb) -
+					       stream->rb_sent;
+		stream_ring_discard(stream->rb, UINT32_MAX);
+		stream->rb = NULL;
+		stream->rb_sent = 0;
+	}
+}
+
+static void stream_drop_release(sys_slist_t *drop)
+{
+	struct net_buf *buf;
+
+	while ((buf = net_buf_slist_get(drop))) {
+		net_buf_unref(buf);
+	}
+}
+
+static void stream_frag_skip_empty(struct nus_stream *stream)
+{
+	while (stream->frag && (stream->offset == stream->frag->len)) {
+		stream->frag = stream->frag->frags;
+		stream->offset = 0;
+	}
+}
+
+/* Take the next slice of data to send, of up to @p mtu bytes. The slice is
+ * passed in place to bt_gatt_notify_cb(), which copies it into the ATT PDU.
+ * It is freed when the notification completes, so that the notifications
+ * queued in the host hold back the producer of the data.
+ */
+static const uint8_t *stream_slice_get(struct nus_stream *stream, uint16_t mtu,
+				       struct stream_tx *tx)
+{
+	const uint8_t *data;
+
+	tx->release = NULL;
+	tx->ring = false;
+
+	if (stream->buf) {
+		data = stream->frag->data + stream->offset;
+		tx->len = MIN(stream->frag->len - stream->offset, mtu);
+
+		stream->offset += tx->len;
+		stream_frag_skip_empty(stream);
+
+		if (!stream->frag) {
+			tx->release = stream->buf;
+			stream->buf = NULL;
+		}
+
+		return data;
+	}
+
+	if (stream->rb) {
+		uint8_t *claimed;
+		uint32_t len;
+
+		/* The in-flight data is freed as the notifications complete,
+		 * so the claim starts at the oldest byte in flight.
+		 */
+		len = ring_buf_get_claim(stream->rb, &claimed,
+					 stream->rb_sent + mtu);
+		(void)ring_buf_get_finish(stream->rb, 0);
+
+		if (len > stream->rb_sent) {
+			data = claimed + stream->rb_sent;
+			tx->len = len - stream->rb_sent;
+			tx->ring = true;
+
+			stream->rb_sent += tx->len;
+
+			return data;
+		}
+	}
+
+	return NULL;
+}
+
+static void stream_sent(struct bt_conn *conn, void *user_data)
+{
+	struct nus_stream *stream = user_data;
+	struct net_buf *release;
+	struct stream_tx *tx;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&stream->lock);
+
+	/* Notifications of a stream dropped on disconnection. */
+	if ((stream->conn != conn) || !stream->tx_cnt) {
+		k_spin_unlock(&stream->lock, key);
+		return;
+	}
+
+	tx = &stream->tx[stream->tx_head];
+	stream->tx_head = (stream->tx_head + 1) % STREAM_TX_COUNT;
+	stream->tx_cnt--;
+
+	if (tx->ring) {
+		stream_ring_discard(stream->rb, tx->len);
+		stream->rb_sent -= tx->len;
+	}
+
+	release = tx->release;
+
+	stream->stats.tx_bytes += tx->len;
+	stream->stats.tx_notifications++;
+
+	k_spin_unlock(&stream->lock, key);
+
+	if (release) {
+		net_buf_unref(release);
+	}
+
+	k_work_reschedule(&stream->work, K_NO_WAIT);
+}
+
+static void stream_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct nus_stream *stream = CONTAINER_OF(dwork, struct nus_stream, work);
+	struct bt_gatt_notify_params params = {
+		.attr = &nus_svc.attrs[2],
+		.func = stream_sent,
+		.user_data = stream,
+	};
+	sys_slist_t drop = SYS_SLIST_STATIC_INIT(&drop);
+	struct bt_conn *conn;
+	k_spinlock_key_t key;
+	uint16_t mtu;
+	int err;
+
+	key = k_spin_lock(&stream->lock);
+	conn = stream->conn;
+
+	if (conn && !bt_gatt_is_subscribed(conn, params.attr,
+					   BT_GATT_CCC_NOTIFY)) {
+		/* Let the notifications in flight complete first. */
+		if (!stream->tx_cnt) {
+			stream_flush(stream, &drop);
+		}
+
+		conn = NULL;
+	}
+
+	k_spin_unlock(&stream->lock, key);
+
+	stream_drop_release(&drop);
+
+	if (!conn) {
+		return;
+	}
+
+	mtu = bt_nus_get_mtu(conn);
+
+	while (true) {
+		struct net_buf *buf;
+		struct net_buf *frag;
+		uint16_t offset;
+		struct stream_tx *tx;
+
+		key = k_spin_lock(&stream->lock);
+
+		if ((stream->conn != conn) || (stream->tx_cnt == STREAM_TX_COUNT)) {
+			k_spin_unlock(&stream->lock, key);
+			return;
+		}
+
+		if (!stream->buf) {
+			stream->buf = net_buf_slist_get(&stream->queue);
+			stream->frag = stream->buf;
+			stream->offset = 0;
+			stream_frag_skip_empty(stream);
+		}
+
+		buf = stream->buf;
+		frag = stream->frag;
+		offset = stream->offset;
+
+		tx = &stream->tx[(stream->tx_head + stream->tx_cnt) % STREAM_TX_COUNT];
+		params.data = stream_slice_get(stream, mtu, tx);
+		if (!params.data) {
+			k_spin_unlock(&stream->lock, key);
+			return;
+		}
+
+		params.len = tx->len;
+		stream->tx_cnt++;
+
+		k_spin_unlock(&stream->lock, key);
+
+		err = bt_gatt_notify_cb(conn, &params);
+		if (!err) {
+			continue;
+		}
+
+		key = k_spin_lock(&stream->lock);
+
+		/* The stream has been flushed on disconnection. */
+		if (stream->conn != conn) {
+			k_spin_unlock(&stream->lock, key);
+			return;
+		}
+
+		/* Nothing else takes slices, so the slice is put back by
+		 * restoring the position, and the notification is the newest.
+		 */
+		stream->tx_cnt--;
+		stream->buf = buf;
+		stream->frag = frag;
+		stream->offset = offset;
+		if (tx->ring) {
+			stream->rb_sent -= tx->len;
+		}
+
+		if ((err != -ENOMEM) && (err != -ENOBUFS)) {
+			LOG_WRN("Stream notification failed (err %d)", err);
+
+			/* The notifications in flight trigger a retry. */
+			if (!stream->tx_cnt) {
+				stream_flush(stream, &drop);
+			}
+
+			k_spin_unlock(&stream->lock, key);
+			stream_drop_release(&drop);
+			return;
+		}
+
+		stream->stats.tx_stalls++;
+
+		/* The notifications in flight trigger the retry. */
+		if (!stream->tx_cnt) {
+			k_work_schedule(&stream->work, STREAM_RETRY_DELAY);
+		}
+
+		k_spin_unlock(&stream->lock, key);
+		return;
+	}
+}
+
+static void stream_disconnected(struct bt_conn *conn, uint8_t reason)
+{
+	struct nus_stream *stream = &streams[bt_conn_index(conn)];
+	sys_slist_t drop = SYS_SLIST_STATIC_INIT(&drop);
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&stream->lock);
+
+	if (stream->conn != conn) {
+		k_spin_unlock(&stream->lock, key);
+		return;
+	}
+
+	stream_flush(stream, &drop);
+	stream->conn = NULL;
+
+	k_spin_unlock(&stream->lock, key);
+
+	(void)k_work_cancel_delayable(&stream->work);
+	stream_drop_release(&drop);
+	bt_conn_unref(conn);
+}
+
+BT_CONN_CB_DEFINE(nus_conn_callbacks) = {
+	.disconnected = stream_disconnected,
+};
+
+static void stream_start(struct nus_stream *stream, struct bt_conn *conn)
+{
+	if (!stream->conn) {
+		stream->conn = bt_conn_ref(conn);
+		memset(&stream->stats, 0, sizeof(stream->stats));
+		stream->stats_start = k_uptime_get();
+	}
+}
+
+int bt_nus_stream_send(struct bt_conn *conn, struct net_buf *buf)
+{
+	struct nus_stream *stream;
+	k_spinlock_key_t key;
+
+	if (!conn || !buf || !net_buf_frags_len(buf)) {
+		return -EINVAL;
+	}
+
+	if (!bt_gatt_is_subscribed(conn, &nus_svc.attrs[2], BT_GATT_CCC_NOTIFY)) {
+		return -EINVAL;
+	}
+
+	stream = &streams[bt_conn_index(conn)];
+
+	key = k_spin_lock(&stream->lock);
+	stream_start(stream, conn);
+	net_buf_slist_put(&stream->queue, buf);
+	k_spin_unlock(&stream->lock, key);
+
+	k_work_schedule(&stream->work, K_NO_WAIT);
+
+	return 0;
+}
+
+int bt_nus_stream_ring_send(struct bt_conn *conn, struct ring_buf *rb)
+{
+	struct nus_stream *stream;
+	k_spinlock_key_t key;
+	int err = 0;
+
+	if (!conn || !rb) {
+		return -EINVAL;
+	}
+
+	if (!bt_gatt_is_subscribed(conn, &nus_svc.attrs[2], BT_GATT_CCC_NOTIFY)) {
+		return -EINVAL;
+	}
+
+	stream = &streams[bt_conn_index(conn)];
+
+	key = k_spin_lock(&stream->lock);
+
+	stream_start(stream, conn);
+
+	if (stream->rb && (stream->rb != rb) && !ring_buf_is_empty(stream->rb)) {
+		err = -EBUSY;
+	} else if (stream->rb != rb) {
+		stream->rb = rb;
+		stream->rb_sent = 0;
+	}
+
+	k_spin_unlock(&stream->lock, key);
+
+	if (!err) {
+		k_work_schedule(&stream->work, K_NO_WAIT);
+	}
+
+	return err;
+}
+
+int bt_nus_stream_stats_get(struct bt_conn *conn,
+			    struct bt_nus_stream_stats *stats)
+{
+	struct nus_stream *stream;
+	k_spinlock_key_t key;
+	int err = 0;
+
+	if (!conn || !stats) {
+		return -EINVAL;
+	}
+
+	stream = &streams[bt_conn_index(conn)];
+
+	key = k_spin_lock(&stream->lock);
+
+	if (stream->conn == conn) {
+		*stats = stream->stats;
+		stats->duration_ms = k_uptime_get() - stream->stats_start;
+	} else {
+		err = -ENOENT;
+	}
+
+	k_spin_unlock(&stream->lock, key);
+
+	return err;
+}
+
+void bt_nus_stream_stats_reset(struct bt_conn *conn)
+{
+	struct nus_stream *stream = &streams[bt_conn_index(conn)];
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&stream->lock);
+
+	if (stream->conn == conn) {
+		memset(&stream->stats, 0, sizeof(stream->stats));
+		stream->stats_start = k_uptime_get();
+	}
+
+	k_spin_unlock(&stream->lock, key);
+}
+#endif /* CONFIG_BT_NUS_STREAM */
+
 int bt_nus_init(struct bt_nus_cb *callbacks)
 {
 	if (callbacks) {
@@ -89,6 +557,12 @@ int bt_nus_init(struct bt_nus_cb *callbacks)
 		nus_cb.send_enabled = callbacks->send_enabled;
 	}
 
+#if CONFIG_BT_NUS_STREAM
+	for (size_t i = 0; i < ARRAY_SIZE(streams); i++) {
+		k_work_init_delayable(&streams[i].work, stream_work_handler);
+	}
+#endif /* CONFIG_BT_NUS_STREAM */
+
 	return 0;
 }
 
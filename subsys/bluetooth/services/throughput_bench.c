@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/types.h>
+
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+
+#include <bluetooth/services/throughput_bench.h>
+
+#if CONFIG_CPU_LOAD
+#include <debug/cpu_load.h>
+#endif /* CONFIG_CPU_LOAD */
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(bt_throughput, CONFIG_BT_THROUGHPUT_LOG_LEVEL);
+
+#define BENCH_TIMEOUT K_SECONDS(CONFIG_BT_THROUGHPUT_BENCH_TIMEOUT)
+
+#define LATENCY_BIN_US    CONFIG_BT_THROUGHPUT_BENCH_LATENCY_BIN_US
+#define LATENCY_BIN_COUNT CONFIG_BT_THROUGHPUT_BENCH_LATENCY_BIN_COUNT
+
+/* Opcode and handle of the ATT Write Command. */
+#define ATT_WRITE_CMD_OVERHEAD 3
+#define ATT_MTU_MIN            23
+
+/* 10 s, long enough for the longest connection interval. */
+#define SUPERVISION_TIMEOUT 1000
+
+static struct bt_throughput *throughput;
+static K_SEM_DEFINE(update_sem, 0, 1);
+static K_SEM_DEFINE(done_sem, 0, 1);
+static K_SEM_DEFINE(sent_sem, 0, 1);
+
+static const uint8_t dummy[CONFIG_BT_L2CAP_TX_MTU - ATT_WRITE_CMD_OVERHEAD];
+
+static struct {
+	/* Write latencies, the last bin counts the ones above the range. */
+	uint32_t histogram[LATENCY_BIN_COUNT + 1];
+	uint32_t latency_max;
+	uint32_t completed;
+	int64_t last_complete;
+	atomic_t pending;
+} bench;
+
+static bool is_bench_conn(struct bt_conn *conn)
+{
+	return throughput && (throughput->conn == conn);
+}
+
+static void le_param_updated(struct bt_conn *conn, uint16_t interval,
+			     uint16_t latency, uint16_t timeout)
+{
+	if (is_bench_conn(conn)) {
+		k_sem_give(&update_sem);
+	}
+}
+
+static void le_phy_updated(struct bt_conn *conn,
+			   struct bt_conn_le_phy_info *param)
+{
+	if (is_bench_conn(conn)) {
+		k_sem_give(&update_sem);
+	}
+}
+
+static void le_data_len_updated(struct bt_conn *conn,
+				struct bt_conn_le_data_len_info *info)
+{
+	if (is_bench_conn(conn)) {
+		k_sem_give(&update_sem);
+	}
+}
+
+BT_CONN_CB_DEFINE(throughput_bench_conn_callbacks) = {
+	.le_param_updated = le_param_updated,
+	.le_phy_updated = le_phy_updated,
+	.le_data_len_updated = le_data_len_updated,
+};
+
+static void write_sent(struct bt_conn *conn, void *user_data)
+{
+	uint32_t cycles = k_cycle_get_32() - POINTER_TO_UINT(user_data);
+	uint32_t latency = k_cyc_to_us_floor32(cycles);
+
+	bench.histogram[MIN(latency / LATENCY_BIN_US, LATENCY_BIN_COUNT)]++;
+	bench.latency_max = MAX(bench.latency_max, latency);
+	bench.completed++;
+	bench.last_complete = k_uptime_ticks();
+
+	k_sem_give(&sent_sem);
+
+	if (atomic_dec(&bench.pending) == 1) {
+		k_sem_give(&done_sem);
+	}
+}
+
+/* Wait for the transmit buffers to free up. The writes in flight free them
+ * as they are sent, otherwise they are held by someone else.
+ */
+static int tx_buf_wait(void)
+{
+	if (!atomic_get(&bench.pending)) {
+		k_sleep(K_MSEC(1));
+		return 0;
+	}
+
+	if (k_sem_take(&sent_sem, BENCH_TIMEOUT)) {
+		LOG_ERR("Transfer timeout");
+		return -EAGAIN;
+	}
+
+	return 0;
+}
+
+static uint32_t latency_percentile(uint32_t count, uint32_t percent)
+{
+	uint32_t rank = DIV_ROUND_UP((uint64_t)count * percent, 100);
+	uint32_t sum = 0;
+
+	for (size_t i = 0; i < LATENCY_BIN_COUNT; i++) {
+		sum += bench.histogram[i];
+		if (sum >= rank) {
+			/* Upper edge of the bin, the resolution of the result. */
+			return MIN((i + 1) * LATENCY_BIN_US, bench.latency_max);
+		}
+	}
+
+	return bench.latency_max;
+}
+
+static int link_update_wait(const char *what)
+{
+	if (k_sem_take(&update_sem, BENCH_TIMEOUT)) {
+		LOG_WRN("%s update timeout", what);
+		return -EAGAIN;
+	}
+
+	return 0;
+}
+
+static int link_update(struct bt_conn *conn,
+		       const struct bt_throughput_bench_params *params)
+{
+	struct bt_conn_info info;
+	int err;
+
+	err = bt_conn_get_info(conn, &info);
+	if (err) {
+		return err;
+	}
+
+	/* The coding of the LE Coded PHY is not reported, always update. */
+	if ((params->phy.pref_tx_phy == BT_GAP_LE_PHY_CODED) ||
+	    (info.le.phy->tx_phy != params->phy.pref_tx_phy) ||
+	    (info.le.phy->rx_phy != params->phy.pref_rx_phy)) {
+		k_sem_reset(&update_sem);
+
+		err = bt_conn_le_phy_update(conn, &params->phy);
+		if (err) {
+			LOG_ERR("PHY update failed (err %d)", err);
+			return err;
+		}
+
+		err = link_update_wait("PHY");
+		if (err) {
+			return err;
+		}
+	}
+
+	if (info.le.data_len->tx_max_len != params->data_len) {
+		k_sem_reset(&update_sem);
+
+		err = bt_conn_le_data_len_update(conn,
+			BT_CONN_LE_DATA_LEN_PARAM(params->data_len,
+						  BT_GAP_DATA_TIME_MAX));
+		if (err) {
+			LOG_ERR("Data length update failed (err %d)", err);
+			return err;
+		}
+
+		/* The controllers may settle on a shorter length than the one
+		 * requested, and then report no change.
+		 */
+		(void)link_update_wait("Data length");
+	}
+
+	if (info.le.interval != params->interval) {
+		k_sem_reset(&update_sem);
+
+		err = bt_conn_le_param_update(conn,
+			BT_LE_CONN_PARAM(params->interval, params->interval,
+					 0, SUPERVISION_TIMEOUT));
+		if (err) {
+			LOG_ERR("Connection parameters update failed (err %d)",
+				err);
+			return err;
+		}
+
+		err = link_update_wait("Connection parameters");
+		if (err) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+int bt_throughput_bench_init(struct bt_throughput *throughput_obj)
+{
+	if (!throughput_obj || !throughput_obj->conn ||
+	    !throughput_obj->char_handle) {
+		return -EINVAL;
+	}
+
+#if CONFIG_CPU_LOAD
+	int err = cpu_load_init();
+
+	if (err) {
+		LOG_WRN("CPU load measurement unavailable (err %d)", err);
+	}
+#endif /* CONFIG_CPU_LOAD */
+
+	throughput = throughput_obj;
+
+	return 0;
+}
+
+int bt_throughput_bench_run(const struct bt_throughput_bench_params *params,
+			    struct bt_throughput_bench_result *result)
+{
+	struct bt_conn *conn;
+	uint32_t sent = 0;
+	uint32_t writes = 0;
+	uint16_t att_mtu;
+	uint16_t len;
+	int64_t start;
+	int err;
+
+	if (!params || !result || !params->size ||
+	    (params->att_mtu && (params->att_mtu < ATT_MTU_MIN))) {
+		return -EINVAL;
+	}
+
+	if (!throughput || !throughput->conn) {
+		return -ENOTCONN;
+	}
+
+	conn = throughput->conn;
+
+	err = link_update(conn, params);
+	if (err) {
+		return err;
+	}
+
+	att_mtu = bt_gatt_get_mtu(conn);
+	if (params->att_mtu) {
+		att_mtu = MIN(att_mtu, params->att_mtu);
+	}
+
+	len = MIN(att_mtu - ATT_WRITE_CMD_OVERHEAD, sizeof(dummy));
+
+	/* Reset the peer metrics. */
+	err = bt_throughput_write(throughput, dummy, 1);
+	if (err) {
+		return err;
+	}
+
+	memset(&bench, 0, sizeof(bench));
+	k_sem_reset(&done_sem);
+	k_sem_reset(&sent_sem);
+
+#if CONFIG_CPU_LOAD
+	cpu_load_reset();
+#endif /* CONFIG_CPU_LOAD */
+
+	start = k_uptime_ticks();
+	bench.last_complete = start;
+
+	while (sent < params->size) {
+		uint16_t chunk = MIN(len, params->size - sent);
+
+		/* The peer resets its metrics on 1-byte writes. */
+		chunk = MAX(chunk, 2);
+
+		atomic_inc(&bench.pending);
+
+		err = bt_gatt_write_without_response_cb(
+			conn, throughput->char_handle, dummy, chunk, false,
+			write_sent, UINT_TO_POINTER(k_cycle_get_32()));
+		if (err) {
+			atomic_dec(&bench.pending);
+
+			if (err == -ENOMEM) {
+				err = tx_buf_wait();
+				if (err) {
+					return err;
+				}
+
+				continue;
+			}
+
+			LOG_ERR("GATT write failed (err %d)", err);
+			return err;
+		}
+
+		sent += chunk;
+		writes++;
+	}
+
+	while (atomic_get(&bench.pending) > 0) {
+		if (k_sem_take(&done_sem, BENCH_TIMEOUT)) {
+			LOG_ERR("Transfer timeout");
+			return -EAGAIN;
+		}
+	}
+
+	memset(result, 0, sizeof(*result));
+
+	result->bytes = sent;
+	result->writes = writes;
+	result->att_mtu = att_mtu;
+	result->duration_us = k_ticks_to_us_floor64(bench.last_complete -
+						    start);
+	if (result->duration_us) {
+		result->goodput = ((uint64_t)sent * 8 * USEC_PER_SEC) /
+				  result->duration_us;
+	}
+
+	result->latency_p50 = latency_percentile(bench.completed, 50);
+	result->latency_p90 = latency_percentile(bench.completed, 90);
+	result->latency_p99 = latency_percentile(bench.completed, 99);
+	result->latency_max = bench.latency_max;
+
+#if CONFIG_CPU_LOAD
+	result->cpu_load = cpu_load_get();
+#endif /* CONFIG_CPU_LOAD */
+
+	return 0;
+}
+
+int bt_throughput_bench_sweep(const struct bt_throughput_bench_sweep *sweep,
+			      bt_throughput_bench_result_cb_t cb,
+			      void *user_data)
+{
+	struct bt_throughput_bench_params params = {0};
+	struct bt_throughput_bench_result result;
+	size_t runs;
+	int err;
+
+	if (!sweep || !cb) {
+		return -EINVAL;
+	}
+
+	runs = sweep->phy_cnt * sweep->data_len_cnt * sweep->interval_cnt *
+	       sweep->att_mtu_cnt;
+	if (!runs) {
+		return -EINVAL;
+	}
+
+	params.size = sweep->size;
+
+	/* The ATT MTU varies fastest, as it needs no link update, and the PHY
+	 * slowest.
+	 */
+	for (size_t n = 0; n < runs; n++) {
+		size_t i = n;
+
+		params.att_mtu = sweep->att_mtu[i % sweep->att_mtu_cnt];
+		i /= sweep->att_mtu_cnt;
+		params.interval = sweep->interval[i % sweep->interval_cnt];
+		i /= sweep->interval_cnt;
+		params.data_len = sweep->data_len[i % sweep->data_len_cnt];
+		i /= sweep->data_len_cnt;
+		params.phy = sweep->phy[i];
+
+		err = bt_throughput_bench_run(&params, &result);
+		if (err) {
+			return err;
+		}
+
+		cb(&params, &result, user_data);
+	}
+
+	return 0;
+}
+
+static const char *phy_str(const struct bt_conn_le_phy_param *phy)
+{
+	switch (phy->pref_tx_phy) {
+	case BT_GAP_LE_PHY_1M:
+		return "1M";
+	case BT_GAP_LE_PHY_2M:
+		return "2M";
+	case BT_GAP_LE_PHY_CODED:
+		if (phy->options == BT_CONN_LE_PHY_OPT_CODED_S2) {
+			return "coded_s2";
+		} else if (phy->options == BT_CONN_LE_PHY_OPT_CODED_S8) {
+			return "coded_s8";
+		}
+
+		return "coded";
+	default:
+		return "unknown";
+	}
+}
+
+int bt_throughput_bench_csv(char *buf, size_t size,
+			    const struct bt_throughput_bench_params *params,
+			    const struct bt_throughput_bench_result *result)
+{
+	return snprintk(buf, size,
+			"%s,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u",
+			phy_str(&params->phy), params->interval,
+			params->data_len, result->att_mtu, result->bytes,
+			result->writes, result->duration_us, result->goodput,
+			result->latency_p50, result->latency_p90,
+			result->latency_p99, result->latency_max,
+			result->cpu_load);
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/shell/shell.h>
+
+#include <bluetooth/services/throughput_bench.h>
+
+#define SWEEP_MAX CONFIG_BT_THROUGHPUT_BENCH_SHELL_SWEEP_MAX
+
+#define CSV_LINE_LEN 128
+
+#define CONN_INTERVAL_MIN 6
+#define CONN_INTERVAL_MAX 3200
+
+#define ATT_MTU_MIN 23
+
+#define PHY_PARAM(_options, _phy)                                              \
+	{ .options = (_options), .pref_tx_phy = (_phy), .pref_rx_phy = (_phy) }
+
+static const struct {
+	const char *name;
+	struct bt_conn_le_phy_param phy;
+} phys[] = {
+	{ "1M", PHY_PARAM(BT_CONN_LE_PHY_OPT_NONE, BT_GAP_LE_PHY_1M) },
+	{ "2M", PHY_PARAM(BT_CONN_LE_PHY_OPT_NONE, BT_GAP_LE_PHY_2M) },
+	{ "coded_s2", PHY_PARAM(BT_CONN_LE_PHY_OPT_CODED_S2, BT_GAP_LE_PHY_CODED) },
+	{ "coded_s8", PHY_PARAM(BT_CONN_LE_PHY_OPT_CODED_S8, BT_GAP_LE_PHY_CODED) },
+};
+
+static struct bt_conn_le_phy_param phy[SWEEP_MAX] = {
+	PHY_PARAM(BT_CONN_LE_PHY_OPT_NONE, BT_GAP_LE_PHY_2M),
+};
+static uint16_t interval[SWEEP_MAX] = { 320 };
+static uint16_t data_len[SWEEP_MAX] = { BT_GAP_DATA_LEN_MAX };
+static uint16_t att_mtu[SWEEP_MAX] = { 0 };
+
+static struct bt_throughput_bench_sweep sweep = {
+	.phy = phy,
+	.phy_cnt = 1,
+	.interval = interval,
+	.interval_cnt = 1,
+	.data_len = data_len,
+	.data_len_cnt = 1,
+	.att_mtu = att_mtu,
+	.att_mtu_cnt = 1,
+	.size = 100 * 1024,
+};
+
+static const char *phy_name(const struct bt_conn_le_phy_param *param)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(phys); i++) {
+		if (!memcmp(&phys[i].phy, param, sizeof(*param))) {
+			return phys[i].name;
+		}
+	}
+
+	return "unknown";
+}
+
+static int value_parse(const struct shell *shell, const char *str,
+		       unsigned long min, unsigned long max,
+		       unsigned long *value)
+{
+	char *end;
+
+	*value = strtoul(str, &end, 0);
+	if ((*end != '\0') || (*value < min) || (*value > max)) {
+		shell_error(shell, "Invalid value: %s, must be between %lu and %lu",
+			    str, min, max);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int values_parse(const struct shell *shell, size_t argc, char **argv,
+			unsigned long min, unsigned long max,
+			uint16_t *values, size_t *cnt)
+{
+	uint16_t parsed[SWEEP_MAX];
+	unsigned long value;
+	int err;
+
+	for (size_t i = 1; i < argc; i++) {
+		err = value_parse(shell, argv[i], min, max, &value);
+		if (err) {
+			return err;
+		}
+
+		parsed[i - 1] = value;
+	}
+
+	memcpy(values, parsed, (argc - 1) * sizeof(parsed[0]));
+	*cnt = argc - 1;
+
+	return 0;
+}
+
+static int cmd_phy(const struct shell *shell, size_t argc, char **argv)
+{
+	struct bt_conn_le_phy_param parsed[SWEEP_MAX];
+
+	for (size_t i = 1; i < argc; i++) {
+		size_t j;
+
+		for (j = 0; j < ARRAY_SIZE(phys); j++) {
+			if (!strcmp(argv[i], phys[j].name)) {
+				parsed[i - 1] = phys[j].phy;
+				break;
+			}
+		}
+
+		if (j == ARRAY_SIZE(phys)) {
+			shell_error(shell, "Unknown PHY: %s", argv[i]);
+			return -EINVAL;
+		}
+	}
+
+	memcpy(phy, parsed, (argc - 1) * sizeof(parsed[0]));
+	sweep.phy_cnt = argc - 1;
+
+	return 0;
+}
+
+static int cmd_interval(const struct shell *shell, size_t argc, char **argv)
+{
+	return values_parse(shell, argc, argv, CONN_INTERVAL_MIN,
+			    CONN_INTERVAL_MAX, interval,
+			    &sweep.interval_cnt);
+}
+
+static int cmd_data_len(const struct shell *shell, size_t argc, char **argv)
+{
+	return values_parse(shell, argc, argv, BT_GAP_DATA_LEN_DEFAULT,
+			    BT_GAP_DATA_LEN_MAX, data_len, &sweep.data_len_cnt);
+}
+
+static int cmd_att_mtu(const struct shell *shell, size_t argc, char **argv)
+{
+	uint16_t parsed[SWEEP_MAX];
+	size_t cnt;
+	int err;
+
+	err = values_parse(shell, argc, argv, 0, UINT16_MAX, parsed, &cnt);
+	if (err) {
+		return err;
+	}
+
+	/* Zero stands for the exchanged ATT MTU. */
+	for (size_t i = 0; i < cnt; i++) {
+		if (parsed[i] && (parsed[i] < ATT_MTU_MIN)) {
+			shell_error(shell, "Invalid ATT MTU: %u, must be 0 or at least %u",
+				    parsed[i], ATT_MTU_MIN);
+			return -EINVAL;
+		}
+	}
+
+	memcpy(att_mtu, parsed, cnt * sizeof(parsed[0]));
+	sweep.att_mtu_cnt = cnt;
+
+	return 0;
+}
+
+static int cmd_size(const struct shell *shell, size_t argc, char **argv)
+{
+	unsigned long value;
+	int err;
+
+	err = value_parse(shell, argv[1], 1, UINT32_MAX, &value);
+	if (err) {
+		return err;
+	}
+
+	sweep.size = value;
+
+	return 0;
+}
+
+static void values_print(const struct shell *shell, const char *name,
+			 const uint16_t *values, size_t cnt)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "%s:", name);
+
+	for (size_t i = 0; i < cnt; i++) {
+		shell_fprintf(shell, SHELL_NORMAL, " %u", values[i]);
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "\n");
+}
+
+static int cmd_print(const struct shell *shell, size_t argc, char **argv)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "phy:");
+
+	for (size_t i = 0; i < sweep.phy_cnt; i++) {
+		shell_fprintf(shell, SHELL_NORMAL, " %s", phy_name(&phy[i]));
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "\n");
+
+	values_print(shell, "interval", interval, sweep.interval_cnt);
+	values_print(shell, "data_len", data_len, sweep.data_len_cnt);
+	values_print(shell, "att_mtu", att_mtu, sweep.att_mtu_cnt);
+	shell_print(shell, "size: %u", sweep.size);
+
+	return 0;
+}
+
+static void result_print(const struct bt_throughput_bench_params *params,
+			 const struct bt_throughput_bench_result *result,
+			 void *user_data)
+{
+	const struct shell *shell = user_data;
+	char line[CSV_LINE_LEN];
+
+	bt_throughput_bench_csv(line, sizeof(line), params, result);
+	shell_print(shell, "%s", line);
+}
+
+static int cmd_run(const struct shell *shell, size_t argc, char **argv)
+{
+	int err;
+
+	shell_print(shell, "%s", BT_THROUGHPUT_BENCH_CSV_HEADER);
+
+	err = bt_throughput_bench_sweep(&sweep, result_print, (void *)shell);
+	if (err) {
+		shell_error(shell, "Benchmark failed (err %d)", err);
+	}
+
+	return err;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(throughput_bench_cmds,
+	SHELL_CMD_ARG(phy, NULL,
+		      "Set the swept PHYs <1M|2M|coded_s2|coded_s8>...",
+		      cmd_phy, 2, SWEEP_MAX - 1),
+	SHELL_CMD_ARG(interval, NULL,
+		      "Set the swept connection intervals <1.25 ms units>...",
+		      cmd_interval, 2, SWEEP_MAX - 1),
+	SHELL_CMD_ARG(data_len, NULL,
+		      "Set the swept LL payload lengths <octets>...",
+		      cmd_data_len, 2, SWEEP_MAX - 1),
+	SHELL_CMD_ARG(att_mtu, NULL,
+		      "Set the swept ATT MTUs <octets, 0 for exchanged>...",
+		      cmd_att_mtu, 2, SWEEP_MAX - 1),
+	SHELL_CMD_ARG(size, NULL, "Set the transfer size <bytes>", cmd_size,
+		      2, 0),
+	SHELL_CMD_ARG(print, NULL, "Print the sweep configuration", cmd_print,
+		      1, 0),
+	SHELL_CMD_ARG(run, NULL, "Run the sweep, print results as CSV",
+		      cmd_run, 1, 0),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(throughput_bench, &throughput_bench_cmds,
+		   "Throughput benchmark commands", NULL);
@@ -125,6 +125,12 @@ int bl_sha256_verify(const uint8_t *data, uint32_t data_len, const uint8_t *expe
 {
 	return verify_truncated_hash(data, data_len, expected, CONFIG_SB_HASH_LEN, true);
 }
+
+int bl_sha256_verify_internal(const uint8_t *data, uint32_t data_len,
+			      const uint8_t *expected)
+{
+	return verify_truncated_hash(data, data_len, expected, CONFIG_SB_HASH_LEN, false);
+}
 #endif
 
 #ifdef CONFIG_BL_ROT_VERIFY_EXT_API_ENABLED
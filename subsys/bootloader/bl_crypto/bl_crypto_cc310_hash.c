@@ -14,8 +14,8 @@
 #include <bl_crypto.h>
 #include "bl_crypto_cc310_common.h"
 
-#define MAX_CHUNK_LEN 0x8000 /* Must be 4 byte aligned. */
-#define CHUNK_LEN_STACK 0x200
+#define MAX_CHUNK_LEN CONFIG_SB_CRYPTO_CC310_SHA256_CHUNK_LEN
+#define CHUNK_LEN_STACK CONFIG_SB_CRYPTO_CC310_SHA256_STACK_CHUNK_LEN
 #define RAM_BUFFER_LEN_WORDS ((MAX_CHUNK_LEN) / 4)
 #define STACK_BUFFER_LEN_WORDS ((CHUNK_LEN_STACK) / 4)
 
@@ -33,6 +33,16 @@
 #define CRYS_HASH_LAST_BLOCK_ALREADY_PROCESSED_ERROR \
 	(CRYS_HASH_MODULE_ERROR_BASE + 0xCUL)
 
+/* Chunks are kept a multiple of the SHA-256 block size so that the CC310 never
+ * has to carry a partial block over from one update to the next.
+ */
+#define SHA256_BLOCK_LEN 64
+
+BUILD_ASSERT((MAX_CHUNK_LEN % SHA256_BLOCK_LEN) == 0,
+		"SB_CRYPTO_CC310_SHA256_CHUNK_LEN must be a multiple of 64.");
+BUILD_ASSERT((CHUNK_LEN_STACK % SHA256_BLOCK_LEN) == 0,
+		"SB_CRYPTO_CC310_SHA256_STACK_CHUNK_LEN must be a multiple of 64.");
+
 BUILD_ASSERT(SHA256_CTX_SIZE >= sizeof(nrf_cc310_bl_hash_context_sha256_t), \
 		"nrf_cc310_bl_hash_context_sha256_t can no longer fit inside " \
 		"bl_sha256_ctx_t.");
@@ -44,13 +54,44 @@ static uint32_t __noinit ram_buffer
 static inline void *memcpy32(void *restrict d, const void *restrict s, size_t n)
 {
 	size_t len_words = ROUND_UP(n, 4) / 4;
+	uint32_t *dst = d;
+	const uint32_t *src = s;
+	size_t i = 0;
+
+	/* Copy four words per iteration to let the flash prefetcher and the
+	 * CPU's load/store pipeline keep up, as this copy is on the critical
+	 * path of every hash of flash-resident data.
+	 */
+	for (; (i + 4) <= len_words; i += 4) {
+		uint32_t w0 = src[i];
+		uint32_t w1 = src[i + 1];
+		uint32_t w2 = src[i + 2];
+		uint32_t w3 = src[i + 3];
+
+		dst[i] = w0;
+		dst[i + 1] = w1;
+		dst[i + 2] = w2;
+		dst[i + 3] = w3;
+	}
 
-	for (size_t i = 0; i < len_words; i++) {
-		((uint32_t *)d)[i] = ((uint32_t *)s)[i];
+	for (; i < len_words; i++) {
+		dst[i] = src[i];
 	}
 	return d;
 }
 
+/* Cryptocell has DMA access to RAM only, so data located anywhere else must be
+ * bounced through a RAM buffer before it can be hashed.
+ */
+static inline bool cc310_dma_accessible(const uint8_t *data, uint32_t data_len)
+{
+	uint32_t start = (uint32_t)data;
+	uint32_t ram_end = CONFIG_SRAM_BASE_ADDRESS + (CONFIG_SRAM_SIZE * 1024);
+
+	return (start >= CONFIG_SRAM_BASE_ADDRESS) && (start <= ram_end) &&
+		(data_len <= (ram_end - start));
+}
+
 int crypto_init_hash(void)
 {
 	return cc310_bl_init();
@@ -110,9 +151,8 @@ static int sha256_update(nrf_cc310_bl_hash_context_sha256_t *const ctx,
 {
 	CRYSError_t retval;
 
-	if ((uint32_t)data < CONFIG_SRAM_BASE_ADDRESS) {
+	if (!cc310_dma_accessible(data, data_len)) {
 		/* Copy to RAM buffer, then hash. */
-		/* Cryptocell has DMA access to RAM only */
 		if (external) {
 			retval = hash_blocks_stack(ctx, data, data_len, CHUNK_LEN_STACK);
 		} else {
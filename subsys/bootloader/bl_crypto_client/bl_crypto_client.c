@@ -48,6 +48,13 @@ int bl_sha256_verify(const uint8_t *data, uint32_t data_len, const uint8_t *expe
 	return bl_sha256->ext_api.bl_sha256_verify(data, data_len, expected);
 }
 
+int bl_sha256_verify_internal(const uint8_t *data, uint32_t data_len,
+			      const uint8_t *expected)
+{
+	/* The provider decides how to buffer, there is no internal variant. */
+	return bl_sha256_verify(data, data_len, expected);
+}
+
 int get_hash(uint8_t *hash, const uint8_t *data, uint32_t data_len, bool external)
 {
 	bl_sha256_ctx_t ctx;
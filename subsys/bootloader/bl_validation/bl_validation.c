@@ -232,7 +232,11 @@ static bool validate_hash(const uint32_t fw_src_address, const uint32_t fw_size,
 		return false;
 	}
 
-	retval = bl_sha256_verify((const uint8_t *)fw_src_address, fw_size,
+	bl_sha256_verify_t sha256_verify = external ?
+					bl_sha256_verify :
+					bl_sha256_verify_internal;
+
+	retval = sha256_verify((const uint8_t *)fw_src_address, fw_size,
 			fw_val_info->hash);
 
 	if (retval != 0) {
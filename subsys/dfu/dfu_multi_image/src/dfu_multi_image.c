@@ -6,8 +6,10 @@
 
 #include <dfu/dfu_multi_image.h>
 #include <sys/byteorder.h>
+#include <sys/crc.h>
 #include <sys/util.h>
 #include <zcbor_decode.h>
+#include <logging/log.h>
 
 #include <errno.h>
 #include <string.h>
@@ -17,6 +19,15 @@
 #define IMAGE_NO_FIXED_HEADER -2
 #define IMAGE_NO_CBOR_HEADER -1
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
+#include <settings/settings.h>
+
+#define MODULE "dfu_multi"
+#define PROGRESS_KEY "progress"
+#endif
+
+LOG_MODULE_REGISTER(dfu_multi_image, CONFIG_DFU_MULTI_IMAGE_LOG_LEVEL);
+
 struct image_info {
 	int32_t id;
 	uint32_t size;
@@ -42,10 +53,118 @@ struct dfu_multi_image_ctx {
 	size_t cur_offset;
 	size_t cur_item_offset;
 	size_t cur_item_size;
+	bool cur_image_open;
+
+#ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
+	uint32_t header_crc;
+	bool header_digest;
+#endif
 };
 
 static struct dfu_multi_image_ctx ctx;
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
+/*
+ * Package-level progress record. Identifies the package by the CRC of its header, which
+ * includes the digest of the package content, and holds the number of the first image
+ * that has not been fully written yet. Progress within that image is tracked by its
+ * writer, see dfu_image_writer::offset.
+ */
+struct progress {
+	uint32_t header_crc;
+	int32_t image_no;
+};
+
+static struct progress stored_progress;
+static bool stored_progress_valid;
+
+static int settings_set(const char *key, size_t len_rd, settings_read_cb read_cb,
+			void *cb_arg)
+{
+	ssize_t len;
+
+	if (strcmp(key, PROGRESS_KEY)) {
+		return 0;
+	}
+
+	len = read_cb(cb_arg, &stored_progress, sizeof(stored_progress));
+	stored_progress_valid = (len == sizeof(stored_progress));
+
+	if (!stored_progress_valid) {
+		LOG_WRN("Discarding malformed progress record");
+	}
+
+	return 0;
+}
+
+static int progress_load(void)
+{
+	static struct settings_handler sh = {
+		.name = MODULE,
+		.h_set = settings_set,
+	};
+	int err;
+
+	stored_progress_valid = false;
+
+	/* settings_subsys_init is idempotent so this is safe to do. */
+	err = settings_subsys_init();
+	if (err) {
+		LOG_ERR("settings_subsys_init failed (err %d)", err);
+		return err;
+	}
+
+	err = settings_register(&sh);
+	if (err && err != -EEXIST) {
+		LOG_ERR("settings_register failed (err %d)", err);
+		return err;
+	}
+
+	err = settings_load_subtree(MODULE);
+	if (err) {
+		LOG_ERR("settings_load_subtree failed (err %d)", err);
+		return err;
+	}
+
+	return 0;
+}
+
+static void progress_store(void)
+{
+	const struct progress progress = {
+		.header_crc = ctx.header_crc,
+		.image_no = ctx.cur_image_no,
+	};
+	int err;
+
+	/* Without a digest, the header does not tell packages of the same layout apart. */
+	if (!ctx.header_digest) {
+		return;
+	}
+
+	err = settings_save_one(MODULE "/" PROGRESS_KEY, &progress, sizeof(progress));
+
+	if (err) {
+		/*
+		 * Failing to store progress is not a critical error, the package will just
+		 * be written from an earlier image if the update is interrupted.
+		 */
+		LOG_WRN("Unable to store progress (err %d)", err);
+	}
+}
+
+static int progress_delete(void)
+{
+	int err = settings_delete(MODULE "/" PROGRESS_KEY);
+
+	if (err) {
+		LOG_ERR("settings_delete failed (err %d)", err);
+	}
+
+	return err;
+}
+#endif /* CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS */
+
 static int parse_fixed_header(void)
 {
 	ctx.cur_item_size += sys_get_le16(ctx.buffer);
@@ -72,6 +191,8 @@ static int parse_cbor_header(void)
 {
 	bool res;
 	uint_fast32_t image_count;
+	struct zcbor_string key;
+	struct zcbor_string digest = { 0 };
 
 	ZCBOR_STATE_D(states, CBOR_HEADER_NESTING_LEVEL, ctx.buffer + FIXED_HEADER_SIZE,
 		      ctx.cur_item_size - FIXED_HEADER_SIZE, 1);
@@ -83,6 +204,13 @@ static int parse_cbor_header(void)
 					(zcbor_decoder_t *)parse_image_info, states,
 					ctx.header.images, sizeof(struct image_info));
 	res = res && zcbor_list_end_decode(states);
+
+	/* Optional digest of the package content */
+	if (res && zcbor_tstr_decode(states, &key)) {
+		res = (key.len == strlen("digest")) && !memcmp(key.value, "digest", key.len);
+		res = res && zcbor_bstr_decode(states, &digest);
+	}
+
 	res = res && zcbor_map_end_decode(states);
 
 	if (!res) {
@@ -91,6 +219,11 @@ static int parse_cbor_header(void)
 
 	ctx.header.image_count = image_count;
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
+	ctx.header_crc = crc32_ieee(ctx.buffer, ctx.cur_item_size);
+	ctx.header_digest = (digest.len > 0);
+#endif
+
 	return 0;
 }
 
@@ -113,6 +246,7 @@ static void select_next_image(void)
 {
 	ctx.cur_item_offset = 0;
 	ctx.cur_item_size = 0;
+	ctx.cur_image_open = false;
 
 	while (++ctx.cur_image_no < ctx.header.image_count && current_image_writer() == NULL) {
 		ctx.cur_offset += ctx.header.images[ctx.cur_image_no].size;
@@ -123,6 +257,74 @@ static void select_next_image(void)
 	}
 }
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
+/*
+ * Skip images which were completed before the update got interrupted and continue the
+ * interrupted image from the offset reported by its writer.
+ */
+static int resume_progress(void)
+{
+	const struct dfu_image_writer *writer;
+	size_t image_offset = 0;
+	int err;
+
+	if (!ctx.header_digest) {
+		LOG_INF("Package has no digest, progress not stored");
+		return 0;
+	}
+
+	if (!stored_progress_valid || stored_progress.header_crc != ctx.header_crc ||
+	    stored_progress.image_no < 0 ||
+	    (size_t)stored_progress.image_no > ctx.header.image_count) {
+		return 0;
+	}
+
+	while (ctx.cur_image_no < stored_progress.image_no) {
+		ctx.cur_offset += ctx.cur_item_size - ctx.cur_item_offset;
+		select_next_image();
+	}
+
+	LOG_INF("Resuming package at image %d", ctx.cur_image_no);
+
+	writer = current_image_writer();
+
+	if (writer == NULL || writer->offset == NULL) {
+		return 0;
+	}
+
+	err = writer->open(writer->image_id, ctx.cur_item_size);
+	if (err) {
+		return err;
+	}
+
+	ctx.cur_image_open = true;
+
+	err = writer->offset(&image_offset);
+	if (err) {
+		return err;
+	}
+
+	if (image_offset >= ctx.cur_item_size) {
+		/* Not expected, but the writer does not want any more data */
+		image_offset = ctx.cur_item_size;
+	}
+
+	ctx.cur_offset += image_offset;
+	ctx.cur_item_offset = image_offset;
+
+	if (ctx.cur_item_offset == ctx.cur_item_size) {
+		err = writer->close(true);
+		if (err) {
+			return err;
+		}
+
+		select_next_image();
+	}
+
+	return 0;
+}
+#endif /* CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS */
+
 static int process_current_item(const uint8_t *chunk, size_t chunk_size)
 {
 	int err = 0;
@@ -148,9 +350,10 @@ static int process_current_item(const uint8_t *chunk, size_t chunk_size)
 			err = -ESPIPE;
 		}
 
-		if (!err && ctx.cur_item_offset == 0) {
+		if (!err && !ctx.cur_image_open) {
 			err = writer->open(writer->image_id,
 					   ctx.header.images[ctx.cur_image_no].size);
+			ctx.cur_image_open = (err == 0);
 		}
 
 		if (!err) {
@@ -159,6 +362,7 @@ static int process_current_item(const uint8_t *chunk, size_t chunk_size)
 
 		if (!err && ctx.cur_item_offset + chunk_size == ctx.cur_item_size) {
 			err = writer->close(true);
+			ctx.cur_image_open = false;
 		}
 	}
 
@@ -170,7 +374,22 @@ static int process_current_item(const uint8_t *chunk, size_t chunk_size)
 	ctx.cur_item_offset += chunk_size;
 
 	if (ctx.cur_item_offset == ctx.cur_item_size) {
+		const bool header_done = (ctx.cur_image_no == IMAGE_NO_CBOR_HEADER);
+
 		select_next_image();
+
+#ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
+		if (header_done) {
+			err = resume_progress();
+			if (err) {
+				return err;
+			}
+		}
+
+		progress_store();
+#else
+		ARG_UNUSED(header_done);
+#endif
 	}
 
 	return chunk_size;
@@ -188,7 +407,11 @@ int dfu_multi_image_init(uint8_t *buffer, size_t buffer_size)
 	ctx.cur_image_no = IMAGE_NO_FIXED_HEADER;
 	ctx.cur_item_size = FIXED_HEADER_SIZE;
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
+	return progress_load();
+#else
 	return 0;
+#endif
 }
 
 int dfu_multi_image_register_writer(const struct dfu_image_writer *writer)
@@ -245,6 +468,7 @@ int dfu_multi_image_done(bool success)
 	/* Close any active writer if such exists */
 	if (writer != NULL) {
 		err = writer->close(success);
+		ctx.cur_image_open = false;
 	}
 
 	/* On success, verify that all images have been fully written */
@@ -252,5 +476,23 @@ int dfu_multi_image_done(bool success)
 		return -ESPIPE;
 	}
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
+	/* Keep the progress record on failure so that the package can be resumed */
+	if (!err && success) {
+		err = progress_delete();
+	}
+#endif
+
 	return err;
 }
+
+int dfu_multi_image_reset_progress(void)
+{
+#ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
+	stored_progress_valid = false;
+
+	return progress_delete();
+#else
+	return 0;
+#endif
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file app_delta_patch.h
+ *
+ * @brief Streaming decoder of application delta patches.
+ *
+ * The patch format is described in 'scripts/bootloader/app_delta_tool.py',
+ * which is used to create the patches. The decoder consumes the patch in
+ * chunks of arbitrary size, reads the source image through a user-provided
+ * function and hands the resulting image over in blocks of
+ * @ref APP_DELTA_PATCH_OUT_BUF_SIZE bytes.
+ */
+
+#ifndef APP_DELTA_PATCH_H__
+#define APP_DELTA_PATCH_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define APP_DELTA_PATCH_MAGIC 0x0d3a11fa
+#define APP_DELTA_PATCH_VERSION 1
+#define APP_DELTA_PATCH_HEADER_SIZE 24
+
+#define APP_DELTA_PATCH_SRC_BUF_SIZE 256
+#define APP_DELTA_PATCH_OUT_BUF_SIZE 256
+
+struct app_delta_patch_header {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t flags;
+	uint32_t source_size;
+	uint32_t source_crc;
+	uint32_t target_size;
+	uint32_t target_crc;
+};
+
+struct app_delta_patch_ops {
+	/** Read @p len bytes of the source image at @p offset. */
+	int (*source_read)(size_t offset, uint8_t *buf, size_t len);
+
+	/** Called once the header has been parsed and the source verified. */
+	int (*header)(const struct app_delta_patch_header *header);
+
+	/** Write the subsequent block of the target image. */
+	int (*target_write)(const uint8_t *buf, size_t len);
+};
+
+enum app_delta_patch_state {
+	APP_DELTA_PATCH_STATE_HEADER,
+	APP_DELTA_PATCH_STATE_CTRL,
+	APP_DELTA_PATCH_STATE_DIFF,
+	APP_DELTA_PATCH_STATE_EXTRA,
+	APP_DELTA_PATCH_STATE_DONE,
+};
+
+struct app_delta_patch {
+	const struct app_delta_patch_ops *ops;
+	enum app_delta_patch_state state;
+	struct app_delta_patch_header header;
+
+	/* Number of patch bytes consumed so far. */
+	size_t patch_offset;
+
+	/* Current record. */
+	uint32_t diff_left;
+	uint32_t extra_left;
+	int32_t seek;
+	uint32_t run_left;
+	uint32_t varint;
+	uint8_t varint_shift;
+	uint8_t ctrl_field;
+
+	size_t source_offset;
+	size_t target_offset;
+	uint32_t target_crc;
+
+	uint8_t header_buf[APP_DELTA_PATCH_HEADER_SIZE];
+	size_t header_len;
+
+	uint8_t src_buf[APP_DELTA_PATCH_SRC_BUF_SIZE];
+	size_t src_buf_offset;
+	size_t src_buf_len;
+
+	uint8_t out_buf[APP_DELTA_PATCH_OUT_BUF_SIZE];
+	size_t out_len;
+};
+
+/**
+ * @brief Check if data starts with an application delta patch header.
+ *
+ * @param[in] buf Data, at least 4 bytes long.
+ *
+ * @retval true if data matches, false otherwise.
+ */
+bool app_delta_patch_identify(const void *buf);
+
+/**
+ * @brief Reset the decoder to the beginning of a patch.
+ *
+ * @param[out] patch Decoder context.
+ * @param[in] ops Functions used to access the source and target images.
+ */
+void app_delta_patch_init(struct app_delta_patch *patch,
+			  const struct app_delta_patch_ops *ops);
+
+/**
+ * @brief Process the subsequent chunk of a patch.
+ *
+ * @param[in] patch Decoder context.
+ * @param[in] buf Patch data.
+ * @param[in] len Length of the patch data.
+ *
+ * @retval -EBADMSG If the patch is malformed.
+ * @retval -ENOENT If the patch does not apply to the source image.
+ * @return negative Error returned by one of the operations.
+ * @return 0 On success.
+ */
+int app_delta_patch_process(struct app_delta_patch *patch, const uint8_t *buf, size_t len);
+
+/**
+ * @brief Flush the remaining target data and verify the target image.
+ *
+ * @param[in] patch Decoder context.
+ *
+ * @retval -EBADMSG If the patch is incomplete or the target image is corrupted.
+ * @return negative Error returned by one of the operations.
+ * @return 0 On success.
+ */
+int app_delta_patch_finish(struct app_delta_patch *patch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_DELTA_PATCH_H__ */
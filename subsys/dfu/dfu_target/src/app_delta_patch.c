@@ -0,0 +1,390 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+
+#include "app_delta_patch.h"
+
+#define RLE_ZERO_RUN BIT(7)
+#define RLE_RUN_MASK BIT_MASK(7)
+#define VARINT_MORE BIT(7)
+#define VARINT_MAX_SHIFT 28
+
+enum ctrl_field {
+	CTRL_DIFF_LEN,
+	CTRL_EXTRA_LEN,
+	CTRL_SEEK,
+};
+
+bool app_delta_patch_identify(const void *buf)
+{
+	return sys_get_le32(buf) == APP_DELTA_PATCH_MAGIC;
+}
+
+void app_delta_patch_init(struct app_delta_patch *patch,
+			  const struct app_delta_patch_ops *ops)
+{
+	memset(patch, 0, sizeof(*patch));
+	patch->ops = ops;
+	patch->state = APP_DELTA_PATCH_STATE_HEADER;
+}
+
+static int out_flush(struct app_delta_patch *patch)
+{
+	int err;
+
+	if (patch->out_len == 0) {
+		return 0;
+	}
+
+	patch->target_crc = crc32_ieee_update(patch->target_crc, patch->out_buf,
+					      patch->out_len);
+
+	err = patch->ops->target_write(patch->out_buf, patch->out_len);
+	patch->out_len = 0;
+
+	return err;
+}
+
+static int out_put(struct app_delta_patch *patch, uint8_t byte)
+{
+	patch->out_buf[patch->out_len++] = byte;
+	patch->target_offset++;
+
+	if (patch->out_len == sizeof(patch->out_buf)) {
+		return out_flush(patch);
+	}
+
+	return 0;
+}
+
+/* Make sure the source byte at the current source offset is buffered. */
+static int source_fetch(struct app_delta_patch *patch)
+{
+	size_t len;
+	int err;
+
+	if (patch->source_offset >= patch->src_buf_offset &&
+	    patch->source_offset < patch->src_buf_offset + patch->src_buf_len) {
+		return 0;
+	}
+
+	if (patch->source_offset >= patch->header.source_size) {
+		return -EBADMSG;
+	}
+
+	len = MIN(sizeof(patch->src_buf), patch->header.source_size - patch->source_offset);
+
+	err = patch->ops->source_read(patch->source_offset, patch->src_buf, len);
+	if (err) {
+		return err;
+	}
+
+	patch->src_buf_offset = patch->source_offset;
+	patch->src_buf_len = len;
+
+	return 0;
+}
+
+/* Add diff bytes, or zeros if @p diff is NULL, to the source and output the result. */
+static int apply_diff(struct app_delta_patch *patch, const uint8_t *diff, size_t len)
+{
+	while (len > 0) {
+		size_t src_pos;
+		size_t chunk;
+		int err;
+
+		err = source_fetch(patch);
+		if (err) {
+			return err;
+		}
+
+		src_pos = patch->source_offset - patch->src_buf_offset;
+		chunk = MIN(len, patch->src_buf_len - src_pos);
+
+		for (size_t i = 0; i < chunk; i++) {
+			uint8_t byte = patch->src_buf[src_pos + i];
+
+			if (diff) {
+				byte += diff[i];
+			}
+
+			err = out_put(patch, byte);
+			if (err) {
+				return err;
+			}
+		}
+
+		patch->source_offset += chunk;
+		len -= chunk;
+
+		if (diff) {
+			diff += chunk;
+		}
+	}
+
+	return 0;
+}
+
+static int verify_source(struct app_delta_patch *patch)
+{
+	uint32_t crc = 0;
+	size_t offset = 0;
+
+	while (offset < patch->header.source_size) {
+		size_t len = MIN(sizeof(patch->src_buf), patch->header.source_size - offset);
+		int err = patch->ops->source_read(offset, patch->src_buf, len);
+
+		if (err) {
+			return err;
+		}
+
+		crc = crc32_ieee_update(crc, patch->src_buf, len);
+		offset += len;
+	}
+
+	/* The buffer now holds the end of the source, not what src_buf_offset says. */
+	patch->src_buf_len = 0;
+
+	return (crc == patch->header.source_crc) ? 0 : -ENOENT;
+}
+
+static int parse_header(struct app_delta_patch *patch)
+{
+	struct app_delta_patch_header *header = &patch->header;
+	const uint8_t *buf = patch->header_buf;
+	int err;
+
+	header->magic = sys_get_le32(&buf[0]);
+	header->version = sys_get_le16(&buf[4]);
+	header->flags = sys_get_le16(&buf[6]);
+	header->source_size = sys_get_le32(&buf[8]);
+	header->source_crc = sys_get_le32(&buf[12]);
+	header->target_size = sys_get_le32(&buf[16]);
+	header->target_crc = sys_get_le32(&buf[20]);
+
+	if (header->magic != APP_DELTA_PATCH_MAGIC ||
+	    header->version != APP_DELTA_PATCH_VERSION) {
+		return -EBADMSG;
+	}
+
+	err = verify_source(patch);
+	if (err) {
+		return err;
+	}
+
+	err = patch->ops->header(header);
+	if (err) {
+		return err;
+	}
+
+	patch->state = (header->target_size > 0) ? APP_DELTA_PATCH_STATE_CTRL :
+						    APP_DELTA_PATCH_STATE_DONE;
+
+	return 0;
+}
+
+static int record_done(struct app_delta_patch *patch)
+{
+	int64_t source_offset = (int64_t)patch->source_offset + patch->seek;
+
+	if (source_offset < 0 || source_offset > patch->header.source_size) {
+		return -EBADMSG;
+	}
+
+	patch->source_offset = (size_t)source_offset;
+	patch->state = (patch->target_offset == patch->header.target_size) ?
+		       APP_DELTA_PATCH_STATE_DONE : APP_DELTA_PATCH_STATE_CTRL;
+
+	return 0;
+}
+
+static int next_segment(struct app_delta_patch *patch)
+{
+	if (patch->diff_left > 0) {
+		patch->state = APP_DELTA_PATCH_STATE_DIFF;
+	} else if (patch->extra_left > 0) {
+		patch->state = APP_DELTA_PATCH_STATE_EXTRA;
+	} else {
+		return record_done(patch);
+	}
+
+	return 0;
+}
+
+static int process_ctrl(struct app_delta_patch *patch, uint8_t byte)
+{
+	uint32_t value;
+
+	if (patch->varint_shift > VARINT_MAX_SHIFT) {
+		return -EBADMSG;
+	}
+
+	patch->varint |= (uint32_t)(byte & ~VARINT_MORE) << patch->varint_shift;
+	patch->varint_shift += 7;
+
+	if (byte & VARINT_MORE) {
+		return 0;
+	}
+
+	value = patch->varint;
+	patch->varint = 0;
+	patch->varint_shift = 0;
+
+	switch (patch->ctrl_field) {
+	case CTRL_DIFF_LEN:
+		patch->diff_left = value;
+		patch->ctrl_field = CTRL_EXTRA_LEN;
+		return 0;
+	case CTRL_EXTRA_LEN:
+		patch->extra_left = value;
+		patch->ctrl_field = CTRL_SEEK;
+		return 0;
+	default:
+		/* Zigzag encoded */
+		patch->seek = (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+		patch->ctrl_field = CTRL_DIFF_LEN;
+		break;
+	}
+
+	if ((uint64_t)patch->target_offset + patch->diff_left + patch->extra_left >
+	    patch->header.target_size) {
+		return -EBADMSG;
+	}
+
+	return next_segment(patch);
+}
+
+/* Returns the number of consumed bytes or a negative error code. */
+static int process_diff(struct app_delta_patch *patch, const uint8_t *buf, size_t len)
+{
+	size_t consumed = 0;
+	size_t chunk;
+	int err;
+
+	if (patch->run_left == 0) {
+		uint8_t token = buf[consumed++];
+		uint32_t run = (token & RLE_RUN_MASK) + 1;
+
+		if (run > patch->diff_left) {
+			return -EBADMSG;
+		}
+
+		if (token & RLE_ZERO_RUN) {
+			/* Zero runs need no further input, apply them right away. */
+			err = apply_diff(patch, NULL, run);
+			if (err) {
+				return err;
+			}
+
+			patch->diff_left -= run;
+			goto out;
+		}
+
+		patch->run_left = run;
+	}
+
+	chunk = MIN(patch->run_left, len - consumed);
+
+	err = apply_diff(patch, &buf[consumed], chunk);
+	if (err) {
+		return err;
+	}
+
+	consumed += chunk;
+	patch->run_left -= chunk;
+	patch->diff_left -= chunk;
+
+out:
+	if (patch->diff_left == 0) {
+		patch->state = APP_DELTA_PATCH_STATE_EXTRA;
+
+		if (patch->extra_left == 0) {
+			err = record_done(patch);
+			if (err) {
+				return err;
+			}
+		}
+	}
+
+	return consumed;
+}
+
+int app_delta_patch_process(struct app_delta_patch *patch, const uint8_t *buf, size_t len)
+{
+	while (len > 0) {
+		size_t consumed = 0;
+		int err = 0;
+
+		switch (patch->state) {
+		case APP_DELTA_PATCH_STATE_HEADER:
+			consumed = MIN(len, sizeof(patch->header_buf) - patch->header_len);
+			memcpy(&patch->header_buf[patch->header_len], buf, consumed);
+			patch->header_len += consumed;
+
+			if (patch->header_len == sizeof(patch->header_buf)) {
+				err = parse_header(patch);
+			}
+			break;
+		case APP_DELTA_PATCH_STATE_CTRL:
+			consumed = 1;
+			err = process_ctrl(patch, buf[0]);
+			break;
+		case APP_DELTA_PATCH_STATE_DIFF:
+			err = process_diff(patch, buf, len);
+			consumed = (err > 0) ? err : 0;
+			err = MIN(err, 0);
+			break;
+		case APP_DELTA_PATCH_STATE_EXTRA:
+			consumed = MIN(len, patch->extra_left);
+
+			for (size_t i = 0; i < consumed && !err; i++) {
+				err = out_put(patch, buf[i]);
+			}
+
+			patch->extra_left -= consumed;
+
+			if (!err && patch->extra_left == 0) {
+				err = record_done(patch);
+			}
+			break;
+		default:
+			/* Trailing data */
+			err = -EBADMSG;
+			break;
+		}
+
+		if (err) {
+			return err;
+		}
+
+		patch->patch_offset += consumed;
+		buf += consumed;
+		len -= consumed;
+	}
+
+	return 0;
+}
+
+int app_delta_patch_finish(struct app_delta_patch *patch)
+{
+	int err;
+
+	if (patch->state != APP_DELTA_PATCH_STATE_DONE) {
+		return -EBADMSG;
+	}
+
+	err = out_flush(patch);
+	if (err) {
+		return err;
+	}
+
+	return (patch->target_crc == patch->header.target_crc) ? 0 : -EBADMSG;
+}
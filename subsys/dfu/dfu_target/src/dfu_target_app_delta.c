@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <pm_config.h>
+#include <dfu/dfu_target.h>
+#include <dfu/dfu_target_mcuboot.h>
+#include <dfu/dfu_target_app_delta.h>
+
+#include "app_delta_patch.h"
+
+LOG_MODULE_REGISTER(dfu_target_app_delta, CONFIG_DFU_TARGET_LOG_LEVEL);
+
+static struct app_delta_patch patch;
+static const struct flash_area *primary;
+static bool target_initialized;
+
+static int source_read(size_t offset, uint8_t *buf, size_t len)
+{
+	return flash_area_read(primary, offset, buf, len);
+}
+
+static int header_parsed(const struct app_delta_patch_header *header)
+{
+	int err;
+
+	LOG_INF("Patching %u byte image into %u byte image",
+		header->source_size, header->target_size);
+
+	err = dfu_target_mcuboot_init(header->target_size, 0, NULL);
+	if (err) {
+		LOG_ERR("dfu_target_mcuboot_init failed %d", err);
+		return err;
+	}
+
+	target_initialized = true;
+
+	return 0;
+}
+
+static int target_write(const uint8_t *buf, size_t len)
+{
+	return dfu_target_mcuboot_write(buf, len);
+}
+
+static const struct app_delta_patch_ops patch_ops = {
+	.source_read = source_read,
+	.header = header_parsed,
+	.target_write = target_write,
+};
+
+bool dfu_target_app_delta_identify(const void *const buf)
+{
+	return app_delta_patch_identify(buf);
+}
+
+int dfu_target_app_delta_init(size_t file_size, int img_num, dfu_target_callback_t cb)
+{
+	ARG_UNUSED(file_size);
+	ARG_UNUSED(cb);
+	int err;
+
+	if (img_num != 0) {
+		LOG_ERR("Only image 0 can be patched");
+		return -ENOTSUP;
+	}
+
+	if (primary == NULL) {
+		err = flash_area_open(PM_MCUBOOT_PRIMARY_ID, &primary);
+		if (err) {
+			LOG_ERR("Failed to open primary slot %d", err);
+			return err;
+		}
+	}
+
+	app_delta_patch_init(&patch, &patch_ops);
+	target_initialized = false;
+
+	return 0;
+}
+
+int dfu_target_app_delta_offset_get(size_t *out)
+{
+	*out = patch.patch_offset;
+
+	return 0;
+}
+
+int dfu_target_app_delta_write(const void *const buf, size_t len)
+{
+	int err = app_delta_patch_process(&patch, buf, len);
+
+	if (err == -ENOENT) {
+		LOG_ERR("Patch does not apply to the primary slot image");
+	} else if (err) {
+		LOG_ERR("Patch processing failed %d", err);
+	}
+
+	return err;
+}
+
+int dfu_target_app_delta_done(bool successful)
+{
+	int err = 0;
+
+	if (successful) {
+		err = app_delta_patch_finish(&patch);
+		if (err) {
+			LOG_ERR("Patched image is incomplete or corrupted %d", err);
+			successful = false;
+		}
+	}
+
+	if (target_initialized) {
+		int done_err = dfu_target_mcuboot_done(successful);
+
+		err = err ? err : done_err;
+	}
+
+	/* The patch can only be applied from the beginning again. */
+	app_delta_patch_init(&patch, &patch_ops);
+	target_initialized = false;
+
+	return err;
+}
+
+int dfu_target_app_delta_schedule_update(int img_num)
+{
+	ARG_UNUSED(img_num);
+
+	return dfu_target_mcuboot_schedule_update(0);
+}
@@ -23,8 +23,49 @@ static sys_slist_t emds_dynamic_entries;
 static struct emds_fs emds_flash;
 static emds_store_cb_t app_store_cb;
 
+static int entry_store(const struct emds_entry *entry)
+{
+	int rc = emds_flash_store_entry(&emds_flash, entry->id, entry->data, entry->len);
+
+	if (rc == -ENOMEM) {
+		LOG_ERR("Write entry: (%d) does not fit", entry->id);
+	} else if (rc) {
+		LOG_ERR("Write entry: (%d) error (%d)", entry->id, rc);
+	}
+
+	return rc;
+}
+
+/* An entry which does not fit is skipped, and the other entries are still
+ * stored.
+ */
+static int entries_store(void)
+{
+	int rc;
+
+	STRUCT_SECTION_FOREACH(emds_entry, ch) {
+		rc = entry_store(ch);
+		if (rc && rc != -ENOMEM) {
+			return rc;
+		}
+	}
+
+	struct emds_dynamic_entry *ch;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
+		rc = entry_store(&ch->entry);
+		if (rc && rc != -ENOMEM) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
 static void emds_handler(void)
 {
+	int rc;
+
 	while (true) {
 		k_sem_reset(&emds_sem);
 		k_sem_take(&emds_sem, K_FOREVER);
@@ -33,33 +74,22 @@ static void emds_handler(void)
 
 		LOG_DBG("Emergency Data Storeage released");
 
-		STRUCT_SECTION_FOREACH(emds_entry, ch) {
-			ssize_t len = emds_flash_write(&emds_flash,
-						       ch->id, ch->data, ch->len);
-			if (len < 0) {
-				LOG_ERR("Write static entry: (%d) error (%d)",
-					ch->id, len);
-			} else if (len != ch->len) {
-				LOG_ERR("Write static entry: (%d) failed (%d:%d)",
-					ch->id, ch->len, len);
-			}
-		}
+		rc = emds_flash_store_begin(&emds_flash);
+		if (!rc) {
+			int err;
 
-		struct emds_dynamic_entry *ch;
+			rc = entries_store();
 
-		SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-			ssize_t len = emds_flash_write(&emds_flash,
-						       ch->entry.id, ch->entry.data, ch->entry.len);
-			if (len < 0) {
-				LOG_ERR("Write dynamic entry: (%d) error (%d).",
-					ch->entry.id, len);
-			}
-			if (len != ch->entry.len) {
-				LOG_ERR("Write dynamic entry: (%d) failed (%d:%d).",
-					ch->entry.id, ch->entry.len, len);
+			err = emds_flash_store_end(&emds_flash);
+			if (!rc) {
+				rc = err;
 			}
 		}
 
+		if (rc) {
+			LOG_ERR("Store failed (%d)", rc);
+		}
+
 		emds_ready = false;
 
 		k_sched_unlock();
@@ -122,27 +152,38 @@ static int emds_fs_init(void)
 }
 
 
-static int emds_entries_size(uint32_t *size)
+static int emds_entries_layout(uint32_t *data_size, uint32_t *ate_size)
 {
 	size_t block_size = emds_flash.flash_params->write_block_size;
 	int entries = 0;
 
-	*size = 0;
+	*data_size = 0;
 
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
-		*size += NRFX_CEIL_DIV(ch->len, block_size) * block_size;
-		*size += NRFX_CEIL_DIV(emds_flash.ate_size, block_size) * block_size;
+		*data_size += NRFX_CEIL_DIV(ch->len, block_size) * block_size;
 		entries++;
 	}
 
 	struct emds_dynamic_entry *ch;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-		*size += NRFX_CEIL_DIV(ch->entry.len, block_size) * block_size;
-		*size += NRFX_CEIL_DIV(emds_flash.ate_size, block_size) * block_size;
+		*data_size += NRFX_CEIL_DIV(ch->entry.len, block_size) * block_size;
 		entries++;
 	}
 
+	*ate_size = entries * NRFX_CEIL_DIV(emds_flash.ate_size, block_size) * block_size;
+
+	return entries;
+}
+
+static int emds_entries_size(uint32_t *size)
+{
+	uint32_t data_size;
+	uint32_t ate_size;
+	int entries = emds_entries_layout(&data_size, &ate_size);
+
+	*size = data_size + ate_size;
+
 	return entries;
 }
 
@@ -276,34 +317,28 @@ int emds_prepare(void)
 
 	emds_ready = true;
 
+	LOG_DBG("Ready to store %u bytes in %u us", size, emds_store_time_get());
+
 	return 0;
 }
 
 uint32_t emds_store_time_get(void)
 {
 	size_t block_size = emds_flash.flash_params->write_block_size;
-	uint32_t store_time_us = CONFIG_EMDS_FLASH_TIME_BASE_OVERHEAD_US;
-
-
-	STRUCT_SECTION_FOREACH(emds_entry, ch) {
-		store_time_us += NRFX_CEIL_DIV(ch->len, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + NRFX_CEIL_DIV(emds_flash.ate_size, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US;
-	}
-
-	struct emds_dynamic_entry *ch;
-
-	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-		store_time_us += NRFX_CEIL_DIV(ch->entry.len, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + NRFX_CEIL_DIV(emds_flash.ate_size, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US;
-	}
-
-	return store_time_us;
+	uint32_t data_size;
+	uint32_t ate_size;
+
+	int entries = emds_entries_layout(&data_size, &ate_size);
+
+	/* The entries are gathered into as few flash writes as the store
+	 * buffer allows, see emds_flash_store_begin().
+	 */
+	return CONFIG_EMDS_FLASH_TIME_BASE_OVERHEAD_US +
+	       entries * CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US +
+	       NRFX_CEIL_DIV(data_size + ate_size, block_size) *
+			CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US +
+	       emds_flash_store_writes_get(data_size, ate_size) *
+			CONFIG_EMDS_FLASH_TIME_WRITE_OVERHEAD_US;
 }
 
 uint32_t emds_store_size_get(void)
@@ -36,6 +36,12 @@ enum ate_type {
 BUILD_ASSERT(offsetof(struct emds_ate, crc8) == sizeof(struct emds_ate) - sizeof(uint8_t),
 	     "crc8 must be the last member");
 
+BUILD_ASSERT(!(CONFIG_EMDS_STORE_BUF_SIZE % sizeof(struct emds_ate)),
+	     "Store buffer must hold a whole number of allocation table entries");
+
+/* Gathers the data and the allocation table entries of a store. */
+static uint8_t store_buf[CONFIG_EMDS_STORE_BUF_SIZE] __aligned(4);
+
 static size_t align_size(struct emds_fs *fs, size_t len)
 {
 	uint8_t write_block_size = fs->flash_params->write_block_size;
@@ -356,6 +362,173 @@ ssize_t emds_flash_write(struct emds_fs *fs, uint16_t id, const void *data, size
 	return len;
 }
 
+/* The data is written before the allocation table entries pointing to it, so
+ * that each flush leaves only complete entries in flash.
+ */
+static int store_flush(struct emds_fs *fs)
+{
+	int rc;
+
+	if (fs->store_len) {
+		rc = flash_write(fs->flash_dev, fs->store_wra, store_buf, fs->store_len);
+		if (rc) {
+			return rc;
+		}
+
+		fs->store_wra += fs->store_len;
+		fs->store_len = 0;
+	}
+
+	if (fs->store_ate_len) {
+		rc = flash_write(fs->flash_dev, fs->ate_wra + fs->ate_size,
+				 &store_buf[sizeof(store_buf) - fs->store_ate_len],
+				 fs->store_ate_len);
+		if (rc) {
+			return rc;
+		}
+
+		fs->store_ate_len = 0;
+	}
+
+	return 0;
+}
+
+/* Whether an entry fits between the allocation table entries and the data,
+ * with its own allocation table entry.
+ */
+static bool store_fits(struct emds_fs *fs, size_t len)
+{
+	ssize_t space = fs->ate_wra - (fs->data_wra_offset + fs->offset);
+
+	return fs->ate_size + align_size(fs, len) <= MAX(space, 0);
+}
+
+/* The data is gathered from the start of the buffer. The CRC is computed on the
+ * gathered copy, which is what gets written.
+ */
+static int store_data_add(struct emds_fs *fs, const void *data, size_t len, uint8_t *crc8)
+{
+	const uint8_t *data8 = (const uint8_t *)data;
+	size_t cpy_len;
+	int rc;
+
+	while (len) {
+		if (fs->store_len + fs->store_ate_len == sizeof(store_buf)) {
+			rc = store_flush(fs);
+			if (rc) {
+				return rc;
+			}
+		}
+
+		cpy_len = MIN(len, sizeof(store_buf) - fs->store_ate_len - fs->store_len);
+		(void)memcpy(&store_buf[fs->store_len], data8, cpy_len);
+
+		if (crc8) {
+			*crc8 = crc8_ccitt(*crc8, &store_buf[fs->store_len], cpy_len);
+		}
+
+		fs->store_len += cpy_len;
+		data8 += cpy_len;
+		len -= cpy_len;
+	}
+
+	return 0;
+}
+
+/* The allocation table entries are written downwards, so they are gathered from
+ * the end of the buffer.
+ */
+static int store_ate_add(struct emds_fs *fs, const struct emds_ate *entry)
+{
+	int rc;
+
+	if (fs->store_len + fs->store_ate_len + fs->ate_size > sizeof(store_buf)) {
+		rc = store_flush(fs);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	fs->store_ate_len += fs->ate_size;
+	(void)memcpy(&store_buf[sizeof(store_buf) - fs->store_ate_len], entry, sizeof(*entry));
+
+	fs->ate_wra -= fs->ate_size;
+	return 0;
+}
+
+int emds_flash_store_begin(struct emds_fs *fs)
+{
+	if (!fs->is_initialized || !fs->is_prepeared) {
+		LOG_ERR("EMDS flash not initialized or not ready for write");
+		return -EACCES;
+	}
+
+	k_mutex_lock(&fs->emds_lock, K_FOREVER);
+
+	fs->store_wra = fs->offset + (fs->data_wra_offset & ADDR_OFFS_MASK);
+	fs->store_len = 0;
+	fs->store_ate_len = 0;
+	return 0;
+}
+
+int emds_flash_store_entry(struct emds_fs *fs, uint16_t id, const void *data, size_t len)
+{
+	uint8_t pad[EMDS_FLASH_BLOCK_SIZE];
+	size_t pad_len = align_size(fs, len) - len;
+	struct emds_ate entry;
+	int rc;
+
+	if (len == 0) {
+		return 0;
+	}
+
+	if (!store_fits(fs, len)) {
+		return -ENOMEM;
+	}
+
+	entry.id = id;
+	entry.offset = fs->data_wra_offset;
+	entry.len = (uint16_t)len;
+	entry.crc8_data = 0xff;
+
+	rc = store_data_add(fs, data, len, &entry.crc8_data);
+	if (rc) {
+		return rc;
+	}
+
+	if (pad_len) {
+		(void)memset(pad, fs->flash_params->erase_value, pad_len);
+		rc = store_data_add(fs, pad, pad_len, NULL);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	fs->data_wra_offset += align_size(fs, len);
+
+	entry.crc8 = crc8_ccitt(0xff, &entry, offsetof(struct emds_ate, crc8));
+
+	return store_ate_add(fs, &entry);
+}
+
+int emds_flash_store_end(struct emds_fs *fs)
+{
+	int rc = store_flush(fs);
+
+	k_mutex_unlock(&fs->emds_lock);
+	return rc;
+}
+
+uint32_t emds_flash_store_writes_get(size_t data_size, size_t ate_size)
+{
+	/* The buffer is flushed when full, up to the last write block of data
+	 * which does not leave room for an allocation table entry. Each flush
+	 * writes the data, then the allocation table entries.
+	 */
+	return 2 * ((data_size + ate_size) / (CONFIG_EMDS_STORE_BUF_SIZE - EMDS_FLASH_BLOCK_SIZE) +
+		    1);
+}
+
 ssize_t emds_flash_read(struct emds_fs *fs, uint16_t id, void *data, size_t len)
 {
 	if (!fs->is_initialized) {
@@ -31,6 +31,9 @@ extern "C" {
  * @param flash_dev Pointer to flash device runtime structure
  * @param flash_params Pointer to flash memory parameters structure
  * @param force_erase Force erase flag
+ * @param store_wra Flash address of the data gathered by the ongoing store
+ * @param store_len Number of data bytes gathered by the ongoing store
+ * @param store_ate_len Number of allocation table entry bytes gathered by the ongoing store
  */
 struct emds_fs {
 	off_t offset;
@@ -45,6 +48,9 @@ struct emds_fs {
 	const struct device *flash_dev;
 	const struct flash_parameters *flash_params;
 	bool force_erase;
+	uint32_t store_wra;
+	size_t store_len;
+	size_t store_ate_len;
 };
 
 /**
@@ -82,6 +88,64 @@ int emds_flash_clear(struct emds_fs *fs);
  */
 ssize_t emds_flash_write(struct emds_fs *fs, uint16_t id, const void *data, size_t len);
 
+/**
+ * @brief Start storing a set of entries to the EMDS file system.
+ *
+ * The data and the allocation table entries of the stored entries are
+ * gathered into writes of up to @kconfig{CONFIG_EMDS_STORE_BUF_SIZE} bytes,
+ * independently of the entry boundaries. Each time the buffer is full, the
+ * gathered data is written, followed by the allocation table entries of the
+ * entries whose data is then complete in flash. An interrupted store thus only
+ * loses the entries gathered since the last write. The result in flash is the
+ * same as calling @ref emds_flash_write for each entry.
+ *
+ * Each entry must be passed to @ref emds_flash_store_entry, and the store must
+ * be completed by @ref emds_flash_store_end.
+ *
+ * @param fs Pointer to file system
+ *
+ * @retval 0 on success or negative error code
+ */
+int emds_flash_store_begin(struct emds_fs *fs);
+
+/**
+ * @brief Gather an entry in the ongoing store.
+ *
+ * The data is copied when called, and the CRC of the entry is computed on the copy.
+ *
+ * @param fs Pointer to file system
+ * @param id Id of the entry
+ * @param data Pointer to the data to be written
+ * @param len Number of bytes to be written
+ *
+ * @retval 0 on success or negative error code
+ * @retval -ENOMEM The entry does not fit, and is skipped. The store can
+ *                 continue with the next entries.
+ */
+int emds_flash_store_entry(struct emds_fs *fs, uint16_t id, const void *data, size_t len);
+
+/**
+ * @brief Complete the ongoing store.
+ *
+ * Writes the data and the allocation table entries still gathered. Must be called once for
+ * each call to @ref emds_flash_store_begin, even if the store failed.
+ *
+ * @param fs Pointer to file system
+ *
+ * @retval 0 on success or negative error code
+ */
+int emds_flash_store_end(struct emds_fs *fs);
+
+/**
+ * @brief Get the number of flash writes needed by a store.
+ *
+ * @param data_size Total size of the data of the entries, aligned to the write block size
+ * @param ate_size Total size of the allocation table entries
+ *
+ * @return Maximum number of flash writes made by a store of the entries.
+ */
+uint32_t emds_flash_store_writes_get(size_t data_size, size_t ate_size);
+
 /**
  * @brief Read an entry from the EMDS file system.
  *
@@ -778,6 +778,49 @@ static int format_range_header(char *const buf, size_t buf_sz, size_t start_byte
 	return 0;
 }
 
+/* Streams A-GPS data directly into the result buffer of the caller. */
+struct agps_stream {
+	struct nrf_cloud_rest_agps_result *result;
+	/* Offset of the requested range in the A-GPS data */
+	size_t range_start;
+	/* Total size of the A-GPS data, from the first response */
+	int total_bytes;
+};
+
+static int agps_body_cb(const struct rest_client_body_frag *frag, void *user_data)
+{
+	struct agps_stream *stream = user_data;
+	size_t pos = stream->range_start + frag->offset;
+
+	if (frag->http_status_code != NRF_CLOUD_HTTP_STATUS_PARTIAL) {
+		/* Not A-GPS data, the status is checked when the request completes */
+		return 0;
+	}
+
+	if (stream->total_bytes == 0) {
+		/* The headers may have been received in an earlier receive buffer */
+		stream->total_bytes = frag->range_total;
+		if (stream->total_bytes <= 0) {
+			LOG_ERR("No Content-Range total in the A-GPS response");
+			return -EBADMSG;
+		}
+
+		if (stream->result->buf_sz < stream->total_bytes) {
+			LOG_ERR("Result buffer too small for %d bytes of A-GPS data",
+				stream->total_bytes);
+			return -ENOBUFS;
+		}
+	}
+
+	if (pos + frag->len > stream->total_bytes) {
+		return -EFBIG;
+	}
+
+	memcpy(&stream->result->buf[pos], frag->data, frag->len);
+
+	return 0;
+}
+
 int nrf_cloud_rest_agps_data_get(struct nrf_cloud_rest_context *const rest_ctx,
 				 struct nrf_cloud_rest_agps_request const *const request,
 				 struct nrf_cloud_rest_agps_result *const result)
@@ -799,6 +842,9 @@ int nrf_cloud_rest_agps_data_get(struct nrf_cloud_rest_context *const rest_ctx,
 	char range_hdr[HDR_RANGE_BYTES_SZ];
 	struct rest_client_req_context req;
 	struct rest_client_resp_context resp;
+	struct agps_stream stream = {
+		.result = result,
+	};
 	static int64_t last_request_timestamp;
 	bool filtered;
 	uint8_t mask_angle;
@@ -806,6 +852,12 @@ int nrf_cloud_rest_agps_data_get(struct nrf_cloud_rest_context *const rest_ctx,
 	memset(&resp, 0, sizeof(resp));
 	init_rest_client_request(rest_ctx, &req, HTTP_GET);
 
+	if (result) {
+		/* Stream the data into the result buffer instead of rx_buf */
+		req.body_cb = agps_body_cb;
+		req.body_cb_user_data = &stream;
+	}
+
 #if defined(CONFIG_NRF_CLOUD_AGPS_FILTERED_RUNTIME)
 	filtered = request->filtered;
 	mask_angle = request->mask_angle;
@@ -971,7 +1023,6 @@ int nrf_cloud_rest_agps_data_get(struct nrf_cloud_rest_context *const rest_ctx,
 
 	req.header_fields = (const char **)headers;
 
-	pos = 0;
 	remain = 0;
 	rcvd_bytes = 0;
 	total_bytes = 0;
@@ -989,6 +1040,8 @@ int nrf_cloud_rest_agps_data_get(struct nrf_cloud_rest_context *const rest_ctx,
 			goto clean_up;
 		}
 
+		stream.range_start = rcvd_bytes;
+
 		/* Send request, do not check for good response status  */
 		ret = do_rest_client_request(rest_ctx, &req, &resp, false, false);
 		if (ret) {
@@ -1001,7 +1054,8 @@ int nrf_cloud_rest_agps_data_get(struct nrf_cloud_rest_context *const rest_ctx,
 		}
 
 		if (total_bytes == 0) {
-			total_bytes = get_content_range_total_bytes(rest_ctx->rx_buf);
+			total_bytes = result ? stream.total_bytes :
+					       get_content_range_total_bytes(rest_ctx->rx_buf);
 			if (total_bytes <= 0) {
 				ret = -EBADMSG;
 				goto clean_up;
@@ -1037,11 +1091,7 @@ int nrf_cloud_rest_agps_data_get(struct nrf_cloud_rest_context *const rest_ctx,
 			goto clean_up;
 		}
 
-		memcpy(&result->buf[pos],
-		       rest_ctx->response,
-		       rest_ctx->response_len);
-
-		pos += rest_ctx->response_len;
+		/* The data has already been streamed into the result buffer */
 		remain = total_bytes - rcvd_bytes;
 
 	} while (remain);
@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <ctype.h>
 #include <string.h>
+#include <strings.h>
 #include <zephyr/kernel.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -26,29 +28,170 @@
 
 #include <net/rest_client.h>
 
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+#include "rest_client_pool.h"
+#endif
+
 LOG_MODULE_REGISTER(rest_client, CONFIG_REST_CLIENT_LOG_LEVEL);
 
 #define HTTP_PROTOCOL "HTTP/1.1"
 
+#define CONTENT_RANGE_FIELD "Content-Range"
+/* Enough for "bytes <first>-<last>/<complete length>" */
+#define REST_CLIENT_RANGE_VALUE_MAX 48
+
+/* State of a single HTTP exchange, passed to the HTTP client as user data. */
+struct rest_client_http_ctx {
+	const struct rest_client_req_context *req_ctx;
+	struct rest_client_resp_context *resp_ctx;
+	/* Body bytes passed to the body callback so far */
+	size_t body_offset;
+	/* First error returned by the body callback */
+	int body_err;
+	/* Characters of the current header field matching Content-Range, or -1 */
+	int range_match;
+	/* The parser is in a header value */
+	bool hdr_value;
+	/* The current header value is the Content-Range value */
+	bool range_value;
+	char range[REST_CLIENT_RANGE_VALUE_MAX];
+	size_t range_len;
+	/* Complete length from the Content-Range header */
+	size_t range_total;
+};
+
+/* Called by the HTTP parser with the body data in the receive buffer. The data
+ * has the chunk framing of chunked transfer encoding removed.
+ */
+static int rest_client_body_stream(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_request *req = CONTAINER_OF(parser, struct http_request, internal.parser);
+	struct rest_client_http_ctx *ctx = req->internal.user_data;
+	struct rest_client_body_frag frag;
+
+	if (length == 0 || ctx->body_err) {
+		return 0;
+	}
+
+	frag.data = at;
+	frag.len = length;
+	frag.offset = ctx->body_offset;
+	frag.http_status_code = parser->status_code;
+	frag.range_total = ctx->range_total;
+
+	ctx->body_err = ctx->req_ctx->body_cb(&frag, ctx->req_ctx->body_cb_user_data);
+	if (ctx->body_err) {
+		LOG_WRN("Body callback failed at offset %d, error: %d", frag.offset,
+			ctx->body_err);
+	}
+
+	ctx->body_offset += length;
+
+	/* Errors are not passed to the parser, which would stop parsing the
+	 * response and leave the HTTP client waiting for its end.
+	 */
+	return 0;
+}
+
+/* The header fields and values can be split over several receive buffers, so
+ * the Content-Range header is matched and copied as it is parsed.
+ */
+static int rest_client_header_field(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_request *req = CONTAINER_OF(parser, struct http_request, internal.parser);
+	struct rest_client_http_ctx *ctx = req->internal.user_data;
+
+	if (ctx->hdr_value) {
+		/* A new header field starts */
+		ctx->hdr_value = false;
+		ctx->range_match = 0;
+	}
+
+	for (size_t i = 0; i < length && ctx->range_match >= 0; i++) {
+		if (ctx->range_match < strlen(CONTENT_RANGE_FIELD) &&
+		    tolower((unsigned char)at[i]) ==
+		    tolower((unsigned char)CONTENT_RANGE_FIELD[ctx->range_match])) {
+			ctx->range_match++;
+		} else {
+			ctx->range_match = -1;
+		}
+	}
+
+	return 0;
+}
+
+static int rest_client_header_value(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_request *req = CONTAINER_OF(parser, struct http_request, internal.parser);
+	struct rest_client_http_ctx *ctx = req->internal.user_data;
+
+	if (!ctx->hdr_value) {
+		ctx->hdr_value = true;
+		ctx->range_value = (ctx->range_match == strlen(CONTENT_RANGE_FIELD));
+		if (ctx->range_value) {
+			ctx->range_len = 0;
+		}
+	}
+
+	if (ctx->range_value) {
+		length = MIN(length, sizeof(ctx->range) - 1 - ctx->range_len);
+		memcpy(&ctx->range[ctx->range_len], at, length);
+		ctx->range_len += length;
+		ctx->range[ctx->range_len] = '\0';
+	}
+
+	return 0;
+}
+
+static int rest_client_headers_complete(struct http_parser *parser)
+{
+	struct http_request *req = CONTAINER_OF(parser, struct http_request, internal.parser);
+	struct rest_client_http_ctx *ctx = req->internal.user_data;
+	const char *total;
+
+	if (!ctx->range_len) {
+		return 0;
+	}
+
+	/* An unknown complete length ("*") is reported as 0 */
+	total = strrchr(ctx->range, '/');
+	if (total) {
+		ctx->range_total = strtoul(total + 1, NULL, 10);
+	}
+
+	return 0;
+}
+
+static const struct http_parser_settings rest_client_body_settings = {
+	.on_header_field = rest_client_header_field,
+	.on_header_value = rest_client_header_value,
+	.on_headers_complete = rest_client_headers_complete,
+	.on_body = rest_client_body_stream,
+};
+
 static void rest_client_http_response_cb(struct http_response *rsp,
 					  enum http_final_call final_data,
 					  void *user_data)
 {
+	struct rest_client_http_ctx *ctx = user_data;
 	struct rest_client_resp_context *resp_ctx = NULL;
 
-	if (user_data) {
-		resp_ctx = (struct rest_client_resp_context *)user_data;
+	if (ctx) {
+		resp_ctx = ctx->resp_ctx;
 	}
 
-	/* If the entire HTTP response is not received in a single "recv" call
-	 * then this could be called multiple times, with a different value in
-	 * rsp->body_start. Only set rest_ctx->response once, the first time,
-	 * which will be the start of the body.
-	 */
-	if (resp_ctx) {
+	if (resp_ctx && !ctx->req_ctx->body_cb) {
+		/* If the entire HTTP response is not received in a single "recv" call
+		 * then this could be called multiple times, with a different value in
+		 * rsp->body_start. Only set rest_ctx->response once, the first time,
+		 * which will be the start of the body.
+		 */
 		if (!resp_ctx->response && rsp->body_found && rsp->body_frag_start) {
 			resp_ctx->response = rsp->body_frag_start;
 		}
+	}
+
+	if (resp_ctx) {
 		resp_ctx->total_response_len += rsp->data_len;
 	}
 
@@ -264,26 +407,108 @@ static void rest_client_init_request(struct rest_client_req_context *const req_c
 	req->method = req_ctx->http_method;
 }
 
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+/* Connections are pooled only if the library both opened them and would close them. */
+static bool rest_client_pool_allowed(const struct rest_client_req_context *const req_ctx)
+{
+	if (req_ctx->connect_socket >= 0 || req_ctx->keep_alive) {
+		return false;
+	}
+
+	for (const char **field = req_ctx->header_fields; field && *field; field++) {
+		if (strncasecmp(*field, "Connection: close", strlen("Connection: close")) == 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+#endif
+
+static int rest_client_sckt_get(struct rest_client_req_context *const req_ctx,
+				const char *const hostname, bool pool, bool *const reused)
+{
+	int err;
+
+	*reused = false;
+
+	if (req_ctx->connect_socket >= 0) {
+		return 0;
+	}
+
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+	if (pool) {
+		int fd = rest_client_pool_get(hostname, req_ctx->port, req_ctx->sec_tag,
+					      req_ctx->tls_peer_verify);
+
+		if (fd >= 0) {
+			err = rest_client_sckt_timeouts_set(fd, req_ctx->timeout_ms);
+			if (!err) {
+				req_ctx->connect_socket = fd;
+				*reused = true;
+				return 0;
+			}
+
+			(void)close(fd);
+		}
+	}
+#else
+	ARG_UNUSED(pool);
+#endif
+
+	err = rest_client_sckt_connect(&req_ctx->connect_socket,
+				       hostname,
+				       req_ctx->port,
+				       req_ctx->sec_tag,
+				       req_ctx->tls_peer_verify,
+				       req_ctx->timeout_ms);
+
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+	if (!err) {
+		rest_client_pool_connected(req_ctx->sec_tag);
+	}
+#endif
+
+	return err;
+}
+
+/* Check if the server closed the connection before sending any response byte.
+ * The HTTP client reports a connection closed before the response as success.
+ * A timeout does not tell that the server has not received the request.
+ */
+static bool rest_client_conn_closed(int err,
+				    const struct rest_client_resp_context *const resp_ctx)
+{
+	if (resp_ctx->total_response_len) {
+		return false;
+	}
+
+	return err >= 0 || err == -ECONNRESET || err == -EPIPE || err == -ENOTCONN;
+}
+
+/* Only requests that can be repeated without side effects are resent. */
+static bool rest_client_method_retryable(enum http_method method)
+{
+	return method == HTTP_GET || method == HTTP_HEAD || method == HTTP_OPTIONS;
+}
+
 static int rest_client_do_api_call(struct http_request *http_req,
 				   struct rest_client_req_context *const req_ctx,
-				   struct rest_client_resp_context *const resp_ctx)
+				   struct rest_client_resp_context *const resp_ctx,
+				   bool pool)
 {
 	int err = 0;
+	bool reused;
+	struct rest_client_http_ctx http_ctx;
 	int64_t sckt_connect_start_time;
 	int64_t sckt_connect_time;
 
+retry:
 	sckt_connect_start_time = k_uptime_get();
 
-	if (req_ctx->connect_socket < 0) {
-		err = rest_client_sckt_connect(&req_ctx->connect_socket,
-						http_req->host,
-						req_ctx->port,
-						req_ctx->sec_tag,
-						req_ctx->tls_peer_verify,
-						req_ctx->timeout_ms);
-		if (err) {
-			return err;
-		}
+	err = rest_client_sckt_get(req_ctx, http_req->host, pool, &reused);
+	if (err) {
+		return err;
 	}
 
 	/* Assign the user provided receive buffer into the http request */
@@ -301,6 +526,11 @@ static int rest_client_do_api_call(struct http_request *http_req,
 	resp_ctx->used_socket_id = req_ctx->connect_socket;
 	resp_ctx->http_status_code_str[0] = '\0';
 
+	http_ctx = (struct rest_client_http_ctx) {
+		.req_ctx = req_ctx,
+		.resp_ctx = resp_ctx,
+	};
+
 	if (req_ctx->timeout_ms != SYS_FOREVER_MS) {
 		/* Take time used for socket connect into account */
 		sckt_connect_time = k_uptime_get() - sckt_connect_start_time;
@@ -313,9 +543,33 @@ static int rest_client_do_api_call(struct http_request *http_req,
 		req_ctx->timeout_ms -= sckt_connect_time;
 	}
 
-	err = http_client_req(req_ctx->connect_socket, http_req, req_ctx->timeout_ms, resp_ctx);
+	err = http_client_req(req_ctx->connect_socket, http_req, req_ctx->timeout_ms, &http_ctx);
+	if (reused && rest_client_conn_closed(err, resp_ctx)) {
+		/* The server has closed the idle connection. */
+		LOG_DBG("Pooled socket %d is stale", req_ctx->connect_socket);
+
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+		rest_client_pool_stale();
+#endif
+		if (rest_client_method_retryable(req_ctx->http_method)) {
+			/* Retry once with a new connection. */
+			(void)close(req_ctx->connect_socket);
+			req_ctx->connect_socket = REST_CLIENT_SCKT_CONNECT;
+			pool = false;
+			goto retry;
+		}
+
+		/* The request may have reached the server, so it is not resent. */
+		err = -ECONNRESET;
+	}
+
 	if (err < 0) {
 		LOG_ERR("http_client_req() error: %d", err);
+	} else if (http_ctx.body_err) {
+		err = http_ctx.body_err;
+	} else if (req_ctx->body_cb) {
+		/* The body was passed to the body callback, not stored in resp_buff */
+		err = 0;
 	} else if (resp_ctx->total_response_len >= req_ctx->resp_buff_len) {
 		/* 1 byte is reserved to NULL terminate the response */
 		LOG_ERR("Receive buffer too small, %d bytes are required",
@@ -337,6 +591,8 @@ void rest_client_request_defaults_set(struct rest_client_req_context *req_ctx)
 	req_ctx->sec_tag = REST_CLIENT_SEC_TAG_NO_SEC;
 	req_ctx->tls_peer_verify = REST_CLIENT_TLS_DEFAULT_PEER_VERIFY;
 	req_ctx->http_method = HTTP_GET;
+	req_ctx->body_cb = NULL;
+	req_ctx->body_cb_user_data = NULL;
 	req_ctx->timeout_ms = CONFIG_REST_CLIENT_REQUEST_TIMEOUT * MSEC_PER_SEC;
 	if (req_ctx->timeout_ms == 0) {
 		req_ctx->timeout_ms = SYS_FOREVER_MS;
@@ -353,8 +609,13 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
 	__ASSERT_NO_MSG(req_ctx->resp_buff_len > 0);
 
 	struct http_request http_req;
+	bool pool = false;
 	int ret;
 
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+	pool = rest_client_pool_allowed(req_ctx);
+#endif
+
 	rest_client_init_request(req_ctx, &http_req);
 
 	http_req.url = req_ctx->url;
@@ -364,19 +625,26 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
 
 	http_req.header_fields = req_ctx->header_fields;
 
+	if (req_ctx->body_cb) {
+		/* The body is passed on from the parser, before the receive buffer is reused. */
+		http_req.http_cb = &rest_client_body_settings;
+	}
+
 	if (req_ctx->body != NULL) {
 		http_req.payload = req_ctx->body;
 		http_req.payload_len = strlen(http_req.payload);
 		LOG_DBG("Payload: %s", http_req.payload);
 	}
 
-	ret = rest_client_do_api_call(&http_req, req_ctx, resp_ctx);
+	ret = rest_client_do_api_call(&http_req, req_ctx, resp_ctx, pool);
 	if (ret) {
 		LOG_ERR("rest_client_do_api_call() failed, err %d", ret);
 		goto clean_up;
 	}
 
-	if (!resp_ctx->response || !resp_ctx->response_len) {
+	if (req_ctx->body_cb) {
+		resp_ctx->response = NULL;
+	} else if (!resp_ctx->response || !resp_ctx->response_len) {
 		char *end_ptr = &req_ctx->resp_buff[resp_ctx->total_response_len];
 
 		LOG_WRN("No data in a response body");
@@ -389,6 +657,14 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
 		resp_ctx->response_len);
 
 clean_up:
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+	if (pool && !ret && req_ctx->connect_socket != REST_CLIENT_SCKT_CONNECT &&
+	    http_should_keep_alive(&http_req.internal.parser)) {
+		rest_client_pool_put(req_ctx->host, req_ctx->port, req_ctx->sec_tag,
+				     req_ctx->tls_peer_verify, req_ctx->connect_socket);
+		req_ctx->connect_socket = REST_CLIENT_SCKT_CONNECT;
+	}
+#endif
 	if (req_ctx->connect_socket != REST_CLIENT_SCKT_CONNECT) {
 		/* Socket was not closed yet: */
 		rest_client_close_connection(req_ctx, resp_ctx);
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#if defined(CONFIG_POSIX_API)
+#include <zephyr/posix/unistd.h>
+#else
+#include <zephyr/net/socket.h>
+#endif
+
+#include <zephyr/logging/log.h>
+
+#include <net/rest_client.h>
+
+#include "rest_client_pool.h"
+
+LOG_MODULE_DECLARE(rest_client, CONFIG_REST_CLIENT_LOG_LEVEL);
+
+#define HOST_MAX_LEN 64
+#define IDLE_TIMEOUT_MS (CONFIG_REST_CLIENT_CONN_POOL_IDLE_TIMEOUT * MSEC_PER_SEC)
+
+struct pool_entry {
+	int fd;
+	int sec_tag;
+	int tls_peer_verify;
+	uint16_t port;
+	int64_t idle_since;
+	char host[HOST_MAX_LEN];
+};
+
+static struct pool_entry pool[CONFIG_REST_CLIENT_CONN_POOL_SIZE] = {
+	[0 ... (CONFIG_REST_CLIENT_CONN_POOL_SIZE - 1)] = { .fd = -1 },
+};
+static struct rest_client_pool_stats stats;
+static K_MUTEX_DEFINE(pool_mutex);
+
+static void idle_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(idle_work, idle_work_handler);
+
+static void entry_close(struct pool_entry *entry)
+{
+	LOG_DBG("Closing pooled socket %d to %s", entry->fd, entry->host);
+
+	if (close(entry->fd)) {
+		LOG_WRN("Failed to close socket, error: %d", errno);
+	}
+
+	entry->fd = -1;
+}
+
+/* Close expired connections and schedule the next check. Call with pool_mutex held. */
+static void expire_idle(void)
+{
+	int64_t now = k_uptime_get();
+	int64_t next_expiry = INT64_MAX;
+
+	for (size_t i = 0; i < ARRAY_SIZE(pool); i++) {
+		int64_t expiry;
+
+		if (pool[i].fd < 0) {
+			continue;
+		}
+
+		expiry = pool[i].idle_since + IDLE_TIMEOUT_MS;
+
+		if (expiry <= now) {
+			entry_close(&pool[i]);
+			stats.expired++;
+		} else {
+			next_expiry = MIN(next_expiry, expiry);
+		}
+	}
+
+	if (next_expiry != INT64_MAX) {
+		k_work_reschedule(&idle_work, K_MSEC(next_expiry - now));
+	}
+}
+
+static void idle_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	k_mutex_lock(&pool_mutex, K_FOREVER);
+	expire_idle();
+	k_mutex_unlock(&pool_mutex);
+}
+
+int rest_client_pool_get(const char *host, uint16_t port, int sec_tag, int tls_peer_verify)
+{
+	int fd = -ENOENT;
+
+	k_mutex_lock(&pool_mutex, K_FOREVER);
+
+	expire_idle();
+
+	for (size_t i = 0; i < ARRAY_SIZE(pool); i++) {
+		if (pool[i].fd >= 0 && pool[i].port == port && pool[i].sec_tag == sec_tag &&
+		    pool[i].tls_peer_verify == tls_peer_verify &&
+		    strcmp(pool[i].host, host) == 0) {
+			fd = pool[i].fd;
+			pool[i].fd = -1;
+			stats.reused++;
+
+			if (sec_tag != REST_CLIENT_SEC_TAG_NO_SEC) {
+				stats.handshakes_saved++;
+			}
+			break;
+		}
+	}
+
+	k_mutex_unlock(&pool_mutex);
+
+	if (fd >= 0) {
+		LOG_DBG("Reusing socket %d to %s", fd, host);
+	}
+
+	return fd;
+}
+
+void rest_client_pool_put(const char *host, uint16_t port, int sec_tag, int tls_peer_verify,
+			  int fd)
+{
+	struct pool_entry *entry = NULL;
+
+	if (strlen(host) >= HOST_MAX_LEN) {
+		(void)close(fd);
+		return;
+	}
+
+	k_mutex_lock(&pool_mutex, K_FOREVER);
+
+	/* Use a free slot, or evict the connection that has been idle the longest. */
+	for (size_t i = 0; i < ARRAY_SIZE(pool); i++) {
+		if (pool[i].fd < 0) {
+			entry = &pool[i];
+			break;
+		}
+
+		if (!entry || pool[i].idle_since < entry->idle_since) {
+			entry = &pool[i];
+		}
+	}
+
+	if (entry->fd >= 0) {
+		entry_close(entry);
+		stats.evicted++;
+	}
+
+	entry->fd = fd;
+	entry->port = port;
+	entry->sec_tag = sec_tag;
+	entry->tls_peer_verify = tls_peer_verify;
+	entry->idle_since = k_uptime_get();
+	strcpy(entry->host, host);
+
+	LOG_DBG("Pooled socket %d to %s", fd, host);
+
+	expire_idle();
+
+	k_mutex_unlock(&pool_mutex);
+}
+
+void rest_client_pool_connected(int sec_tag)
+{
+	k_mutex_lock(&pool_mutex, K_FOREVER);
+
+	stats.connections++;
+
+	if (sec_tag != REST_CLIENT_SEC_TAG_NO_SEC) {
+		stats.handshakes++;
+	}
+
+	k_mutex_unlock(&pool_mutex);
+}
+
+void rest_client_pool_stale(void)
+{
+	k_mutex_lock(&pool_mutex, K_FOREVER);
+	stats.stale++;
+	k_mutex_unlock(&pool_mutex);
+}
+
+void rest_client_pool_flush(void)
+{
+	k_mutex_lock(&pool_mutex, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(pool); i++) {
+		if (pool[i].fd >= 0) {
+			entry_close(&pool[i]);
+		}
+	}
+
+	(void)k_work_cancel_delayable(&idle_work);
+
+	k_mutex_unlock(&pool_mutex);
+}
+
+void rest_client_pool_stats_get(struct rest_client_pool_stats *out)
+{
+	__ASSERT_NO_MSG(out != NULL);
+
+	k_mutex_lock(&pool_mutex, K_FOREVER);
+	*out = stats;
+	k_mutex_unlock(&pool_mutex);
+}
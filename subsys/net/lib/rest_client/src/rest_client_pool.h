@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef REST_CLIENT_POOL_H__
+#define REST_CLIENT_POOL_H__
+
+#include <zephyr/types.h>
+
+/**
+ * @brief Take an idle connection to the given peer out of the pool.
+ *
+ * @return Socket of the connection, or -ENOENT if there is none.
+ */
+int rest_client_pool_get(const char *host, uint16_t port, int sec_tag, int tls_peer_verify);
+
+/**
+ * @brief Hand a connection that can be reused over to the pool.
+ *
+ * The socket is closed if it cannot be pooled.
+ */
+void rest_client_pool_put(const char *host, uint16_t port, int sec_tag, int tls_peer_verify,
+			  int fd);
+
+/** @brief Record that a new connection has been established. */
+void rest_client_pool_connected(int sec_tag);
+
+/** @brief Record that a pooled connection was found stale and dropped. */
+void rest_client_pool_stale(void);
+
+#endif /* REST_CLIENT_POOL_H__ */
@@ -38,10 +38,78 @@ struct nrf_rpc_os_msg {
 
 typedef void (*nrf_rpc_os_work_t)(const uint8_t *data, size_t len);
 
+/** @brief Priority classes of the commands passed to the thread pool.
+ *
+ * Each class has its own queue and threads, so that the commands of a class
+ * are not delayed by the commands of the other classes.
+ */
+enum nrf_rpc_os_prio {
+	/** Commands served by the @kconfig{CONFIG_NRF_RPC_THREAD_POOL_SIZE}
+	 *  threads of priority @kconfig{CONFIG_NRF_RPC_THREAD_PRIORITY}.
+	 */
+	NRF_RPC_OS_PRIO_DEFAULT,
+
+	/** Commands served by the @kconfig{CONFIG_NRF_RPC_THREAD_POOL_HIGH_PRIO_SIZE}
+	 *  threads of priority @kconfig{CONFIG_NRF_RPC_THREAD_HIGH_PRIO_PRIORITY}.
+	 *  Served as default priority commands if there are no such threads.
+	 */
+	NRF_RPC_OS_PRIO_HIGH,
+
+	NRF_RPC_OS_PRIO_COUNT,
+};
+
+/** @brief Thread pool statistics of a priority class. */
+struct nrf_rpc_os_stats {
+	/** Number of commands passed to the thread pool. */
+	uint32_t cmds;
+
+	/** Number of commands that found the queue full, blocking the
+	 *  receiving thread.
+	 */
+	uint32_t queue_full;
+
+	/** Maximum number of commands waiting in the queue. */
+	uint32_t queue_depth_max;
+
+	/** Total time the commands waited for a thread in microseconds. */
+	uint64_t latency_us;
+
+	/** Maximum time a command waited for a thread in microseconds. */
+	uint32_t latency_max_us;
+};
+
 int nrf_rpc_os_init(nrf_rpc_os_work_t callback);
 
 void nrf_rpc_os_thread_pool_send(const uint8_t *data, size_t len);
 
+/** @brief Set the priority class of the commands received by the calling thread.
+ *
+ * Commands passed to @ref nrf_rpc_os_thread_pool_send by the calling thread
+ * are queued for the threads of the given class, until the class is set back
+ * to @ref NRF_RPC_OS_PRIO_DEFAULT. This is used by the transports to assign
+ * the priority of an endpoint to the commands it receives. At most
+ * @kconfig{CONFIG_NRF_RPC_RX_THREADS_MAX} threads can have a non-default
+ * class at the same time, the class set by further threads is ignored.
+ *
+ * @param prio Priority class.
+ */
+void nrf_rpc_os_rx_prio_set(enum nrf_rpc_os_prio prio);
+
+/** @brief Get the thread pool statistics of a priority class.
+ *
+ * Requires @kconfig{CONFIG_NRF_RPC_OS_STATS}.
+ *
+ * @param prio Priority class.
+ * @param stats Statistics output.
+ */
+void nrf_rpc_os_stats_get(enum nrf_rpc_os_prio prio, struct nrf_rpc_os_stats *stats);
+
+/** @brief Reset the thread pool statistics of all priority classes.
+ *
+ * Requires @kconfig{CONFIG_NRF_RPC_OS_STATS}.
+ */
+void nrf_rpc_os_stats_reset(void);
+
 static inline int nrf_rpc_os_event_init(struct nrf_rpc_os_event *event)
 {
 	return k_sem_init(&event->sem, 0, 1);
@@ -7,6 +7,7 @@
 #include <nrf_rpc.h>
 #include <nrf_rpc_tr.h>
 #include <nrf_rpc_errno.h>
+#include <nrf_rpc_os.h>
 #include <nrf_rpc/nrf_rpc_ipc.h>
 
 #include <openamp/rpmsg.h>
@@ -84,7 +85,25 @@ static void ept_received(const void *data, size_t len, void *priv)
 
 	DUMP_LIMITED_DBG(data, len, "Received");
 
-	ipc_config->receive_cb(transport, data, len, ipc_config->context);
+	/* nRF RPC returns from the receive callback once the packet is decoded,
+	 * so the buffer can be held by the decoder until then.
+	 */
+	ipc_config->rx_data = data;
+	ipc_config->rx_len = len;
+
+	if (ipc_config->prio == NRF_RPC_OS_PRIO_DEFAULT) {
+		ipc_config->receive_cb(transport, data, len, ipc_config->context);
+	} else {
+		/* Commands passed to the thread pool from the receive callback
+		 * are queued for the priority class of this endpoint.
+		 */
+		nrf_rpc_os_rx_prio_set(ipc_config->prio);
+		ipc_config->receive_cb(transport, data, len, ipc_config->context);
+		nrf_rpc_os_rx_prio_set(NRF_RPC_OS_PRIO_DEFAULT);
+	}
+
+	ipc_config->rx_data = NULL;
+	ipc_config->rx_len = 0;
 }
 
 static void ept_error(const char *message, void *priv)
@@ -209,6 +228,48 @@ void tx_buf_free(const struct nrf_rpc_tr *transport, void *buf)
 	k_free(buf);
 }
 
+int nrf_rpc_ipc_rx_hold(const struct nrf_rpc_tr *transport, const void *packet,
+			const void **buf)
+{
+	int err;
+	struct nrf_rpc_ipc *ipc_config = transport->ctx;
+	const uint8_t *rx_data = ipc_config->rx_data;
+
+	if (!rx_data) {
+		return -ENOENT;
+	}
+
+	/* Only the buffer of the packet given to the decoder can be held. */
+	if ((const uint8_t *)packet < rx_data ||
+	    (const uint8_t *)packet >= rx_data + ipc_config->rx_len) {
+		LOG_DBG("Data %p not in the received packet", packet);
+		return -EINVAL;
+	}
+
+	err = ipc_service_hold_rx_buffer(&ipc_config->endpoint.ept, (void *)rx_data);
+	if (err) {
+		LOG_DBG("Holding Rx buffer failed: %d", err);
+		return err;
+	}
+
+	*buf = rx_data;
+
+	return 0;
+}
+
+int nrf_rpc_ipc_rx_release(const struct nrf_rpc_tr *transport, const void *data)
+{
+	int err;
+	struct nrf_rpc_ipc *ipc_config = transport->ctx;
+
+	err = ipc_service_release_rx_buffer(&ipc_config->endpoint.ept, (void *)data);
+	if (err) {
+		LOG_ERR("Releasing Rx buffer failed: %d", err);
+	}
+
+	return err;
+}
+
 const struct nrf_rpc_tr_api nrf_rpc_ipc_service_api = {
 	.init = init,
 	.send = send,
@@ -7,6 +7,8 @@
 #define NRF_RPC_LOG_MODULE NRF_RPC_OS
 #include <nrf_rpc_log.h>
 
+#include <string.h>
+
 #include "nrf_rpc_os.h"
 
 /* Maximum number of remote thread that this implementation allows. */
@@ -19,24 +21,90 @@
 	(~(((atomic_val_t)1 << (8 * sizeof(atomic_val_t) -		       \
 				CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE)) - 1))
 
+#define POOL_THREADS_HIGH CONFIG_NRF_RPC_THREAD_POOL_HIGH_PRIO_SIZE
+#define POOL_THREADS (CONFIG_NRF_RPC_THREAD_POOL_SIZE + POOL_THREADS_HIGH)
+
 struct pool_start_msg {
 	const uint8_t *data;
 	size_t len;
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+	uint32_t start;
+#endif
+};
+
+struct pool {
+	struct pool_start_msg msg_buf[CONFIG_NRF_RPC_THREAD_POOL_QUEUE_SIZE];
+	struct k_msgq msgq;
+};
+
+struct rx_thread {
+	k_tid_t thread;
+	enum nrf_rpc_os_prio prio;
 };
 
 static nrf_rpc_os_work_t thread_pool_callback;
 
-static struct pool_start_msg pool_start_msg_buf[2];
-static struct k_msgq pool_start_msg;
+static struct pool pools[NRF_RPC_OS_PRIO_COUNT];
+
+static struct k_spinlock rx_lock;
+static struct rx_thread rx_threads[CONFIG_NRF_RPC_RX_THREADS_MAX];
 
 static struct k_sem context_reserved;
 static atomic_t context_mask;
 
 static K_THREAD_STACK_ARRAY_DEFINE(pool_stacks,
-	CONFIG_NRF_RPC_THREAD_POOL_SIZE,
+	POOL_THREADS,
 	CONFIG_NRF_RPC_THREAD_STACK_SIZE);
 
-static struct k_thread pool_threads[CONFIG_NRF_RPC_THREAD_POOL_SIZE];
+static struct k_thread pool_threads[POOL_THREADS];
+
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+static struct k_spinlock stats_lock;
+static struct nrf_rpc_os_stats stats[NRF_RPC_OS_PRIO_COUNT];
+
+static void stats_cmd_queued(enum nrf_rpc_os_prio prio, bool full)
+{
+	uint32_t depth = k_msgq_num_used_get(&pools[prio].msgq);
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats[prio].cmds++;
+	stats[prio].queue_full += full;
+	stats[prio].queue_depth_max = MAX(stats[prio].queue_depth_max, depth);
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+static void stats_cmd_started(enum nrf_rpc_os_prio prio, uint32_t start)
+{
+	uint32_t latency = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats[prio].latency_us += latency;
+	stats[prio].latency_max_us = MAX(stats[prio].latency_max_us, latency);
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+void nrf_rpc_os_stats_get(enum nrf_rpc_os_prio prio, struct nrf_rpc_os_stats *out)
+{
+	__ASSERT_NO_MSG(prio < NRF_RPC_OS_PRIO_COUNT);
+
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	*out = stats[prio];
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+void nrf_rpc_os_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	memset(stats, 0, sizeof(stats));
+
+	k_spin_unlock(&stats_lock, key);
+}
+#endif /* defined(CONFIG_NRF_RPC_OS_STATS) */
 
 BUILD_ASSERT(CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE > 0,
 	     "CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE must be greaten than zero");
@@ -47,18 +115,33 @@ BUILD_ASSERT(sizeof(uint32_t) == sizeof(atomic_val_t),
 
 static void thread_pool_entry(void *p1, void *p2, void *p3)
 {
+	enum nrf_rpc_os_prio prio = (enum nrf_rpc_os_prio)(uintptr_t)p1;
 	struct pool_start_msg msg;
 
 	do {
-		k_msgq_get(&pool_start_msg, &msg, K_FOREVER);
+		k_msgq_get(&pools[prio].msgq, &msg, K_FOREVER);
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+		stats_cmd_started(prio, msg.start);
+#endif
 		thread_pool_callback(msg.data, msg.len);
 	} while (1);
 }
 
+static void pool_threads_create(enum nrf_rpc_os_prio prio, int first, int count,
+				int thread_prio)
+{
+	for (int i = first; i < first + count; i++) {
+		k_thread_create(&pool_threads[i], pool_stacks[i],
+			K_THREAD_STACK_SIZEOF(pool_stacks[i]),
+			thread_pool_entry,
+			(void *)(uintptr_t)prio, NULL, NULL,
+			thread_prio, 0, K_NO_WAIT);
+	}
+}
+
 int nrf_rpc_os_init(nrf_rpc_os_work_t callback)
 {
 	int err;
-	int i;
 
 	__ASSERT_NO_MSG(callback != NULL);
 
@@ -72,28 +155,101 @@ int nrf_rpc_os_init(nrf_rpc_os_work_t callback)
 
 	atomic_set(&context_mask, CONTEXT_MASK_INIT_VALUE);
 
-	k_msgq_init(&pool_start_msg, (char *)pool_start_msg_buf,
-		    sizeof(struct pool_start_msg),
-		    ARRAY_SIZE(pool_start_msg_buf));
-
-	for (i = 0; i < CONFIG_NRF_RPC_THREAD_POOL_SIZE; i++) {
-		k_thread_create(&pool_threads[i], pool_stacks[i],
-			K_THREAD_STACK_SIZEOF(pool_stacks[i]),
-			thread_pool_entry,
-			NULL, NULL, NULL,
-			CONFIG_NRF_RPC_THREAD_PRIORITY, 0, K_NO_WAIT);
+	for (int i = 0; i < ARRAY_SIZE(pools); i++) {
+		k_msgq_init(&pools[i].msgq, (char *)pools[i].msg_buf,
+			    sizeof(struct pool_start_msg),
+			    ARRAY_SIZE(pools[i].msg_buf));
 	}
 
+	pool_threads_create(NRF_RPC_OS_PRIO_DEFAULT, 0, CONFIG_NRF_RPC_THREAD_POOL_SIZE,
+			    CONFIG_NRF_RPC_THREAD_PRIORITY);
+	pool_threads_create(NRF_RPC_OS_PRIO_HIGH, CONFIG_NRF_RPC_THREAD_POOL_SIZE,
+			    POOL_THREADS_HIGH, CONFIG_NRF_RPC_THREAD_HIGH_PRIO_PRIORITY);
+
 	return 0;
 }
 
+static enum nrf_rpc_os_prio rx_prio_get(void)
+{
+	enum nrf_rpc_os_prio prio = NRF_RPC_OS_PRIO_DEFAULT;
+	k_tid_t thread = k_current_get();
+	k_spinlock_key_t key = k_spin_lock(&rx_lock);
+
+	for (int i = 0; i < ARRAY_SIZE(rx_threads); i++) {
+		if (rx_threads[i].thread == thread) {
+			prio = rx_threads[i].prio;
+			break;
+		}
+	}
+
+	k_spin_unlock(&rx_lock, key);
+
+	/* Without threads of its own, the class is served by the default ones. */
+	if (prio == NRF_RPC_OS_PRIO_HIGH && !POOL_THREADS_HIGH) {
+		return NRF_RPC_OS_PRIO_DEFAULT;
+	}
+
+	return prio;
+}
+
+void nrf_rpc_os_rx_prio_set(enum nrf_rpc_os_prio prio)
+{
+	k_tid_t thread = k_current_get();
+	struct rx_thread *slot = NULL;
+	k_spinlock_key_t key;
+
+	__ASSERT_NO_MSG(prio < NRF_RPC_OS_PRIO_COUNT);
+
+	key = k_spin_lock(&rx_lock);
+
+	for (int i = 0; i < ARRAY_SIZE(rx_threads); i++) {
+		if (rx_threads[i].thread == thread) {
+			slot = &rx_threads[i];
+			break;
+		} else if (!slot && !rx_threads[i].thread) {
+			slot = &rx_threads[i];
+		}
+	}
+
+	if (prio == NRF_RPC_OS_PRIO_DEFAULT) {
+		if (slot && slot->thread == thread) {
+			slot->thread = NULL;
+		}
+	} else if (slot) {
+		slot->thread = thread;
+		slot->prio = prio;
+	}
+
+	k_spin_unlock(&rx_lock, key);
+
+	if (!slot && prio != NRF_RPC_OS_PRIO_DEFAULT) {
+		NRF_RPC_WRN("Too many receiving threads, priority class %d ignored", prio);
+	}
+}
+
 void nrf_rpc_os_thread_pool_send(const uint8_t *data, size_t len)
 {
+	enum nrf_rpc_os_prio prio = rx_prio_get();
 	struct pool_start_msg msg;
+	bool full = false;
 
 	msg.data = data;
 	msg.len = len;
-	k_msgq_put(&pool_start_msg, &msg, K_FOREVER);
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+	msg.start = k_cycle_get_32();
+#endif
+
+	/* A full queue blocks the receive context of the whole IPC instance. */
+	if (k_msgq_put(&pools[prio].msgq, &msg, K_NO_WAIT)) {
+		full = true;
+		k_msgq_put(&pools[prio].msgq, &msg, K_FOREVER);
+	}
+
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+	stats_cmd_queued(prio, full);
+#else
+	ARG_UNUSED(full);
+#endif
 }
 
 void nrf_rpc_os_msg_set(struct nrf_rpc_os_msg *msg, const uint8_t *data,
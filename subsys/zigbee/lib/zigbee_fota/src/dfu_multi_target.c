@@ -25,6 +25,7 @@ union dfu_multi_target_ver {
 
 static int dfu_multi_target_open(int image_id, size_t image_size);
 static int dfu_multi_target_write(const uint8_t *chunk, size_t chunk_size);
+static int dfu_multi_target_offset(size_t *offset);
 static int dfu_multi_target_done_0(bool success);
 #if CONFIG_UPDATEABLE_IMAGE_NUMBER > 1
 static int dfu_multi_target_done_1(bool success);
@@ -41,7 +42,8 @@ static struct dfu_image_writer dfu_multi_target_writer_0 = {
 	.image_id = 0,
 	.open = dfu_multi_target_open,
 	.write = dfu_multi_target_write,
-	.close = dfu_multi_target_done_0
+	.close = dfu_multi_target_done_0,
+	.offset = dfu_multi_target_offset
 };
 
 #if CONFIG_UPDATEABLE_IMAGE_NUMBER > 1
@@ -50,7 +52,8 @@ static struct dfu_image_writer dfu_multi_target_writer_1 = {
 	.image_id = 1,
 	.open = dfu_multi_target_open,
 	.write = dfu_multi_target_write,
-	.close = dfu_multi_target_done_1
+	.close = dfu_multi_target_done_1,
+	.offset = dfu_multi_target_offset
 };
 #endif
 
@@ -73,6 +76,20 @@ static int dfu_multi_target_write(const uint8_t *chunk, size_t chunk_size)
 	return dfu_target_write(chunk, chunk_size);
 }
 
+static int dfu_multi_target_offset(size_t *offset)
+{
+	int err = dfu_target_offset_get(offset);
+
+	if (err) {
+		LOG_ERR("Failed to get DFU target offset (err %d)", err);
+		return err;
+	}
+
+	LOG_INF("Resume image at offset: %d", *offset);
+
+	return 0;
+}
+
 static int dfu_multi_target_done_0(bool success)
 {
 	LOG_INF("Close image 0 for writing success: %d", success);
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/hci.h>
+#include <bluetooth/gatt_dm.h>
+#include <bluetooth/services/throughput.h>
+#include <bluetooth/services/throughput_bench.h>
+
+#include "bs_types.h"
+#include "bs_tracing.h"
+#include "time_machine.h"
+#include "bstests.h"
+
+/* Simulated time after which the test fails, in microseconds. */
+#define WAIT_TIME (300 * 1e6)
+
+#define TRANSFER_SIZE (20 * 1024)
+
+extern enum bst_result_t bst_result;
+
+#define FAIL(...)                                                              \
+	do {                                                                   \
+		bst_result = Failed;                                           \
+		bs_trace_error_time_line(__VA_ARGS__);                         \
+	} while (0)
+
+#define PASS(...)                                                              \
+	do {                                                                   \
+		bst_result = Passed;                                           \
+		bs_trace_info_time(1, __VA_ARGS__);                            \
+	} while (0)
+
+static const struct bt_conn_le_phy_param phy[] = {
+	{ .options = BT_CONN_LE_PHY_OPT_NONE,
+	  .pref_tx_phy = BT_GAP_LE_PHY_1M, .pref_rx_phy = BT_GAP_LE_PHY_1M },
+	{ .options = BT_CONN_LE_PHY_OPT_NONE,
+	  .pref_tx_phy = BT_GAP_LE_PHY_2M, .pref_rx_phy = BT_GAP_LE_PHY_2M },
+};
+static const uint16_t interval[] = { 12, 80 };
+static const uint16_t data_len[] = { BT_GAP_DATA_LEN_DEFAULT,
+				     BT_GAP_DATA_LEN_MAX };
+static const uint16_t att_mtu[] = { 23, 0 };
+
+static const struct bt_throughput_bench_sweep sweep = {
+	.phy = phy,
+	.phy_cnt = ARRAY_SIZE(phy),
+	.interval = interval,
+	.interval_cnt = ARRAY_SIZE(interval),
+	.data_len = data_len,
+	.data_len_cnt = ARRAY_SIZE(data_len),
+	.att_mtu = att_mtu,
+	.att_mtu_cnt = ARRAY_SIZE(att_mtu),
+	.size = TRANSFER_SIZE,
+};
+
+static const struct bt_data ad[] = {
+	BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
+	BT_DATA_BYTES(BT_DATA_UUID128_ALL, BT_UUID_THROUGHPUT_VAL),
+};
+
+static K_SEM_DEFINE(ready_sem, 0, 1);
+static struct bt_conn *default_conn;
+static struct bt_throughput throughput;
+static struct bt_gatt_exchange_params exchange_params;
+static bool failed_run;
+
+static void exchange_func(struct bt_conn *conn, uint8_t att_err,
+			  struct bt_gatt_exchange_params *params)
+{
+	if (att_err) {
+		FAIL("MTU exchange failed (err %u)\n", att_err);
+		return;
+	}
+
+	k_sem_give(&ready_sem);
+}
+
+static void discovery_complete(struct bt_gatt_dm *dm, void *context)
+{
+	int err;
+
+	err = bt_throughput_handles_assign(dm, &throughput);
+	bt_gatt_dm_data_release(dm);
+
+	if (err) {
+		FAIL("Handles not assigned (err %d)\n", err);
+		return;
+	}
+
+	exchange_params.func = exchange_func;
+
+	err = bt_gatt_exchange_mtu(default_conn, &exchange_params);
+	if (err) {
+		FAIL("MTU exchange failed (err %d)\n", err);
+	}
+}
+
+static void discovery_service_not_found(struct bt_conn *conn, void *context)
+{
+	FAIL("Throughput Service not found\n");
+}
+
+static void discovery_error(struct bt_conn *conn, int err, void *context)
+{
+	FAIL("Discovery failed (err %d)\n", err);
+}
+
+static const struct bt_gatt_dm_cb discovery_cb = {
+	.completed = discovery_complete,
+	.service_not_found = discovery_service_not_found,
+	.error_found = discovery_error,
+};
+
+static void connected(struct bt_conn *conn, uint8_t hci_err)
+{
+	struct bt_conn_info info;
+	int err;
+
+	if (hci_err) {
+		FAIL("Connection failed (err 0x%02x)\n", hci_err);
+		return;
+	}
+
+	if (!default_conn) {
+		default_conn = bt_conn_ref(conn);
+	}
+
+	err = bt_conn_get_info(conn, &info);
+	if (err) {
+		FAIL("No connection info (err %d)\n", err);
+		return;
+	}
+
+	if (info.role != BT_CONN_ROLE_CENTRAL) {
+		return;
+	}
+
+	err = bt_gatt_dm_start(conn, BT_UUID_THROUGHPUT, &discovery_cb, NULL);
+	if (err) {
+		FAIL("Discovery not started (err %d)\n", err);
+	}
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason)
+{
+	FAIL("Disconnected (reason 0x%02x)\n", reason);
+}
+
+BT_CONN_CB_DEFINE(conn_callbacks) = {
+	.connected = connected,
+	.disconnected = disconnected,
+};
+
+static void device_found(const bt_addr_le_t *addr, int8_t rssi, uint8_t type,
+			 struct net_buf_simple *ad)
+{
+	struct bt_conn *conn;
+	int err;
+
+	if (type != BT_GAP_ADV_TYPE_ADV_IND) {
+		return;
+	}
+
+	err = bt_le_scan_stop();
+	if (err) {
+		FAIL("Scanning not stopped (err %d)\n", err);
+		return;
+	}
+
+	err = bt_conn_le_create(addr, BT_CONN_LE_CREATE_CONN,
+				BT_LE_CONN_PARAM_DEFAULT, &conn);
+	if (err) {
+		FAIL("Connection not created (err %d)\n", err);
+		return;
+	}
+
+	bt_conn_unref(conn);
+}
+
+static void result_print(const struct bt_throughput_bench_params *params,
+			 const struct bt_throughput_bench_result *result,
+			 void *user_data)
+{
+	char line[128];
+
+	bt_throughput_bench_csv(line, sizeof(line), params, result);
+	printk("%s\n", line);
+
+	if ((result->bytes < params->size) || !result->goodput) {
+		failed_run = true;
+	}
+}
+
+static const struct bt_throughput_cb throughput_cb;
+
+static void test_central_main(void)
+{
+	int err;
+
+	err = bt_enable(NULL);
+	if (err) {
+		FAIL("Bluetooth init failed (err %d)\n", err);
+		return;
+	}
+
+	err = bt_throughput_init(&throughput, &throughput_cb);
+	if (err) {
+		FAIL("Throughput Service init failed (err %d)\n", err);
+		return;
+	}
+
+	err = bt_le_scan_start(BT_LE_SCAN_PASSIVE, device_found);
+	if (err) {
+		FAIL("Scanning not started (err %d)\n", err);
+		return;
+	}
+
+	k_sem_take(&ready_sem, K_FOREVER);
+
+	err = bt_throughput_bench_init(&throughput);
+	if (err) {
+		FAIL("Benchmark init failed (err %d)\n", err);
+		return;
+	}
+
+	printk("%s\n", BT_THROUGHPUT_BENCH_CSV_HEADER);
+
+	err = bt_throughput_bench_sweep(&sweep, result_print, NULL);
+	if (err) {
+		FAIL("Benchmark failed (err %d)\n", err);
+		return;
+	}
+
+	if (failed_run) {
+		FAIL("Incomplete transfer\n");
+		return;
+	}
+
+	PASS("Benchmark done\n");
+}
+
+static void data_received(const struct bt_throughput_metrics *met)
+{
+	if (met->write_len) {
+		PASS("Data received\n");
+	}
+}
+
+static const struct bt_throughput_cb peripheral_cb = {
+	.data_received = data_received,
+};
+
+static void test_peripheral_main(void)
+{
+	int err;
+
+	err = bt_enable(NULL);
+	if (err) {
+		FAIL("Bluetooth init failed (err %d)\n", err);
+		return;
+	}
+
+	err = bt_throughput_init(&throughput, &peripheral_cb);
+	if (err) {
+		FAIL("Throughput Service init failed (err %d)\n", err);
+		return;
+	}
+
+	err = bt_le_adv_start(BT_LE_ADV_CONN, ad, ARRAY_SIZE(ad), NULL, 0);
+	if (err) {
+		FAIL("Advertising not started (err %d)\n", err);
+	}
+}
+
+static void test_init(void)
+{
+	bst_ticker_set_next_tick_absolute(WAIT_TIME);
+	bst_result = In_progress;
+}
+
+static void test_tick(bs_time_t HW_device_time)
+{
+	if (bst_result != Passed) {
+		FAIL("Test failed (not passed after %i seconds)\n",
+		     (int)(WAIT_TIME / 1e6));
+	}
+}
+
+static const struct bst_test_instance test_def[] = {
+	{
+		.test_id = "central",
+		.test_descr = "Central running the throughput benchmark sweep",
+		.test_post_init_f = test_init,
+		.test_tick_f = test_tick,
+		.test_main_f = test_central_main
+	},
+	{
+		.test_id = "peripheral",
+		.test_descr = "Peripheral with the Throughput Service",
+		.test_post_init_f = test_init,
+		.test_tick_f = test_tick,
+		.test_main_f = test_peripheral_main
+	},
+	BSTEST_END_MARKER
+};
+
+struct bst_test_list *test_throughput_bench_install(struct bst_test_list *tests)
+{
+	return bst_add_tests(tests, test_def);
+}
+
+bst_test_install_t test_installers[] = {
+	test_throughput_bench_install,
+	NULL
+};
+
+void main(void)
+{
+	bst_main();
+}
@@ -0,0 +1,40 @@
+#!/usr/bin/env bash
+# Copyright (c) 2022 Nordic Semiconductor ASA
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+# Throughput benchmark sweep between two simulated nRF52 devices.
+# The central prints one comma-separated line per result.
+#
+# Build the test image first and copy it to the BabbleSim binaries:
+#   west build -b nrf52_bsim tests/bluetooth/bsim/throughput_bench
+#   cp build/zephyr/zephyr.exe \
+#      ${BSIM_OUT_PATH}/bin/bs_nrf52_bsim_throughput_bench
+
+simulation_id="throughput_bench"
+verbosity_level=2
+process_ids=""; exit_code=0
+
+function Execute(){
+  if [ ! -f $1 ]; then
+    echo -e "  \e[91m`pwd`/`basename $1` cannot be found (did you forget to\
+ compile it?)\e[39m"
+    exit 1
+  fi
+  timeout 600 $@ & process_ids="$process_ids $!"
+}
+
+: "${BSIM_OUT_PATH:?BSIM_OUT_PATH must be defined}"
+
+cd ${BSIM_OUT_PATH}/bin
+
+Execute ./bs_nrf52_bsim_throughput_bench -v=${verbosity_level} \
+  -s=${simulation_id} -d=0 -testid=central
+Execute ./bs_nrf52_bsim_throughput_bench -v=${verbosity_level} \
+  -s=${simulation_id} -d=1 -testid=peripheral
+Execute ./bs_2G4_phy_v1 -v=${verbosity_level} -s=${simulation_id} \
+  -D=2 -sim_length=300e6 $@
+
+for process_id in $process_ids; do
+  wait $process_id || let "exit_code=$?"
+done
+exit $exit_code
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/att.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/settings/settings.h>
+#include <ztest.h>
+
+#include "gatt_cache_mock.h"
+
+/* Settings entries stored at once */
+#define SETTINGS_MOCK_ENTRIES 8
+#define SETTINGS_MOCK_NAME_LEN 40
+#define SETTINGS_MOCK_VAL_LEN 1536
+
+#define DB_HASH_LEN 16
+
+const bt_addr_le_t gatt_cache_mock_peer = {
+	.type = BT_ADDR_LE_PUBLIC,
+	.a.val = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 },
+};
+
+static bool mock_bonded;
+static bool mock_db_hash_supported;
+static uint8_t mock_db_hash[DB_HASH_LEN];
+static size_t mock_read_cnt;
+static size_t mock_save_cnt;
+
+static struct {
+	struct bt_conn *conn;
+	struct bt_gatt_read_params *params;
+	struct k_work_delayable work;
+} read_mock;
+
+static struct settings_mock_entry {
+	char name[SETTINGS_MOCK_NAME_LEN];
+	size_t len;
+	uint8_t val[SETTINGS_MOCK_VAL_LEN];
+} settings_mock[SETTINGS_MOCK_ENTRIES];
+
+static void read_mock_work(struct k_work *work)
+{
+	if (mock_db_hash_supported) {
+		read_mock.params->func(read_mock.conn, 0, read_mock.params, mock_db_hash,
+				       DB_HASH_LEN);
+	} else {
+		read_mock.params->func(read_mock.conn, BT_ATT_ERR_ATTRIBUTE_NOT_FOUND,
+				       read_mock.params, NULL, 0);
+	}
+}
+
+void gatt_cache_mock_reset(void)
+{
+	memset(settings_mock, 0, sizeof(settings_mock));
+	mock_bonded = false;
+	k_work_init_delayable(&read_mock.work, read_mock_work);
+}
+
+void gatt_cache_mock_bonded_set(bool bonded)
+{
+	mock_bonded = bonded;
+}
+
+void gatt_cache_mock_db_hash_set(const uint8_t *hash)
+{
+	mock_db_hash_supported = (hash != NULL);
+
+	if (hash) {
+		memcpy(mock_db_hash, hash, DB_HASH_LEN);
+	}
+}
+
+size_t gatt_cache_mock_read_cnt(void)
+{
+	return mock_read_cnt;
+}
+
+size_t gatt_cache_mock_save_cnt(void)
+{
+	return mock_save_cnt;
+}
+
+size_t gatt_cache_mock_entry_cnt(void)
+{
+	size_t cnt = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(settings_mock); i++) {
+		if (settings_mock[i].name[0]) {
+			cnt++;
+		}
+	}
+
+	return cnt;
+}
+
+/****************** mock section **********************************/
+
+int __wrap_bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info)
+{
+	memset(info, 0, sizeof(*info));
+
+	info->type = BT_CONN_TYPE_LE;
+	info->le.dst = &gatt_cache_mock_peer;
+
+	return 0;
+}
+
+bool __wrap_bt_addr_le_is_bonded(uint8_t id, const bt_addr_le_t *addr)
+{
+	return mock_bonded && !bt_addr_le_cmp(addr, &gatt_cache_mock_peer);
+}
+
+int __wrap_bt_gatt_read(struct bt_conn *conn, struct bt_gatt_read_params *params)
+{
+	zassert_equal(params->handle_count, 0, "Not a read by UUID");
+	zassert_true(!bt_uuid_cmp(params->by_uuid.uuid, BT_UUID_GATT_DB_HASH),
+		     "Not a read of the Database Hash");
+
+	mock_read_cnt++;
+
+	read_mock.conn = conn;
+	read_mock.params = params;
+	k_work_schedule(&read_mock.work, K_MSEC(5));
+
+	return 0;
+}
+
+static struct settings_mock_entry *settings_mock_find(const char *name)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(settings_mock); i++) {
+		if (!strcmp(settings_mock[i].name, name)) {
+			return &settings_mock[i];
+		}
+	}
+
+	return NULL;
+}
+
+int __wrap_settings_save_one(const char *name, const void *value, size_t val_len)
+{
+	struct settings_mock_entry *entry = settings_mock_find(name);
+
+	zassert_true(strlen(name) < SETTINGS_MOCK_NAME_LEN, "Name too long: %s", name);
+	zassert_true(val_len <= SETTINGS_MOCK_VAL_LEN, "Value too long: %zu", val_len);
+
+	if (!entry) {
+		entry = settings_mock_find("");
+		zassert_not_null(entry, "Settings mock full");
+		strcpy(entry->name, name);
+	}
+
+	memcpy(entry->val, value, val_len);
+	entry->len = val_len;
+	mock_save_cnt++;
+
+	return 0;
+}
+
+int __wrap_settings_delete(const char *name)
+{
+	struct settings_mock_entry *entry = settings_mock_find(name);
+
+	if (entry) {
+		memset(entry, 0, sizeof(*entry));
+	}
+
+	return 0;
+}
+
+static ssize_t settings_mock_read(void *cb_arg, void *data, size_t len)
+{
+	struct settings_mock_entry *entry = cb_arg;
+
+	len = MIN(len, entry->len);
+	memcpy(data, entry->val, len);
+
+	return len;
+}
+
+/* Same key passed to the callback as by the settings subsystem: NULL for the
+ * subtree itself, the rest of the name for the entries below it.
+ */
+int __wrap_settings_load_subtree_direct(const char *subtree, settings_load_direct_cb cb,
+					void *param)
+{
+	size_t len = strlen(subtree);
+
+	for (size_t i = 0; i < ARRAY_SIZE(settings_mock); i++) {
+		struct settings_mock_entry *entry = &settings_mock[i];
+		const char *key;
+
+		if (!entry->name[0] || strncmp(entry->name, subtree, len)) {
+			continue;
+		}
+
+		if (entry->name[len] == '\0') {
+			key = NULL;
+		} else if (entry->name[len] == '/') {
+			key = &entry->name[len + 1];
+		} else {
+			continue;
+		}
+
+		if (cb(key, entry->len, settings_mock_read, entry, param)) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/****************** mock section **********************************/
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BT_GATT_CACHE_MOCK_H_
+#define BT_GATT_CACHE_MOCK_H_
+
+#include <zephyr/bluetooth/addr.h>
+
+/**
+ * @file
+ * @defgroup bt_gatt_cache_mock API
+ * @{
+ * @brief The API used to setup the mocks used by the discovery cache
+ *
+ * The connection information, the bond state, the read of the Database Hash
+ * and the settings storage are replaced by mocks with the linker.
+ */
+
+/** @brief Address of the peer, the same on all connections. */
+extern const bt_addr_le_t gatt_cache_mock_peer;
+
+/**
+ * @brief Reset the mocks
+ *
+ * Removes all the stored settings, and sets the peer as not bonded.
+ */
+void gatt_cache_mock_reset(void);
+
+/**
+ * @brief Set the bond state of the peer
+ *
+ * @param bonded True if the peer is bonded.
+ */
+void gatt_cache_mock_bonded_set(bool bonded);
+
+/**
+ * @brief Set the Database Hash of the peer
+ *
+ * @param hash The 16 byte hash, or NULL if the peer does not have one.
+ */
+void gatt_cache_mock_db_hash_set(const uint8_t *hash);
+
+/** @brief Number of reads of the Database Hash. */
+size_t gatt_cache_mock_read_cnt(void);
+
+/** @brief Number of settings written. */
+size_t gatt_cache_mock_save_cnt(void);
+
+/** @brief Number of settings entries stored. */
+size_t gatt_cache_mock_entry_cnt(void);
+
+/** @} */
+#endif /* BT_GATT_CACHE_MOCK_H_ */
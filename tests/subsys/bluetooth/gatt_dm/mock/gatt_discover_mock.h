@@ -90,5 +90,12 @@
  */
 void bt_gatt_discover_mock_setup(const struct bt_gatt_attr *attr, size_t len);
 
+/**
+ * @brief Number of calls to the @ref bt_gatt_discover mock
+ *
+ * @return The number of discoveries started since boot.
+ */
+size_t bt_gatt_discover_mock_call_cnt(void);
+
 /** @} */
 #endif /* #define BT_GATT_DISCOVERY_MOCK_H_ */
@@ -10,6 +10,9 @@
 #include <zephyr/bluetooth/uuid.h>
 #include <bluetooth/gatt_dm.h>
 #include "../mock/gatt_discover_mock.h"
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+#include "../mock/gatt_cache_mock.h"
+#endif
 
 /* Timeout for the discovery in ms */
 #define SERVICE_DISCOVERY_TIMEOUT 2000
@@ -18,7 +21,18 @@
 #define BT_UUID_EMPTY_CHR BT_UUID_DECLARE_16(0x1235)
 
 static char dummy_conn;
+static char dummy_conn_2;
+static char dummy_conn_3;
 K_SEM_DEFINE(discovery_finished, 0, 1);
+K_SEM_DEFINE(parallel_discovery_finished, 0, 2);
+
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+static const uint8_t db_hash_a[16] = { 0xa };
+static const uint8_t db_hash_b[16] = { 0xb };
+
+/* Number of settings written when the completed callback was called */
+static size_t saves_at_completed;
+#endif
 
 
 const struct bt_gatt_attr discover_sim[] = {
@@ -64,6 +78,9 @@ const struct bt_gatt_attr discover_sim[] = {
 void test_cb_completed(struct bt_gatt_dm *dm, void *context)
 {
 	printk("%s\n", __func__);
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	saves_at_completed = gatt_cache_mock_save_cnt();
+#endif
 	/* Saving discovery manager instance and giving the semaphore */
 	*(struct bt_gatt_dm **)context = dm;
 	k_sem_give(&discovery_finished);
@@ -89,6 +106,25 @@ struct bt_gatt_dm_cb test_hids_cb = {
 	.error_found       = test_cb_error_found
 };
 
+void test_cb_parallel_completed(struct bt_gatt_dm *dm, void *context)
+{
+	printk("%s\n", __func__);
+	*(struct bt_gatt_dm **)context = dm;
+	k_sem_give(&parallel_discovery_finished);
+}
+
+void test_cb_parallel_service_not_found(struct bt_conn *conn, void *context)
+{
+	printk("%s\n", __func__);
+	zassert_unreachable("Service not found");
+}
+
+struct bt_gatt_dm_cb test_parallel_cb = {
+	.completed         = test_cb_parallel_completed,
+	.service_not_found = test_cb_parallel_service_not_found,
+	.error_found       = test_cb_error_found
+};
+
 void test_setup(void)
 {
 	k_sem_reset(&discovery_finished);
@@ -469,6 +505,308 @@ void test_gatt_many_serv_by_uuid(void)
 		      bt_gatt_dm_attr_cnt(dm));
 }
 
+/* Discoveries on different connections run in parallel */
+void test_gatt_parallel_conn(void)
+{
+	struct bt_gatt_dm *dm_hids = NULL;
+	struct bt_gatt_dm *dm_dis = NULL;
+	struct bt_gatt_dm *dm_unused = NULL;
+	int err;
+
+	k_sem_reset(&parallel_discovery_finished);
+
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn, BT_UUID_HIDS,
+			       &test_parallel_cb, &dm_hids);
+	zassert_equal(0, err, "bt_gatt_dm_start finished with error: %d", err);
+
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn, BT_UUID_DIS,
+			       &test_parallel_cb, &dm_unused);
+	zassert_equal(-EALREADY, err, "Second discovery on a connection: %d", err);
+
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn_2, BT_UUID_DIS,
+			       &test_parallel_cb, &dm_dis);
+	zassert_equal(0, err, "bt_gatt_dm_start finished with error: %d", err);
+
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn_3, BT_UUID_BAS,
+			       &test_parallel_cb, &dm_unused);
+	zassert_equal(-ENOMEM, err, "Discovery with all instances in use: %d", err);
+
+	for (int i = 0; i < 2; ++i) {
+		err = k_sem_take(&parallel_discovery_finished,
+				 K_MSEC(SERVICE_DISCOVERY_TIMEOUT));
+		zassert_equal(0, err, "It seems that no callback function was called: %d", err);
+	}
+
+	zassert_not_null(dm_hids, "Device Manager pointer not set");
+	zassert_not_null(dm_dis, "Device Manager pointer not set");
+	zassert_not_equal(dm_hids, dm_dis, "Both connections share an instance");
+	zassert_equal_ptr(&dummy_conn, bt_gatt_dm_conn_get(dm_hids), "Unexpected connection");
+	zassert_equal_ptr(&dummy_conn_2, bt_gatt_dm_conn_get(dm_dis), "Unexpected connection");
+
+	zassert_true(!bt_uuid_cmp(BT_UUID_HIDS,
+				  bt_gatt_dm_attr_service_val(bt_gatt_dm_service_get(dm_hids))->uuid),
+		     "Invalid service detected");
+	zassert_equal(11, bt_gatt_dm_attr_cnt(dm_hids),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm_hids));
+	zassert_true(!bt_uuid_cmp(BT_UUID_DIS,
+				  bt_gatt_dm_attr_service_val(bt_gatt_dm_service_get(dm_dis))->uuid),
+		     "Invalid service detected");
+	zassert_equal(5, bt_gatt_dm_attr_cnt(dm_dis),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm_dis));
+
+	bt_gatt_dm_data_release(dm_hids);
+	bt_gatt_dm_data_release(dm_dis);
+	zassert_equal(0, bt_gatt_dm_attr_cnt(dm_hids), "Parameter count after clearing: %d",
+		      bt_gatt_dm_attr_cnt(dm_hids));
+	zassert_equal(0, bt_gatt_dm_attr_cnt(dm_dis), "Parameter count after clearing: %d",
+		      bt_gatt_dm_attr_cnt(dm_dis));
+}
+
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+void test_cache_setup(void)
+{
+	test_setup();
+	gatt_cache_mock_reset();
+	gatt_cache_mock_bonded_set(true);
+	gatt_cache_mock_db_hash_set(db_hash_a);
+
+	/* The instance keeps the Database Hash read in the previous test */
+	bt_gatt_dm_cache_invalidate((struct bt_conn *)&dummy_conn);
+}
+
+/* Waits until the given number of settings have been written. */
+void cache_store_wait(size_t saves)
+{
+	for (int i = 0; i < SERVICE_DISCOVERY_TIMEOUT; i += 10) {
+		if (gatt_cache_mock_save_cnt() >= saves) {
+			break;
+		}
+		k_sleep(K_MSEC(10));
+	}
+
+	zassert_equal(saves, gatt_cache_mock_save_cnt(), "Unexpected number of settings written");
+}
+
+/* Discovers the HIDS over the air, and waits until the result is stored. */
+void cache_hids_prime(void)
+{
+	size_t saves = gatt_cache_mock_save_cnt();
+	struct bt_gatt_dm *dm = run_dm(BT_UUID_HIDS);
+
+	zassert_not_null(dm, "Device Manager pointer not set");
+	bt_gatt_dm_data_release(dm);
+
+	cache_store_wait(saves + 1);
+}
+
+void test_gatt_cache_miss(void)
+{
+	size_t discoveries = bt_gatt_discover_mock_call_cnt();
+	size_t reads = gatt_cache_mock_read_cnt();
+	size_t saves = gatt_cache_mock_save_cnt();
+	struct bt_gatt_dm *dm = run_dm(BT_UUID_HIDS);
+
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(11, bt_gatt_dm_attr_cnt(dm), "Unexpected number of attributes: %d",
+		      bt_gatt_dm_attr_cnt(dm));
+	zassert_equal(reads + 1, gatt_cache_mock_read_cnt(), "Database Hash not read");
+	zassert_true(bt_gatt_discover_mock_call_cnt() > discoveries, "Not discovered");
+	zassert_equal(saves, saves_at_completed, "Stored before the completed callback");
+
+	bt_gatt_dm_data_release(dm);
+
+	cache_store_wait(saves + 1);
+	zassert_equal(1, gatt_cache_mock_entry_cnt(), "Result not stored");
+}
+
+void test_gatt_cache_hit(void)
+{
+	const struct bt_gatt_dm_attr *attr_chrc;
+	const struct bt_gatt_dm_attr *attr_desc;
+	const struct bt_gatt_chrc *chrc_val;
+	struct bt_gatt_dm *dm;
+	size_t discoveries;
+	size_t reads;
+	size_t saves;
+
+	cache_hids_prime();
+
+	discoveries = bt_gatt_discover_mock_call_cnt();
+	reads = gatt_cache_mock_read_cnt();
+	saves = gatt_cache_mock_save_cnt();
+
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(discoveries, bt_gatt_discover_mock_call_cnt(), "Discovered over the air");
+	zassert_equal(reads, gatt_cache_mock_read_cnt(), "Database Hash read again");
+
+	zassert_equal(11, bt_gatt_dm_attr_cnt(dm), "Unexpected number of attributes: %d",
+		      bt_gatt_dm_attr_cnt(dm));
+	zassert_true(!bt_uuid_cmp(BT_UUID_HIDS,
+				  bt_gatt_dm_attr_service_val(bt_gatt_dm_service_get(dm))->uuid),
+		     "Invalid service restored");
+
+	attr_chrc = bt_gatt_dm_char_by_uuid(dm, BT_UUID_HIDS_REPORT);
+	zassert_not_null(attr_chrc, "Unexpected NULL");
+	zassert_equal(6, attr_chrc->handle, "Unexpected handle: %d", attr_chrc->handle);
+	chrc_val = bt_gatt_dm_attr_chrc_val(attr_chrc);
+	zassert_equal(BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY, chrc_val->properties,
+		      "Unexpected HIDS_REPORT properties");
+	attr_desc = bt_gatt_dm_desc_by_uuid(dm, attr_chrc, BT_UUID_GATT_CCC);
+	zassert_not_null(attr_desc, "Unexpected NULL");
+	zassert_equal(8, attr_desc->handle, "Unexpected handle: %d", attr_desc->handle);
+
+	bt_gatt_dm_data_release(dm);
+
+	k_sleep(K_MSEC(20));
+	zassert_equal(saves, gatt_cache_mock_save_cnt(), "Restored result stored again");
+}
+
+/* A discovery completed from the cache can be continued like one over the air. */
+void test_gatt_cache_hit_continue(void)
+{
+	size_t saves = gatt_cache_mock_save_cnt();
+	size_t discoveries;
+	struct bt_gatt_dm *dm;
+	struct bt_gatt_dm *dm_next;
+	int err;
+
+	dm = run_dm(BT_UUID_HRS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	dm = run_dm_next(dm);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	bt_gatt_dm_data_release(dm);
+
+	cache_store_wait(saves + 2);
+
+	discoveries = bt_gatt_discover_mock_call_cnt();
+
+	dm = run_dm(BT_UUID_HRS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(20, bt_gatt_dm_service_get(dm)->handle, "Unexpected service");
+
+	bt_gatt_dm_data_release(dm);
+	err = bt_gatt_dm_continue(dm, &dm_next);
+	zassert_equal(0, err, "Continue after a cache hit failed: %d", err);
+
+	err = k_sem_take(&discovery_finished, K_MSEC(SERVICE_DISCOVERY_TIMEOUT));
+	zassert_equal(0, err, "It seems that no callback function was called: %d", err);
+
+	zassert_not_null(dm_next, "Device Manager pointer not set");
+	zassert_equal(22, bt_gatt_dm_service_get(dm_next)->handle, "Unexpected service");
+	zassert_equal(2, bt_gatt_dm_attr_cnt(dm_next), "Unexpected number of attributes: %d",
+		      bt_gatt_dm_attr_cnt(dm_next));
+	zassert_equal(discoveries, bt_gatt_discover_mock_call_cnt(), "Discovered over the air");
+
+	bt_gatt_dm_data_release(dm_next);
+}
+
+void test_gatt_cache_invalidate(void)
+{
+	size_t discoveries;
+	size_t reads;
+	struct bt_gatt_dm *dm;
+
+	cache_hids_prime();
+
+	bt_gatt_dm_cache_invalidate((struct bt_conn *)&dummy_conn);
+
+	discoveries = bt_gatt_discover_mock_call_cnt();
+	reads = gatt_cache_mock_read_cnt();
+
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(reads + 1, gatt_cache_mock_read_cnt(), "Database Hash not read again");
+	zassert_equal(discoveries, bt_gatt_discover_mock_call_cnt(),
+		      "Discovered over the air with an unchanged hash");
+
+	bt_gatt_dm_data_release(dm);
+}
+
+void test_gatt_cache_db_hash_mismatch(void)
+{
+	size_t discoveries;
+	size_t saves;
+	struct bt_gatt_dm *dm;
+
+	cache_hids_prime();
+
+	gatt_cache_mock_db_hash_set(db_hash_b);
+	bt_gatt_dm_cache_invalidate((struct bt_conn *)&dummy_conn);
+
+	discoveries = bt_gatt_discover_mock_call_cnt();
+	saves = gatt_cache_mock_save_cnt();
+
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_true(bt_gatt_discover_mock_call_cnt() > discoveries,
+		     "Out of date result used");
+	zassert_equal(11, bt_gatt_dm_attr_cnt(dm), "Unexpected number of attributes: %d",
+		      bt_gatt_dm_attr_cnt(dm));
+	bt_gatt_dm_data_release(dm);
+
+	/* The stored result is replaced */
+	cache_store_wait(saves + 1);
+	zassert_equal(1, gatt_cache_mock_entry_cnt(), "Result not replaced");
+
+	discoveries = bt_gatt_discover_mock_call_cnt();
+
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(discoveries, bt_gatt_discover_mock_call_cnt(), "Discovered over the air");
+	bt_gatt_dm_data_release(dm);
+}
+
+void test_gatt_cache_not_used(void)
+{
+	size_t reads = gatt_cache_mock_read_cnt();
+	size_t saves = gatt_cache_mock_save_cnt();
+	struct bt_gatt_dm *dm;
+
+	/* Peers that are not bonded are not cached */
+	gatt_cache_mock_bonded_set(false);
+
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(reads, gatt_cache_mock_read_cnt(), "Database Hash read");
+	bt_gatt_dm_data_release(dm);
+
+	/* Neither are peers without a Database Hash */
+	gatt_cache_mock_bonded_set(true);
+	gatt_cache_mock_db_hash_set(NULL);
+
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(reads + 1, gatt_cache_mock_read_cnt(), "Database Hash not read");
+	bt_gatt_dm_data_release(dm);
+
+	k_sleep(K_MSEC(20));
+	zassert_equal(saves, gatt_cache_mock_save_cnt(), "Result stored");
+}
+
+void test_gatt_cache_clear(void)
+{
+	size_t discoveries;
+	struct bt_gatt_dm *dm;
+	int err;
+
+	cache_hids_prime();
+
+	err = bt_gatt_dm_cache_clear(&gatt_cache_mock_peer);
+	zassert_equal(0, err, "Clearing the cache failed: %d", err);
+	zassert_equal(0, gatt_cache_mock_entry_cnt(), "Result not removed");
+
+	discoveries = bt_gatt_discover_mock_call_cnt();
+
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_true(bt_gatt_discover_mock_call_cnt() > discoveries, "Removed result used");
+	bt_gatt_dm_data_release(dm);
+}
+#endif /* defined(CONFIG_BT_GATT_DM_CACHE) */
+
 void test_main(void)
 {
 	ztest_test_suite(
@@ -487,9 +825,33 @@ void test_main(void)
 		ztest_unit_test_setup_teardown(test_gatt_HIDS_chrc_by_uuid, test_setup,
 					       unit_test_noop),
 		ztest_unit_test_setup_teardown(test_gatt_generic_serv, test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_gatt_parallel_conn, test_setup,
+					       unit_test_noop),
 		ztest_unit_test_setup_teardown(test_gatt_many_serv_by_uuid, test_setup,
 					       unit_test_noop)
 	);
 
 	ztest_run_test_suite(test_gatt);
+
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	ztest_test_suite(
+		test_gatt_cache,
+		ztest_unit_test_setup_teardown(test_gatt_cache_miss, test_cache_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_gatt_cache_hit, test_cache_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_gatt_cache_hit_continue, test_cache_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_gatt_cache_invalidate, test_cache_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_gatt_cache_db_hash_mismatch, test_cache_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_gatt_cache_not_used, test_cache_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_gatt_cache_clear, test_cache_setup,
+					       unit_test_noop)
+	);
+
+	ztest_run_test_suite(test_gatt_cache);
+#endif
 }
@@ -0,0 +1,473 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <bluetooth/services/hids.h>
+
+#define REP_LEN 4
+#define REP_ID 1
+#define PEER_CNT CONFIG_BT_HIDS_MAX_CLIENT_COUNT
+#define LOG_SIZE 16
+
+BT_HIDS_DEF(hids_obj, REP_LEN);
+
+static const uint8_t report_map[] = {
+	0x05, 0x01, /* Usage Page (Generic Desktop) */
+	0x09, 0x02, /* Usage (Mouse) */
+	0xA1, 0x01, /* Collection (Application) */
+	0x85, REP_ID, /* Report Id */
+	0x75, 0x08, /* Report Size (8) */
+	0x95, REP_LEN, /* Report Count */
+	0x81, 0x02, /* Input (Data, Variable, Absolute) */
+	0xC0, /* End Collection */
+};
+
+/* The connection objects are opaque, and only their addresses are used. */
+static uint8_t conn_obj[PEER_CNT];
+#define PEER(i) ((struct bt_conn *)&conn_obj[i])
+
+static bool connected[PEER_CNT];
+static bool subscribed[PEER_CNT];
+static int conn_refs;
+
+static struct {
+	struct bt_conn *conn;
+	bt_gatt_complete_func_t func;
+	void *user_data;
+	uint8_t data[REP_LEN];
+	bool completed;
+} notify_log[LOG_SIZE];
+static size_t notify_cnt;
+static size_t sent_cnt[PEER_CNT];
+
+/****************** mock section **********************************/
+int __wrap_bt_gatt_service_register(struct bt_gatt_service *svc)
+{
+	return 0;
+}
+
+int __wrap_bt_gatt_service_unregister(struct bt_gatt_service *svc)
+{
+	return 0;
+}
+
+int __wrap_bt_gatt_notify_cb(struct bt_conn *conn,
+			     struct bt_gatt_notify_params *params)
+{
+	zassert_equal(params->len, REP_LEN, "Wrong report length");
+	zassert_true(notify_cnt < LOG_SIZE, "Too many notifications");
+
+	notify_log[notify_cnt].conn = conn;
+	notify_log[notify_cnt].func = params->func;
+	notify_log[notify_cnt].user_data = params->user_data;
+	notify_log[notify_cnt].completed = false;
+	memcpy(notify_log[notify_cnt].data, params->data, params->len);
+	notify_cnt++;
+
+	return 0;
+}
+
+bool __wrap_bt_gatt_is_subscribed(struct bt_conn *conn,
+				  const struct bt_gatt_attr *attr,
+				  uint16_t ccc_value)
+{
+	for (size_t i = 0; i < PEER_CNT; i++) {
+		if (conn == PEER(i)) {
+			return subscribed[i];
+		}
+	}
+
+	return false;
+}
+
+struct bt_conn *__wrap_bt_conn_ref(struct bt_conn *conn)
+{
+	conn_refs++;
+	return conn;
+}
+
+void __wrap_bt_conn_unref(struct bt_conn *conn)
+{
+	conn_refs--;
+}
+/****************** mock section **********************************/
+
+static size_t peer_index(struct bt_conn *conn)
+{
+	for (size_t i = 0; i < PEER_CNT; i++) {
+		if (conn == PEER(i)) {
+			return i;
+		}
+	}
+
+	zassert_unreachable("Unknown connection");
+	return 0;
+}
+
+static void sent_cb(struct bt_conn *conn, void *user_data)
+{
+	zassert_is_null(user_data, "User data set");
+
+	sent_cnt[peer_index(conn)]++;
+}
+
+static int report_send(uint8_t value)
+{
+	uint8_t rep[REP_LEN];
+
+	memset(rep, value, sizeof(rep));
+
+	return bt_hids_inp_rep_send(&hids_obj, NULL, 0, rep, sizeof(rep),
+				    sent_cb);
+}
+
+/* Number of notifications sent to the peer. */
+static size_t notify_cnt_get(size_t peer)
+{
+	size_t cnt = 0;
+
+	for (size_t i = 0; i < notify_cnt; i++) {
+		if (notify_log[i].conn == PEER(peer)) {
+			cnt++;
+		}
+	}
+
+	return cnt;
+}
+
+/* Check the report carried by the last notification sent to the peer. */
+static void last_report_check(size_t peer, uint8_t value)
+{
+	for (size_t i = notify_cnt; i > 0; i--) {
+		if (notify_log[i - 1].conn != PEER(peer)) {
+			continue;
+		}
+
+		for (size_t j = 0; j < REP_LEN; j++) {
+			zassert_equal(notify_log[i - 1].data[j], value,
+				      "Wrong report sent");
+		}
+
+		return;
+	}
+
+	zassert_unreachable("No report sent");
+}
+
+/* Complete the oldest notification in flight to the peer. */
+static void complete(size_t peer)
+{
+	for (size_t i = 0; i < notify_cnt; i++) {
+		if ((notify_log[i].conn != PEER(peer)) ||
+		    notify_log[i].completed) {
+			continue;
+		}
+
+		notify_log[i].completed = true;
+		notify_log[i].func(PEER(peer), notify_log[i].user_data);
+
+		return;
+	}
+
+	zassert_unreachable("Nothing to complete");
+}
+
+static void ccc_write(size_t peer, uint16_t value)
+{
+	const struct bt_hids_inp_rep *rep = &hids_obj.inp_rep_group.reports[0];
+	const struct bt_gatt_attr *attr = &hids_obj.gp.svc.attrs[rep->att_ind + 1];
+	struct _bt_gatt_ccc *ccc = attr->user_data;
+	ssize_t ret;
+
+	subscribed[peer] = (value == BT_GATT_CCC_NOTIFY);
+
+	ret = ccc->cfg_write(PEER(peer), attr, value);
+	zassert_equal(ret, (ssize_t)sizeof(value), "CCC write failed");
+}
+
+static void peer_connect(size_t peer)
+{
+	int err = bt_hids_connected(&hids_obj, PEER(peer));
+
+	zassert_ok(err, "Connecting failed (err %d)", err);
+	connected[peer] = true;
+}
+
+static void peer_disconnect(size_t peer)
+{
+	int err = bt_hids_disconnected(&hids_obj, PEER(peer));
+
+	zassert_ok(err, "Disconnecting failed (err %d)", err);
+	connected[peer] = false;
+}
+
+static void security_changed(size_t peer)
+{
+	STRUCT_SECTION_FOREACH(bt_conn_cb, cb) {
+		if (cb->security_changed) {
+			cb->security_changed(PEER(peer), BT_SECURITY_L2,
+					     BT_SECURITY_ERR_SUCCESS);
+		}
+	}
+}
+
+static void test_setup(void)
+{
+	memset(notify_log, 0, sizeof(notify_log));
+	memset(sent_cnt, 0, sizeof(sent_cnt));
+	memset(subscribed, 0, sizeof(subscribed));
+	notify_cnt = 0;
+
+	for (size_t i = 0; i < PEER_CNT; i++) {
+		peer_connect(i);
+	}
+}
+
+static void test_teardown(void)
+{
+	for (size_t i = 0; i < PEER_CNT; i++) {
+		if (connected[i]) {
+			peer_disconnect(i);
+		}
+	}
+
+	zassert_equal(conn_refs, 0, "Connection reference leaked");
+}
+
+static void test_subscription(void)
+{
+	int err;
+
+	err = report_send(1);
+	zassert_equal(err, -ENODATA, "Sent without subscribers");
+	zassert_equal(notify_cnt, 0, "Sent without subscribers");
+
+	ccc_write(1, BT_GATT_CCC_NOTIFY);
+
+	err = report_send(2);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	zassert_equal(notify_cnt_get(0), 0, "Sent to an unsubscribed peer");
+	zassert_equal(notify_cnt_get(1), 1, "Not sent to a subscribed peer");
+	last_report_check(1, 2);
+
+	complete(1);
+	zassert_equal(sent_cnt[1], 1, "Sent callback not called");
+}
+
+static void test_waiting(void)
+{
+	int err;
+
+	ccc_write(0, BT_GATT_CCC_NOTIFY);
+	ccc_write(1, BT_GATT_CCC_NOTIFY);
+
+	err = report_send(1);
+	zassert_ok(err, "Sending failed (err %d)", err);
+
+	/* A report sent while a notification is in flight waits. */
+	err = report_send(2);
+	zassert_ok(err, "Sending failed (err %d)", err);
+
+	/* The waiting report is not replaced. */
+	err = report_send(3);
+	zassert_equal(err, -EBUSY, "Waiting report replaced");
+
+	zassert_equal(notify_cnt_get(0), 1, "Sent while in flight");
+	zassert_equal(notify_cnt_get(1), 1, "Sent while in flight");
+
+	/* The waiting report is sent once the notification completes. */
+	complete(0);
+	zassert_equal(sent_cnt[0], 1, "Sent callback not called");
+	zassert_equal(notify_cnt_get(0), 2, "Waiting report not sent");
+	last_report_check(0, 2);
+	zassert_equal(notify_cnt_get(1), 1, "Sent before completion");
+
+	/* The report still waits for the other peer. */
+	err = report_send(3);
+	zassert_equal(err, -EBUSY, "Waiting report replaced");
+
+	complete(1);
+	zassert_equal(sent_cnt[1], 1, "Sent callback not called");
+	last_report_check(1, 2);
+
+	/* Both peers have a notification in flight, the report waits. */
+	err = report_send(3);
+	zassert_ok(err, "Sending failed (err %d)", err);
+
+	complete(0);
+	complete(1);
+	last_report_check(0, 3);
+	last_report_check(1, 3);
+
+	complete(0);
+	complete(1);
+	zassert_equal(sent_cnt[0], 3, "Sent callback not called");
+	zassert_equal(sent_cnt[1], 3, "Sent callback not called");
+
+	/* Nothing in flight, so the next report is sent right away. */
+	err = report_send(4);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	last_report_check(0, 4);
+	last_report_check(1, 4);
+}
+
+static void test_unsubscribe_in_flight(void)
+{
+	int err;
+
+	ccc_write(0, BT_GATT_CCC_NOTIFY);
+
+	err = report_send(1);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	err = report_send(2);
+	zassert_ok(err, "Sending failed (err %d)", err);
+
+	ccc_write(0, 0);
+
+	/* The waiting report is dropped. */
+	complete(0);
+	zassert_equal(sent_cnt[0], 1, "Sent callback not called");
+	zassert_equal(notify_cnt_get(0), 1, "Sent to an unsubscribed peer");
+
+	err = report_send(3);
+	zassert_equal(err, -ENODATA, "Sent without subscribers");
+
+	/* Nothing is left in flight after subscribing again. */
+	ccc_write(0, BT_GATT_CCC_NOTIFY);
+
+	err = report_send(4);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	zassert_equal(notify_cnt_get(0), 2, "Not sent after subscribing");
+	last_report_check(0, 4);
+}
+
+static void test_disconnect_in_flight(void)
+{
+	int err;
+
+	ccc_write(0, BT_GATT_CCC_NOTIFY);
+	ccc_write(1, BT_GATT_CCC_NOTIFY);
+
+	err = report_send(1);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	err = report_send(2);
+	zassert_ok(err, "Sending failed (err %d)", err);
+
+	peer_disconnect(0);
+
+	/* Late completions for the disconnected peer are ignored. */
+	complete(0);
+	zassert_equal(sent_cnt[0], 0, "Sent callback called after disconnect");
+	zassert_equal(notify_cnt_get(0), 1, "Sent after disconnect");
+
+	/* The other peer is not affected. */
+	complete(1);
+	zassert_equal(sent_cnt[1], 1, "Sent callback not called");
+	zassert_equal(notify_cnt_get(1), 2, "Waiting report not sent");
+	last_report_check(1, 2);
+
+	/* A new connection does not inherit the state of the old one. */
+	subscribed[0] = false;
+	peer_connect(0);
+
+	err = report_send(3);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	zassert_equal(notify_cnt_get(0), 1, "Sent to an unsubscribed peer");
+}
+
+static void test_bonded_reconnect(void)
+{
+	int err;
+
+	ccc_write(0, BT_GATT_CCC_NOTIFY);
+	ccc_write(1, BT_GATT_CCC_NOTIFY);
+
+	err = report_send(1);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	complete(0);
+
+	peer_disconnect(0);
+
+	/* The host restores the CCC of the bonded peer on connection, without
+	 * a CCC write. The CCC changed callback is not called either, as the
+	 * other peer keeps the aggregated value unchanged.
+	 */
+	peer_connect(0);
+
+	err = report_send(2);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	zassert_equal(notify_cnt_get(0), 2, "Not sent to a restored peer");
+	last_report_check(0, 2);
+
+	complete(0);
+	zassert_equal(sent_cnt[0], 2, "Sent callback not called");
+}
+
+static void test_restored_on_security(void)
+{
+	int err;
+
+	/* The CCC requires encryption, so the host only restores it once the
+	 * link is encrypted.
+	 */
+	subscribed[1] = true;
+
+	err = report_send(1);
+	zassert_equal(err, -ENODATA, "Sent before restoring the CCC");
+
+	security_changed(1);
+
+	err = report_send(2);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	zassert_equal(notify_cnt_get(1), 1, "Not sent to a restored peer");
+	last_report_check(1, 2);
+
+	complete(1);
+}
+
+void test_main(void)
+{
+	struct bt_hids_init_param init_param = {0};
+	struct bt_hids_inp_rep *inp_rep =
+		&init_param.inp_rep_group_init.reports[0];
+	int err;
+
+	init_param.rep_map.data = report_map;
+	init_param.rep_map.size = sizeof(report_map);
+	init_param.is_mouse = true;
+
+	inp_rep->size = REP_LEN;
+	inp_rep->id = REP_ID;
+	init_param.inp_rep_group_init.cnt++;
+
+	err = bt_hids_init(&hids_obj, &init_param);
+	zassert_ok(err, "HIDS initialization failed (err %d)", err);
+
+	ztest_test_suite(test_bt_hids_fast_path,
+			 ztest_unit_test_setup_teardown(test_subscription,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_waiting,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_unsubscribe_in_flight,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_disconnect_in_flight,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_bonded_reconnect,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_restored_on_security,
+							test_setup,
+							test_teardown)
+	);
+	ztest_run_test_suite(test_bt_hids_fast_path);
+}
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MEMFAULT_CONFIG_MOCK_H_
+#define MEMFAULT_CONFIG_MOCK_H_
+
+#define MEMFAULT_HTTP_APIS_DEFAULT_SCHEME "https"
+#define MEMFAULT_HTTP_CHUNKS_API_HOST "chunks.memfault.com"
+
+#endif /* MEMFAULT_CONFIG_MOCK_H_ */
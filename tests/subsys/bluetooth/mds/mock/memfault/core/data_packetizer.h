@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MEMFAULT_DATA_PACKETIZER_MOCK_H_
+#define MEMFAULT_DATA_PACKETIZER_MOCK_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+bool memfault_packetizer_get_chunk(void *buf, size_t *buf_len);
+
+void memfault_packetizer_abort(void);
+
+#endif /* MEMFAULT_DATA_PACKETIZER_MOCK_H_ */
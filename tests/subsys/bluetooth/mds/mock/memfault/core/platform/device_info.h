@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MEMFAULT_DEVICE_INFO_MOCK_H_
+#define MEMFAULT_DEVICE_INFO_MOCK_H_
+
+typedef struct MemfaultDeviceInfo {
+	const char *device_serial;
+	const char *software_type;
+	const char *software_version;
+	const char *hardware_version;
+} sMemfaultDeviceInfo;
+
+void memfault_platform_get_device_info(sMemfaultDeviceInfo *info);
+
+#endif /* MEMFAULT_DEVICE_INFO_MOCK_H_ */
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/hci.h>
+#include <bluetooth/services/mds.h>
+
+#include <memfault/core/platform/device_info.h>
+#include <memfault/core/data_packetizer.h>
+
+#define ATT_MTU 23
+/* Notification payload without the chunk number byte. */
+#define CHUNK_LEN (ATT_MTU - 3 - 1)
+#define PIPELINE CONFIG_BT_MDS_PIPELINE_COUNT
+#define DATA_LEN 100
+#define LOG_SIZE 16
+
+#define CHUNK_NUMBER_MASK BIT_MASK(5)
+
+/* The connection object is opaque, and only its address is used. */
+static uint8_t conn_obj;
+static struct bt_conn *conn = (struct bt_conn *)&conn_obj;
+
+static const struct bt_mds_cb mds_cb;
+static const struct bt_gatt_attr *data_export_attr;
+
+static uint8_t pattern[DATA_LEN];
+static size_t data_offset;
+static size_t get_chunk_cnt;
+static size_t abort_cnt;
+
+static uint16_t mtu;
+static size_t notify_calls;
+static size_t notify_err_at;
+static int notify_err;
+
+static struct {
+	bt_gatt_complete_func_t func;
+	void *user_data;
+	uint8_t chunk_number;
+	uint8_t data[CHUNK_LEN];
+	uint16_t len;
+} notify_log[LOG_SIZE];
+static size_t notify_cnt;
+static size_t complete_cnt;
+
+/****************** mock section **********************************/
+bool memfault_packetizer_get_chunk(void *buf, size_t *buf_len)
+{
+	size_t len = MIN(*buf_len, DATA_LEN - data_offset);
+
+	get_chunk_cnt++;
+
+	if (!len) {
+		return false;
+	}
+
+	memcpy(buf, &pattern[data_offset], len);
+	data_offset += len;
+	*buf_len = len;
+
+	return true;
+}
+
+void memfault_packetizer_abort(void)
+{
+	/* The message in progress is sent again from its start. */
+	data_offset = 0;
+	abort_cnt++;
+}
+
+void memfault_platform_get_device_info(sMemfaultDeviceInfo *info)
+{
+	*info = (sMemfaultDeviceInfo) {
+		.device_serial = "test",
+		.software_type = "test",
+		.software_version = "1.0.0",
+		.hardware_version = "test",
+	};
+}
+
+int __wrap_bt_gatt_notify_cb(struct bt_conn *c,
+			     struct bt_gatt_notify_params *params)
+{
+	const uint8_t *data = params->data;
+
+	zassert_equal(c, conn, "Wrong connection");
+	zassert_true(params->len <= (mtu - 3), "Notification too long");
+	zassert_true(params->len > 1, "Notification without data");
+	zassert_true(notify_cnt < LOG_SIZE, "Too many notifications");
+
+	notify_calls++;
+
+	if (notify_err && (notify_calls == notify_err_at)) {
+		return notify_err;
+	}
+
+	notify_log[notify_cnt].func = params->func;
+	notify_log[notify_cnt].user_data = params->user_data;
+	notify_log[notify_cnt].chunk_number = data[0] & CHUNK_NUMBER_MASK;
+	notify_log[notify_cnt].len = params->len - 1;
+	memcpy(notify_log[notify_cnt].data, &data[1], params->len - 1);
+	notify_cnt++;
+
+	return 0;
+}
+
+bool __wrap_bt_gatt_is_subscribed(struct bt_conn *c,
+				  const struct bt_gatt_attr *attr,
+				  uint16_t ccc_value)
+{
+	return true;
+}
+
+uint16_t __wrap_bt_gatt_get_mtu(struct bt_conn *c)
+{
+	return mtu;
+}
+/****************** mock section **********************************/
+
+static void export_run(void)
+{
+	/* Let the export work run on the system workqueue. */
+	k_sleep(K_MSEC(5));
+}
+
+static void complete(size_t cnt)
+{
+	for (size_t i = 0; i < cnt; i++) {
+		zassert_true(complete_cnt < notify_cnt, "Nothing to complete");
+
+		notify_log[complete_cnt].func(conn,
+					      notify_log[complete_cnt].user_data);
+		complete_cnt++;
+	}
+
+	export_run();
+}
+
+static void stream_set(uint8_t mode)
+{
+	ssize_t ret = data_export_attr->write(conn, data_export_attr, &mode,
+					      sizeof(mode), 0, 0);
+
+	zassert_equal(ret, (ssize_t)sizeof(mode), "Data export write failed");
+	export_run();
+}
+
+static void disconnect(void)
+{
+	STRUCT_SECTION_FOREACH(bt_conn_cb, cb) {
+		if (cb->disconnected) {
+			cb->disconnected(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+		}
+	}
+}
+
+/* Check that the notifications carry consecutive chunks of the data, numbered from 0. */
+static void notify_check(size_t first, size_t cnt, size_t offset)
+{
+	for (size_t i = first; i < (first + cnt); i++) {
+		zassert_equal(notify_log[i].chunk_number,
+			      (i - first) & CHUNK_NUMBER_MASK,
+			      "Wrong chunk number %zu", i);
+		zassert_mem_equal(notify_log[i].data, &pattern[offset],
+				  notify_log[i].len, "Wrong data in chunk %zu", i);
+		offset += notify_log[i].len;
+	}
+}
+
+static void test_setup(void)
+{
+	memset(notify_log, 0, sizeof(notify_log));
+	notify_cnt = 0;
+	complete_cnt = 0;
+	notify_calls = 0;
+	notify_err = 0;
+	notify_err_at = 0;
+	data_offset = 0;
+	get_chunk_cnt = 0;
+	abort_cnt = 0;
+	mtu = ATT_MTU;
+}
+
+static void test_teardown(void)
+{
+	disconnect();
+	export_run();
+}
+
+static void test_pipeline(void)
+{
+	struct bt_mds_stats stats;
+	int err;
+
+	stream_set(1);
+
+	/* The pipeline is filled and the next chunk is prefetched. */
+	zassert_equal(notify_cnt, PIPELINE, "Pipeline not filled");
+	zassert_equal(data_offset, (PIPELINE + 1) * CHUNK_LEN, "Not prefetched");
+
+	/* Every completion makes room for the next chunk. */
+	while (complete_cnt < notify_cnt) {
+		complete(1);
+	}
+
+	zassert_equal(notify_cnt, ceiling_fraction(DATA_LEN, CHUNK_LEN),
+		      "Wrong number of chunks");
+	notify_check(0, notify_cnt, 0);
+
+	err = bt_mds_stats_get(&stats);
+	zassert_ok(err, "Getting statistics failed (err %d)", err);
+	zassert_equal(stats.bytes, DATA_LEN, "Wrong byte count");
+	zassert_equal(stats.chunks, notify_cnt, "Wrong chunk count");
+	zassert_equal(stats.stalls, 0, "Wrong stall count");
+}
+
+static void test_mtu_too_low(void)
+{
+	/* The ATT MTU is 0 once the link is disconnected. */
+	mtu = 0;
+	stream_set(1);
+
+	zassert_equal(notify_cnt, 0, "Sent without a valid MTU");
+	zassert_equal(get_chunk_cnt, 0, "Fetched without a valid MTU");
+
+	/* No room for the chunk number and data. */
+	mtu = 4;
+	k_sleep(K_MSEC(CONFIG_BT_MDS_DATA_POLL_INTERVAL));
+
+	zassert_equal(notify_cnt, 0, "Sent without a valid MTU");
+	zassert_equal(get_chunk_cnt, 0, "Fetched without a valid MTU");
+
+	/* The export starts on the next poll. */
+	mtu = ATT_MTU;
+	k_sleep(K_MSEC(CONFIG_BT_MDS_DATA_POLL_INTERVAL));
+
+	zassert_equal(notify_cnt, PIPELINE, "Export not started");
+	notify_check(0, notify_cnt, 0);
+}
+
+static void test_stall(void)
+{
+	struct bt_mds_stats stats;
+	int err;
+
+	notify_err = -ENOMEM;
+	notify_err_at = 1;
+
+	stream_set(1);
+
+	/* Retried after a delay without chunks in flight. */
+	zassert_equal(notify_cnt, 0, "Sent without buffers");
+	k_sleep(K_MSEC(20));
+
+	zassert_equal(notify_cnt, PIPELINE, "Not retried");
+	zassert_equal(abort_cnt, 0, "Message aborted");
+	notify_check(0, notify_cnt, 0);
+
+	err = bt_mds_stats_get(&stats);
+	zassert_ok(err, "Getting statistics failed (err %d)", err);
+	zassert_equal(stats.stalls, 1, "Wrong stall count");
+}
+
+static void test_stall_in_flight(void)
+{
+	notify_err = -ENOBUFS;
+	notify_err_at = 2;
+
+	stream_set(1);
+	zassert_equal(notify_cnt, 1, "Sent without buffers");
+
+	/* The completion of the chunk in flight triggers the retry. */
+	k_sleep(K_MSEC(20));
+	zassert_equal(notify_cnt, 1, "Retried with a chunk in flight");
+
+	complete(1);
+	zassert_equal(notify_cnt, 1 + PIPELINE, "Not retried");
+	zassert_equal(abort_cnt, 0, "Message aborted");
+
+	/* The chunk that stalled is sent with the next chunk number. */
+	notify_check(0, notify_cnt, 0);
+}
+
+static void test_disconnect_in_flight(void)
+{
+	struct bt_mds_stats stats;
+	int err;
+
+	stream_set(1);
+	zassert_equal(notify_cnt, PIPELINE, "Pipeline not filled");
+
+	/* The chunks in flight are lost, the message restarts on the next
+	 * connection.
+	 */
+	disconnect();
+	zassert_equal(abort_cnt, 1, "Message not aborted");
+
+	/* Late completions do not send chunks nor refill the pipeline. */
+	complete(PIPELINE);
+	zassert_equal(notify_cnt, PIPELINE, "Sent after disconnection");
+
+	stream_set(1);
+	zassert_equal(notify_cnt, 2 * PIPELINE, "Wrong pipeline depth");
+	notify_check(PIPELINE, PIPELINE, 0);
+
+	err = bt_mds_stats_get(&stats);
+	zassert_ok(err, "Getting statistics failed (err %d)", err);
+	zassert_equal(stats.chunks, PIPELINE, "Statistics not reset");
+}
+
+void test_main(void)
+{
+	int err;
+
+	for (size_t i = 0; i < ARRAY_SIZE(pattern); i++) {
+		pattern[i] = i;
+	}
+
+	STRUCT_SECTION_FOREACH(bt_gatt_service_static, svc) {
+		for (size_t i = 0; i < svc->attr_count; i++) {
+			if (!bt_uuid_cmp(svc->attrs[i].uuid,
+					 BT_UUID_MDS_DATA_EXPORT)) {
+				data_export_attr = &svc->attrs[i];
+			}
+		}
+	}
+
+	zassert_not_null(data_export_attr, "No Data Export characteristic");
+
+	err = bt_mds_cb_register(&mds_cb);
+	zassert_ok(err, "Registering the callbacks failed (err %d)", err);
+
+	ztest_test_suite(test_bt_mds,
+			 ztest_unit_test_setup_teardown(test_pipeline,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_mtu_too_low,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_stall,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_stall_in_flight,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_disconnect_in_flight,
+							test_setup,
+							test_teardown)
+	);
+	ztest_run_test_suite(test_bt_mds);
+}
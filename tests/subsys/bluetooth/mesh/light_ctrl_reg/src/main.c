@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdlib.h>
+#include <ztest.h>
+#include <bluetooth/mesh/light_ctrl_reg_spec.h>
+#include <bluetooth/mesh/light_ctrl_reg_fixed.h>
+
+/* Runs the specification-defined regulator and its fixed-point implementation
+ * side by side, each in a closed loop with its own simulated luminaire, and
+ * compares their outputs over recorded ambient illuminance traces.
+ */
+
+#define REG_INT CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_INTERVAL
+
+/* Regulator steps per ambient illuminance sample. */
+#define STEPS_PER_SAMPLE (MSEC_PER_SEC / REG_INT)
+
+/* Maximum difference between the outputs of the regulators. */
+#define TOLERANCE 1
+
+BUILD_ASSERT(CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_INTERVAL ==
+	     CONFIG_BT_MESH_LIGHT_CTRL_REG_FIXED_INTERVAL);
+
+/* Ambient illuminance in lux, sampled once a second by a sensor next to a
+ * window on a partly cloudy morning.
+ */
+static const uint16_t trace_window[] = {
+	170, 182, 191, 174, 172, 185, 190, 205, 217, 196, 209, 184, 212, 217, 208,
+	218, 207, 194, 214, 219, 193, 186, 161, 131, 96,  76,  71,  20,  49,  104,
+	128, 198, 246, 285, 307, 282, 299, 323, 302, 287, 310, 322, 299, 293, 317,
+	293, 320, 350, 342, 347, 360, 381, 380, 400, 425, 427, 427, 448, 474, 485,
+};
+
+/* Ambient illuminance in lux in a corridor, where the ceiling lights of the
+ * neighboring zone are switched on and off.
+ */
+static const uint16_t trace_corridor[] = {
+	2,   2,   3,   2,   2,   2,   85,  140, 152, 155, 154, 155, 156, 155, 154,
+	155, 155, 156, 155, 90,  20,  4,   3,   2,   2,   3,   2,   2,   2,   2,
+};
+
+struct loop {
+	/* Luminaire output in lux per lightness level. */
+	float lux_per_lvl;
+	const uint16_t *trace;
+	size_t step;
+	uint16_t lvl;
+};
+
+static struct loop spec_loop;
+static struct loop fixed_loop;
+
+static struct bt_mesh_light_ctrl_reg_spec spec_reg =
+	BT_MESH_LIGHT_CTRL_REG_SPEC_INIT;
+static struct bt_mesh_light_ctrl_reg_fixed fixed_reg =
+	BT_MESH_LIGHT_CTRL_REG_FIXED_INIT;
+
+static int64_t mock_uptime;
+
+/****************** mock section **********************************/
+
+void k_work_init_delayable(struct k_work_delayable *dwork,
+			   k_work_handler_t handler)
+{
+	dwork->work.handler = handler;
+}
+
+int k_work_cancel_delayable(struct k_work_delayable *dwork)
+{
+	return 0;
+}
+
+/*
+ * This is mocked, as k_work_reschedule is inline and can't be, but calls this
+ * underneath
+ */
+int k_work_reschedule_for_queue(struct k_work_q *queue,
+				struct k_work_delayable *dwork,
+				k_timeout_t delay)
+{
+	return 0;
+}
+
+int k_work_schedule(struct k_work_delayable *dwork,
+		    k_timeout_t delay)
+{
+	return 0;
+}
+
+int64_t z_impl_k_uptime_ticks(void)
+{
+	return k_ms_to_ticks_ceil64(mock_uptime);
+}
+
+/****************** mock section **********************************/
+
+static void measure(struct bt_mesh_light_ctrl_reg *reg, struct loop *loop)
+{
+	reg->measured = loop->trace[loop->step / STEPS_PER_SAMPLE] +
+			loop->lvl * loop->lux_per_lvl;
+	loop->step++;
+}
+
+static void spec_updated(struct bt_mesh_light_ctrl_reg *reg, float output)
+{
+	spec_loop.lvl = CLAMP(output, 0, UINT16_MAX);
+	measure(reg, &spec_loop);
+}
+
+static void fixed_updated(struct bt_mesh_light_ctrl_reg *reg, uint16_t output)
+{
+	fixed_loop.lvl = output;
+	measure(reg, &fixed_loop);
+}
+
+static void setup(void)
+{
+	struct bt_mesh_light_ctrl_reg_cfg cfg = {
+		.ki = { .up = 250.0f, .down = 25.0f },
+		.kp = { .up = 80.0f, .down = 80.0f },
+		.accuracy = 2.0f,
+	};
+
+	mock_uptime = 0;
+
+	spec_reg.reg.cfg = cfg;
+	spec_reg.reg.updated = spec_updated;
+	spec_reg.reg.init(&spec_reg.reg);
+
+	fixed_reg.reg.cfg = cfg;
+	fixed_reg.reg.updated_lvl = fixed_updated;
+	fixed_reg.reg.init(&fixed_reg.reg);
+}
+
+static void teardown(void)
+{
+	spec_reg.reg.stop(&spec_reg.reg);
+	fixed_reg.reg.stop(&fixed_reg.reg);
+}
+
+static void target_set(float target, int32_t transition_time)
+{
+	bt_mesh_light_ctrl_reg_target_set(&spec_reg.reg, target, transition_time);
+	bt_mesh_light_ctrl_reg_target_set(&fixed_reg.reg, target, transition_time);
+}
+
+/* Run both regulators over the trace, changing the target halfway. */
+static void loop_run(const uint16_t *trace, size_t len, float lux_per_lvl,
+		     float target_start, float target_end, int32_t transition_time)
+{
+	uint32_t max_diff = 0;
+	uint32_t diff_sum = 0;
+	size_t steps = len * STEPS_PER_SAMPLE;
+
+	spec_loop = (struct loop){ .lux_per_lvl = lux_per_lvl, .trace = trace };
+	fixed_loop = spec_loop;
+
+	spec_reg.reg.measured = trace[0];
+	fixed_reg.reg.measured = trace[0];
+
+	target_set(target_start, transition_time);
+
+	spec_reg.reg.start(&spec_reg.reg);
+	fixed_reg.reg.start(&fixed_reg.reg);
+
+	for (size_t i = 0; i < steps; i++) {
+		if (i == steps / 2) {
+			target_set(target_end, transition_time);
+		}
+
+		mock_uptime += REG_INT;
+
+		spec_reg.timer.work.handler(&spec_reg.timer.work);
+		fixed_reg.timer.work.handler(&fixed_reg.timer.work);
+
+		uint32_t diff = abs((int32_t)spec_loop.lvl - (int32_t)fixed_loop.lvl);
+
+		zassert_true(diff <= TOLERANCE,
+			     "Step %u: spec output %u, fixed output %u", i,
+			     spec_loop.lvl, fixed_loop.lvl);
+
+		max_diff = MAX(max_diff, diff);
+		diff_sum += diff;
+	}
+
+	TC_PRINT("steps,max_diff,diff_sum\n");
+	TC_PRINT("%u,%u,%u\n", steps, max_diff, diff_sum);
+}
+
+static void test_window(void)
+{
+	loop_run(trace_window, ARRAY_SIZE(trace_window), 0.01f, 500.0f, 300.0f,
+		 0);
+}
+
+static void test_window_transition(void)
+{
+	loop_run(trace_window, ARRAY_SIZE(trace_window), 0.01f, 500.0f, 300.0f,
+		 5000);
+}
+
+static void test_corridor(void)
+{
+	loop_run(trace_corridor, ARRAY_SIZE(trace_corridor), 0.004f, 200.0f,
+		 80.0f, 2000);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(light_ctrl_reg_test,
+			 ztest_unit_test_setup_teardown(test_window, setup,
+							teardown),
+			 ztest_unit_test_setup_teardown(test_window_transition,
+							setup, teardown),
+			 ztest_unit_test_setup_teardown(test_corridor, setup,
+							teardown)
+			 );
+
+	ztest_run_test_suite(light_ctrl_reg_test);
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/mesh.h>
+#include <mesh/net.h>
+#include <mesh/rpl.h>
+
+#define RPL_SIZE CONFIG_BT_MESH_CRPL
+
+/* Sources spread over the unicast range, next to sequential ones. */
+static uint16_t src_get(int i)
+{
+	return (i % 2) ? (0x0100 + i) : (0x7fff - i * 0x0123);
+}
+
+static bool check(uint16_t src, uint32_t seq, bool old_iv, struct bt_mesh_rpl **match)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = src,
+		.seq = seq,
+		.old_iv = old_iv,
+		.net_if = BT_MESH_NET_IF_ADV,
+		.local_match = true,
+	};
+
+	return bt_mesh_rpl_check(&rx, match);
+}
+
+static void update(struct bt_mesh_rpl *rpl, uint16_t src, uint32_t seq)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = src,
+		.seq = seq,
+		.net_if = BT_MESH_NET_IF_ADV,
+		.local_match = true,
+	};
+
+	bt_mesh_rpl_update(rpl, &rx);
+}
+
+static void fill(int first, int count)
+{
+	for (int i = first; i < first + count; i++) {
+		zassert_false(check(src_get(i), 1, false, NULL), "Source %d rejected", i);
+	}
+}
+
+static void setup(void)
+{
+	bt_mesh_rpl_clear();
+}
+
+static void test_lookup(void)
+{
+	fill(0, RPL_SIZE);
+
+	for (int i = 0; i < RPL_SIZE; i++) {
+		zassert_true(check(src_get(i), 1, false, NULL), "Replay of %d not found", i);
+		zassert_false(check(src_get(i), 2, false, NULL), "Source %d not updated", i);
+		zassert_true(check(src_get(i), 2, false, NULL), "Replay of %d not found", i);
+	}
+}
+
+static void test_full(void)
+{
+	fill(0, RPL_SIZE);
+
+	zassert_true(check(src_get(RPL_SIZE), 1, false, NULL), "New source added to full RPL");
+
+	for (int i = 0; i < RPL_SIZE; i++) {
+		zassert_true(check(src_get(i), 1, false, NULL), "Replay of %d not found", i);
+	}
+}
+
+static void test_clear(void)
+{
+	fill(0, RPL_SIZE);
+
+	bt_mesh_rpl_clear();
+
+	fill(0, RPL_SIZE);
+
+	zassert_true(check(src_get(RPL_SIZE), 1, false, NULL), "New source added to full RPL");
+}
+
+static void test_reset(void)
+{
+	int half = RPL_SIZE / 2;
+
+	/* The first half is flagged as old, then discarded, and the second half
+	 * is moved into the freed slots.
+	 */
+	fill(0, half);
+	bt_mesh_rpl_reset();
+	fill(half, RPL_SIZE - half);
+	bt_mesh_rpl_reset();
+
+	/* The discarded sources are added again, which fills the RPL. */
+	for (int i = 0; i < half; i++) {
+		zassert_false(check(src_get(i), 1, true, NULL), "Source %d not discarded", i);
+	}
+
+	for (int i = half; i < RPL_SIZE; i++) {
+		zassert_true(check(src_get(i), 1, true, NULL), "Replay of %d not found", i);
+	}
+
+	zassert_true(check(src_get(RPL_SIZE), 1, true, NULL), "New source added to full RPL");
+
+	/* The kept sources move on to the new IV index. */
+	for (int i = half; i < RPL_SIZE; i++) {
+		zassert_false(check(src_get(i), 1, false, NULL), "Source %d rejected", i);
+	}
+}
+
+static void test_check_then_update(void)
+{
+	struct bt_mesh_rpl *first;
+	struct bt_mesh_rpl *second;
+
+	fill(0, RPL_SIZE - 2);
+
+	/* Both new sources get the same free slot until one is updated. */
+	zassert_false(check(src_get(RPL_SIZE - 2), 1, false, &first), "Source rejected");
+	zassert_false(check(src_get(RPL_SIZE - 1), 1, false, &second), "Source rejected");
+	zassert_equal_ptr(first, second, "Different free slots");
+
+	update(second, src_get(RPL_SIZE - 1), 1);
+	update(first, src_get(RPL_SIZE - 2), 1);
+
+	for (int i = 0; i < RPL_SIZE; i++) {
+		zassert_true(check(src_get(i), 1, false, NULL), "Replay of %d not found", i);
+	}
+
+	/* The source whose slot is taken by another one while the RPL fills up
+	 * is not stored.
+	 */
+	bt_mesh_rpl_clear();
+	fill(0, RPL_SIZE - 1);
+
+	zassert_false(check(src_get(RPL_SIZE), 1, false, &first), "Source rejected");
+	fill(RPL_SIZE - 1, 1);
+	update(first, src_get(RPL_SIZE), 1);
+
+	zassert_true(check(src_get(RPL_SIZE), 1, false, NULL), "New source added to full RPL");
+
+	for (int i = 0; i < RPL_SIZE; i++) {
+		zassert_true(check(src_get(i), 1, false, NULL), "Replay of %d not found", i);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(rpl_test,
+		ztest_unit_test_setup_teardown(test_lookup, setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_full, setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_clear, setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_reset, setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_check_then_update, setup, unit_test_noop)
+		);
+
+	ztest_run_test_suite(rpl_test);
+}
@@ -0,0 +1,461 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ztest.h>
+#include <bluetooth/mesh/models.h>
+#include <zephyr/settings/settings.h>
+#include "model_utils.h"
+
+/* Stores scenes the way an installer does during commissioning, and counts
+ * the settings writes of the Scene Server. Run with
+ * CONFIG_BT_MESH_SCENE_SRV_PAGES_MAX set to 0 to compare with a Scene Server
+ * that writes all pages.
+ */
+
+#define SCENE_COUNT CONFIG_BT_MESH_SCENES_MAX
+#define TEST_MODELS 4
+/* Two entries fit in a page, so each scene has two pages. */
+#define ENTRY_LEN   100
+#define STORE_SIZE  64
+
+/* Model state of the first model in each scene. The other models have the
+ * same state in all scenes.
+ */
+#define LVL(_scene) (_scene)
+#define FIXED(_mod) (0xa0 + (_mod))
+
+static struct {
+	uint32_t writes;
+	uint32_t bytes;
+} stats;
+
+static struct {
+	char key[16];
+	uint8_t data[SETTINGS_MAX_VAL_LEN];
+	size_t len;
+} store[STORE_SIZE];
+
+static uint8_t state[TEST_MODELS];
+static uint8_t recalled[TEST_MODELS];
+static uint8_t expected[SCENE_COUNT + 1][TEST_MODELS];
+static bool provisioned;
+
+static ssize_t test_scene_store(struct bt_mesh_model *model, uint8_t data[]);
+static void test_scene_recall(struct bt_mesh_model *model, const uint8_t data[],
+			      size_t len, struct bt_mesh_model_transition *transition);
+
+#define TEST_MODEL_ID(_mod) (0x7000 + (_mod))
+
+#define TEST_SCENE_ENTRY(_mod)                                                 \
+	BT_MESH_SCENE_ENTRY_SIG(test##_mod) = {                                \
+		.id.sig = TEST_MODEL_ID(_mod),                                 \
+		.maxlen = ENTRY_LEN,                                           \
+		.store = test_scene_store,                                     \
+		.recall = test_scene_recall,                                   \
+	}
+
+TEST_SCENE_ENTRY(0);
+TEST_SCENE_ENTRY(1);
+TEST_SCENE_ENTRY(2);
+TEST_SCENE_ENTRY(3);
+
+static struct bt_mesh_scene_srv scene_srv;
+
+static struct bt_mesh_model models[] = {
+	BT_MESH_MODEL_SCENE_SRV(&scene_srv),
+	BT_MESH_MODEL(TEST_MODEL_ID(0), NULL, NULL, NULL),
+	BT_MESH_MODEL(TEST_MODEL_ID(1), NULL, NULL, NULL),
+	BT_MESH_MODEL(TEST_MODEL_ID(2), NULL, NULL, NULL),
+	BT_MESH_MODEL(TEST_MODEL_ID(3), NULL, NULL, NULL),
+};
+
+/* Index of the first test model: */
+#define TEST_MODEL_IDX 2
+
+static struct bt_mesh_elem elems[] = {
+	BT_MESH_ELEM(0, models, BT_MESH_MODEL_NONE),
+};
+
+static const struct bt_mesh_comp comp = {
+	.elem = elems,
+	.elem_count = ARRAY_SIZE(elems),
+};
+
+/****************** mock section **********************************/
+
+const struct bt_mesh_comp *bt_mesh_comp_get(void)
+{
+	return &comp;
+}
+
+uint8_t bt_mesh_elem_count(void)
+{
+	return comp.elem_count;
+}
+
+bool bt_mesh_model_is_extended(struct bt_mesh_model *model)
+{
+	return false;
+}
+
+bool bt_mesh_is_provisioned(void)
+{
+	return provisioned;
+}
+
+struct bt_mesh_model *bt_mesh_model_find(const struct bt_mesh_elem *elem,
+					 uint16_t id)
+{
+	for (int i = 0; i < elem->model_count; i++) {
+		if (elem->models[i].id == id) {
+			return &elem->models[i];
+		}
+	}
+
+	return NULL;
+}
+
+struct bt_mesh_model *bt_mesh_model_find_vnd(const struct bt_mesh_elem *elem,
+					     uint16_t company, uint16_t id)
+{
+	return NULL;
+}
+
+int bt_mesh_model_extend(struct bt_mesh_model *mod,
+			 struct bt_mesh_model *base_mod)
+{
+	return 0;
+}
+
+void bt_mesh_model_msg_init(struct net_buf_simple *msg, uint32_t opcode)
+{
+	net_buf_simple_init(msg, 0);
+}
+
+int model_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+	       struct net_buf_simple *buf)
+{
+	return 0;
+}
+
+int tid_check_and_update(struct bt_mesh_tid_ctx *prev_transaction, uint8_t tid,
+			 const struct bt_mesh_msg_ctx *ctx)
+{
+	return 0;
+}
+
+uint8_t model_transition_encode(int32_t transition_time)
+{
+	return 0;
+}
+
+int32_t model_transition_decode(uint8_t encoded_transition)
+{
+	return 0;
+}
+
+int32_t model_delay_decode(uint8_t encoded_delay)
+{
+	return 0;
+}
+
+static int store_find(const char *key)
+{
+	for (int i = 0; i < STORE_SIZE; i++) {
+		if (store[i].len && !strcmp(store[i].key, key)) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+int bt_mesh_model_data_store(struct bt_mesh_model *mod, bool vnd,
+			     const char *name, const void *data,
+			     size_t data_len)
+{
+	int i = store_find(name);
+
+	zassert_equal(mod, &models[0], "Stored with wrong model");
+	zassert_true(data_len <= SETTINGS_MAX_VAL_LEN, "Too long %s", name);
+
+	stats.writes++;
+	stats.bytes += data_len;
+
+	if (!data_len) {
+		if (i >= 0) {
+			store[i].len = 0;
+		}
+
+		return 0;
+	}
+
+	if (i < 0) {
+		for (i = 0; i < STORE_SIZE && store[i].len; i++) {
+		}
+
+		zassert_true(i < STORE_SIZE, "Mock store full");
+		strcpy(store[i].key, name);
+	}
+
+	memcpy(store[i].data, data, data_len);
+	store[i].len = data_len;
+
+	return 0;
+}
+
+static ssize_t store_read(void *cb_arg, void *data, size_t len)
+{
+	int i = (intptr_t)cb_arg;
+
+	len = MIN(len, store[i].len);
+	memcpy(data, store[i].data, len);
+
+	return len;
+}
+
+int settings_name_next(const char *name, const char **next)
+{
+	const char *sep = strchr(name, '/');
+
+	if (!sep) {
+		*next = NULL;
+		return strlen(name);
+	}
+
+	*next = sep + 1;
+	return sep - name;
+}
+
+/* Only the data of the Scene Server is stored under "bt/mesh/s/0/data/". */
+static const char *model_key(const char *path)
+{
+	const char *prefix = "bt/mesh/s/0/data/";
+
+	zassert_equal(strncmp(path, prefix, strlen(prefix)), 0,
+		      "Unexpected path %s", path);
+
+	return &path[strlen(prefix)];
+}
+
+int settings_load_subtree(const char *subtree)
+{
+	const char *key = model_key(subtree);
+	size_t len = strlen(key);
+
+	for (int i = 0; i < STORE_SIZE; i++) {
+		if (!store[i].len || strncmp(store[i].key, key, len) ||
+		    store[i].key[len] != '/') {
+			continue;
+		}
+
+		zassert_ok(_bt_mesh_scene_srv_cb.settings_set(
+				   &models[0], store[i].key, store[i].len,
+				   store_read, (void *)(intptr_t)i),
+			   "Loading %s failed", store[i].key);
+	}
+
+	return 0;
+}
+
+int settings_load_subtree_direct(const char *subtree, settings_load_direct_cb cb,
+				 void *param)
+{
+	int i = store_find(model_key(subtree));
+
+	if (i >= 0) {
+		return cb(NULL, store[i].len, store_read, (void *)(intptr_t)i,
+			  param);
+	}
+
+	return 0;
+}
+
+/****************** mock section **********************************/
+
+static ssize_t test_scene_store(struct bt_mesh_model *model, uint8_t data[])
+{
+	memset(data, state[model->mod_idx - TEST_MODEL_IDX], ENTRY_LEN);
+
+	return ENTRY_LEN;
+}
+
+static void test_scene_recall(struct bt_mesh_model *model, const uint8_t data[],
+			      size_t len, struct bt_mesh_model_transition *transition)
+{
+	zassert_equal(len, ENTRY_LEN, "Wrong length %u", len);
+
+	recalled[model->mod_idx - TEST_MODEL_IDX] = data[0];
+}
+
+static void op_call(uint32_t opcode, uint16_t scene)
+{
+	const struct bt_mesh_model_op *op;
+	struct bt_mesh_msg_ctx ctx = {};
+
+	NET_BUF_SIMPLE_DEFINE(buf, 2);
+
+	net_buf_simple_add_le16(&buf, scene);
+
+	for (op = _bt_mesh_scene_setup_srv_op; op->func; op++) {
+		if (op->opcode == opcode) {
+			zassert_ok(op->func(&models[1], &ctx, &buf), "Op failed");
+			return;
+		}
+	}
+
+	ztest_test_fail();
+}
+
+static void scene_store(uint16_t scene)
+{
+	memcpy(expected[scene], state, sizeof(state));
+	op_call(BT_MESH_SCENE_OP_STORE_UNACK, scene);
+}
+
+static void scenes_check(void)
+{
+	for (uint16_t scene = 1; scene <= SCENE_COUNT; scene++) {
+		int err;
+
+		memset(recalled, 0, sizeof(recalled));
+
+		/* Make sure that the scene isn't the current one, which
+		 * wouldn't be recalled again:
+		 */
+		bt_mesh_scene_invalidate(&models[TEST_MODEL_IDX]);
+
+		err = bt_mesh_scene_srv_set(&scene_srv, scene, NULL);
+		if (!expected[scene][0]) {
+			zassert_equal(err, -ENOENT, "Deleted scene %u recalled",
+				      scene);
+			continue;
+		}
+
+		zassert_ok(err, "Recalling scene %u failed", scene);
+		zassert_mem_equal(recalled, expected[scene], sizeof(recalled),
+				  "Scene %u recalled wrong state", scene);
+	}
+}
+
+static void stats_print(const char *step)
+{
+	TC_PRINT("%s,%u,%u,%u\n", step, CONFIG_BT_MESH_SCENE_SRV_PAGES_MAX,
+		 stats.writes, stats.bytes);
+	memset(&stats, 0, sizeof(stats));
+}
+
+/* Reload the scenes from the stored data, like on boot. */
+static void reboot(void)
+{
+	provisioned = false;
+	scene_srv.count = 0;
+	scene_srv.sigpages = 0;
+	scene_srv.vndpages = 0;
+	memset(scene_srv.pages, 0, sizeof(scene_srv.pages));
+
+	for (int i = 0; i < STORE_SIZE; i++) {
+		if (!store[i].len) {
+			continue;
+		}
+
+		zassert_ok(_bt_mesh_scene_srv_cb.settings_set(
+				   &models[0], store[i].key, store[i].len,
+				   store_read, (void *)(intptr_t)i),
+			   "Loading %s failed", store[i].key);
+	}
+
+	provisioned = true;
+}
+
+static void test_store(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(models); i++) {
+		models[i].elem_idx = 0;
+		models[i].mod_idx = i;
+	}
+
+	zassert_ok(_bt_mesh_scene_srv_cb.init(&models[0]), "Init failed");
+	provisioned = true;
+
+	for (int mod = 0; mod < TEST_MODELS; mod++) {
+		state[mod] = FIXED(mod);
+	}
+
+	TC_PRINT("step,pages_max,writes,bytes\n");
+
+	/* Commissioning: All scenes only differ in the first page. */
+	for (uint16_t scene = 1; scene <= SCENE_COUNT; scene++) {
+		state[0] = LVL(scene);
+		scene_store(scene);
+	}
+
+	if (CONFIG_BT_MESH_SCENE_SRV_PAGES_MAX) {
+		/* The second page of all but the first scene is a link. */
+		zassert_equal(stats.writes, 2 * SCENE_COUNT, "Wrong write count");
+		zassert_true(stats.bytes < (SCENE_COUNT + 2) * SETTINGS_MAX_VAL_LEN,
+			     "Pages not deduplicated");
+	}
+
+	stats_print("store");
+	scenes_check();
+
+	/* Storing the same scenes again doesn't change anything. */
+	for (uint16_t scene = 1; scene <= SCENE_COUNT; scene++) {
+		state[0] = LVL(scene);
+		scene_store(scene);
+	}
+
+	if (CONFIG_BT_MESH_SCENE_SRV_PAGES_MAX) {
+		zassert_equal(stats.writes, 0, "Unchanged pages written");
+	}
+
+	stats_print("store_again");
+
+	/* Change the second page of the scene the others link to. */
+	state[0] = LVL(1);
+	state[3] = 0x55;
+	scene_store(1);
+	stats_print("change_shared");
+	scenes_check();
+
+	/* Delete the scene the others now link to. */
+	op_call(BT_MESH_SCENE_OP_DELETE_UNACK, 2);
+	memset(expected[2], 0, sizeof(expected[2]));
+	stats_print("delete_shared");
+	scenes_check();
+
+	reboot();
+	scenes_check();
+
+	for (uint16_t scene = 1; scene <= SCENE_COUNT; scene++) {
+		if (!expected[scene][0]) {
+			continue;
+		}
+
+		memcpy(state, expected[scene], sizeof(state));
+		scene_store(scene);
+	}
+
+	if (CONFIG_BT_MESH_SCENE_SRV_PAGES_MAX) {
+		zassert_equal(stats.writes, 0, "Index not recovered");
+	}
+
+	stats_print("store_after_reboot");
+	scenes_check();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(scene_srv_test,
+			 ztest_unit_test(test_store)
+			 );
+
+	ztest_run_test_suite(scene_srv_test);
+}
@@ -6,9 +6,11 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <ztest.h>
 #include <zephyr/kernel.h>
 #include <zephyr/sys/timeutil.h>
+#include <zephyr/random/rand32.h>
 #include <bluetooth/mesh/gen_onoff_srv.h>
 #include <bluetooth/mesh/time_srv.h>
 #include <bluetooth/mesh/scheduler_srv.h>
@@ -18,6 +20,8 @@
 
 #define DELTA_TIME   1
 #define SUBSEC_STEPS 256
+#define RANDOM_ROUNDS 20
+#define RANDOM_SEED 0x2f6b3a91
 
 /* item of struct tm */
 #define ISTM(year, month, day, hour, minute, second) \
@@ -923,6 +927,147 @@ static void test_exact_time_general_ovflw(void)
 	expected_tm_check(&expected, 1);
 }
 
+static void random_action_put(uint8_t idx, const struct bt_mesh_schedule_entry *entry)
+{
+	BT_MESH_MODEL_BUF_DEFINE(buf, BT_MESH_SCHEDULER_OP_ACTION_SET_UNACK,
+			BT_MESH_SCHEDULER_MSG_LEN_ACTION_SET);
+
+	net_buf_simple_init(&buf, 0);
+	scheduler_action_pack(&buf, idx, entry);
+
+	zassert_false(_bt_mesh_scheduler_setup_srv_op[1].func(&mock_sched_model, NULL, &buf),
+		"Cannot schedule test action.");
+}
+
+/* Fixed seed, so that a failing sequence of schedules can be reproduced. */
+static uint32_t random_state;
+
+/* xorshift32 */
+static uint32_t random_get(void)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+
+	return random_state;
+}
+
+static void random_entry_get(struct bt_mesh_schedule_entry *entry)
+{
+	static const uint8_t hours[] = {
+		BT_MESH_SCHEDULER_ANY_HOUR, BT_MESH_SCHEDULER_ONCE_A_DAY,
+	};
+	static const uint8_t minutes[] = {
+		BT_MESH_SCHEDULER_ANY_MINUTE, BT_MESH_SCHEDULER_EVERY_15_MINUTES,
+		BT_MESH_SCHEDULER_EVERY_20_MINUTES, BT_MESH_SCHEDULER_ONCE_AN_HOUR,
+	};
+	static const uint8_t seconds[] = {
+		BT_MESH_SCHEDULER_ANY_SECOND, BT_MESH_SCHEDULER_EVERY_15_SECONDS,
+		BT_MESH_SCHEDULER_EVERY_20_SECONDS, BT_MESH_SCHEDULER_ONCE_A_MINUTE,
+	};
+	uint32_t rnd = random_get();
+
+	memset(entry, 0, sizeof(*entry));
+
+	/* Years from 2020 on, so that no action fires during the test. */
+	entry->year = 20 + random_get() % 50;
+	entry->month = (random_get() & ANY_MONTH) ?: ANY_MONTH;
+	entry->day = random_get() % 29;
+	entry->hour = (rnd & BIT(0)) ? hours[random_get() % ARRAY_SIZE(hours)] :
+				       random_get() % 24;
+	entry->minute = (rnd & BIT(1)) ? minutes[random_get() % ARRAY_SIZE(minutes)] :
+					 random_get() % 60;
+	entry->second = (rnd & BIT(2)) ? seconds[random_get() % ARRAY_SIZE(seconds)] :
+					 random_get() % 60;
+	entry->day_of_week = (random_get() & ANY_DAY_OF_WEEK) ?: ANY_DAY_OF_WEEK;
+	entry->action = (rnd & BIT(3)) ? BT_MESH_SCHEDULER_SCENE_RECALL :
+					 BT_MESH_SCHEDULER_TURN_ON;
+	entry->scene_number = 1;
+}
+
+/* The entry planned next must be the earliest of the active entries. */
+static void planned_entry_check(void)
+{
+	uint8_t earliest = BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
+	int count = 0;
+
+	for (int i = 0; i < BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT; i++) {
+		if (!(scheduler_srv.active_bitmap & BIT(i))) {
+			continue;
+		}
+
+		count++;
+
+		if (earliest == BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT ||
+		    scheduler_srv.sched_tai[i].sec < scheduler_srv.sched_tai[earliest].sec) {
+			earliest = i;
+		}
+	}
+
+	zassert_equal(scheduler_srv.heap_len, count, "Wrong number of planned entries (seed %#x)",
+		      RANDOM_SEED);
+
+	if (!count) {
+		zassert_equal(scheduler_srv.idx, BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT,
+			      "Entry planned without active entries (seed %#x)", RANDOM_SEED);
+		return;
+	}
+
+	zassert_equal(scheduler_srv.sched_tai[scheduler_srv.idx].sec,
+		      scheduler_srv.sched_tai[earliest].sec,
+		      "Entry %d planned, %d is earlier (seed %#x)", scheduler_srv.idx, earliest,
+		      RANDOM_SEED);
+}
+
+static void test_random_schedules(void)
+{
+	struct bt_mesh_schedule_entry entry;
+	uint32_t set_cycles = 0;
+	uint32_t update_cycles = 0;
+	uint32_t start;
+
+	random_state = RANDOM_SEED;
+
+	for (int round = 0; round < RANDOM_ROUNDS; round++) {
+		for (uint8_t idx = 0; idx < BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT; idx++) {
+			random_entry_get(&entry);
+
+			start = k_cycle_get_32();
+			random_action_put(idx, &entry);
+			set_cycles += k_cycle_get_32() - start;
+
+			planned_entry_check();
+		}
+
+		start = k_cycle_get_32();
+		zassert_ok(bt_mesh_scheduler_srv_time_update(&scheduler_srv),
+			   "Time update failed (seed %#x)", RANDOM_SEED);
+		update_cycles += k_cycle_get_32() - start;
+
+		planned_entry_check();
+
+		/* Disable a random half of the entries. */
+		for (uint8_t idx = 0; idx < BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT; idx++) {
+			if (random_get() & 1) {
+				continue;
+			}
+
+			entry = scheduler_srv.sch_reg[idx];
+			entry.action = BT_MESH_SCHEDULER_NO_ACTIONS;
+			random_action_put(idx, &entry);
+
+			zassert_false(scheduler_srv.active_bitmap & BIT(idx),
+				      "Disabled entry %d is still active (seed %#x)", idx,
+				      RANDOM_SEED);
+			planned_entry_check();
+		}
+	}
+
+	TC_PRINT("action_set_cycles,time_update_cycles\n");
+	TC_PRINT("%u,%u\n", set_cycles / (RANDOM_ROUNDS * BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT),
+		 update_cycles / RANDOM_ROUNDS);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(scheduler_test,
@@ -948,7 +1093,8 @@ void test_main(void)
 				setup, teardown),
 		ztest_unit_test_setup_teardown(test_any_day_month_gap, setup, teardown),
 		ztest_unit_test_setup_teardown(test_month_ovflw, setup, teardown),
-		ztest_unit_test_setup_teardown(test_exact_time_general_ovflw, setup, teardown)
+		ztest_unit_test_setup_teardown(test_exact_time_general_ovflw, setup, teardown),
+		ztest_unit_test_setup_teardown(test_random_schedules, setup, teardown)
 		);
 
 	ztest_run_test_suite(scheduler_test);
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <bluetooth/mesh/sensor_srv.h>
+#include <bluetooth/mesh/sensor_types.h>
+#include <model_utils.h>
+#include <sensor.h> // private header from the source folder
+
+/* Simulates the periodic publication of a Sensor Server with sensors whose
+ * values change at random, and counts the published Sensor Status messages.
+ * Run with different values of CONFIG_BT_MESH_SENSOR_SRV_PUB_WINDOW to compare.
+ */
+
+#define PUB_DIV        2
+#define PUB_INTERVAL   (1 << PUB_DIV)
+#define BASE_PERIOD_MS 10000
+#define DELTA          5
+#define TICKS          1000
+
+/****************** mock section **********************************/
+
+int32_t bt_mesh_model_pub_period_get(struct bt_mesh_model *mod)
+{
+	if (!mod->pub->fast_period) {
+		return BASE_PERIOD_MS;
+	}
+
+	return BASE_PERIOD_MS >> mod->pub->period_div;
+}
+
+int bt_mesh_model_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+		       struct net_buf_simple *msg, const struct bt_mesh_send_cb *cb,
+		       void *cb_data)
+{
+	return 0;
+}
+
+int model_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+	       struct net_buf_simple *buf)
+{
+	return 0;
+}
+
+int bt_mesh_model_data_store(struct bt_mesh_model *mod, bool vnd, const char *name,
+			     const void *data, size_t data_len)
+{
+	return 0;
+}
+
+/****************** mock section **********************************/
+
+static int32_t values[CONFIG_BT_MESH_SENSOR_SRV_SENSORS_MAX];
+
+static int sensor_get(struct bt_mesh_sensor_srv *srv, struct bt_mesh_sensor *sensor,
+		      struct bt_mesh_msg_ctx *ctx, struct sensor_value *rsp);
+
+static struct bt_mesh_sensor sensors[] = {
+	{ .type = &bt_mesh_sensor_people_count, .get = sensor_get },
+	{ .type = &bt_mesh_sensor_present_amb_temp, .get = sensor_get },
+	{ .type = &bt_mesh_sensor_present_amb_rel_humidity, .get = sensor_get },
+	{ .type = &bt_mesh_sensor_present_amb_light_level, .get = sensor_get },
+};
+
+static struct bt_mesh_sensor *const sensor_ptrs[] = {
+	&sensors[0], &sensors[1], &sensors[2], &sensors[3],
+};
+
+static struct bt_mesh_sensor_srv srv =
+	BT_MESH_SENSOR_SRV_INIT(sensor_ptrs, ARRAY_SIZE(sensor_ptrs));
+
+static struct bt_mesh_model mock_model = {
+	.user_data = &srv,
+};
+
+static uint32_t rand_state = 1;
+
+static int sensor_get(struct bt_mesh_sensor_srv *srv, struct bt_mesh_sensor *sensor,
+		      struct bt_mesh_msg_ctx *ctx, struct sensor_value *rsp)
+{
+	rsp[0].val1 = values[sensor - sensors];
+	rsp[0].val2 = 0;
+
+	return 0;
+}
+
+/* Deterministic pseudo random sequence, so that all runs see the same values. */
+static uint32_t rand_get(void)
+{
+	rand_state = rand_state * 1103515245 + 12345;
+
+	return rand_state >> 16;
+}
+
+static void setup(void)
+{
+	BUILD_ASSERT(ARRAY_SIZE(sensors) <= CONFIG_BT_MESH_SENSOR_SRV_SENSORS_MAX);
+
+	mock_model.pub = &srv.pub;
+
+	zassert_ok(_bt_mesh_sensor_srv_cb.init(&mock_model), "Init failed");
+
+	for (int i = 0; i < ARRAY_SIZE(sensors); i++) {
+		struct bt_mesh_sensor *s = &sensors[i];
+
+		s->state.configured = true;
+		s->state.pub_div = PUB_DIV;
+		s->state.min_int = 0;
+		s->state.threshold.delta.type = BT_MESH_SENSOR_DELTA_VALUE;
+		s->state.threshold.delta.up.val1 = DELTA;
+		s->state.threshold.delta.down.val1 = DELTA;
+	}
+
+	srv.pub.period_div = PUB_DIV;
+}
+
+static void test_pub_messages(void)
+{
+	uint16_t last[ARRAY_SIZE(sensors)] = {};
+	uint32_t messages = 0;
+	uint32_t publications = 0;
+
+	setup();
+
+	for (int tick = 0; tick < TICKS; tick++) {
+		uint16_t seq = srv.seq;
+
+		/* Each sensor value jumps past its delta threshold once every
+		 * 16 publication periods on average, which triggers a
+		 * publication outside of the periodic ones.
+		 */
+		for (int i = 0; i < ARRAY_SIZE(sensors); i++) {
+			if (!(rand_get() % 16)) {
+				values[i] += (rand_get() % 2) ? 2 * DELTA : -2 * DELTA;
+			}
+		}
+
+		if (!srv.pub.update(&mock_model)) {
+			messages++;
+		}
+
+		for (int i = 0; i < ARRAY_SIZE(sensors); i++) {
+			if (sensors[i].state.seq != seq) {
+				continue;
+			}
+
+			/* Coalescing may only bring publications forward. */
+			zassert_true((uint16_t)(seq - last[i]) <= PUB_INTERVAL,
+				     "Sensor %d published late at %u", i, seq);
+
+			last[i] = seq;
+			publications++;
+		}
+	}
+
+	zassert_true(messages > 0, "Nothing published");
+	zassert_true(messages <= publications, "Empty messages published");
+
+	TC_PRINT("pub_window,messages,sensor_publications\n");
+	TC_PRINT("%u,%u,%u\n", CONFIG_BT_MESH_SENSOR_SRV_PUB_WINDOW, messages,
+		 publications);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(sensor_srv_pub_test,
+			 ztest_unit_test(test_pub_messages)
+			 );
+
+	ztest_run_test_suite(sensor_srv_pub_test);
+}
@@ -1594,6 +1594,31 @@ static void gain_check(const struct bt_mesh_sensor_type *sensor_type)
 	}
 }
 
+/* Sensor type lookup */
+
+static void test_type_lookup(void)
+{
+	const struct bt_mesh_sensor_type *prev = NULL;
+	size_t count = 0;
+
+	/* The lookup depends on the section being sorted by ID. */
+	STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		if (prev) {
+			zassert_true(prev->id < type->id, "Type 0x%04x out of order", type->id);
+		}
+
+		zassert_equal_ptr(bt_mesh_sensor_type_get(type->id), type,
+				  "Type 0x%04x not found", type->id);
+
+		prev = type;
+		count++;
+	}
+
+	zassert_true(count > 0, "No sensor types");
+	zassert_is_null(bt_mesh_sensor_type_get(BT_MESH_PROP_ID_PROHIBITED), "Unexpected type");
+	zassert_is_null(bt_mesh_sensor_type_get(0xffff), "Unexpected type");
+}
+
 /* Occupancy sensors */
 
 static void test_motion_sensor(void)
@@ -2440,6 +2465,9 @@ static void test_present_rel_output_ripple_voltage(void)
 void test_main(void)
 {
 	ztest_test_suite(sensor_types_test,
+			/* Sensor type lookup */
+			ztest_unit_test(test_type_lookup),
+
 			/* Occupancy sensors */
 			ztest_unit_test(test_motion_sensor),
 			ztest_unit_test(test_motion_threshold),
@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/net/buf.h>
+#include <zephyr/sys/ring_buffer.h>
+#include <bluetooth/services/nus.h>
+
+#define ATT_MTU 23
+#define PAYLOAD_LEN (ATT_MTU - 3)
+#define TX_COUNT CONFIG_BT_NUS_STREAM_TX_COUNT
+#define LOG_SIZE 16
+
+NET_BUF_POOL_DEFINE(test_pool, 4, 64, 0, NULL);
+RING_BUF_DECLARE(test_rb, 64);
+
+/* The connection object is opaque, and only its address is used. */
+static uint8_t conn_obj;
+static struct bt_conn *conn = (struct bt_conn *)&conn_obj;
+static int conn_refs;
+static bool subscribed;
+static int notify_err;
+
+static uint8_t pattern[128];
+
+static struct {
+	bt_gatt_complete_func_t func;
+	void *user_data;
+	uint8_t data[PAYLOAD_LEN];
+	uint16_t len;
+} notify_log[LOG_SIZE];
+static size_t notify_cnt;
+static size_t complete_cnt;
+
+int __wrap_bt_gatt_notify_cb(struct bt_conn *c,
+			     struct bt_gatt_notify_params *params)
+{
+	zassert_equal(c, conn, "Wrong connection");
+	zassert_true(params->len <= PAYLOAD_LEN, "Notification too long");
+	zassert_true(notify_cnt < LOG_SIZE, "Too many notifications");
+
+	if (notify_err) {
+		int err = notify_err;
+
+		notify_err = 0;
+		return err;
+	}
+
+	notify_log[notify_cnt].func = params->func;
+	notify_log[notify_cnt].user_data = params->user_data;
+	notify_log[notify_cnt].len = params->len;
+	memcpy(notify_log[notify_cnt].data, params->data, params->len);
+	notify_cnt++;
+
+	return 0;
+}
+
+bool __wrap_bt_gatt_is_subscribed(struct bt_conn *c,
+				  const struct bt_gatt_attr *attr,
+				  uint16_t ccc_value)
+{
+	return subscribed;
+}
+
+uint16_t __wrap_bt_gatt_get_mtu(struct bt_conn *c)
+{
+	return ATT_MTU;
+}
+
+uint8_t __wrap_bt_conn_index(const struct bt_conn *c)
+{
+	return 0;
+}
+
+struct bt_conn *__wrap_bt_conn_ref(struct bt_conn *c)
+{
+	conn_refs++;
+	return c;
+}
+
+void __wrap_bt_conn_unref(struct bt_conn *c)
+{
+	conn_refs--;
+}
+
+static void stream_run(void)
+{
+	/* Let the stream work run on the system workqueue. */
+	k_sleep(K_MSEC(5));
+}
+
+static void complete(size_t cnt)
+{
+	for (size_t i = 0; i < cnt; i++) {
+		zassert_true(complete_cnt < notify_cnt, "Nothing to complete");
+
+		notify_log[complete_cnt].func(conn,
+					      notify_log[complete_cnt].user_data);
+		complete_cnt++;
+	}
+
+	stream_run();
+}
+
+static void disconnect(void)
+{
+	STRUCT_SECTION_FOREACH(bt_conn_cb, cb) {
+		if (cb->disconnected) {
+			cb->disconnected(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+		}
+	}
+}
+
+/* Check that the notifications carry the given data, in order. */
+static void notify_check(const uint16_t *lens, size_t cnt, const uint8_t *data)
+{
+	zassert_equal(notify_cnt, cnt, "Wrong number of notifications");
+
+	for (size_t i = 0; i < cnt; i++) {
+		zassert_equal(notify_log[i].len, lens[i],
+			      "Wrong length of notification %u", i);
+		zassert_mem_equal(notify_log[i].data, data, lens[i],
+				  "Wrong data in notification %u", i);
+		data += lens[i];
+	}
+}
+
+static struct net_buf *chain_alloc(const uint16_t *lens, size_t cnt)
+{
+	struct net_buf *head = NULL;
+	size_t offset = 0;
+
+	for (size_t i = 0; i < cnt; i++) {
+		struct net_buf *frag = net_buf_alloc(&test_pool, K_NO_WAIT);
+
+		zassert_not_null(frag, "No buffer");
+		net_buf_add_mem(frag, &pattern[offset], lens[i]);
+		offset += lens[i];
+
+		if (head) {
+			net_buf_frag_add(head, frag);
+		} else {
+			head = frag;
+		}
+	}
+
+	return head;
+}
+
+static void test_setup(void)
+{
+	memset(notify_log, 0, sizeof(notify_log));
+	notify_cnt = 0;
+	complete_cnt = 0;
+	notify_err = 0;
+	subscribed = true;
+	ring_buf_reset(&test_rb);
+}
+
+static void test_teardown(void)
+{
+	disconnect();
+	stream_run();
+
+	zassert_equal(conn_refs, 0, "Connection reference leaked");
+}
+
+static void test_fragmentation(void)
+{
+	static const uint16_t frags[] = { 50 };
+	static const uint16_t lens[] = { PAYLOAD_LEN, PAYLOAD_LEN, 10 };
+	struct net_buf *buf = chain_alloc(frags, ARRAY_SIZE(frags));
+	struct bt_nus_stream_stats stats;
+	int err;
+
+	err = bt_nus_stream_send(conn, net_buf_ref(buf));
+	zassert_ok(err, "Sending failed (err %d)", err);
+	stream_run();
+
+	notify_check(lens, ARRAY_SIZE(lens), pattern);
+
+	complete(2);
+	zassert_equal(buf->ref, 2, "Buffer released too early");
+
+	complete(1);
+	zassert_equal(buf->ref, 1, "Buffer not released");
+	net_buf_unref(buf);
+
+	err = bt_nus_stream_stats_get(conn, &stats);
+	zassert_ok(err, "Getting statistics failed (err %d)", err);
+	zassert_equal(stats.tx_bytes, 50, "Wrong byte count");
+	zassert_equal(stats.tx_notifications, 3, "Wrong notification count");
+}
+
+static void test_chain(void)
+{
+	static const uint16_t frags[] = { 10, 0, 30 };
+	static const uint16_t lens[] = { 10, PAYLOAD_LEN, 10 };
+	struct net_buf *buf = chain_alloc(frags, ARRAY_SIZE(frags));
+	int err;
+
+	err = bt_nus_stream_send(conn, buf);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	stream_run();
+
+	/* A notification carries the data of a single fragment. */
+	notify_check(lens, ARRAY_SIZE(lens), pattern);
+}
+
+static void test_in_flight(void)
+{
+	static const uint16_t frags[] = { 60, 40 };
+	static const uint16_t lens[] = { PAYLOAD_LEN, PAYLOAD_LEN, PAYLOAD_LEN,
+					 PAYLOAD_LEN, PAYLOAD_LEN };
+	struct net_buf *buf = chain_alloc(frags, ARRAY_SIZE(frags));
+	int err;
+
+	err = bt_nus_stream_send(conn, buf);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	stream_run();
+
+	zassert_equal(notify_cnt, TX_COUNT, "Wrong number in flight");
+
+	/* Every completion makes room for the next notification. */
+	complete(1);
+	zassert_equal(notify_cnt, TX_COUNT + 1, "Stream not refilled");
+
+	complete(1);
+	notify_check(lens, ARRAY_SIZE(lens), pattern);
+}
+
+static void test_ring(void)
+{
+	static const uint16_t lens[] = { PAYLOAD_LEN, PAYLOAD_LEN, 10 };
+	int err;
+
+	ring_buf_put(&test_rb, pattern, 50);
+
+	err = bt_nus_stream_ring_send(conn, &test_rb);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	stream_run();
+
+	notify_check(lens, ARRAY_SIZE(lens), pattern);
+
+	/* The ring buffer data is freed as the notifications complete. */
+	complete(1);
+	zassert_equal(ring_buf_size_get(&test_rb), 50 - PAYLOAD_LEN,
+		      "Data not freed");
+
+	complete(2);
+	zassert_true(ring_buf_is_empty(&test_rb), "Data not freed");
+}
+
+static void test_ring_wrap(void)
+{
+	uint8_t data[40] = {0};
+	int err;
+
+	/* Move the ring buffer data to the end of the buffer. */
+	ring_buf_put(&test_rb, data, sizeof(data));
+	ring_buf_get(&test_rb, data, sizeof(data));
+
+	ring_buf_put(&test_rb, pattern, 40);
+
+	err = bt_nus_stream_ring_send(conn, &test_rb);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	stream_run();
+
+	/* The stream does not send past the wrap with data in flight. */
+	zassert_equal(notify_cnt, 2, "Sent past the wrap");
+	zassert_equal(notify_log[1].len, 4, "Wrong length at the wrap");
+
+	complete(2);
+	complete(1);
+
+	zassert_true(ring_buf_is_empty(&test_rb), "Data not sent");
+
+	for (size_t i = 0, offset = 0; i < notify_cnt; i++) {
+		zassert_mem_equal(notify_log[i].data, &pattern[offset],
+				  notify_log[i].len, "Wrong data");
+		offset += notify_log[i].len;
+	}
+}
+
+static void test_stall(void)
+{
+	static const uint16_t frags[] = { 10 };
+	struct net_buf *buf = chain_alloc(frags, ARRAY_SIZE(frags));
+	struct bt_nus_stream_stats stats;
+	int err;
+
+	notify_err = -ENOMEM;
+
+	err = bt_nus_stream_send(conn, buf);
+	zassert_ok(err, "Sending failed (err %d)", err);
+	stream_run();
+
+	/* Retried without notifications in flight. */
+	notify_check(frags, ARRAY_SIZE(frags), pattern);
+
+	err = bt_nus_stream_stats_get(conn, &stats);
+	zassert_ok(err, "Getting statistics failed (err %d)", err);
+	zassert_equal(stats.tx_stalls, 1, "Wrong stall count");
+}
+
+static void test_unsubscribed(void)
+{
+	static const uint16_t frags[] = { 60, 40 };
+	struct net_buf *buf = chain_alloc(frags, ARRAY_SIZE(frags));
+	struct bt_nus_stream_stats stats;
+	int err;
+
+	subscribed = false;
+
+	err = bt_nus_stream_send(conn, buf);
+	zassert_equal(err, -EINVAL, "Sending without subscription");
+
+	subscribed = true;
+
+	err = bt_nus_stream_send(conn, net_buf_ref(buf));
+	zassert_ok(err, "Sending failed (err %d)", err);
+	stream_run();
+
+	subscribed = false;
+
+	/* The data not yet sent is dropped once nothing is in flight. */
+	complete(notify_cnt);
+	zassert_equal(notify_cnt, TX_COUNT, "Data sent without subscription");
+	zassert_equal(buf->ref, 1, "Buffer not released");
+	net_buf_unref(buf);
+
+	err = bt_nus_stream_stats_get(conn, &stats);
+	zassert_ok(err, "Getting statistics failed (err %d)", err);
+	zassert_equal(stats.dropped_bytes, 100 - TX_COUNT * PAYLOAD_LEN,
+		      "Wrong dropped count");
+}
+
+static void test_disconnect(void)
+{
+	static const uint16_t frags[] = { 60 };
+	struct net_buf *buf = chain_alloc(frags, ARRAY_SIZE(frags));
+	struct bt_nus_stream_stats stats;
+	int err;
+
+	err = bt_nus_stream_send(conn, net_buf_ref(buf));
+	zassert_ok(err, "Sending failed (err %d)", err);
+	stream_run();
+
+	disconnect();
+	zassert_equal(buf->ref, 1, "Buffer not released");
+	net_buf_unref(buf);
+
+	err = bt_nus_stream_stats_get(conn, &stats);
+	zassert_equal(err, -ENOENT, "Stream not stopped");
+
+	/* Late completions are ignored. */
+	complete(notify_cnt);
+}
+
+void test_main(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(pattern); i++) {
+		pattern[i] = i;
+	}
+
+	bt_nus_init(NULL);
+
+	ztest_test_suite(test_bt_nus_stream,
+			 ztest_unit_test_setup_teardown(test_fragmentation,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_chain,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_in_flight,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_ring,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_ring_wrap,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_stall,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_unsubscribed,
+							test_setup,
+							test_teardown),
+			 ztest_unit_test_setup_teardown(test_disconnect,
+							test_setup,
+							test_teardown)
+	);
+	ztest_run_test_suite(test_bt_nus_stream);
+}
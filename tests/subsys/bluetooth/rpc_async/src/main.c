@@ -0,0 +1,541 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/gatt.h>
+
+#include <zcbor_encode.h>
+#include <zcbor_decode.h>
+
+#include <bt_rpc_async_host.c>
+
+#include "bt_rpc.h"
+#include "bt_rpc_async_client.h"
+#include "bt_rpc_fast.h"
+#include "bt_rpc_gatt_common.h"
+
+#define TX_BUF_CNT  4
+#define TX_BUF_SIZE 256
+#define SENT_MAX    8
+#define CALLS_MAX   8
+#define DATA_MAX    64
+
+/* Upper bound of the number of CBOR items in a batch. */
+#define DECODE_ELEM_COUNT 64
+
+static struct bt_gatt_attr attrs[] = {
+	BT_GATT_PRIMARY_SERVICE(BT_UUID_DECLARE_16(0x1234)),
+	BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_16(0x1235), BT_GATT_CHRC_NOTIFY,
+			       BT_GATT_PERM_NONE, NULL, NULL, NULL),
+	BT_GATT_CCC(NULL, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+};
+
+static struct bt_gatt_service svc = BT_GATT_SERVICE(attrs);
+
+static const struct bt_gatt_attr *notify_attr = &attrs[2];
+static uint8_t pattern[DATA_MAX];
+
+static uint8_t tx_buf[TX_BUF_CNT][TX_BUF_SIZE];
+static size_t tx_buf_next;
+
+/* Packets sent by the client, in order. */
+static struct {
+	bool evt;
+	uint8_t id;
+	uint8_t data[TX_BUF_SIZE];
+	size_t len;
+} sent[SENT_MAX];
+static size_t sent_cnt;
+
+enum call_type {
+	CALL_NOTIFY,
+	CALL_ADV_UPDATE,
+};
+
+/* Calls executed by the host, in order. */
+static struct {
+	enum call_type type;
+	const struct bt_gatt_attr *attr;
+	uint8_t data[DATA_MAX];
+	uint16_t len;
+	uintptr_t user_data;
+	bool func;
+	size_t ad_len;
+	size_t sd_len;
+	uint8_t ad_type;
+} calls[CALLS_MAX];
+static size_t calls_cnt;
+
+static size_t decoding_errors;
+
+static void notify_complete(struct bt_conn *conn, void *user_data)
+{
+}
+
+/****************** mock section **********************************/
+
+/* Same as in bt_rpc_gap_client.c. */
+size_t bt_data_buf_size(const struct bt_data *data)
+{
+	return 9 + data->data_len;
+}
+
+size_t bt_data_sp_size(const struct bt_data *data)
+{
+	return SCRATCHPAD_ALIGN(data->data_len);
+}
+
+void bt_data_enc(struct nrf_rpc_cbor_ctx *encoder, const struct bt_data *data)
+{
+	ser_encode_uint(encoder, data->type);
+	ser_encode_uint(encoder, data->data_len);
+	ser_encode_buffer(encoder, data->data, data->data_len);
+}
+
+/* Same as in bt_rpc_gatt_client.c. The tests do not use a UUID. */
+size_t bt_gatt_notify_params_buf_size(const struct bt_gatt_notify_params *data)
+{
+	return 23 + 2 * data->len;
+}
+
+size_t bt_gatt_notify_params_sp_size(const struct bt_gatt_notify_params *data)
+{
+	return SCRATCHPAD_ALIGN(data->len) + data->len;
+}
+
+void bt_gatt_notify_params_enc(struct nrf_rpc_cbor_ctx *encoder,
+			       const struct bt_gatt_notify_params *data)
+{
+	zassert_is_null(data->uuid, "UUID not supported by the test");
+
+	bt_rpc_encode_gatt_attr(encoder, data->attr);
+	ser_encode_uint(encoder, data->len);
+	ser_encode_buffer(encoder, data->data, data->len);
+	ser_encode_callback(encoder, data->func);
+	ser_encode_uint(encoder, (uintptr_t)data->user_data);
+	ser_encode_null(encoder);
+}
+
+int bt_rpc_gatt_notify_fast_get(const struct bt_gatt_notify_params *data,
+				struct bt_rpc_fast_notify *notify)
+{
+	uint32_t attr_index;
+	int slot;
+	int err;
+
+	err = bt_rpc_gatt_attr_to_index(data->attr, &attr_index);
+	if (err || (attr_index > UINT16_MAX) || (data->len > UINT16_MAX)) {
+		return -EINVAL;
+	}
+
+	notify->attr_index = attr_index;
+	notify->func_slot = BT_RPC_FAST_NO_CALLBACK;
+	notify->user_data = (uintptr_t)data->user_data;
+	notify->data = data->data;
+	notify->len = data->len;
+
+	if (data->func) {
+		slot = cbkproxy_in_set(data->func);
+		if (slot < 0) {
+			return -ENOMEM;
+		}
+
+		notify->func_slot = slot;
+	}
+
+	return 0;
+}
+
+void __wrap_nrf_rpc_alloc_tx_buf(const struct nrf_rpc_group *group, uint8_t **buf,
+				 size_t len)
+{
+	zassert_true(len <= TX_BUF_SIZE, "Packet too long");
+
+	*buf = tx_buf[tx_buf_next];
+	tx_buf_next = (tx_buf_next + 1) % TX_BUF_CNT;
+}
+
+static void packet_capture(bool evt, uint8_t id, struct nrf_rpc_cbor_ctx *ctx)
+{
+	const uint8_t *end = ctx->zs->payload;
+
+	zassert_true(sent_cnt < SENT_MAX, "Too many packets");
+
+	for (size_t i = 0; i < TX_BUF_CNT; i++) {
+		if ((end >= tx_buf[i]) && (end <= &tx_buf[i][TX_BUF_SIZE])) {
+			sent[sent_cnt].evt = evt;
+			sent[sent_cnt].id = id;
+			sent[sent_cnt].len = end - tx_buf[i];
+			memcpy(sent[sent_cnt].data, tx_buf[i], sent[sent_cnt].len);
+			sent_cnt++;
+			return;
+		}
+	}
+
+	zassert_unreachable("Packet not allocated");
+}
+
+void __wrap_nrf_rpc_cbor_evt_no_err(const struct nrf_rpc_group *group, uint8_t evt,
+				    struct nrf_rpc_cbor_ctx *ctx)
+{
+	zassert_equal_ptr(group, &bt_rpc_grp, "Wrong group");
+
+	packet_capture(true, evt, ctx);
+}
+
+void __wrap_nrf_rpc_cbor_cmd_no_err(const struct nrf_rpc_group *group, uint8_t cmd,
+				    struct nrf_rpc_cbor_ctx *ctx,
+				    nrf_rpc_cbor_handler_t handler, void *handler_data)
+{
+	zassert_equal_ptr(group, &bt_rpc_grp, "Wrong group");
+
+	packet_capture(false, cmd, ctx);
+}
+
+void __wrap_nrf_rpc_cbor_decoding_done(const struct nrf_rpc_group *group,
+				       struct nrf_rpc_cbor_ctx *ctx)
+{
+}
+
+void __wrap_nrf_rpc_err(int code, enum nrf_rpc_err_src src, const struct nrf_rpc_group *group,
+			uint8_t id, uint8_t packet_type)
+{
+	zassert_equal(code, -EBADMSG, "Wrong error");
+	zassert_equal(id, BT_RPC_ASYNC_BATCH_RPC_EVT, "Wrong event");
+
+	decoding_errors++;
+}
+
+struct bt_conn *__wrap_bt_conn_lookup_index(uint8_t index)
+{
+	return NULL;
+}
+
+int __wrap_bt_gatt_notify_cb(struct bt_conn *conn, struct bt_gatt_notify_params *params)
+{
+	zassert_true(calls_cnt < CALLS_MAX, "Too many calls");
+	zassert_true(params->len <= DATA_MAX, "Notification too long");
+
+	calls[calls_cnt].type = CALL_NOTIFY;
+	calls[calls_cnt].attr = params->attr;
+	calls[calls_cnt].len = params->len;
+	calls[calls_cnt].user_data = (uintptr_t)params->user_data;
+	calls[calls_cnt].func = (params->func != NULL);
+	memcpy(calls[calls_cnt].data, params->data, params->len);
+	calls_cnt++;
+
+	return 0;
+}
+
+int __wrap_bt_le_adv_update_data(const struct bt_data *ad, size_t ad_len,
+				 const struct bt_data *sd, size_t sd_len)
+{
+	zassert_true(calls_cnt < CALLS_MAX, "Too many calls");
+	zassert_true(ad_len > 0, "No advertising data");
+	zassert_true(ad[0].data_len <= DATA_MAX, "Advertising data too long");
+
+	calls[calls_cnt].type = CALL_ADV_UPDATE;
+	calls[calls_cnt].ad_len = ad_len;
+	calls[calls_cnt].sd_len = sd_len;
+	calls[calls_cnt].ad_type = ad[0].type;
+	calls[calls_cnt].len = ad[0].data_len;
+	memcpy(calls[calls_cnt].data, ad[0].data, ad[0].data_len);
+	calls_cnt++;
+
+	return 0;
+}
+/****************** mock section **********************************/
+
+static void notify(uint16_t len, uintptr_t user_data)
+{
+	struct bt_gatt_notify_params params = {
+		.attr = notify_attr,
+		.data = pattern,
+		.len = len,
+		.func = notify_complete,
+		.user_data = (void *)user_data,
+	};
+	int err;
+
+	err = bt_rpc_gatt_notify_cb_async(NULL, &params);
+	zassert_ok(err, "Asynchronous notification failed (err %d)", err);
+}
+
+static void adv_update(uint8_t len)
+{
+	const struct bt_data ad[] = {
+		BT_DATA(BT_DATA_MANUFACTURER_DATA, pattern, len),
+	};
+	int err;
+
+	err = bt_rpc_le_adv_update_data_async(ad, ARRAY_SIZE(ad), NULL, 0);
+	zassert_ok(err, "Asynchronous advertising data update failed (err %d)", err);
+}
+
+static void sync_call(void)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+
+	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, 0);
+
+	bt_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_IS_READY_RPC_CMD, &ctx, ser_rsp_decode_void,
+			       NULL);
+}
+
+/* Decode the batch on the host and execute its calls. */
+static void deliver(size_t i)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+
+	zassert_true(sent[i].evt, "Not an event");
+	zassert_equal(sent[i].id, BT_RPC_ASYNC_BATCH_RPC_EVT, "Wrong event");
+	zassert_true(sent[i].len <= CONFIG_BT_RPC_ASYNC_BATCH_SIZE, "Batch too long");
+
+	zcbor_new_decode_state(ctx.zs, ARRAY_SIZE(ctx.zs), sent[i].data, sent[i].len,
+			       DECODE_ELEM_COUNT);
+
+	bt_rpc_async_batch_rpc_handler(&bt_rpc_grp, &ctx, NULL);
+}
+
+static void notify_check(size_t i, uint16_t len, uintptr_t user_data)
+{
+	zassert_equal(calls[i].type, CALL_NOTIFY, "Call %zu is not a notification", i);
+	zassert_equal_ptr(calls[i].attr, notify_attr, "Wrong attribute in call %zu", i);
+	zassert_equal(calls[i].len, len, "Wrong length in call %zu", i);
+	zassert_mem_equal(calls[i].data, pattern, len, "Wrong data in call %zu", i);
+	zassert_equal(calls[i].user_data, user_data, "Wrong user data in call %zu", i);
+	zassert_true(calls[i].func, "No callback in call %zu", i);
+}
+
+static void adv_update_check(size_t i, uint8_t len)
+{
+	zassert_equal(calls[i].type, CALL_ADV_UPDATE, "Call %zu is not an update", i);
+	zassert_equal(calls[i].ad_len, 1, "Wrong advertising data count in call %zu", i);
+	zassert_equal(calls[i].sd_len, 0, "Wrong scan response count in call %zu", i);
+	zassert_equal(calls[i].ad_type, BT_DATA_MANUFACTURER_DATA, "Wrong type in call %zu", i);
+	zassert_equal(calls[i].len, len, "Wrong length in call %zu", i);
+	zassert_mem_equal(calls[i].data, pattern, len, "Wrong data in call %zu", i);
+}
+
+static void test_setup(void)
+{
+	memset(sent, 0, sizeof(sent));
+	memset(calls, 0, sizeof(calls));
+	sent_cnt = 0;
+	calls_cnt = 0;
+	decoding_errors = 0;
+}
+
+static void test_single_call(void)
+{
+	/* A call made outside of a batch is sent at once. */
+	notify(20, 1);
+	zassert_equal(sent_cnt, 1, "Call not sent");
+
+	deliver(0);
+
+	zassert_equal(calls_cnt, 1, "Wrong number of calls");
+	notify_check(0, 20, 1);
+	zassert_equal(decoding_errors, 0, "Decoding failed");
+}
+
+static void test_batch(void)
+{
+	bt_rpc_batch_begin();
+
+	notify(0, 1);
+	adv_update(10);
+	notify(DATA_MAX, 2);
+
+	zassert_equal(sent_cnt, 0, "Sent before the batch has ended");
+	zassert_ok(bt_rpc_batch_end(), "Ending the batch failed");
+	zassert_equal(sent_cnt, 1, "Batch not sent in one event");
+
+	deliver(0);
+
+	zassert_equal(calls_cnt, 3, "Wrong number of calls");
+	notify_check(0, 0, 1);
+	adv_update_check(1, 10);
+	notify_check(2, DATA_MAX, 2);
+	zassert_equal(decoding_errors, 0, "Decoding failed");
+}
+
+static void test_batch_nested(void)
+{
+	bt_rpc_batch_begin();
+	bt_rpc_batch_begin();
+
+	notify(20, 1);
+
+	zassert_ok(bt_rpc_batch_end(), "Ending the inner batch failed");
+	zassert_equal(sent_cnt, 0, "Sent by the inner batch");
+
+	notify(20, 2);
+
+	zassert_ok(bt_rpc_batch_end(), "Ending the outer batch failed");
+	zassert_equal(sent_cnt, 1, "Batch not sent in one event");
+	zassert_equal(bt_rpc_batch_end(), -EALREADY, "Ended without a batch");
+
+	deliver(0);
+
+	zassert_equal(calls_cnt, 2, "Wrong number of calls");
+	notify_check(0, 20, 1);
+	notify_check(1, 20, 2);
+}
+
+static void test_batch_full(void)
+{
+	const size_t cnt = 5;
+
+	bt_rpc_batch_begin();
+
+	for (size_t i = 0; i < cnt; i++) {
+		notify(40, i);
+	}
+
+	zassert_ok(bt_rpc_batch_end(), "Ending the batch failed");
+
+	/* Calls which do not fit in the batch are sent in the next one. */
+	zassert_true(sent_cnt > 1, "Batch size not respected");
+	zassert_true(sent_cnt < cnt, "Calls not batched");
+
+	for (size_t i = 0; i < sent_cnt; i++) {
+		deliver(i);
+	}
+
+	zassert_equal(calls_cnt, cnt, "Wrong number of calls");
+
+	for (size_t i = 0; i < cnt; i++) {
+		notify_check(i, 40, i);
+	}
+}
+
+static void test_sync_call_flush(void)
+{
+	bt_rpc_batch_begin();
+
+	notify(20, 1);
+
+	/* The calls batched so far are sent before the synchronous call. */
+	sync_call();
+
+	zassert_equal(sent_cnt, 2, "Batch not sent before the synchronous call");
+	zassert_true(sent[0].evt, "Synchronous call sent before the batch");
+	zassert_false(sent[1].evt, "Synchronous call not sent");
+	zassert_equal(sent[1].id, BT_IS_READY_RPC_CMD, "Wrong command");
+
+	/* The batch stays open. */
+	notify(20, 2);
+	zassert_equal(sent_cnt, 2, "Sent before the batch has ended");
+
+	zassert_ok(bt_rpc_batch_end(), "Ending the batch failed");
+	zassert_equal(sent_cnt, 3, "Batch not sent");
+
+	deliver(0);
+	deliver(2);
+
+	zassert_equal(calls_cnt, 2, "Wrong number of calls");
+	notify_check(0, 20, 1);
+	notify_check(1, 20, 2);
+}
+
+static K_THREAD_STACK_DEFINE(other_stack, 1024);
+static struct k_thread other_thread;
+
+static void other_thread_fn(void *p1, void *p2, void *p3)
+{
+	sync_call();
+}
+
+static void test_sync_call_other_thread(void)
+{
+	bt_rpc_batch_begin();
+
+	notify(20, 1);
+
+	/* The batch of another thread is not sent. */
+	k_thread_create(&other_thread, other_stack, K_THREAD_STACK_SIZEOF(other_stack),
+			other_thread_fn, NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_thread_join(&other_thread, K_FOREVER);
+
+	zassert_equal(sent_cnt, 1, "Synchronous call not sent");
+	zassert_false(sent[0].evt, "Batch of another thread sent");
+
+	zassert_ok(bt_rpc_batch_end(), "Ending the batch failed");
+	zassert_equal(sent_cnt, 2, "Batch not sent");
+
+	deliver(1);
+
+	zassert_equal(calls_cnt, 1, "Wrong number of calls");
+	notify_check(0, 20, 1);
+}
+
+static void test_unknown_call(void)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+
+	bt_rpc_batch_begin();
+	adv_update(10);
+	notify(20, 1);
+	zassert_ok(bt_rpc_batch_end(), "Ending the batch failed");
+	zassert_equal(sent_cnt, 1, "Batch not sent");
+
+	/* Replace the null ending the batch with a call unknown to the host. */
+	zcbor_new_encode_state(ctx.zs, ARRAY_SIZE(ctx.zs), &sent[0].data[sent[0].len - 1],
+			       TX_BUF_SIZE - sent[0].len + 1, 0);
+	ser_encode_uint(&ctx, BT_ENABLE_RPC_CMD);
+	ser_encode_null(&ctx);
+	zassert_true(ser_decode_valid(&ctx), "Encoding failed");
+	sent[0].len = ctx.zs->payload - sent[0].data;
+
+	deliver(0);
+
+	/* The calls preceding the unknown one are executed. */
+	zassert_equal(calls_cnt, 2, "Wrong number of calls");
+	adv_update_check(0, 10);
+	notify_check(1, 20, 1);
+	zassert_equal(decoding_errors, 1, "Decoding error not reported");
+}
+
+void test_main(void)
+{
+	uint32_t svc_index;
+	int err;
+
+	for (size_t i = 0; i < sizeof(pattern); i++) {
+		pattern[i] = i;
+	}
+
+	err = bt_rpc_gatt_add_service(&svc, &svc_index);
+	zassert_ok(err, "Adding the service failed (err %d)", err);
+
+	ztest_test_suite(test_bt_rpc_async,
+			 ztest_unit_test_setup_teardown(test_single_call,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_batch,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_batch_nested,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_batch_full,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_sync_call_flush,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_sync_call_other_thread,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_unknown_call,
+							test_setup,
+							unit_test_noop)
+	);
+	ztest_run_test_suite(test_bt_rpc_async);
+}
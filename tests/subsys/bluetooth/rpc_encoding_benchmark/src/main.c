@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/gatt.h>
+
+#include <zcbor_encode.h>
+#include <zcbor_decode.h>
+
+#include "bt_rpc_fast.h"
+#include "cbkproxy.h"
+#include "serialize.h"
+
+#define ROUNDS 1000
+
+#define ATTR_INDEX 7
+#define USER_DATA  0x20001234
+
+/* Upper bound of the number of CBOR items in a notification command. */
+#define DECODE_ELEM_COUNT 16
+
+/* Host decoders, see bt_rpc_gatt_host.c. */
+void bt_gatt_notify_params_dec(struct ser_scratchpad *scratchpad,
+			       struct bt_gatt_notify_params *data);
+void bt_gatt_notify_fast_dec(struct nrf_rpc_cbor_ctx *ctx, struct bt_gatt_notify_params *data);
+
+static uint8_t packet[BT_RPC_FAST_NOTIFY_BUF_SIZE(CONFIG_BT_L2CAP_TX_MTU) + 16];
+static uint8_t pattern[CONFIG_BT_L2CAP_TX_MTU];
+
+static void notify_complete(struct bt_conn *conn, void *user_data)
+{
+}
+
+static void encode_init(struct nrf_rpc_cbor_ctx *ctx)
+{
+	zcbor_new_encode_state(ctx->zs, ARRAY_SIZE(ctx->zs), packet, sizeof(packet), 0);
+}
+
+static void decode_init(struct nrf_rpc_cbor_ctx *ctx, size_t len)
+{
+	zcbor_new_decode_state(ctx->zs, ARRAY_SIZE(ctx->zs), packet, len, DECODE_ELEM_COUNT);
+}
+
+static size_t encoded_len(struct nrf_rpc_cbor_ctx *ctx)
+{
+	return ctx->zs->payload - packet;
+}
+
+/* Same fields as bt_gatt_notify_cb() in bt_rpc_gatt_client.c. */
+static size_t cbor_encode(const struct bt_gatt_notify_params *params)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+
+	encode_init(&ctx);
+
+	ser_encode_uint(&ctx, SCRATCHPAD_ALIGN(params->len) + params->len);
+	ser_encode_uint(&ctx, ATTR_INDEX);
+	ser_encode_uint(&ctx, params->len);
+	ser_encode_buffer(&ctx, params->data, params->len);
+	ser_encode_callback(&ctx, params->func);
+	ser_encode_uint(&ctx, (uintptr_t)params->user_data);
+	ser_encode_null(&ctx);
+
+	zassert_true(ser_decode_valid(&ctx), "CBOR encoding failed");
+
+	return encoded_len(&ctx);
+}
+
+static void params_check(const struct bt_gatt_notify_params *params, uint16_t len)
+{
+	zassert_equal(params->len, len, "Wrong length");
+	zassert_mem_equal(params->data, pattern, len, "Wrong data");
+	zassert_equal((uintptr_t)params->user_data, USER_DATA, "Wrong user data");
+	zassert_not_null(params->func, "No callback");
+}
+
+/* Same steps as bt_gatt_notify_cb_rpc_handler() in bt_rpc_gatt_host.c. The
+ * data is copied into the scratchpad.
+ */
+static void cbor_decode(size_t len, const struct bt_gatt_notify_params *expected)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	struct bt_gatt_notify_params params;
+	struct ser_scratchpad scratchpad;
+
+	decode_init(&ctx, len);
+
+	SER_SCRATCHPAD_DECLARE(&scratchpad, &ctx);
+
+	bt_gatt_notify_params_dec(&scratchpad, &params);
+
+	zassert_true(ser_decode_valid(&ctx), "CBOR decoding failed");
+
+	if (expected) {
+		params_check(&params, expected->len);
+	}
+}
+
+/* Same fields as bt_gatt_notify_cb_fast() in bt_rpc_gatt_client.c. */
+static size_t fast_encode(const struct bt_gatt_notify_params *params)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	struct bt_rpc_fast_notify notify = {
+		.attr_index = ATTR_INDEX,
+		.func_slot = cbkproxy_in_set(params->func),
+		.user_data = (uintptr_t)params->user_data,
+		.data = params->data,
+		.len = params->len,
+	};
+
+	encode_init(&ctx);
+
+	bt_rpc_fast_notify_enc(&ctx, &notify);
+
+	zassert_true(ser_decode_valid(&ctx), "Fixed-layout encoding failed");
+
+	return encoded_len(&ctx);
+}
+
+/* Same steps as bt_gatt_notify_cb_fast_rpc_handler() in bt_rpc_gatt_host.c. The
+ * data is copied out of the received packet.
+ */
+static void fast_decode(size_t len, const struct bt_gatt_notify_params *expected)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	struct bt_gatt_notify_params params;
+
+	decode_init(&ctx, len);
+
+	bt_gatt_notify_fast_dec(&ctx, &params);
+
+	zassert_true(ser_decode_valid(&ctx), "Fixed-layout decoding failed");
+
+	uint8_t data[MAX(params.len, 1)];
+
+	memcpy(data, params.data, params.len);
+	params.data = data;
+
+	if (expected) {
+		params_check(&params, expected->len);
+	}
+}
+
+static void test_roundtrip(void)
+{
+	struct bt_gatt_notify_params tx = {
+		.data = pattern,
+		.len = sizeof(pattern),
+		.func = notify_complete,
+		.user_data = (void *)USER_DATA,
+	};
+
+	cbor_decode(cbor_encode(&tx), &tx);
+	fast_decode(fast_encode(&tx), &tx);
+}
+
+static uint32_t cycles_per_call(bool fast, uint16_t data_len)
+{
+	struct bt_gatt_notify_params tx = {
+		.data = pattern,
+		.len = data_len,
+		.func = notify_complete,
+		.user_data = (void *)USER_DATA,
+	};
+	uint32_t start;
+
+	start = k_cycle_get_32();
+
+	for (size_t i = 0; i < ROUNDS; i++) {
+		if (fast) {
+			fast_decode(fast_encode(&tx), NULL);
+		} else {
+			cbor_decode(cbor_encode(&tx), NULL);
+		}
+	}
+
+	return (k_cycle_get_32() - start) / ROUNDS;
+}
+
+static void test_benchmark(void)
+{
+	static const uint16_t data_len[] = { 0, 20, 244 };
+
+	TC_PRINT("data_len,cbor_cycles,fast_cycles\n");
+
+	for (size_t i = 0; i < ARRAY_SIZE(data_len); i++) {
+		uint16_t len = MIN(data_len[i], sizeof(pattern));
+		uint32_t cbor = cycles_per_call(false, len);
+		uint32_t fast = cycles_per_call(true, len);
+
+		TC_PRINT("%u,%u,%u\n", len, cbor, fast);
+	}
+}
+
+void test_main(void)
+{
+	for (size_t i = 0; i < sizeof(pattern); i++) {
+		pattern[i] = i;
+	}
+
+	ztest_test_suite(test_bt_rpc_encoding_benchmark,
+			 ztest_unit_test(test_roundtrip),
+			 ztest_unit_test(test_benchmark)
+	);
+	ztest_run_test_suite(test_bt_rpc_encoding_benchmark);
+}
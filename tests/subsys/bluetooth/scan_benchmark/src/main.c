@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <bluetooth/scan.h>
+
+#define REPLAY_ROUNDS 1000
+
+#define ADDR(_type, b5, b4, b3, b2, b1, b0) \
+	{ .type = (_type), .a = { .val = { b0, b1, b2, b3, b4, b5 } } }
+
+#define REPORT(_addr, _match, ...)				\
+	{							\
+		.addr = _addr,					\
+		.match = (_match),				\
+		.len = sizeof((uint8_t[]){ __VA_ARGS__ }),	\
+		.data = { __VA_ARGS__ },			\
+	}
+
+#define FLAGS 0x02, BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)
+
+struct captured_report {
+	bt_addr_le_t addr;
+	bool match;
+	uint8_t len;
+	uint8_t data[BT_GAP_ADV_MAX_ADV_DATA_LEN];
+};
+
+/* Advertising reports captured in an office environment, extended with
+ * the devices the filters below are looking for.
+ */
+static const struct captured_report reports[] = {
+	/* Heart rate sensor, matches the UUID filter. */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0xE8, 0x5C, 0x21, 0x4F, 0x03, 0xB1), true,
+	       FLAGS,
+	       0x03, BT_DATA_UUID16_ALL, 0x0D, 0x18,
+	       0x11, BT_DATA_NAME_COMPLETE,
+	       'P', 'o', 'l', 'a', 'r', ' ', 'H', '1', '0', ' ',
+	       'A', '1', 'B', '2', 'C', '3'),
+	/* iBeacon, matches the manufacturer data filter. */
+	REPORT(ADDR(BT_ADDR_LE_PUBLIC, 0x6C, 0x96, 0xCF, 0x12, 0x77, 0x40), true,
+	       FLAGS,
+	       0x1A, BT_DATA_MANUFACTURER_DATA, 0x4C, 0x00, 0x02, 0x15,
+	       0xE2, 0xC5, 0x6D, 0xB5, 0xDF, 0xFB, 0x48, 0xD2,
+	       0xB0, 0x60, 0xD0, 0xF5, 0xA7, 0x10, 0x96, 0xE0,
+	       0x00, 0x01, 0x00, 0x02, 0xC5),
+	/* Eddystone-URL beacon. */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0xF1, 0x0A, 0x4D, 0x38, 0x90, 0x2E), false,
+	       FLAGS,
+	       0x03, BT_DATA_UUID16_ALL, 0xAA, 0xFE,
+	       0x11, BT_DATA_SVC_DATA16, 0xAA, 0xFE, 0x10, 0xEB, 0x03,
+	       'n', 'o', 'r', 'd', 'i', 'c', 's', 'e', 'm', 'i', 0x07),
+	/* Exposure Notification. */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0x2B, 0x81, 0xE6, 0x5A, 0x19, 0xC4), false,
+	       0x02, BT_DATA_FLAGS, 0x1A,
+	       0x03, BT_DATA_UUID16_ALL, 0x6F, 0xFD,
+	       0x17, BT_DATA_SVC_DATA16, 0x6F, 0xFD,
+	       0x8C, 0x1D, 0x57, 0xF3, 0x20, 0x6A, 0xB9, 0x44,
+	       0x01, 0xE2, 0x7B, 0x5D, 0x93, 0x0F, 0xC6, 0x28,
+	       0x40, 0x8E, 0x17, 0xA2),
+	/* Nordic UART Service peripheral, matches the UUID filter. */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0xC7, 0x3E, 0x55, 0x0B, 0xD2, 0x61), true,
+	       FLAGS,
+	       0x11, BT_DATA_UUID128_ALL,
+	       0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0,
+	       0x93, 0xF3, 0xA3, 0xB5, 0x01, 0x00, 0x40, 0x6E),
+	/* HID keyboard, matches the appearance filter. */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0xD9, 0x14, 0x7A, 0xE0, 0x36, 0x8B), true,
+	       FLAGS,
+	       0x03, BT_DATA_GAP_APPEARANCE, 0xC1, 0x03,
+	       0x03, BT_DATA_UUID16_ALL, 0x12, 0x18,
+	       0x09, BT_DATA_NAME_COMPLETE,
+	       'K', 'e', 'y', 'b', 'o', 'a', 'r', 'd'),
+	/* Matches the name filter. */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0xEE, 0x42, 0x0C, 0x9D, 0x71, 0x15), true,
+	       FLAGS,
+	       0x07, BT_DATA_NAME_COMPLETE, 'T', 'h', 'i', 'n', 'g', 'y'),
+	/* Matches the short name filter. */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0xCB, 0x60, 0x2F, 0x84, 0x5E, 0x07), true,
+	       FLAGS,
+	       0x05, BT_DATA_NAME_SHORTENED, 'E', 'n', 'v', '1'),
+	/* Matches the address filter. */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0xD4, 0x3B, 0x11, 0x6E, 0x2A, 0x90), true,
+	       0x02, BT_DATA_FLAGS, BT_LE_AD_NO_BREDR,
+	       0x05, BT_DATA_MANUFACTURER_DATA, 0x59, 0x00, 0xAB, 0xCD),
+	/* Unknown vendor data. */
+	REPORT(ADDR(BT_ADDR_LE_PUBLIC, 0xF4, 0xCE, 0x36, 0x00, 0x5B, 0x12), false,
+	       FLAGS,
+	       0x07, BT_DATA_MANUFACTURER_DATA, 0x59, 0x00, 0x01, 0x02, 0x03,
+	       0x04),
+	/* Directed advertising, no advertising data. */
+	{
+		.addr = ADDR(BT_ADDR_LE_RANDOM, 0x5A, 0x33, 0x08, 0xBC, 0x47, 0x9D),
+		.match = false,
+	},
+	/* Sensor network node, matches the name filter. */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0xC2, 0x77, 0x91, 0x3A, 0x0E, 0xF8), true,
+	       FLAGS,
+	       0x0B, BT_DATA_NAME_COMPLETE,
+	       'S', 'e', 'n', 's', 'o', 'r', '-', '1', '3', '7'),
+};
+
+static struct bt_le_scan_cb *scan_cb;
+static size_t match_cnt;
+static size_t no_match_cnt;
+static struct bt_scan_filter_match last_match;
+
+void __wrap_bt_le_scan_cb_register(struct bt_le_scan_cb *cb)
+{
+	scan_cb = cb;
+}
+
+static void scan_filter_match(struct bt_scan_device_info *device_info,
+			      struct bt_scan_filter_match *filter_match,
+			      bool connectable)
+{
+	match_cnt++;
+	last_match = *filter_match;
+}
+
+static void scan_filter_no_match(struct bt_scan_device_info *device_info,
+				 bool connectable)
+{
+	no_match_cnt++;
+}
+
+BT_SCAN_CB_INIT(scan_cb_data, scan_filter_match, scan_filter_no_match,
+		NULL, NULL);
+
+static void replay(const struct captured_report *report)
+{
+	struct bt_le_scan_recv_info info = {
+		.addr = &report->addr,
+		.rssi = -70,
+		.adv_type = BT_GAP_ADV_TYPE_ADV_IND,
+		.adv_props = BT_GAP_ADV_PROP_CONNECTABLE |
+			     BT_GAP_ADV_PROP_SCANNABLE,
+	};
+	struct net_buf_simple buf;
+
+	net_buf_simple_init_with_data(&buf, (void *)report->data, report->len);
+	scan_cb->recv(&info, &buf);
+}
+
+/* Fill the filter lists the way a gateway does, with the entries that
+ * the captured devices match at the end. The name and UUID lists are left
+ * one entry short of full, so that adding duplicates can be tested.
+ */
+static void filters_add(void)
+{
+	static const char *const names[] = { "Thingy" };
+	static struct bt_scan_short_name short_name = {
+		.name = "Env1-Outdoor",
+		.min_len = 4,
+	};
+	static const bt_addr_le_t addr =
+		ADDR(BT_ADDR_LE_RANDOM, 0xD4, 0x3B, 0x11, 0x6E, 0x2A, 0x90);
+	static uint8_t ibeacon[] = { 0x4C, 0x00, 0x02, 0x15 };
+	struct bt_scan_manufacturer_data manufacturer_data = {
+		.data = ibeacon,
+		.data_len = sizeof(ibeacon),
+	};
+	uint16_t appearance = BT_APPEARANCE_HID_KEYBOARD;
+	char name[CONFIG_BT_SCAN_NAME_MAX_LEN];
+	int err;
+
+	for (size_t i = 0; i < CONFIG_BT_SCAN_NAME_CNT - ARRAY_SIZE(names) - 1; i++) {
+		snprintk(name, sizeof(name), "Sensor-%03u", 100 + (unsigned int)i);
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, name);
+		zassert_ok(err, "Adding name filter failed (err %d)", err);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(names); i++) {
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, names[i]);
+		zassert_ok(err, "Adding name filter failed (err %d)", err);
+	}
+
+	for (size_t i = 0; i < CONFIG_BT_SCAN_SHORT_NAME_CNT - 1; i++) {
+		struct bt_scan_short_name node = {
+			.name = name,
+			.min_len = 5,
+		};
+
+		snprintk(name, sizeof(name), "Node-%02u", (unsigned int)i);
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_SHORT_NAME, &node);
+		zassert_ok(err, "Adding short name filter failed (err %d)", err);
+	}
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_SHORT_NAME, &short_name);
+	zassert_ok(err, "Adding short name filter failed (err %d)", err);
+
+	for (size_t i = 0; i < CONFIG_BT_SCAN_ADDRESS_CNT - 1; i++) {
+		bt_addr_le_t filler = ADDR(BT_ADDR_LE_RANDOM, 0xC0, 0x00, 0x00,
+					   0x00, i >> 8, i & 0xFF);
+
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &filler);
+		zassert_ok(err, "Adding address filter failed (err %d)", err);
+	}
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr);
+	zassert_ok(err, "Adding address filter failed (err %d)", err);
+
+	for (size_t i = 0; i < CONFIG_BT_SCAN_UUID_CNT - 3; i++) {
+		struct bt_uuid_128 uuid = BT_UUID_INIT_128(
+			BT_UUID_128_ENCODE(0x00000000, 0x1212, 0xefde, 0x1523,
+					   0x785feabcd123));
+
+		sys_put_le16(i, &uuid.val[12]);
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid);
+		zassert_ok(err, "Adding UUID filter failed (err %d)", err);
+	}
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_HRS);
+	zassert_ok(err, "Adding UUID filter failed (err %d)", err);
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_DECLARE_128(
+		BT_UUID_128_ENCODE(0x6e400001, 0xb5a3, 0xf393, 0xe0a9,
+				   0xe50e24dcca9e)));
+	zassert_ok(err, "Adding UUID filter failed (err %d)", err);
+
+	for (size_t i = 0; i < CONFIG_BT_SCAN_APPEARANCE_CNT - 1; i++) {
+		uint16_t filler = BT_APPEARANCE_GENERIC_SENSOR + i;
+
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_APPEARANCE, &filler);
+		zassert_ok(err, "Adding appearance filter failed (err %d)", err);
+	}
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_APPEARANCE, &appearance);
+	zassert_ok(err, "Adding appearance filter failed (err %d)", err);
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA,
+				 &manufacturer_data);
+	zassert_ok(err, "Adding manufacturer data filter failed (err %d)", err);
+
+	err = bt_scan_filter_enable(BT_SCAN_ALL_FILTER, false);
+	zassert_ok(err, "Enabling filters failed (err %d)", err);
+}
+
+static void test_setup(void)
+{
+	match_cnt = 0;
+	no_match_cnt = 0;
+	memset(&last_match, 0, sizeof(last_match));
+}
+
+static void test_duplicate_filter(void)
+{
+	struct bt_filter_status status;
+	int err;
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Sensor-137");
+	zassert_ok(err, "Adding duplicate name filter failed (err %d)", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_HRS);
+	zassert_ok(err, "Adding duplicate UUID filter failed (err %d)", err);
+
+	err = bt_scan_filter_status_get(&status);
+	zassert_ok(err, "Getting filter status failed (err %d)", err);
+	zassert_equal(status.name.cnt, CONFIG_BT_SCAN_NAME_CNT - 1,
+		      "Duplicate name filter added");
+	zassert_equal(status.uuid.cnt, CONFIG_BT_SCAN_UUID_CNT - 1,
+		      "Duplicate UUID filter added");
+}
+
+static void test_filter_match(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+		size_t expected = match_cnt + (reports[i].match ? 1 : 0);
+
+		replay(&reports[i]);
+		zassert_equal(match_cnt, expected, "Wrong filter result for report %u",
+			      (unsigned int)i);
+	}
+
+	zassert_equal(no_match_cnt, 4, "Wrong number of unmatched reports");
+
+	/* The last captured device matches by name. */
+	zassert_true(last_match.name.match, "Name filter not matched");
+	zassert_equal(strcmp(last_match.name.name, "Sensor-137"), 0,
+		      "Wrong name filter reported");
+
+	replay(&reports[4]);
+	zassert_true(last_match.uuid.match, "UUID filter not matched");
+	zassert_equal(last_match.uuid.count, 1, "Wrong UUID match count");
+	zassert_equal(bt_uuid_cmp(last_match.uuid.uuid[0], BT_UUID_DECLARE_128(
+		BT_UUID_128_ENCODE(0x6e400001, 0xb5a3, 0xf393, 0xe0a9,
+				   0xe50e24dcca9e))), 0, "Wrong UUID filter reported");
+
+	replay(&reports[7]);
+	zassert_true(last_match.short_name.match, "Short name filter not matched");
+	zassert_equal(strcmp(last_match.short_name.name, "Env1-Outdoor"), 0,
+		      "Wrong short name filter reported");
+
+	replay(&reports[8]);
+	zassert_true(last_match.addr.match, "Address filter not matched");
+	zassert_equal(bt_addr_le_cmp(last_match.addr.addr, &reports[8].addr), 0,
+		      "Wrong address filter reported");
+}
+
+static void test_replay_benchmark(void)
+{
+	size_t expected = 0;
+	uint32_t start;
+	uint32_t cycles;
+
+	for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+		expected += reports[i].match ? REPLAY_ROUNDS : 0;
+	}
+
+	start = k_cycle_get_32();
+
+	for (size_t round = 0; round < REPLAY_ROUNDS; round++) {
+		for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+			replay(&reports[i]);
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	zassert_equal(match_cnt, expected, "Wrong number of matched reports");
+
+	TC_PRINT("Filter engine: %s\n",
+		 IS_ENABLED(CONFIG_BT_SCAN_FILTER_INDEX) ? "index" : "linear");
+	TC_PRINT("Replay time: %u ns/report\n",
+		 (uint32_t)(k_cyc_to_ns_floor64(cycles) /
+			    (REPLAY_ROUNDS * ARRAY_SIZE(reports))));
+}
+
+void test_main(void)
+{
+	bt_scan_init(NULL);
+	bt_scan_cb_register(&scan_cb_data);
+
+	zassert_not_null(scan_cb, "Scan callbacks not registered");
+
+	filters_add();
+
+	ztest_test_suite(test_bt_scan_benchmark,
+			 ztest_unit_test(test_duplicate_filter),
+			 ztest_unit_test_setup_teardown(test_filter_match,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_replay_benchmark,
+							test_setup,
+							unit_test_noop)
+	);
+	ztest_run_test_suite(test_bt_scan_benchmark);
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <bluetooth/scan.h>
+
+#define RSSI_DEFAULT (-70)
+
+static struct bt_le_scan_cb *scan_cb;
+static size_t report_cnt;
+
+static const uint8_t adv_data[] = {
+	0x02, BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR),
+	0x05, BT_DATA_NAME_COMPLETE, 'N', 'o', 'd', 'e',
+};
+
+static const uint8_t adv_data_changed[] = {
+	0x02, BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR),
+	0x05, BT_DATA_NAME_COMPLETE, 'N', 'o', 'd', 'f',
+};
+
+void __wrap_bt_le_scan_cb_register(struct bt_le_scan_cb *cb)
+{
+	scan_cb = cb;
+}
+
+static void scan_filter_no_match(struct bt_scan_device_info *device_info,
+				 bool connectable)
+{
+	report_cnt++;
+}
+
+BT_SCAN_CB_INIT(scan_cb_data, NULL, scan_filter_no_match, NULL, NULL);
+
+static void addr_get(uint8_t device, bt_addr_le_t *addr)
+{
+	addr->type = BT_ADDR_LE_RANDOM;
+	memset(addr->a.val, 0, sizeof(addr->a.val));
+	addr->a.val[0] = device;
+	addr->a.val[5] = 0xC0;
+}
+
+static void replay(uint8_t device, const uint8_t *data, size_t len,
+		   uint8_t adv_props, int8_t rssi)
+{
+	bt_addr_le_t addr;
+	struct bt_le_scan_recv_info info = {
+		.addr = &addr,
+		.rssi = rssi,
+		.adv_props = adv_props,
+	};
+	struct net_buf_simple buf;
+
+	addr_get(device, &addr);
+	net_buf_simple_init_with_data(&buf, (void *)data, len);
+	scan_cb->recv(&info, &buf);
+}
+
+static void replay_default(uint8_t device)
+{
+	replay(device, adv_data, sizeof(adv_data), BT_GAP_ADV_PROP_CONNECTABLE,
+	       RSSI_DEFAULT);
+}
+
+static void stats_check(uint32_t received, uint32_t reported,
+			uint32_t suppressed, uint32_t evicted)
+{
+	struct bt_scan_dedup_stats stats;
+	int err;
+
+	err = bt_scan_dedup_stats_get(&stats);
+	zassert_ok(err, "Getting statistics failed (err %d)", err);
+
+	zassert_equal(stats.received, received, "Wrong received count");
+	zassert_equal(stats.reported, reported, "Wrong reported count");
+	zassert_equal(stats.suppressed, suppressed, "Wrong suppressed count");
+	zassert_equal(stats.evicted, evicted, "Wrong evicted count");
+	zassert_equal(report_cnt, reported, "Wrong number of reports passed on");
+}
+
+static void test_setup(void)
+{
+	bt_scan_dedup_clear();
+	bt_scan_dedup_stats_reset();
+	report_cnt = 0;
+}
+
+static void test_duplicate(void)
+{
+	replay_default(0);
+	replay_default(0);
+	replay_default(0);
+
+	stats_check(3, 1, 2, 0);
+}
+
+static void test_changed_data(void)
+{
+	replay_default(0);
+	replay(0, adv_data_changed, sizeof(adv_data_changed),
+	       BT_GAP_ADV_PROP_CONNECTABLE, RSSI_DEFAULT);
+
+	/* Scan response data is tracked separately. */
+	replay(0, adv_data, sizeof(adv_data),
+	       BT_GAP_ADV_PROP_CONNECTABLE | BT_GAP_ADV_PROP_SCAN_RESPONSE,
+	       RSSI_DEFAULT);
+
+	/* So are other devices. */
+	replay_default(1);
+
+	stats_check(4, 4, 0, 0);
+}
+
+static void test_interval(void)
+{
+	replay_default(0);
+	k_sleep(K_MSEC(CONFIG_BT_SCAN_DEDUP_INTERVAL / 2));
+	replay_default(0);
+	k_sleep(K_MSEC(CONFIG_BT_SCAN_DEDUP_INTERVAL / 2));
+	replay_default(0);
+
+	stats_check(3, 2, 1, 0);
+}
+
+static void test_rssi_threshold(void)
+{
+	int8_t rssi = RSSI_DEFAULT + CONFIG_BT_SCAN_DEDUP_RSSI_THRESHOLD;
+
+	replay_default(0);
+	replay(0, adv_data, sizeof(adv_data), BT_GAP_ADV_PROP_CONNECTABLE,
+	       rssi - 1);
+	replay(0, adv_data, sizeof(adv_data), BT_GAP_ADV_PROP_CONNECTABLE,
+	       rssi);
+
+	/* The threshold applies to the RSSI of the report last passed on. */
+	replay(0, adv_data, sizeof(adv_data), BT_GAP_ADV_PROP_CONNECTABLE,
+	       rssi + 1);
+
+	stats_check(4, 2, 2, 0);
+}
+
+static void test_eviction(void)
+{
+	for (uint8_t i = 0; i <= CONFIG_BT_SCAN_DEDUP_CACHE_SIZE; i++) {
+		replay_default(i);
+	}
+
+	stats_check(CONFIG_BT_SCAN_DEDUP_CACHE_SIZE + 1,
+		    CONFIG_BT_SCAN_DEDUP_CACHE_SIZE + 1, 0, 1);
+
+	/* The most recently seen device is still cached. */
+	replay_default(CONFIG_BT_SCAN_DEDUP_CACHE_SIZE);
+
+	/* The first device has been evicted. */
+	replay_default(0);
+
+	stats_check(CONFIG_BT_SCAN_DEDUP_CACHE_SIZE + 3,
+		    CONFIG_BT_SCAN_DEDUP_CACHE_SIZE + 2, 1, 2);
+}
+
+static void test_clear(void)
+{
+	replay_default(0);
+	bt_scan_dedup_clear();
+	replay_default(0);
+
+	stats_check(2, 2, 0, 0);
+}
+
+void test_main(void)
+{
+	bt_scan_init(NULL);
+	bt_scan_cb_register(&scan_cb_data);
+
+	zassert_not_null(scan_cb, "Scan callbacks not registered");
+
+	ztest_test_suite(test_bt_scan_dedup,
+			 ztest_unit_test_setup_teardown(test_duplicate,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_changed_data,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_interval,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_rssi_threshold,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_eviction,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_clear,
+							test_setup,
+							unit_test_noop)
+	);
+	ztest_run_test_suite(test_bt_scan_dedup);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/kernel.h>
+
+#include "bl_crypto.h"
+
+/* Hash the first part of this image, which is guaranteed to be flash-resident
+ * and readable, as a stand-in for the image validated at boot.
+ */
+#define FLASH_DATA_ADDR CONFIG_FLASH_BASE_ADDRESS
+#define FLASH_DATA_LEN (64 * 1024)
+#define RAM_DATA_LEN (16 * 1024)
+#define ITERATIONS 4
+
+static uint32_t ram_data[RAM_DATA_LEN / 4];
+
+static uint32_t ms_per_mb(uint64_t cycles, uint32_t bytes)
+{
+	uint64_t us = k_cyc_to_us_floor64(cycles);
+
+	return (uint32_t)((us * 1024 * 1024) / ((uint64_t)bytes * 1000));
+}
+
+static uint64_t time_update(const uint8_t *data, uint32_t len, uint8_t *hash)
+{
+	bl_sha256_ctx_t ctx;
+	uint32_t start;
+	uint32_t end;
+	int rc;
+
+	start = k_cycle_get_32();
+
+	rc = bl_sha256_init(&ctx);
+	zassert_equal(0, rc, "bl_sha256_init failed retval was: %d", rc);
+	rc = bl_sha256_update(&ctx, data, len);
+	zassert_equal(0, rc, "bl_sha256_update failed retval was: %d", rc);
+	rc = bl_sha256_finalize(&ctx, hash);
+	zassert_equal(0, rc, "bl_sha256_finalize failed retval was: %d", rc);
+
+	end = k_cycle_get_32();
+
+	return end - start;
+}
+
+static uint64_t time_verify_internal(const uint8_t *data, uint32_t len,
+				     const uint8_t *expected)
+{
+	uint32_t start;
+	uint32_t end;
+	int rc;
+
+	start = k_cycle_get_32();
+	rc = bl_sha256_verify_internal(data, len, expected);
+	end = k_cycle_get_32();
+
+	zassert_equal(0, rc, "bl_sha256_verify_internal returned %d", rc);
+
+	return end - start;
+}
+
+static void report(const char *name, uint64_t cycles, uint32_t bytes)
+{
+	TC_PRINT("SHA-256 (%s): %u ms/MB\n", name, ms_per_mb(cycles, bytes));
+}
+
+static void run_benchmark(const char *name, const uint8_t *data, uint32_t len)
+{
+	uint8_t hash[CONFIG_SB_HASH_LEN];
+	uint64_t external_cycles = 0;
+	uint64_t internal_cycles = 0;
+	char label[32];
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		external_cycles += time_update(data, len, hash);
+		internal_cycles += time_verify_internal(data, len, hash);
+	}
+
+	snprintk(label, sizeof(label), "%s, EXT_API", name);
+	report(label, external_cycles, len * ITERATIONS);
+	snprintk(label, sizeof(label), "%s, bootloader", name);
+	report(label, internal_cycles, len * ITERATIONS);
+}
+
+void test_sha256_flash(void)
+{
+	run_benchmark("flash", (const uint8_t *)FLASH_DATA_ADDR,
+		      FLASH_DATA_LEN);
+}
+
+void test_sha256_ram(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(ram_data); i++) {
+		ram_data[i] = i * 0x9E3779B9;
+	}
+
+	run_benchmark("RAM", (const uint8_t *)ram_data, sizeof(ram_data));
+}
+
+void test_main(void)
+{
+	zassert_equal(0, bl_crypto_init(), "bl_crypto_init failed");
+
+	ztest_test_suite(test_bl_crypto_benchmark,
+			 ztest_unit_test(test_sha256_flash),
+			 ztest_unit_test(test_sha256_ram)
+	);
+	ztest_run_test_suite(test_bl_crypto_benchmark);
+}
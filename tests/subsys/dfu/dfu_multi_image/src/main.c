@@ -44,6 +44,7 @@ struct comparison_context {
 	struct expected expected;
 	size_t current_image_no;
 	size_t current_image_offset;
+	bool resuming;
 };
 
 static struct comparison_context ctx;
@@ -55,7 +56,10 @@ static int image_comparator_open(int image_id, size_t image_size)
 		      "Unexpected image id");
 	zassert_equal(ctx.expected.images[ctx.current_image_no].content_size, image_size,
 		      "Unexpected image size");
-	zassert_equal(ctx.current_image_offset, 0, "Opening image while already in progress");
+	zassert_true(ctx.current_image_offset == 0 || ctx.resuming,
+		     "Opening image while already in progress");
+
+	ctx.resuming = false;
 
 	return 0;
 }
@@ -84,6 +88,13 @@ static int image_comparator_close(bool success)
 	return 0;
 }
 
+static int image_comparator_offset(size_t *offset)
+{
+	*offset = ctx.current_image_offset;
+
+	return 0;
+}
+
 /*
  * Generic test that verifies that expected image data is written while downloading and
  * unpacking a given DFU Multi Image package.
@@ -154,6 +165,22 @@ static const struct expected two_image_package_expected = {
 	.image_count = 2,
 };
 
+/* Same package with the SHA-256 digest of its content in the header */
+static const uint8_t two_image_digest_package[] = {
+	0x47, 0x00, 0xa2, 0x63, 0x69, 0x6d, 0x67, 0x82, 0xa2, 0x62, 0x69, 0x64, 0x00,
+	0x64, 0x73, 0x69, 0x7a, 0x65, 0x0f, 0xa2, 0x62, 0x69, 0x64, 0x19, 0x01, 0x00,
+	0x64, 0x73, 0x69, 0x7a, 0x65, 0x11, 0x66, 0x64, 0x69, 0x67, 0x65, 0x73, 0x74,
+	0x58, 0x20, 0x83, 0x99, 0xb7, 0xd3, 0x8c, 0xdc, 0x0d, 0x6f, 0x18, 0x1b, 0x42,
+	0xc5, 0x37, 0x31, 0xf8, 0xd6, 0xed, 0x97, 0xdf, 0x0d, 0xa9, 0x80, 0xa9, 0x7f,
+	0xb0, 0xc7, 0x79, 0xb0, 0xe8, 0xb2, 0xef, 0x8f, 0x69, 0x6d, 0x61, 0x67, 0x65,
+	0x20, 0x30, 0x20, 0x63, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x69, 0x6d, 0x61,
+	0x67, 0x65, 0x20, 0x32, 0x35, 0x36, 0x20, 0x63, 0x6f, 0x6e, 0x74, 0x65, 0x6e,
+	0x74
+};
+
+/* Offset of the last byte of the digest in the package above */
+#define DIGEST_LAST_BYTE_OFFSET 72
+
 static void test_two_image_package(void)
 {
 	uint8_t buffer[128];
@@ -172,6 +199,15 @@ static void test_two_image_package_small_chunk(void)
 		   "DFU failed");
 }
 
+static void test_digest_package(void)
+{
+	uint8_t buffer[128];
+
+	zassert_ok(comparison_test(two_image_digest_package, sizeof(two_image_digest_package),
+				   &two_image_package_expected, buffer, sizeof(buffer), 100),
+		   "DFU failed");
+}
+
 static void test_too_small_buffer(void)
 {
 	int err;
@@ -267,14 +303,229 @@ static void test_generated_dfu_package(void)
 		   "DFU failed");
 }
 
+static void test_generated_dfu_digest_package(void)
+{
+	uint8_t buffer[128];
+	uint8_t package[strlen(DFU_DIGEST_PACKAGE_HEX) / 2];
+	size_t package_len;
+
+	package_len = hex2bin(DFU_DIGEST_PACKAGE_HEX, strlen(DFU_DIGEST_PACKAGE_HEX), package,
+			      sizeof(package));
+	zassert_true(package_len > 0, "Failed to convert package from hex string");
+
+	zassert_ok(comparison_test(package, package_len, &generated_dfu_package_expected, buffer,
+				   sizeof(buffer), 100),
+		   "DFU failed");
+}
+
+#ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
+static int resume_init(const struct expected *expected, uint8_t *buffer, size_t buffer_size)
+{
+	int err;
+
+	err = dfu_multi_image_init(buffer, buffer_size);
+
+	if (err) {
+		return err;
+	}
+
+	for (size_t i = 0; i < expected->image_count; ++i) {
+		struct dfu_image_writer writer = { .image_id = expected->images[i].image_id,
+						   .open = image_comparator_open,
+						   .write = image_comparator_write,
+						   .close = image_comparator_close,
+						   .offset = image_comparator_offset };
+
+		err = dfu_multi_image_register_writer(&writer);
+
+		if (err) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Write the package from the beginning, following the resume offset reported by the
+ * library, until either the package is complete or the given offset is reached.
+ */
+static int resume_write(const uint8_t *package, size_t package_size, size_t stop_offset,
+			size_t chunk_size)
+{
+	size_t offset = 0;
+	int err;
+
+	while (offset < stop_offset) {
+		err = dfu_multi_image_write(offset, package + offset,
+					    MIN(chunk_size, stop_offset - offset));
+
+		if (err) {
+			return err;
+		}
+
+		/* The library jumps ahead once it has parsed the header of a resumed package */
+		offset = MAX(offset + MIN(chunk_size, stop_offset - offset),
+			     dfu_multi_image_offset());
+	}
+
+	return 0;
+}
+
+static void resume_test(const uint8_t *package, size_t package_size,
+			const struct expected *expected, size_t chunk_size)
+{
+	uint8_t buffer[128];
+
+	/*
+	 * Simulate power loss at every offset within the package. The comparator context,
+	 * which plays the role of the image storage, survives the "reboot".
+	 */
+	for (size_t cut = 1; cut < package_size; cut++) {
+		zassert_ok(dfu_multi_image_reset_progress(), "Failed to reset progress");
+
+		ctx.expected = *expected;
+		ctx.current_image_no = 0;
+		ctx.current_image_offset = 0;
+		ctx.resuming = false;
+
+		zassert_ok(resume_init(expected, buffer, sizeof(buffer)), "Init failed");
+		zassert_ok(resume_write(package, package_size, cut, chunk_size),
+			   "Write before power loss failed (cut at %u)", cut);
+
+		ctx.resuming = true;
+
+		zassert_ok(resume_init(expected, buffer, sizeof(buffer)), "Init failed");
+		zassert_ok(resume_write(package, package_size, package_size, chunk_size),
+			   "Write after power loss failed (cut at %u)", cut);
+		zassert_ok(dfu_multi_image_done(true), "DFU failed (cut at %u)", cut);
+		zassert_equal(ctx.current_image_no, expected->image_count,
+			      "Too few images written (cut at %u)", cut);
+	}
+
+	/* Completed package leaves no progress behind, so it is written anew. */
+	ctx.current_image_no = 0;
+	ctx.current_image_offset = 0;
+	ctx.resuming = false;
+
+	zassert_ok(resume_init(expected, buffer, sizeof(buffer)), "Init failed");
+	zassert_ok(resume_write(package, package_size, package_size, chunk_size),
+		   "Write of completed package failed");
+	zassert_ok(dfu_multi_image_done(true), "DFU failed");
+	zassert_equal(ctx.current_image_no, expected->image_count, "Too few images written");
+}
+
+static void test_resume_after_power_loss(void)
+{
+	resume_test(two_image_digest_package, sizeof(two_image_digest_package),
+		    &two_image_package_expected, 7);
+}
+
+static void test_resume_after_power_loss_small_chunk(void)
+{
+	resume_test(two_image_digest_package, sizeof(two_image_digest_package),
+		    &two_image_package_expected, 1);
+}
+
+static void test_resume_skipped_image(void)
+{
+	struct expected expected = two_image_package_expected;
+
+	expected.images[0] = expected.images[1];
+	expected.image_count = 1;
+	resume_test(two_image_digest_package, sizeof(two_image_digest_package), &expected, 7);
+}
+
+/*
+ * Interrupt the first package in its last image, then check that the second package is
+ * written from its first image instead of being resumed.
+ */
+static void restart_test(const uint8_t *first, const uint8_t *second, size_t package_size)
+{
+	uint8_t buffer[128];
+
+	zassert_ok(dfu_multi_image_reset_progress(), "Failed to reset progress");
+
+	ctx.expected = two_image_package_expected;
+	ctx.current_image_no = 0;
+	ctx.current_image_offset = 0;
+	ctx.resuming = false;
+
+	zassert_ok(resume_init(&two_image_package_expected, buffer, sizeof(buffer)),
+		   "Init failed");
+	zassert_ok(resume_write(first, package_size, package_size - 3, 7),
+		   "Write before power loss failed");
+
+	/* Fresh image storage, which the writers must fill from the beginning */
+	ctx.current_image_no = 0;
+	ctx.current_image_offset = 0;
+
+	zassert_ok(resume_init(&two_image_package_expected, buffer, sizeof(buffer)),
+		   "Init failed");
+	zassert_ok(resume_write(second, package_size, package_size, 7),
+		   "Write after power loss failed");
+	zassert_ok(dfu_multi_image_done(true), "DFU failed");
+	zassert_equal(ctx.current_image_no, two_image_package_expected.image_count,
+		      "Too few images written");
+}
+
+static void test_restart_without_digest(void)
+{
+	restart_test(two_image_package, two_image_package, sizeof(two_image_package));
+}
+
+static void test_restart_other_digest(void)
+{
+	uint8_t package[sizeof(two_image_digest_package)];
+
+	/* Same layout, different content */
+	memcpy(package, two_image_digest_package, sizeof(package));
+	package[DIGEST_LAST_BYTE_OFFSET] ^= 0xff;
+
+	restart_test(two_image_digest_package, package, sizeof(package));
+}
+#else
+static void test_resume_after_power_loss(void)
+{
+	ztest_test_skip();
+}
+
+static void test_resume_after_power_loss_small_chunk(void)
+{
+	ztest_test_skip();
+}
+
+static void test_resume_skipped_image(void)
+{
+	ztest_test_skip();
+}
+
+static void test_restart_without_digest(void)
+{
+	ztest_test_skip();
+}
+
+static void test_restart_other_digest(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS */
+
 void test_main(void)
 {
 	ztest_test_suite(dfu_multi_image_test, ztest_unit_test(test_two_image_package),
 			 ztest_unit_test(test_two_image_package_small_chunk),
+			 ztest_unit_test(test_digest_package),
 			 ztest_unit_test(test_too_small_buffer),
 			 ztest_unit_test(test_too_small_package),
 			 ztest_unit_test(test_too_large_package),
 			 ztest_unit_test(test_skipped_image),
-			 ztest_unit_test(test_generated_dfu_package));
+			 ztest_unit_test(test_generated_dfu_package),
+			 ztest_unit_test(test_generated_dfu_digest_package),
+			 ztest_unit_test(test_resume_after_power_loss),
+			 ztest_unit_test(test_resume_after_power_loss_small_chunk),
+			 ztest_unit_test(test_resume_skipped_image),
+			 ztest_unit_test(test_restart_without_digest),
+			 ztest_unit_test(test_restart_other_digest));
 	ztest_run_test_suite(dfu_multi_image_test);
 }
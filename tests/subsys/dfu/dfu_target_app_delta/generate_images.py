@@ -0,0 +1,40 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2022 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+"""
+Generate a pair of images resembling two builds of the same application:
+the target has code inserted and removed, and addresses shifted, with
+respect to the source.
+"""
+
+import random
+import sys
+
+SOURCE_SIZE = 4096
+
+
+def main():
+    rng = random.Random(2022)
+    source = bytes(rng.getrandbits(8) for _ in range(SOURCE_SIZE))
+
+    target = bytearray(source[:1024])
+    target += b'inserted function' * 8
+    target += source[1024:2560]
+    target += source[2816:]
+
+    # Shift "addresses" referenced every 64 bytes
+    for i in range(0, len(target), 64):
+        target[i] = (target[i] + 0x10) & 0xff
+
+    with open(sys.argv[1], 'wb') as file:
+        file.write(source)
+
+    with open(sys.argv[2], 'wb') as file:
+        file.write(target)
+
+
+if __name__ == '__main__':
+    main()
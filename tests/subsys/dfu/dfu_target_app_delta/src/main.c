@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <ztest.h>
+#include <string.h>
+
+#include "app_delta_patch.h"
+
+/* See CMakeLists.txt of the test project for how the images and patch are generated. */
+static uint8_t source[sizeof(SOURCE_HEX) / 2];
+static uint8_t target[sizeof(TARGET_HEX) / 2];
+static uint8_t patch_data[sizeof(PATCH_HEX) / 2];
+static size_t source_len;
+static size_t target_len;
+static size_t patch_len;
+
+static uint8_t output[sizeof(TARGET_HEX) / 2];
+static size_t output_len;
+static bool header_called;
+
+static struct app_delta_patch patch;
+
+static int source_read(size_t offset, uint8_t *buf, size_t len)
+{
+	zassert_true(offset + len <= source_len, "Read outside of the source");
+	memcpy(buf, &source[offset], len);
+
+	return 0;
+}
+
+static int header(const struct app_delta_patch_header *hdr)
+{
+	zassert_false(header_called, "Header reported twice");
+	zassert_equal(hdr->source_size, source_len, "Unexpected source size");
+	zassert_equal(hdr->target_size, target_len, "Unexpected target size");
+	header_called = true;
+
+	return 0;
+}
+
+static int target_write(const uint8_t *buf, size_t len)
+{
+	zassert_true(header_called, "Target written before header");
+
+	if (output_len + len > sizeof(output)) {
+		return -EFBIG;
+	}
+
+	memcpy(&output[output_len], buf, len);
+	output_len += len;
+
+	return 0;
+}
+
+static const struct app_delta_patch_ops ops = {
+	.source_read = source_read,
+	.header = header,
+	.target_write = target_write,
+};
+
+static int apply(const uint8_t *data, size_t len, size_t chunk_size)
+{
+	int err;
+
+	app_delta_patch_init(&patch, &ops);
+	output_len = 0;
+	header_called = false;
+
+	for (size_t i = 0; i < len; i += chunk_size) {
+		err = app_delta_patch_process(&patch, &data[i], MIN(chunk_size, len - i));
+		if (err) {
+			return err;
+		}
+	}
+
+	return app_delta_patch_finish(&patch);
+}
+
+static void check_output(void)
+{
+	zassert_equal(output_len, target_len, "Unexpected output length");
+	zassert_mem_equal(output, target, target_len, "Unexpected output");
+}
+
+static void test_identify(void)
+{
+	zassert_true(app_delta_patch_identify(patch_data), "Patch not identified");
+	zassert_false(app_delta_patch_identify(source), "Source identified as patch");
+}
+
+static void test_apply(void)
+{
+	zassert_ok(apply(patch_data, patch_len, patch_len), "Apply failed");
+	check_output();
+}
+
+static void test_apply_small_chunks(void)
+{
+	const size_t chunk_sizes[] = { 1, 2, 7, 64, 100 };
+
+	for (size_t i = 0; i < ARRAY_SIZE(chunk_sizes); i++) {
+		zassert_ok(apply(patch_data, patch_len, chunk_sizes[i]),
+			   "Apply failed for chunk size %u", chunk_sizes[i]);
+		check_output();
+	}
+}
+
+static void test_wrong_source(void)
+{
+	source[source_len / 2]++;
+	zassert_equal(apply(patch_data, patch_len, 100), -ENOENT,
+		      "Patch applied to a different source");
+	source[source_len / 2]--;
+	zassert_false(header_called, "Header reported for a different source");
+}
+
+static void test_truncated_patch(void)
+{
+	zassert_equal(apply(patch_data, patch_len - 1, 100), -EBADMSG,
+		      "Truncated patch not detected");
+}
+
+static void test_trailing_data(void)
+{
+	static uint8_t longer[sizeof(patch_data) + 1];
+
+	memcpy(longer, patch_data, patch_len);
+	zassert_equal(apply(longer, patch_len + 1, 100), -EBADMSG,
+		      "Trailing data not detected");
+}
+
+static void test_corrupted_patch(void)
+{
+	/* Corrupt the last byte of the patch. */
+	patch_data[patch_len - 1] ^= 0x01;
+	zassert_equal(apply(patch_data, patch_len, 100), -EBADMSG,
+		      "Corrupted target not detected");
+	patch_data[patch_len - 1] ^= 0x01;
+}
+
+static void test_benchmark(void)
+{
+	uint32_t start;
+	uint32_t cycles;
+
+	start = k_cycle_get_32();
+	zassert_ok(apply(patch_data, patch_len, 512), "Apply failed");
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("Patch size: %u bytes for %u byte image (%u%%)\n", patch_len, target_len,
+		 (patch_len * 100) / target_len);
+	TC_PRINT("Apply time: %u us\n", (uint32_t)k_cyc_to_us_floor64(cycles));
+}
+
+void test_main(void)
+{
+	source_len = hex2bin(SOURCE_HEX, strlen(SOURCE_HEX), source, sizeof(source));
+	target_len = hex2bin(TARGET_HEX, strlen(TARGET_HEX), target, sizeof(target));
+	patch_len = hex2bin(PATCH_HEX, strlen(PATCH_HEX), patch_data, sizeof(patch_data));
+
+	ztest_test_suite(dfu_target_app_delta_test,
+			 ztest_unit_test(test_identify),
+			 ztest_unit_test(test_apply),
+			 ztest_unit_test(test_apply_small_chunks),
+			 ztest_unit_test(test_wrong_source),
+			 ztest_unit_test(test_truncated_patch),
+			 ztest_unit_test(test_trailing_data),
+			 ztest_unit_test(test_corrupted_patch),
+			 ztest_unit_test(test_benchmark));
+	ztest_run_test_suite(dfu_target_app_delta_test);
+}
@@ -628,6 +628,191 @@ static void test_corrupted_data(void)
 				     "Should not be able to read");
 }
 
+static void test_store_gathered(void)
+{
+	static uint8_t flash_ref[256];
+	static uint8_t flash_out[256];
+	uint8_t data_in[5][13];
+	uint8_t data_out[13];
+	uint32_t data_size = 0;
+	uint32_t ate_wra;
+
+	for (int i = 0; i < ARRAY_SIZE(data_in); i++) {
+		memset(data_in[i], i + 1, sizeof(data_in[i]));
+		data_size += align_size(i + 9);
+	}
+
+	/* Store the entries one by one for reference */
+	flash_clear();
+	device_reset();
+
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_false(emds_flash_prepare(&ctx, data_size + 5 * ctx.ate_size), "Prepare failed");
+	ate_wra = ctx.ate_wra;
+
+	for (int i = 0; i < ARRAY_SIZE(data_in); i++) {
+		zassert_equal(emds_flash_write(&ctx, i + 1, data_in[i], i + 9), i + 9,
+			      "Error when write");
+	}
+
+	flash_read(m_test_fd.fd, m_test_fd.offset, flash_ref, sizeof(flash_ref));
+	zassert_false(flash_read(m_test_fd.fd, ate_wra - 4 * ctx.ate_size, &flash_ref[128],
+				 5 * ctx.ate_size), "Error when read");
+
+	/* Gather the same entries, and expect the same result in flash */
+	flash_clear();
+	device_reset();
+
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_false(emds_flash_prepare(&ctx, data_size + 5 * ctx.ate_size), "Prepare failed");
+	zassert_false(emds_flash_store_begin(&ctx), "Error when begin");
+
+	for (int i = 0; i < ARRAY_SIZE(data_in); i++) {
+		zassert_false(emds_flash_store_entry(&ctx, i + 1, data_in[i], i + 9),
+			      "Error when store");
+	}
+
+	zassert_false(emds_flash_store_end(&ctx), "Error when end");
+
+	flash_read(m_test_fd.fd, m_test_fd.offset, flash_out, sizeof(flash_out));
+	zassert_false(flash_read(m_test_fd.fd, ate_wra - 4 * ctx.ate_size, &flash_out[128],
+				 5 * ctx.ate_size), "Error when read");
+	zassert_mem_equal(flash_out, flash_ref, sizeof(flash_ref), "Flash content differs");
+
+	/* Entries can be read, also after recovery */
+	device_reset();
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+
+	for (int i = 0; i < ARRAY_SIZE(data_in); i++) {
+		zassert_equal(emds_flash_read(&ctx, i + 1, data_out, sizeof(data_out)), i + 9,
+			      "Error when read");
+		zassert_mem_equal(data_out, data_in[i], i + 9, "Retrived wrong value");
+	}
+
+	zassert_true(emds_flash_store_writes_get(data_size, 5 * ctx.ate_size) <= 2,
+		     "Entries not gathered");
+}
+
+static void test_store_overflow(void)
+{
+	uint8_t data_in[64];
+	uint8_t data_out[64];
+	uint16_t cnt = 0;
+
+	memset(data_in, 69, sizeof(data_in));
+
+	flash_clear();
+	device_reset();
+
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_false(emds_flash_prepare(&ctx, sizeof(data_in) + ctx.ate_size), "Prepare failed");
+	zassert_false(emds_flash_store_begin(&ctx), "Error when begin");
+
+	/* Room for the data must be left for the allocation table entries */
+	while (!emds_flash_store_entry(&ctx, cnt + 1, data_in, sizeof(data_in))) {
+		cnt++;
+	}
+
+	zassert_true(ctx.ate_wra >= ctx.offset + ctx.data_wra_offset,
+		     "No room for allocation table entries");
+	zassert_false(emds_flash_store_end(&ctx), "Error when end");
+
+	device_reset();
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+
+	for (uint16_t i = 0; i < cnt; i++) {
+		zassert_equal(emds_flash_read(&ctx, i + 1, data_out, sizeof(data_out)),
+			      sizeof(data_out), "Error when read %d", i);
+	}
+}
+
+static void test_store_skip(void)
+{
+	uint8_t data_in[3][13];
+	uint8_t data_out[13];
+	size_t len[ARRAY_SIZE(data_in)];
+	const int expected[ARRAY_SIZE(data_in)] = { 0, -ENOMEM, 0 };
+
+	for (int i = 0; i < ARRAY_SIZE(data_in); i++) {
+		memset(data_in[i], i + 1, sizeof(data_in[i]));
+		len[i] = sizeof(data_in[i]);
+	}
+
+	flash_clear();
+	device_reset();
+
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_false(emds_flash_prepare(&ctx, 2 * align_size(sizeof(data_in[0])) +
+					 2 * ctx.ate_size), "Prepare failed");
+
+	/* The second entry is longer than the free space. Its data is not read. */
+	len[1] = ctx.ate_wra - (ctx.offset + ctx.data_wra_offset);
+
+	zassert_false(emds_flash_store_begin(&ctx), "Error when begin");
+
+	/* The entry is skipped, and the next entry gets the right data offset */
+	for (int i = 0; i < ARRAY_SIZE(data_in); i++) {
+		zassert_equal(emds_flash_store_entry(&ctx, i + 1, data_in[i], len[i]), expected[i],
+			      "Wrong result for entry %d", i);
+	}
+
+	zassert_false(emds_flash_store_end(&ctx), "Error when end");
+
+	device_reset();
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+
+	for (int i = 0; i < ARRAY_SIZE(data_in); i++) {
+		if (expected[i]) {
+			zassert_true(emds_flash_read(&ctx, i + 1, data_out, sizeof(data_out)) < 0,
+				     "Skipped entry %d stored", i);
+			continue;
+		}
+
+		zassert_equal(emds_flash_read(&ctx, i + 1, data_out, sizeof(data_out)),
+			      sizeof(data_out), "Error when read");
+		zassert_mem_equal(data_out, data_in[i], sizeof(data_out), "Retrived wrong value");
+	}
+}
+
+static void test_store_interrupted(void)
+{
+	static uint8_t data_in[3][CONFIG_EMDS_STORE_BUF_SIZE / 2];
+	static uint8_t data_out[CONFIG_EMDS_STORE_BUF_SIZE / 2];
+
+	for (int i = 0; i < ARRAY_SIZE(data_in); i++) {
+		memset(data_in[i], i + 1, sizeof(data_in[i]));
+	}
+
+	flash_clear();
+	device_reset();
+
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_false(emds_flash_prepare(&ctx, sizeof(data_in) +
+					 ARRAY_SIZE(data_in) * ctx.ate_size), "Prepare failed");
+	zassert_false(emds_flash_store_begin(&ctx), "Error when begin");
+
+	/* The data of the second entry fills the buffer, which writes the first
+	 * entry completely.
+	 */
+	for (int i = 0; i < ARRAY_SIZE(data_in); i++) {
+		zassert_false(emds_flash_store_entry(&ctx, i + 1, data_in[i], sizeof(data_in[i])),
+			      "Error when store");
+	}
+
+	/* Power loss before the store is completed */
+	device_reset();
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+
+	zassert_equal(emds_flash_read(&ctx, 1, data_out, sizeof(data_out)), sizeof(data_out),
+		      "Written entry lost");
+	zassert_mem_equal(data_out, data_in[0], sizeof(data_out), "Retrived wrong value");
+
+	for (int i = 1; i < ARRAY_SIZE(data_in); i++) {
+		zassert_true(emds_flash_read(&ctx, i + 1, data_out, sizeof(data_out)) < 0,
+			     "Incomplete entry %d read", i);
+	}
+}
+
 static void test_write_speed(void)
 {
 	char data_in[4] = "bee";
@@ -686,6 +871,10 @@ void test_main(void)
 			 ztest_unit_test(test_full_corrupt_recovery),
 			 ztest_unit_test(test_overflow),
 			 ztest_unit_test(test_corrupted_data),
+			 ztest_unit_test(test_store_gathered),
+			 ztest_unit_test(test_store_overflow),
+			 ztest_unit_test(test_store_skip),
+			 ztest_unit_test(test_store_interrupted),
 			 ztest_unit_test(test_write_speed)
 			 );
 
@@ -0,0 +1,508 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+
+#include <net/rest_client.h>
+
+/* Runs the REST client against an HTTP server on the loopback interface. The
+ * server answers every GET request with the same body, sent with chunked
+ * transfer encoding for /chunked. It closes the connection after answering a
+ * request for /close, which looks to the client like a keep-alive connection
+ * closed by the server while idle. It never answers requests for /slow. It
+ * answers requests for /range with a partial response, whose Content-Range
+ * header is split over several receive buffers of the streaming tests.
+ */
+
+#define SERVER_ADDR "127.0.0.1"
+#define SERVER_PORT 8080
+#define CONN_MAX    3
+#define REQ_MAX     256
+#define BODY_LEN    300
+#define CHUNK_LEN   100
+#define TIMEOUT_MS  2000
+#define SLOW_TIMEOUT_MS 200
+#define RANGE_TOTAL 1000
+#define HTTP_STATUS_PARTIAL 206
+
+#define SERVER_STACK_SIZE 2048
+#define SERVER_PRIO       5
+
+static K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+static struct {
+	int listen_fd;
+	atomic_t accepted;
+	atomic_t slow;
+	struct {
+		int fd;
+		size_t len;
+		char req[REQ_MAX];
+	} conn[CONN_MAX];
+} server;
+
+static char body[BODY_LEN];
+static char resp_buf[512];
+
+/* Receive buffer size that makes the body span several receive buffers. */
+#define STREAM_BUF_SIZE 128
+
+static struct {
+	char data[BODY_LEN];
+	size_t len;
+	uint32_t frags;
+	uint32_t abort_after;
+	uint16_t status;
+	size_t range_total;
+} received;
+
+static void server_send(int fd, const void *data, size_t len)
+{
+	while (len) {
+		ssize_t sent = send(fd, data, len, 0);
+
+		if (sent < 0) {
+			return;
+		}
+
+		data = (const char *)data + sent;
+		len -= sent;
+	}
+}
+
+/* Return true if the server closes the connection after the response. */
+static bool server_respond(int fd, const char *req)
+{
+	char hdr[80];
+	int len;
+
+	if (strncmp(req, "GET /slow ", strlen("GET /slow ")) == 0) {
+		atomic_inc(&server.slow);
+
+		return false;
+	}
+
+	if (strncmp(req, "GET /range ", strlen("GET /range ")) == 0) {
+		/* Content-Range straddles the first two receive buffers, and the
+		 * body starts in the third one.
+		 */
+		static char range_hdr[3 * STREAM_BUF_SIZE];
+
+		len = snprintk(range_hdr, sizeof(range_hdr),
+			       "HTTP/1.1 206 Partial Content\r\n"
+			       "X-Pad: %.70s\r\n"
+			       "Content-Range: bytes 0-%u/%u\r\n"
+			       "X-Pad: %.120s\r\n"
+			       "Content-Length: %u\r\n\r\n",
+			       body, BODY_LEN - 1, RANGE_TOTAL, body, BODY_LEN);
+		server_send(fd, range_hdr, len);
+		server_send(fd, body, BODY_LEN);
+
+		return false;
+	}
+
+	if (strncmp(req, "GET /chunked ", strlen("GET /chunked ")) == 0) {
+		len = snprintk(hdr, sizeof(hdr),
+			       "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n");
+		server_send(fd, hdr, len);
+
+		for (size_t offset = 0; offset < BODY_LEN; offset += CHUNK_LEN) {
+			size_t chunk = MIN(CHUNK_LEN, BODY_LEN - offset);
+
+			len = snprintk(hdr, sizeof(hdr), "%x\r\n", (unsigned int)chunk);
+			server_send(fd, hdr, len);
+			server_send(fd, &body[offset], chunk);
+			server_send(fd, "\r\n", 2);
+		}
+
+		server_send(fd, "0\r\n\r\n", 5);
+
+		return false;
+	}
+
+	len = snprintk(hdr, sizeof(hdr), "HTTP/1.1 200 OK\r\nContent-Length: %u\r\n\r\n",
+		       BODY_LEN);
+	server_send(fd, hdr, len);
+	server_send(fd, body, BODY_LEN);
+
+	return strncmp(req, "GET /close ", strlen("GET /close ")) == 0;
+}
+
+static void server_conn_close(int i)
+{
+	(void)close(server.conn[i].fd);
+	server.conn[i].fd = -1;
+}
+
+static void server_accept(void)
+{
+	int fd = accept(server.listen_fd, NULL, NULL);
+
+	if (fd < 0) {
+		return;
+	}
+
+	atomic_inc(&server.accepted);
+
+	for (int i = 0; i < CONN_MAX; i++) {
+		if (server.conn[i].fd < 0) {
+			server.conn[i].fd = fd;
+			server.conn[i].len = 0;
+			return;
+		}
+	}
+
+	(void)close(fd);
+}
+
+static void server_recv(int i)
+{
+	size_t space = sizeof(server.conn[i].req) - server.conn[i].len - 1;
+	ssize_t len;
+
+	len = recv(server.conn[i].fd, &server.conn[i].req[server.conn[i].len], space, 0);
+	if (len <= 0) {
+		server_conn_close(i);
+		return;
+	}
+
+	server.conn[i].len += len;
+	server.conn[i].req[server.conn[i].len] = '\0';
+
+	/* The requests have no body, the headers end the request. */
+	if (!strstr(server.conn[i].req, "\r\n\r\n")) {
+		if (len == space) {
+			server_conn_close(i);
+		}
+
+		return;
+	}
+
+	server.conn[i].len = 0;
+
+	if (server_respond(server.conn[i].fd, server.conn[i].req)) {
+		server_conn_close(i);
+	}
+}
+
+static void server_run(void *p1, void *p2, void *p3)
+{
+	struct pollfd fds[CONN_MAX + 1];
+
+	while (true) {
+		fds[0].fd = server.listen_fd;
+		fds[0].events = POLLIN;
+
+		for (int i = 0; i < CONN_MAX; i++) {
+			fds[i + 1].fd = server.conn[i].fd;
+			fds[i + 1].events = POLLIN;
+		}
+
+		if (poll(fds, ARRAY_SIZE(fds), -1) < 0) {
+			k_sleep(K_MSEC(10));
+			continue;
+		}
+
+		for (int i = 0; i < CONN_MAX; i++) {
+			if (fds[i + 1].revents) {
+				server_recv(i);
+			}
+		}
+
+		if (fds[0].revents & POLLIN) {
+			server_accept();
+		}
+	}
+}
+
+static void server_start(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+
+	for (int i = 0; i < CONN_MAX; i++) {
+		server.conn[i].fd = -1;
+	}
+
+	zassert_equal(inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr), 1, "Invalid address");
+
+	server.listen_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(server.listen_fd >= 0, "Failed to open socket");
+	zassert_ok(bind(server.listen_fd, (struct sockaddr *)&addr, sizeof(addr)),
+		   "Failed to bind");
+	zassert_ok(listen(server.listen_fd, CONN_MAX), "Failed to listen");
+
+	k_thread_create(&server_thread, server_stack, K_THREAD_STACK_SIZEOF(server_stack),
+			server_run, NULL, NULL, NULL, SERVER_PRIO, 0, K_NO_WAIT);
+}
+
+static void req_init(struct rest_client_req_context *req, const char *url)
+{
+	rest_client_request_defaults_set(req);
+
+	req->host = SERVER_ADDR;
+	req->port = SERVER_PORT;
+	req->url = url;
+	req->timeout_ms = TIMEOUT_MS;
+	req->resp_buff = resp_buf;
+	req->resp_buff_len = sizeof(resp_buf);
+}
+
+static void resp_check(const struct rest_client_resp_context *resp)
+{
+	zassert_equal(resp->http_status_code, REST_CLIENT_HTTP_STATUS_OK, "Wrong status %u",
+		      resp->http_status_code);
+	zassert_equal(resp->response_len, BODY_LEN, "Wrong body length %zu",
+		      resp->response_len);
+	zassert_mem_equal(resp->response, body, BODY_LEN, "Wrong body");
+}
+
+static int body_cb(const struct rest_client_body_frag *frag, void *user_data)
+{
+	zassert_equal_ptr(user_data, &received, "Wrong user data");
+	zassert_equal(frag->http_status_code, received.status, "Wrong status");
+	zassert_equal(frag->offset, received.len, "Fragment out of order");
+	zassert_true(frag->len > 0, "Empty fragment");
+	zassert_true(received.len + frag->len <= sizeof(received.data), "Body too long");
+
+	zassert_true(!received.frags || frag->range_total == received.range_total,
+		     "Range changed");
+
+	memcpy(&received.data[received.len], frag->data, frag->len);
+	received.len += frag->len;
+	received.frags++;
+	received.range_total = frag->range_total;
+
+	if (received.frags == received.abort_after) {
+		return -ECANCELED;
+	}
+
+	return 0;
+}
+
+static void stream_req_init(struct rest_client_req_context *req, const char *url)
+{
+	req_init(req, url);
+
+	req->resp_buff_len = STREAM_BUF_SIZE;
+	req->body_cb = body_cb;
+	req->body_cb_user_data = &received;
+
+	memset(&received, 0, sizeof(received));
+	received.status = REST_CLIENT_HTTP_STATUS_OK;
+}
+
+static void stream_check(const struct rest_client_resp_context *resp)
+{
+	zassert_equal(resp->http_status_code, REST_CLIENT_HTTP_STATUS_OK, "Wrong status %u",
+		      resp->http_status_code);
+	zassert_is_null(resp->response, "Body stored in the receive buffer");
+	zassert_equal(received.len, BODY_LEN, "Wrong body length %zu", received.len);
+	zassert_mem_equal(received.data, body, BODY_LEN, "Wrong body");
+	zassert_true(received.frags > 1, "Body not received in fragments");
+}
+
+static void setup(void)
+{
+	rest_client_pool_flush();
+}
+
+static void test_pool_reuse(void)
+{
+	struct rest_client_req_context req;
+	struct rest_client_resp_context resp;
+	struct rest_client_pool_stats before;
+	struct rest_client_pool_stats after;
+	atomic_val_t accepted = atomic_get(&server.accepted);
+
+	rest_client_pool_stats_get(&before);
+
+	for (int i = 0; i < 3; i++) {
+		req_init(&req, "/fixed");
+		zassert_ok(rest_client_request(&req, &resp), "Request %d failed", i);
+		resp_check(&resp);
+	}
+
+	rest_client_pool_stats_get(&after);
+
+	zassert_equal(atomic_get(&server.accepted) - accepted, 1, "Connection not reused");
+	zassert_equal(after.connections - before.connections, 1, "Wrong connection count");
+	zassert_equal(after.reused - before.reused, 2, "Wrong reuse count");
+	zassert_equal(after.stale, before.stale, "Connection found stale");
+}
+
+static void test_pool_idle_close(void)
+{
+	struct rest_client_req_context req;
+	struct rest_client_resp_context resp;
+	struct rest_client_pool_stats before;
+	struct rest_client_pool_stats after;
+	atomic_val_t accepted = atomic_get(&server.accepted);
+
+	rest_client_pool_stats_get(&before);
+
+	/* The connection is pooled, as the response allows keep-alive. */
+	req_init(&req, "/close");
+	zassert_ok(rest_client_request(&req, &resp), "Request failed");
+	resp_check(&resp);
+
+	/* Let the server close the connection. */
+	k_sleep(K_MSEC(100));
+
+	/* The pooled connection is stale, the request is retried on a new one. */
+	req_init(&req, "/fixed");
+	zassert_ok(rest_client_request(&req, &resp), "Request not retried");
+	resp_check(&resp);
+
+	rest_client_pool_stats_get(&after);
+
+	zassert_equal(atomic_get(&server.accepted) - accepted, 2, "No new connection");
+	zassert_equal(after.connections - before.connections, 2, "Wrong connection count");
+	zassert_equal(after.reused - before.reused, 1, "Stale connection not used");
+	zassert_equal(after.stale - before.stale, 1, "Stale connection not detected");
+
+	/* The new connection is pooled in turn. */
+	req_init(&req, "/fixed");
+	zassert_ok(rest_client_request(&req, &resp), "Request failed");
+	resp_check(&resp);
+
+	zassert_equal(atomic_get(&server.accepted) - accepted, 2, "Connection not reused");
+}
+
+static void test_pool_idle_close_post(void)
+{
+	struct rest_client_req_context req;
+	struct rest_client_resp_context resp;
+	atomic_val_t accepted = atomic_get(&server.accepted);
+
+	req_init(&req, "/close");
+	zassert_ok(rest_client_request(&req, &resp), "Request failed");
+	resp_check(&resp);
+
+	k_sleep(K_MSEC(100));
+
+	/* The request may have reached the server, so it is not resent. */
+	req_init(&req, "/fixed");
+	req.http_method = HTTP_POST;
+	zassert_not_equal(rest_client_request(&req, &resp), 0, "Error not returned");
+	zassert_equal(atomic_get(&server.accepted) - accepted, 1, "Request resent");
+}
+
+static void test_pool_timeout(void)
+{
+	struct rest_client_req_context req;
+	struct rest_client_resp_context resp;
+	atomic_val_t accepted = atomic_get(&server.accepted);
+	atomic_val_t slow = atomic_get(&server.slow);
+
+	req_init(&req, "/fixed");
+	zassert_ok(rest_client_request(&req, &resp), "Request failed");
+	resp_check(&resp);
+
+	/* A request that times out on a pooled connection is not resent. */
+	req_init(&req, "/slow");
+	req.timeout_ms = SLOW_TIMEOUT_MS;
+	zassert_true(rest_client_request(&req, &resp) < 0, "Error not returned");
+
+	k_sleep(K_MSEC(100));
+
+	zassert_equal(atomic_get(&server.slow) - slow, 1, "Request resent");
+	zassert_equal(atomic_get(&server.accepted) - accepted, 1, "Request resent");
+}
+
+static void test_body_cb_fixed(void)
+{
+	struct rest_client_req_context req;
+	struct rest_client_resp_context resp;
+
+	stream_req_init(&req, "/fixed");
+	zassert_ok(rest_client_request(&req, &resp), "Request failed");
+	stream_check(&resp);
+	zassert_equal(resp.response_len, BODY_LEN, "Wrong body length");
+}
+
+static void test_body_cb_chunked(void)
+{
+	struct rest_client_req_context req;
+	struct rest_client_resp_context resp;
+
+	stream_req_init(&req, "/chunked");
+	zassert_ok(rest_client_request(&req, &resp), "Request failed");
+	stream_check(&resp);
+	zassert_true(received.frags >= BODY_LEN / CHUNK_LEN, "Chunks merged");
+}
+
+static void test_body_cb_range(void)
+{
+	struct rest_client_req_context req;
+	struct rest_client_resp_context resp;
+
+	stream_req_init(&req, "/range");
+	received.status = HTTP_STATUS_PARTIAL;
+
+	zassert_ok(rest_client_request(&req, &resp), "Request failed");
+	zassert_equal(resp.http_status_code, HTTP_STATUS_PARTIAL, "Wrong status %u",
+		      resp.http_status_code);
+	zassert_equal(received.len, BODY_LEN, "Wrong body length %zu", received.len);
+	zassert_mem_equal(received.data, body, BODY_LEN, "Wrong body");
+
+	/* The headers were received in earlier receive buffers. */
+	zassert_equal(received.range_total, RANGE_TOTAL, "Wrong range total %zu",
+		      received.range_total);
+
+	/* Responses without Content-Range give no total. */
+	stream_req_init(&req, "/fixed");
+	zassert_ok(rest_client_request(&req, &resp), "Request failed");
+	stream_check(&resp);
+	zassert_equal(received.range_total, 0, "Range total without Content-Range");
+}
+
+static void test_body_cb_abort(void)
+{
+	struct rest_client_req_context req;
+	struct rest_client_resp_context resp;
+
+	stream_req_init(&req, "/fixed");
+	received.abort_after = 1;
+
+	zassert_equal(rest_client_request(&req, &resp), -ECANCELED, "Error not returned");
+	zassert_equal(received.frags, 1, "Body passed on after the error");
+
+	/* The connection of the failed request is not reused. */
+	stream_req_init(&req, "/chunked");
+	zassert_ok(rest_client_request(&req, &resp), "Request failed");
+	stream_check(&resp);
+}
+
+void test_main(void)
+{
+	for (size_t i = 0; i < sizeof(body); i++) {
+		body[i] = 'a' + i % 26;
+	}
+
+	server_start();
+
+	ztest_test_suite(rest_client_test,
+			 ztest_unit_test_setup_teardown(test_pool_reuse, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_pool_idle_close, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_pool_idle_close_post, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_pool_timeout, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_body_cb_fixed, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_body_cb_chunked, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_body_cb_range, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_body_cb_abort, setup, unit_test_noop)
+			 );
+
+	ztest_run_test_suite(rest_client_test);
+}
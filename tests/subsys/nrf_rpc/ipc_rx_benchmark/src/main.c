@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/ipc/ipc_service.h>
+
+#include <zcbor_encode.h>
+#include <zcbor_decode.h>
+
+#include <nrf_rpc/nrf_rpc_ipc.h>
+
+#include "bt_rpc_common.h"
+#include "bt_rpc_fast.h"
+#include "serialize.h"
+
+/* Receives fast-encoded notifications through the nRF RPC IPC Service
+ * transport of Bluetooth RPC, and decodes them with the host decoder of
+ * bt_gatt_notify_cb_fast(), which either holds the IPC Service buffer of the
+ * packet or copies the data out of it.
+ */
+
+#define ROUNDS 1000
+
+#define ATTR_INDEX 7
+#define USER_DATA  0x20001234
+
+/* Room for the nRF RPC header in front of the CBOR payload. */
+#define PACKET_HDR_SIZE 4
+#define PACKET_MAX (PACKET_HDR_SIZE + BT_RPC_FAST_NOTIFY_BUF_SIZE(CONFIG_BT_L2CAP_TX_MTU))
+
+/* Upper bound of the number of CBOR items in a notification command. */
+#define DECODE_ELEM_COUNT 16
+
+/* Host decoders, see bt_rpc_gatt_host.c. */
+void bt_gatt_notify_fast_dec(struct nrf_rpc_cbor_ctx *ctx, struct bt_gatt_notify_params *data);
+const void *bt_gatt_notify_fast_data_keep(struct bt_gatt_notify_params *params, uint8_t *buf);
+
+static const struct ipc_ept_cfg *ept_cfg;
+
+static uint8_t packet[PACKET_MAX];
+static uint8_t pattern[CONFIG_BT_L2CAP_TX_MTU];
+
+/* Stands for the ATT PDU the data is copied into by bt_gatt_notify_cb(). */
+static uint8_t pdu[CONFIG_BT_L2CAP_TX_MTU];
+
+static bool hold_supported;
+static bool hold_foreign;
+static uint32_t holds;
+static uint32_t releases;
+static uint32_t copies;
+static uint32_t copied_bytes;
+
+/****************** mock section **********************************/
+
+int __wrap_ipc_service_open_instance(const struct device *instance)
+{
+	return 0;
+}
+
+int __wrap_ipc_service_register_endpoint(const struct device *instance, struct ipc_ept *ept,
+					 const struct ipc_ept_cfg *cfg)
+{
+	ept_cfg = cfg;
+	cfg->cb.bound(cfg->priv);
+
+	return 0;
+}
+
+int __wrap_ipc_service_send(struct ipc_ept *ept, const void *data, size_t len)
+{
+	return len;
+}
+
+int __wrap_ipc_service_hold_rx_buffer(struct ipc_ept *ept, void *data)
+{
+	if (!hold_supported) {
+		return -ENOTSUP;
+	}
+
+	holds++;
+
+	return 0;
+}
+
+int __wrap_ipc_service_release_rx_buffer(struct ipc_ept *ept, void *data)
+{
+	releases++;
+
+	return 0;
+}
+
+/****************** mock section **********************************/
+
+/* Same fields as bt_gatt_notify_cb_fast() in bt_rpc_gatt_client.c, without
+ * the connection.
+ */
+static size_t packet_encode(uint16_t data_len)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	struct bt_rpc_fast_notify notify = {
+		.attr_index = ATTR_INDEX,
+		.func_slot = BT_RPC_FAST_NO_CALLBACK,
+		.user_data = USER_DATA,
+		.data = pattern,
+		.len = data_len,
+	};
+
+	zcbor_new_encode_state(ctx.zs, ARRAY_SIZE(ctx.zs), packet + PACKET_HDR_SIZE,
+			       sizeof(packet) - PACKET_HDR_SIZE, 0);
+
+	bt_rpc_fast_notify_enc(&ctx, &notify);
+
+	zassert_true(ser_decode_valid(&ctx), "Encoding failed");
+
+	return ctx.zs->payload - packet;
+}
+
+/* Same steps as bt_gatt_notify_cb_fast_rpc_handler() in bt_rpc_gatt_host.c,
+ * run before the receive callback returns as nRF RPC does until the decoding
+ * is done. The notification is replaced by the copy into the ATT PDU.
+ */
+static void receive_cb(const struct nrf_rpc_tr *transport, const uint8_t *data, size_t len,
+		       void *context)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	struct bt_gatt_notify_params params;
+	const void *held;
+
+	if (hold_foreign) {
+		zassert_equal(nrf_rpc_ipc_rx_hold(transport, pattern, &held), -EINVAL,
+			      "Held data outside of the packet");
+		zassert_equal(nrf_rpc_ipc_rx_hold(transport, data + len, &held), -EINVAL,
+			      "Held data past the packet");
+		return;
+	}
+
+	zcbor_new_decode_state(ctx.zs, ARRAY_SIZE(ctx.zs), data + PACKET_HDR_SIZE,
+			       len - PACKET_HDR_SIZE, DECODE_ELEM_COUNT);
+
+	bt_gatt_notify_fast_dec(&ctx, &params);
+
+	uint8_t buf[MAX(params.len, 1)];
+
+	held = bt_gatt_notify_fast_data_keep(&params, buf);
+
+	zassert_true(ser_decode_valid(&ctx), "Decoding failed");
+
+	if (!held) {
+		copies++;
+		copied_bytes += params.len;
+	}
+
+	memcpy(pdu, params.data, params.len);
+
+	if (held) {
+		zassert_equal_ptr(held, data, "Wrong buffer held");
+		zassert_ok(nrf_rpc_ipc_rx_release(&bt_rpc_tr, held), "Release failed");
+	}
+}
+
+static void receive(size_t len)
+{
+	ept_cfg->cb.received(packet, len, ept_cfg->priv);
+}
+
+static void test_init(void)
+{
+	zassert_ok(bt_rpc_tr.api->init(&bt_rpc_tr, receive_cb, NULL), "Init failed");
+	zassert_not_null(ept_cfg, "Endpoint not registered");
+}
+
+static void test_hold_release(void)
+{
+	const void *held;
+	size_t len = packet_encode(sizeof(pattern));
+
+	hold_supported = true;
+	holds = 0;
+	releases = 0;
+	copies = 0;
+
+	zassert_equal(nrf_rpc_ipc_rx_hold(&bt_rpc_tr, packet, &held), -ENOENT,
+		      "Held outside of the receive callback");
+
+	hold_foreign = true;
+	receive(len);
+	hold_foreign = false;
+
+	zassert_equal(holds, 0, "Held data outside of the packet");
+
+	memset(pdu, 0, sizeof(pdu));
+	receive(len);
+
+	zassert_equal(holds, 1, "Not held");
+	zassert_equal(releases, holds, "Not released");
+	zassert_equal(copies, 0, "Copied while held");
+	zassert_mem_equal(pdu, pattern, sizeof(pattern), "Wrong data");
+
+	hold_supported = false;
+
+	memset(pdu, 0, sizeof(pdu));
+	receive(len);
+
+	zassert_equal(holds, 1, "Held without hold support");
+	zassert_equal(copies, 1, "Not copied without hold support");
+	zassert_mem_equal(pdu, pattern, sizeof(pattern), "Wrong data");
+}
+
+static uint32_t cycles_per_packet(bool hold, size_t len)
+{
+	uint32_t start;
+
+	hold_supported = hold;
+
+	start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < ROUNDS; i++) {
+		receive(len);
+	}
+
+	return (k_cycle_get_32() - start) / ROUNDS;
+}
+
+static void test_benchmark(void)
+{
+	static const size_t data_len[] = { 20, 64, 244 };
+
+	TC_PRINT("data_len,packet_len,copy_cycles,copies,copied_bytes,hold_cycles,holds\n");
+
+	for (size_t i = 0; i < ARRAY_SIZE(data_len); i++) {
+		size_t len = MIN(data_len[i], sizeof(pattern));
+		size_t packet_len = packet_encode(len);
+		uint32_t copy;
+		uint32_t hold;
+
+		copies = 0;
+		copied_bytes = 0;
+		holds = 0;
+
+		copy = cycles_per_packet(false, packet_len);
+		hold = cycles_per_packet(true, packet_len);
+
+		zassert_equal(copies, ROUNDS, "Wrong number of copies");
+		zassert_equal(holds, ROUNDS, "Wrong number of holds");
+
+		TC_PRINT("%zu,%zu,%u,%u,%u,%u,%u\n", len, packet_len, copy, copies,
+			 copied_bytes, hold, holds);
+	}
+}
+
+void test_main(void)
+{
+	for (size_t i = 0; i < sizeof(pattern); i++) {
+		pattern[i] = i;
+	}
+
+	ztest_test_suite(nrf_rpc_ipc_rx_benchmark,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_hold_release),
+			 ztest_unit_test(test_benchmark)
+			 );
+
+	ztest_run_test_suite(nrf_rpc_ipc_rx_benchmark);
+}
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ipc/ipc_service.h>
+
+#include <nrf_rpc_os.h>
+#include <nrf_rpc/nrf_rpc_ipc.h>
+
+/* Passes the commands received by nRF RPC IPC Service transports of each
+ * priority class to the thread pool, and checks which threads serve them. The
+ * transports are on different IPC instances, and the receive context of each
+ * instance is the thread calling receive().
+ */
+
+#define CMDS_MAX     16
+#define STACK_SIZE   1024
+#define THREAD_PRIO  K_PRIO_PREEMPT(5)
+#define STALL_MS     10
+
+#define RX_THREADS_MAX  CONFIG_NRF_RPC_RX_THREADS_MAX
+#define POOL_QUEUE_SIZE CONFIG_NRF_RPC_THREAD_POOL_QUEUE_SIZE
+
+#define HIGH_POOL (CONFIG_NRF_RPC_THREAD_POOL_HIGH_PRIO_SIZE > 0)
+
+#define PRIO_DEFAULT CONFIG_NRF_RPC_THREAD_PRIORITY
+#define PRIO_HIGH (HIGH_POOL ? CONFIG_NRF_RPC_THREAD_HIGH_PRIO_PRIORITY : PRIO_DEFAULT)
+
+NRF_RPC_IPC_TRANSPORT(default_tr, NULL, "default_ept");
+NRF_RPC_IPC_TRANSPORT_PRIO(high_tr, NULL, "high_ept", NRF_RPC_OS_PRIO_HIGH);
+
+static const struct ipc_ept_cfg *ept_cfgs[2];
+static size_t ept_cnt;
+
+static uint8_t cmd_data[CMDS_MAX];
+
+/* Commands run by the thread pool, in order. */
+static struct {
+	uint8_t id;
+	int prio;
+} ran[CMDS_MAX];
+static atomic_t ran_cnt;
+static K_SEM_DEFINE(ran_sem, 0, CMDS_MAX);
+
+/* Holds the commands of the default priority class while closed. */
+static volatile bool gate_closed;
+static K_SEM_DEFINE(gate, 0, 1);
+
+static K_THREAD_STACK_ARRAY_DEFINE(rx_stacks, RX_THREADS_MAX + 1, STACK_SIZE);
+static struct k_thread rx_threads[RX_THREADS_MAX + 1];
+static K_SEM_DEFINE(rx_ready, 0, 1);
+static K_SEM_DEFINE(rx_go, 0, RX_THREADS_MAX + 1);
+
+static K_THREAD_STACK_DEFINE(helper_stack, STACK_SIZE);
+static struct k_thread helper_thread;
+
+/****************** mock section **********************************/
+
+int __wrap_ipc_service_open_instance(const struct device *instance)
+{
+	return 0;
+}
+
+int __wrap_ipc_service_register_endpoint(const struct device *instance, struct ipc_ept *ept,
+					 const struct ipc_ept_cfg *cfg)
+{
+	zassert_true(ept_cnt < ARRAY_SIZE(ept_cfgs), "Too many endpoints");
+
+	ept_cfgs[ept_cnt++] = cfg;
+	cfg->cb.bound(cfg->priv);
+
+	return 0;
+}
+
+int __wrap_ipc_service_send(struct ipc_ept *ept, const void *data, size_t len)
+{
+	return len;
+}
+
+int __wrap_ipc_service_hold_rx_buffer(struct ipc_ept *ept, void *data)
+{
+	return -ENOTSUP;
+}
+
+int __wrap_ipc_service_release_rx_buffer(struct ipc_ept *ept, void *data)
+{
+	return -ENOTSUP;
+}
+
+/****************** mock section **********************************/
+
+static void work(const uint8_t *data, size_t len)
+{
+	int prio = k_thread_priority_get(k_current_get());
+	atomic_val_t i;
+
+	if (gate_closed && (prio == PRIO_DEFAULT)) {
+		k_sem_take(&gate, K_FOREVER);
+	}
+
+	i = atomic_inc(&ran_cnt);
+	zassert_true(i < CMDS_MAX, "Too many commands");
+
+	ran[i].id = data[0];
+	ran[i].prio = prio;
+
+	k_sem_give(&ran_sem);
+}
+
+/* Same as nRF RPC does with a received command. */
+static void receive_cb(const struct nrf_rpc_tr *transport, const uint8_t *packet, size_t len,
+		       void *context)
+{
+	nrf_rpc_os_thread_pool_send(packet, len);
+}
+
+static void receive(const struct nrf_rpc_tr *transport, uint8_t id)
+{
+	for (size_t i = 0; i < ept_cnt; i++) {
+		if (ept_cfgs[i]->priv == transport) {
+			ept_cfgs[i]->cb.received(&cmd_data[id], 1, ept_cfgs[i]->priv);
+			return;
+		}
+	}
+
+	zassert_unreachable("Endpoint not registered");
+}
+
+static void ran_wait(size_t cnt)
+{
+	for (size_t i = 0; i < cnt; i++) {
+		zassert_ok(k_sem_take(&ran_sem, K_MSEC(100)), "Command not run");
+	}
+}
+
+static void ran_check(size_t i, uint8_t id, int prio)
+{
+	zassert_equal(ran[i].id, id, "Wrong command %zu", i);
+	zassert_equal(ran[i].prio, prio, "Command %u run at wrong priority", id);
+}
+
+static void gate_open(void)
+{
+	gate_closed = false;
+	k_sem_give(&gate);
+}
+
+static void test_setup(void)
+{
+	memset(ran, 0, sizeof(ran));
+	atomic_set(&ran_cnt, 0);
+	k_sem_reset(&ran_sem);
+	k_sem_reset(&gate);
+	gate_closed = false;
+
+	nrf_rpc_os_stats_reset();
+}
+
+static void test_init(void)
+{
+	zassert_ok(nrf_rpc_os_init(work), "OS init failed");
+	zassert_ok(default_tr.api->init(&default_tr, receive_cb, NULL), "Init failed");
+	zassert_ok(high_tr.api->init(&high_tr, receive_cb, NULL), "Init failed");
+	zassert_equal(ept_cnt, 2, "Endpoints not registered");
+}
+
+static void test_dispatch(void)
+{
+	receive(&default_tr, 0);
+	ran_wait(1);
+	ran_check(0, 0, PRIO_DEFAULT);
+
+	/* Served by the default threads without high priority threads. */
+	receive(&high_tr, 1);
+	ran_wait(1);
+	ran_check(1, 1, PRIO_HIGH);
+
+	/* The class only applies to the commands of the receive callback. */
+	nrf_rpc_os_thread_pool_send(&cmd_data[2], 1);
+	ran_wait(1);
+	ran_check(2, 2, PRIO_DEFAULT);
+}
+
+/* Receive context of the IPC instance of default_tr. */
+static void bulk_rx_fn(void *p1, void *p2, void *p3)
+{
+	/* The command after the ones filling the queue blocks the context. */
+	for (uint8_t id = 0; id <= POOL_QUEUE_SIZE + 1; id++) {
+		receive(&default_tr, id);
+	}
+}
+
+static void test_isolation(void)
+{
+	const uint8_t high_id = POOL_QUEUE_SIZE + 2;
+
+	if (!HIGH_POOL) {
+		ztest_test_skip();
+	}
+
+	/* Hold the default thread, and overfill its queue. */
+	gate_closed = true;
+	k_thread_create(&helper_thread, helper_stack, K_THREAD_STACK_SIZEOF(helper_stack),
+			bulk_rx_fn, NULL, NULL, NULL, THREAD_PRIO, 0, K_NO_WAIT);
+	k_sleep(K_MSEC(STALL_MS));
+
+	zassert_equal(k_thread_join(&helper_thread, K_NO_WAIT), -EBUSY,
+		      "Receive context not blocked");
+
+	/* High priority commands on another IPC instance are not held up. */
+	receive(&high_tr, high_id);
+	ran_wait(1);
+	ran_check(0, high_id, PRIO_HIGH);
+
+	gate_open();
+	zassert_ok(k_thread_join(&helper_thread, K_MSEC(100)), "Receive context blocked");
+	ran_wait(POOL_QUEUE_SIZE + 2);
+
+	for (uint8_t id = 0; id <= POOL_QUEUE_SIZE + 1; id++) {
+		ran_check(id + 1, id, PRIO_DEFAULT);
+	}
+}
+
+static void rx_thread_fn(void *p1, void *p2, void *p3)
+{
+	uint8_t id = (uintptr_t)p1;
+
+	/* Same as a transport of high priority around its receive callback. */
+	nrf_rpc_os_rx_prio_set(NRF_RPC_OS_PRIO_HIGH);
+	k_sem_give(&rx_ready);
+
+	k_sem_take(&rx_go, K_FOREVER);
+	nrf_rpc_os_thread_pool_send(&cmd_data[id], 1);
+
+	nrf_rpc_os_rx_prio_set(NRF_RPC_OS_PRIO_DEFAULT);
+}
+
+static void test_rx_threads_overflow(void)
+{
+	/* Each thread sets its class before the next one is started. */
+	for (size_t i = 0; i < ARRAY_SIZE(rx_threads); i++) {
+		k_thread_create(&rx_threads[i], rx_stacks[i], K_THREAD_STACK_SIZEOF(rx_stacks[i]),
+				rx_thread_fn, (void *)i, NULL, NULL, THREAD_PRIO, 0, K_NO_WAIT);
+		zassert_ok(k_sem_take(&rx_ready, K_MSEC(100)), "Thread not started");
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(rx_threads); i++) {
+		k_sem_give(&rx_go);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(rx_threads); i++) {
+		zassert_ok(k_thread_join(&rx_threads[i], K_MSEC(100)), "Thread not done");
+	}
+
+	ran_wait(ARRAY_SIZE(rx_threads));
+
+	/* The class of the thread without a slot is ignored. */
+	for (size_t i = 0; i < ARRAY_SIZE(rx_threads); i++) {
+		zassert_equal(ran[i].prio, (ran[i].id < RX_THREADS_MAX) ? PRIO_HIGH : PRIO_DEFAULT,
+			      "Command %u run at wrong priority", ran[i].id);
+	}
+
+	/* The slots are released. */
+	receive(&high_tr, 0);
+	ran_wait(1);
+	ran_check(ARRAY_SIZE(rx_threads), 0, PRIO_HIGH);
+}
+
+static void sender_fn(void *p1, void *p2, void *p3)
+{
+	uint8_t id = (uintptr_t)p1;
+
+	nrf_rpc_os_thread_pool_send(&cmd_data[id], 1);
+}
+
+static void test_stats(void)
+{
+	struct nrf_rpc_os_stats stats;
+	uint8_t id;
+
+	/* Hold the default thread, and fill its queue. */
+	gate_closed = true;
+	nrf_rpc_os_thread_pool_send(&cmd_data[0], 1);
+	k_sleep(K_MSEC(1));
+
+	for (id = 1; id <= POOL_QUEUE_SIZE; id++) {
+		nrf_rpc_os_thread_pool_send(&cmd_data[id], 1);
+	}
+
+	/* The next command blocks its sender until there is room. */
+	k_thread_create(&helper_thread, helper_stack, K_THREAD_STACK_SIZEOF(helper_stack),
+			sender_fn, (void *)(uintptr_t)id, NULL, NULL, THREAD_PRIO, 0,
+			K_NO_WAIT);
+	k_sleep(K_MSEC(STALL_MS));
+
+	gate_open();
+	ran_wait(id + 1);
+	zassert_ok(k_thread_join(&helper_thread, K_MSEC(100)), "Sender blocked");
+
+	receive(&high_tr, 0);
+	ran_wait(1);
+
+	nrf_rpc_os_stats_get(NRF_RPC_OS_PRIO_DEFAULT, &stats);
+
+	zassert_equal(stats.cmds, HIGH_POOL ? (id + 1) : (id + 2), "Wrong command count");
+	zassert_equal(stats.queue_full, 1, "Wrong queue full count");
+	zassert_equal(stats.queue_depth_max, POOL_QUEUE_SIZE, "Wrong queue depth");
+	zassert_true(stats.latency_max_us >= (STALL_MS - 1) * USEC_PER_MSEC,
+		     "Latency too low (%u us)", stats.latency_max_us);
+	zassert_true(stats.latency_us >= stats.latency_max_us, "Wrong total latency");
+
+	nrf_rpc_os_stats_get(NRF_RPC_OS_PRIO_HIGH, &stats);
+
+	zassert_equal(stats.cmds, HIGH_POOL ? 1 : 0, "Wrong command count");
+	zassert_equal(stats.queue_full, 0, "Wrong queue full count");
+
+	/* The statistics can be reset. */
+	nrf_rpc_os_stats_reset();
+	nrf_rpc_os_stats_get(NRF_RPC_OS_PRIO_DEFAULT, &stats);
+
+	zassert_equal(stats.cmds, 0, "Statistics not reset");
+	zassert_equal(stats.latency_max_us, 0, "Statistics not reset");
+}
+
+void test_main(void)
+{
+	for (size_t i = 0; i < sizeof(cmd_data); i++) {
+		cmd_data[i] = i;
+	}
+
+	ztest_test_suite(nrf_rpc_thread_pool,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test_setup_teardown(test_dispatch,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_isolation,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_rx_threads_overflow,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_stats,
+							test_setup,
+							unit_test_noop)
+			 );
+
+	ztest_run_test_suite(nrf_rpc_thread_pool);
+}